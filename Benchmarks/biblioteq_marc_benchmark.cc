@@ -0,0 +1,235 @@
+/*
+** Measures how many MARC records biblioteq_marc parses per second for
+** each item type and record syntax, as MARCXML (SRU), as rendered
+** Z39.50 text and as ISO 2709 records.
+**
+** qmake biblioteq_marc_benchmark.pro && make
+** ./biblioteq_marc_benchmark [records]
+*/
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "biblioteq_marc.h"
+
+struct field
+{
+  const char *m_tag;
+  const char *m_indicators;
+  const char *m_subfields; // Subfields are separated by '|'.
+};
+
+static const field marc21Fields[] =
+  {
+    {"001", "", "ocm12345678"},
+    {"008", "", "870115s1987    nyua     b    001 0 eng  "},
+    {"010", "  ", "a   86031321"},
+    {"020", "  ", "a0387964843"},
+    {"020", "  ", "a9780387964843"},
+    {"050", "00", "aQA76.73.C15|bS74 1987"},
+    {"082", "00", "a005.13/3|219"},
+    {"100", "1 ", "aStroustrup, Bjarne."},
+    {"245", "14", "aThe C++ programming language /|cBjarne Stroustrup."},
+    {"250", "  ", "a2nd ed."},
+    {"260", "  ", "aReading, Mass. :|bAddison-Wesley,|c1987."},
+    {"300", "  ", "axiii, 328 p. :|bill. ;|c24 cm."},
+    {"504", "  ", "aIncludes bibliographical references and index."},
+    {"520", "  ", "aA description of the C++ language and its library."},
+    {"650", " 0", "aC++ (Computer program language)"},
+    {"650", " 0", "aObject-oriented programming (Computer science)"},
+    {"650", " 0", "aProgramming languages (Electronic computers)"},
+    {0, 0, 0}
+  };
+
+static const field unimarcFields[] =
+  {
+    {"001", "", "FRBNF12345678"},
+    {"010", "  ", "a0387964843|bbr."},
+    {"100", "  ", "a19870115d1987    m  y0frey50      ba"},
+    {"101", "0 ", "aeng"},
+    {"200", "1 ", "aThe C++ programming language|fBjarne Stroustrup"},
+    {"205", "  ", "a2nd ed."},
+    {"210", "  ", "aReading, Mass.|cAddison-Wesley|d1987"},
+    {"215", "  ", "aXIII-328 p.|cill.|d24 cm"},
+    {"330", "  ", "aA description of the C++ language and its library."},
+    {"606", "  ", "aC++ (langage de programmation)"},
+    {"606", "  ", "aProgrammation orientee objets (informatique)"},
+    {"676", "  ", "a005.13"},
+    {"680", "  ", "aQA76.73.C15"},
+    {"700", " 1", "aStroustrup|bBjarne"},
+    {0, 0, 0}
+  };
+
+/*
+** -- digits() --
+*/
+
+static QByteArray digits(const int value, const int width)
+{
+  return QByteArray::number(value).rightJustified(width, '0');
+}
+
+/*
+** -- iso2709Record() --
+*/
+
+static QByteArray iso2709Record(const field *fields)
+{
+  QByteArray data;
+  QByteArray directory;
+
+  for(int i = 0; fields[i].m_tag; i++)
+    {
+      QByteArray value(fields[i].m_indicators);
+
+      if(fields[i].m_indicators[0] != 0)
+	{
+	  value.append('\x1f');
+	  value.append(QByteArray(fields[i].m_subfields).replace('|', '\x1f'));
+	}
+      else
+	value.append(fields[i].m_subfields);
+
+      value.append('\x1e');
+      directory.append(fields[i].m_tag);
+      directory.append(digits(value.length(), 4));
+      directory.append(digits(data.length(), 5));
+      data.append(value);
+    }
+
+  directory.append('\x1e');
+  data.append('\x1d');
+
+  int base = 24 + directory.length();
+  QByteArray record;
+
+  record.append(digits(base + data.length(), 5));
+  record.append("nam  22");
+  record.append(digits(base, 5));
+  record.append("   4500");
+  record.append(directory);
+  record.append(data);
+  return record;
+}
+
+/*
+** -- marcXmlRecord() --
+*/
+
+static QString marcXmlRecord(const field *fields)
+{
+  QString xml("<record xmlns=\"http://www.loc.gov/MARC21/slim\">"
+	      "<leader>00000nam  2200000   4500</leader>");
+
+  for(int i = 0; fields[i].m_tag; i++)
+    if(fields[i].m_indicators[0] == 0)
+      xml.append(QString("<controlfield tag=\"%1\">%2</controlfield>").
+		 arg(fields[i].m_tag).arg(fields[i].m_subfields));
+    else
+      {
+	QStringList subfields
+	  (QString(fields[i].m_subfields).split('|'));
+
+	xml.append(QString("<datafield tag=\"%1\" ind1=\"%2\" "
+			   "ind2=\"%3\">").
+		   arg(fields[i].m_tag).
+		   arg(QChar(fields[i].m_indicators[0])).
+		   arg(QChar(fields[i].m_indicators[1])));
+
+	for(int j = 0; j < subfields.size(); j++)
+	  xml.append(QString("<subfield code=\"%1\">%2</subfield>").
+		     arg(subfields.at(j).left(1)).
+		     arg(subfields.at(j).mid(1)));
+
+	xml.append("</datafield>");
+      }
+
+  xml.append("</record>");
+  return xml;
+}
+
+/*
+** -- report() --
+*/
+
+static void report(const char *name, const int records, const qint64 ms)
+{
+  std::printf("%-28s %12.0f records/s\n", name,
+	      ms > 0 ? 1000.0 * records / ms : 0.0);
+}
+
+/*
+** -- main() --
+*/
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication application(argc, argv);
+  int records = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+  if(records <= 0)
+    records = 100000;
+
+  static const char *itemNames[] = {"book", "magazine"};
+  static const char *syntaxNames[] = {"MARC21", "UNIMARC"};
+
+  for(int syntax = 0; syntax < 2; syntax++)
+    {
+      const field *fields = syntax == 0 ? marc21Fields : unimarcFields;
+      QByteArray iso2709(iso2709Record(fields));
+      QString text(biblioteq_marc::recordText(iso2709));
+      QString xml(marcXmlRecord(fields));
+
+      for(int item = 0; item < 2; item++)
+	{
+	  biblioteq_marc::ITEM_TYPE itemType =
+	    item == 0 ? biblioteq_marc::BOOK : biblioteq_marc::MAGAZINE;
+	  biblioteq_marc::RECORD_SYNTAX recordSyntax =
+	    syntax == 0 ? biblioteq_marc::MARC21 : biblioteq_marc::UNIMARC;
+	  QByteArray name;
+	  QElapsedTimer timer;
+
+	  {
+	    biblioteq_marc marc(itemType, biblioteq_marc::SRU, recordSyntax);
+
+	    timer.start();
+
+	    for(int i = 0; i < records; i++)
+	      marc.setData(xml);
+
+	    name = QByteArray(itemNames[item]) + " " + syntaxNames[syntax] +
+	      " SRU";
+	    report(name.constData(), records, timer.elapsed());
+	  }
+
+	  {
+	    biblioteq_marc marc(itemType, biblioteq_marc::Z3950, recordSyntax);
+
+	    timer.start();
+
+	    for(int i = 0; i < records; i++)
+	      marc.setData(text);
+
+	    name = QByteArray(itemNames[item]) + " " + syntaxNames[syntax] +
+	      " Z39.50 text";
+	    report(name.constData(), records, timer.elapsed());
+	    timer.start();
+
+	    for(int i = 0; i < records; i++)
+	      marc.setRecord(iso2709);
+
+	    name = QByteArray(itemNames[item]) + " " + syntaxNames[syntax] +
+	      " ISO 2709";
+	    report(name.constData(), records, timer.elapsed());
+	  }
+	}
+    }
+
+  return EXIT_SUCCESS;
+}
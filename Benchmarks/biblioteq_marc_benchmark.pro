@@ -0,0 +1,13 @@
+CONFIG		+= console qt release warn_on
+LANGUAGE	= C++
+QT		-= gui
+TEMPLATE	= app
+
+INCLUDEPATH	+= ../Source
+
+HEADERS		= ../Source/biblioteq_marc.h
+
+SOURCES		= ../Source/biblioteq_marc.cc \
+		  biblioteq_marc_benchmark.cc
+
+TARGET		= biblioteq_marc_benchmark
@@ -0,0 +1,347 @@
+/*
+** Times BiblioteQ's hot SQLite queries on a generated catalogue of
+** 100,000 books, before and after sqlite_create_indexes_text is applied.
+**
+** g++ -O2 -I../Source biblioteq_sqlite_indexes_benchmark.cc \
+**     -o biblioteq_sqlite_indexes_benchmark -lsqlite3
+** ./biblioteq_sqlite_indexes_benchmark [database]
+**
+** The database defaults to an in-memory database. An existing file is
+** replaced.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <sqlite3.h>
+#include <sys/time.h>
+
+#include "biblioteq_sqlite_create_schema.h"
+
+static const int BOOKS = 100000;
+static const int COLLECTIONS = 500;
+static const int HISTORY = 200000;
+static const int MEMBERS = 10000;
+static const int PHOTOGRAPHS_PER_COLLECTION = 40;
+static const int RESERVATIONS = 20000;
+
+struct benchmark
+{
+  const char *m_name;
+  const char *m_query;
+  int m_iterations;
+  int m_range;
+  bool m_text;
+};
+
+/*
+** The queries follow the members browser, the history dialog, the
+** copy editors and the photograph collection browser.
+*/
+
+static const benchmark benchmarks[] =
+  {
+    {"item by myoid",
+     "SELECT title FROM book WHERE myoid = ?",
+     1000, BOOKS, false},
+    {"item reservations",
+     "SELECT COUNT(*) FROM item_borrower "
+     "WHERE item_oid = ? AND type = 'Book'",
+     1000, BOOKS, false},
+    {"member reservations",
+     "SELECT COUNT(*) FROM item_borrower WHERE memberid = ?",
+     1000, MEMBERS, true},
+    {"member history",
+     "SELECT history.memberid, member.first_name, member.last_name, "
+     "book.title, book.id, history.copyid, book.type, "
+     "history.reserved_date, history.duedate, history.returned_date, "
+     "history.reserved_by, book.myoid "
+     "FROM member_history history, book book, member member "
+     "WHERE history.memberid = member.memberid AND "
+     "book.myoid = history.item_oid AND "
+     "member.memberid = ? AND book.type = history.type",
+     200, MEMBERS, true},
+    {"collection photographs",
+     "SELECT id, title FROM photograph WHERE collection_oid = ? "
+     "ORDER BY id",
+     500, COLLECTIONS, false},
+    {"overdue items",
+     "SELECT COUNT(*) FROM item_borrower WHERE duedate < ?",
+     100, 0, false},
+    {0, 0, 0, 0, false}
+  };
+
+/*
+** -- now() --
+*/
+
+static double now(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/*
+** -- execute() --
+*/
+
+static void execute(sqlite3 *db, const char *text)
+{
+  char *error = 0;
+
+  if(sqlite3_exec(db, text, 0, 0, &error) != SQLITE_OK)
+    {
+      std::fprintf(stderr, "%s\n", error ? error : "Unknown error.");
+      sqlite3_free(error);
+      std::exit(EXIT_FAILURE);
+    }
+}
+
+/*
+** -- prepare() --
+*/
+
+static sqlite3_stmt *prepare(sqlite3 *db, const char *text)
+{
+  sqlite3_stmt *statement = 0;
+
+  if(sqlite3_prepare_v2(db, text, -1, &statement, 0) != SQLITE_OK)
+    {
+      std::fprintf(stderr, "%s\n", sqlite3_errmsg(db));
+      std::exit(EXIT_FAILURE);
+    }
+
+  return statement;
+}
+
+/*
+** -- step() --
+*/
+
+static void step(sqlite3 *db, sqlite3_stmt *statement)
+{
+  if(sqlite3_step(statement) != SQLITE_DONE)
+    {
+      std::fprintf(stderr, "%s\n", sqlite3_errmsg(db));
+      std::exit(EXIT_FAILURE);
+    }
+
+  sqlite3_reset(statement);
+}
+
+/*
+** -- populate() --
+*/
+
+static void populate(sqlite3 *db)
+{
+  char text[64];
+  sqlite3_stmt *statement = 0;
+
+  execute(db, "BEGIN");
+  statement = prepare
+    (db,
+     "INSERT INTO book (author, binding_type, category, description, "
+     "edition, id, location, myoid, pdate, place, publisher, title) "
+     "VALUES ('Author', 'paperback', 'Category', 'Description', '1st', "
+     "?, 'Location', ?, '2001-01-01', 'Place', 'Publisher', ?)");
+
+  for(int i = 1; i <= BOOKS; i++)
+    {
+      std::snprintf(text, sizeof(text), "%010d", i);
+      sqlite3_bind_text(statement, 1, text, -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int64(statement, 2, i);
+      std::snprintf(text, sizeof(text), "Title %d", i);
+      sqlite3_bind_text(statement, 3, text, -1, SQLITE_TRANSIENT);
+      step(db, statement);
+    }
+
+  sqlite3_finalize(statement);
+  statement = prepare
+    (db,
+     "INSERT INTO book_copy_info (copyid, item_oid, myoid) "
+     "VALUES (?, ?, ?)");
+
+  for(int i = 1; i <= BOOKS; i++)
+    {
+      std::snprintf(text, sizeof(text), "C%010d", i);
+      sqlite3_bind_text(statement, 1, text, -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int64(statement, 2, i);
+      sqlite3_bind_int64(statement, 3, BOOKS + i);
+      step(db, statement);
+    }
+
+  sqlite3_finalize(statement);
+  statement = prepare
+    (db,
+     "INSERT INTO member (city, dob, expiration_date, first_name, "
+     "last_name, memberid, membersince, street) "
+     "VALUES ('City', '1980-01-01', '2030-01-01', 'First', ?, ?, "
+     "'2001-01-01', 'Street')");
+
+  for(int i = 1; i <= MEMBERS; i++)
+    {
+      std::snprintf(text, sizeof(text), "Last %d", i);
+      sqlite3_bind_text(statement, 1, text, -1, SQLITE_TRANSIENT);
+      std::snprintf(text, sizeof(text), "%d", i);
+      sqlite3_bind_text(statement, 2, text, -1, SQLITE_TRANSIENT);
+      step(db, statement);
+    }
+
+  sqlite3_finalize(statement);
+  statement = prepare
+    (db,
+     "INSERT INTO item_borrower (copyid, duedate, item_oid, memberid, "
+     "reserved_by, reserved_date, type) "
+     "VALUES ('C', ?, ?, ?, 'Librarian', '2001-01-01', 'Book')");
+
+  for(int i = 0; i < RESERVATIONS; i++)
+    {
+      std::snprintf(text, sizeof(text), "20%02d-%02d-%02d",
+		    i % 30, i % 12 + 1, i % 28 + 1);
+      sqlite3_bind_text(statement, 1, text, -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int64(statement, 2, std::rand() % BOOKS + 1);
+      std::snprintf(text, sizeof(text), "%d", std::rand() % MEMBERS + 1);
+      sqlite3_bind_text(statement, 3, text, -1, SQLITE_TRANSIENT);
+      step(db, statement);
+    }
+
+  sqlite3_finalize(statement);
+  statement = prepare
+    (db,
+     "INSERT INTO member_history (copyid, duedate, item_oid, memberid, "
+     "reserved_by, reserved_date, returned_date, type) "
+     "VALUES ('C', '2001-02-01', ?, ?, 'Librarian', '2001-01-01', "
+     "'2001-01-15', 'Book')");
+
+  for(int i = 0; i < HISTORY; i++)
+    {
+      sqlite3_bind_int64(statement, 1, std::rand() % BOOKS + 1);
+      std::snprintf(text, sizeof(text), "%d", std::rand() % MEMBERS + 1);
+      sqlite3_bind_text(statement, 2, text, -1, SQLITE_TRANSIENT);
+      step(db, statement);
+    }
+
+  sqlite3_finalize(statement);
+  statement = prepare
+    (db,
+     "INSERT INTO photograph_collection (id, location, myoid, title) "
+     "VALUES (?, 'Location', ?, 'Collection')");
+
+  for(int i = 1; i <= COLLECTIONS; i++)
+    {
+      std::snprintf(text, sizeof(text), "P%d", i);
+      sqlite3_bind_text(statement, 1, text, -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int64(statement, 2, i);
+      step(db, statement);
+    }
+
+  sqlite3_finalize(statement);
+  statement = prepare
+    (db,
+     "INSERT INTO photograph (collection_oid, copyright, creators, id, "
+     "medium, myoid, pdate, reproduction_number, title) "
+     "VALUES (?, 'Copyright', 'Creators', ?, 'Medium', ?, "
+     "'2001-01-01', 'Number', 'Photograph')");
+
+  for(int i = 0; i < COLLECTIONS * PHOTOGRAPHS_PER_COLLECTION; i++)
+    {
+      sqlite3_bind_int64(statement, 1, i % COLLECTIONS + 1);
+      std::snprintf(text, sizeof(text), "%d", i);
+      sqlite3_bind_text(statement, 2, text, -1, SQLITE_TRANSIENT);
+      sqlite3_bind_int64(statement, 3, i + 1);
+      step(db, statement);
+    }
+
+  sqlite3_finalize(statement);
+  execute(db, "COMMIT");
+}
+
+/*
+** -- run() --
+*/
+
+static void run(sqlite3 *db, double *seconds)
+{
+  char text[64];
+
+  for(int i = 0; benchmarks[i].m_name; i++)
+    {
+      double start = now();
+      sqlite3_stmt *statement = prepare(db, benchmarks[i].m_query);
+
+      std::srand(i);
+
+      for(int j = 0; j < benchmarks[i].m_iterations; j++)
+	{
+	  if(benchmarks[i].m_range == 0)
+	    {
+	      std::snprintf(text, sizeof(text), "20%02d-01-01", j % 30);
+	      sqlite3_bind_text(statement, 1, text, -1, SQLITE_TRANSIENT);
+	    }
+	  else if(benchmarks[i].m_text)
+	    {
+	      std::snprintf(text, sizeof(text), "%d",
+			    std::rand() % benchmarks[i].m_range + 1);
+	      sqlite3_bind_text(statement, 1, text, -1, SQLITE_TRANSIENT);
+	    }
+	  else
+	    sqlite3_bind_int64
+	      (statement, 1, std::rand() % benchmarks[i].m_range + 1);
+
+	  while(sqlite3_step(statement) == SQLITE_ROW)
+	    ;
+
+	  sqlite3_reset(statement);
+	}
+
+      sqlite3_finalize(statement);
+      seconds[i] = (now() - start) / benchmarks[i].m_iterations;
+    }
+}
+
+/*
+** -- main() --
+*/
+
+int main(int argc, char *argv[])
+{
+  const char *path = argc > 1 ? argv[1] : ":memory:";
+  double after[sizeof(benchmarks) / sizeof(benchmarks[0])];
+  double before[sizeof(benchmarks) / sizeof(benchmarks[0])];
+  double start = 0.0;
+  sqlite3 *db = 0;
+
+  std::remove(path);
+
+  if(sqlite3_open(path, &db) != SQLITE_OK)
+    {
+      std::fprintf(stderr, "%s\n", sqlite3_errmsg(db));
+      return EXIT_FAILURE;
+    }
+
+  std::srand(1);
+  execute(db, sqlite_create_schema_text);
+  populate(db);
+  execute(db, "ANALYZE");
+  run(db, before);
+  start = now();
+  execute(db, sqlite_create_indexes_text);
+  execute(db, "ANALYZE");
+  std::printf("Indexes created in %.2f s.\n\n", now() - start);
+  run(db, after);
+  std::printf("%-24s %14s %14s %10s\n",
+	      "Query", "Before (ms)", "After (ms)", "Speedup");
+
+  for(int i = 0; benchmarks[i].m_name; i++)
+    std::printf("%-24s %14.3f %14.3f %9.1fx\n",
+		benchmarks[i].m_name,
+		1000.0 * before[i],
+		1000.0 * after[i],
+		after[i] > 0.0 ? before[i] / after[i] : 0.0);
+
+  sqlite3_close(db);
+  return EXIT_SUCCESS;
+}
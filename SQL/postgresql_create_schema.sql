@@ -148,6 +148,14 @@ CREATE TABLE dvd_copy_info
 	PRIMARY KEY(item_oid, copyid)
 );
 
+CREATE TABLE file_chunks
+(
+	chunk		BYTEA NOT NULL,
+	chunk_number	INTEGER NOT NULL,
+	file_digest	TEXT NOT NULL,
+	PRIMARY KEY(file_digest, chunk_number)
+);
+
 CREATE TABLE grey_literature
 (
 	author		TEXT NOT NULL,
@@ -476,6 +484,36 @@ END;
 CREATE TRIGGER item_request_trigger AFTER INSERT ON item_borrower
 FOR EACH row EXECUTE PROCEDURE delete_request();
 
+CREATE TABLE item_reservation_counts
+(
+	item_oid	 BIGINT NOT NULL,
+	total_reserved	 INTEGER NOT NULL DEFAULT 0,
+	type		 VARCHAR(16) NOT NULL,
+	PRIMARY KEY(item_oid, type)
+);
+
+CREATE OR REPLACE FUNCTION increase_reservation_count() RETURNS trigger AS '
+BEGIN
+	INSERT INTO item_reservation_counts (item_oid, total_reserved, type)
+	VALUES (new.item_oid, 1, new.type)
+	ON CONFLICT (item_oid, type) DO UPDATE
+	SET total_reserved = item_reservation_counts.total_reserved + 1;
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER item_borrower_insert_trigger AFTER INSERT ON item_borrower
+FOR EACH row EXECUTE PROCEDURE increase_reservation_count();
+
+CREATE OR REPLACE FUNCTION decrease_reservation_count() RETURNS trigger AS '
+BEGIN
+	UPDATE item_reservation_counts SET total_reserved = total_reserved - 1
+	WHERE item_oid = old.item_oid AND type = old.type;
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER item_borrower_delete_trigger AFTER DELETE ON item_borrower
+FOR EACH row EXECUTE PROCEDURE decrease_reservation_count();
+
 CREATE TABLE book_binding_types
 (
 	binding_type	 TEXT NOT NULL PRIMARY KEY
@@ -545,6 +583,209 @@ SELECT	 copy_number,
 	 type
 FROM	 item_borrower;
 
+CREATE INDEX item_borrower_duedate_idx ON item_borrower(duedate);
+CREATE INDEX item_borrower_item_oid_type_idx ON item_borrower(item_oid, type);
+CREATE INDEX item_borrower_memberid_idx ON item_borrower(memberid);
+CREATE INDEX item_request_memberid_idx ON item_request(memberid);
+CREATE INDEX member_last_name_pattern_idx ON member(last_name varchar_pattern_ops);
+CREATE INDEX member_memberid_pattern_idx ON member(memberid varchar_pattern_ops);
+CREATE INDEX member_history_item_oid_type_idx ON member_history(item_oid, type);
+CREATE INDEX member_history_memberid_idx ON member_history(memberid);
+CREATE INDEX photograph_collection_myoid_idx ON photograph_collection(myoid);
+CREATE INDEX photograph_collection_oid_id_idx ON photograph(collection_oid, id);
+CREATE INDEX photograph_myoid_idx ON photograph(myoid);
+
+CREATE TABLE item_search
+(
+	document	 TSVECTOR NOT NULL,
+	item_oid	 BIGINT NOT NULL,
+	keyword		 TSVECTOR NOT NULL,
+	title		 TSVECTOR NOT NULL,
+	type		 VARCHAR(32) NOT NULL,
+	PRIMARY KEY(item_oid, type)
+);
+
+CREATE INDEX item_search_document_idx ON item_search USING GIN (document);
+CREATE INDEX item_search_keyword_idx ON item_search USING GIN (keyword);
+CREATE INDEX item_search_title_idx ON item_search USING GIN (title);
+
+CREATE OR REPLACE FUNCTION delete_item_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = old.myoid AND
+	type = old.type;
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+
+CREATE OR REPLACE FUNCTION update_book_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.author, new.keyword, new.description,
+	new.publisher)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER book_search_trigger AFTER INSERT OR
+UPDATE OF title, author, keyword, description, publisher ON book
+FOR EACH row EXECUTE PROCEDURE update_book_search();
+CREATE TRIGGER book_search_delete_trigger AFTER DELETE ON book
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_cd_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.artist, new.keyword, new.description,
+	new.recording_label, (SELECT string_agg(songtitle, '' '') FROM
+	cd_songs WHERE item_oid = new.myoid))),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER cd_search_trigger AFTER INSERT OR
+UPDATE OF title, artist, keyword, description, recording_label ON cd
+FOR EACH row EXECUTE PROCEDURE update_cd_search();
+CREATE TRIGGER cd_search_delete_trigger AFTER DELETE ON cd
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_dvd_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, COALESCE(new.dvdactor, '''') || '' '' ||
+	COALESCE(new.dvddirector, ''''), new.keyword, new.description,
+	new.studio)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER dvd_search_trigger AFTER INSERT OR
+UPDATE OF title, dvdactor, dvddirector, keyword, description, studio ON dvd
+FOR EACH row EXECUTE PROCEDURE update_dvd_search();
+CREATE TRIGGER dvd_search_delete_trigger AFTER DELETE ON dvd
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_journal_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.keyword, new.description, new.publisher)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER journal_search_trigger AFTER INSERT OR
+UPDATE OF title, keyword, description, publisher ON journal
+FOR EACH row EXECUTE PROCEDURE update_journal_search();
+CREATE TRIGGER journal_search_delete_trigger AFTER DELETE ON journal
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_magazine_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.keyword, new.description, new.publisher)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER magazine_search_trigger AFTER INSERT OR
+UPDATE OF title, keyword, description, publisher ON magazine
+FOR EACH row EXECUTE PROCEDURE update_magazine_search();
+CREATE TRIGGER magazine_search_delete_trigger AFTER DELETE ON magazine
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_photograph_collection_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.about)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.about, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER photograph_collection_search_trigger AFTER INSERT OR
+UPDATE OF title, about ON photograph_collection
+FOR EACH row EXECUTE PROCEDURE update_photograph_collection_search();
+CREATE TRIGGER photograph_collection_search_delete_trigger AFTER DELETE ON photograph_collection
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_videogame_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.developer, new.keyword, new.description,
+	new.publisher)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER videogame_search_trigger AFTER INSERT OR
+UPDATE OF title, developer, keyword, description, publisher ON videogame
+FOR EACH row EXECUTE PROCEDURE update_videogame_search();
+CREATE TRIGGER videogame_search_delete_trigger AFTER DELETE ON videogame
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_cd_songs_search() RETURNS trigger AS '
+DECLARE
+	item BIGINT;
+BEGIN
+	IF TG_OP = ''DELETE'' THEN
+		item := old.item_oid;
+	ELSE
+		item := new.item_oid;
+	END IF;
+	UPDATE item_search SET document =
+	to_tsvector(''simple'', concat_ws('' '', cd.title, cd.artist, cd.keyword,
+	cd.description, cd.recording_label,
+	(SELECT string_agg(songtitle, '' '') FROM cd_songs
+	WHERE item_oid = item)))
+	FROM cd WHERE cd.myoid = item AND item_search.item_oid = item AND
+	item_search.type = cd.type;
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER cd_songs_search_trigger AFTER INSERT OR UPDATE OR DELETE
+ON cd_songs
+FOR EACH row EXECUTE PROCEDURE update_cd_songs_search();
+
 CREATE ROLE biblioteq_administrator INHERIT SUPERUSER;
 CREATE ROLE biblioteq_circulation INHERIT;
 CREATE ROLE biblioteq_circulation_librarian INHERIT;
@@ -584,8 +825,11 @@ GRANT DELETE, INSERT, SELECT, UPDATE ON dvd_aspect_ratios TO biblioteq_administr
 GRANT DELETE, INSERT, SELECT, UPDATE ON dvd_copy_info TO biblioteq_administrator;
 GRANT DELETE, INSERT, SELECT, UPDATE ON dvd_ratings TO biblioteq_administrator;
 GRANT DELETE, INSERT, SELECT, UPDATE ON dvd_regions TO biblioteq_administrator;
+GRANT DELETE, INSERT, SELECT, UPDATE ON file_chunks TO biblioteq_administrator;
 GRANT DELETE, INSERT, SELECT, UPDATE ON grey_literature TO biblioteq_administrator;
 GRANT DELETE, INSERT, SELECT, UPDATE ON item_borrower TO biblioteq_administrator;
+GRANT DELETE, INSERT, SELECT, UPDATE ON item_reservation_counts TO biblioteq_administrator;
+GRANT DELETE, INSERT, SELECT, UPDATE ON item_search TO biblioteq_administrator;
 GRANT DELETE, INSERT, SELECT, UPDATE ON journal TO biblioteq_administrator;
 GRANT DELETE, INSERT, SELECT, UPDATE ON journal_copy_info TO biblioteq_administrator;
 GRANT DELETE, INSERT, SELECT, UPDATE ON journal_files TO biblioteq_administrator;
@@ -630,6 +874,8 @@ GRANT SELECT, UPDATE, USAGE ON videogame_myoid_seq TO biblioteq_administrator;
 GRANT SELECT, USAGE ON item_request_myoid_seq TO biblioteq_administrator;
 
 GRANT DELETE, INSERT, SELECT, UPDATE ON item_borrower TO biblioteq_circulation;
+GRANT DELETE, INSERT, SELECT, UPDATE ON item_reservation_counts TO biblioteq_circulation;
+GRANT SELECT ON item_search TO biblioteq_circulation;
 GRANT DELETE, INSERT, SELECT, UPDATE ON minimum_days TO biblioteq_circulation;
 GRANT DELETE, SELECT ON item_request TO biblioteq_circulation;
 GRANT INSERT, SELECT, UPDATE ON member_history TO biblioteq_circulation;
@@ -654,6 +900,7 @@ GRANT SELECT ON dvd_copy_info_myoid_seq TO biblioteq_circulation;
 GRANT SELECT ON dvd_myoid_seq TO biblioteq_circulation;
 GRANT SELECT ON dvd_ratings TO biblioteq_circulation;
 GRANT SELECT ON dvd_regions TO biblioteq_circulation;
+GRANT SELECT ON file_chunks TO biblioteq_circulation;
 GRANT SELECT ON grey_literature TO biblioteq_circulation;
 GRANT SELECT ON item_borrower_vw TO biblioteq_circulation;
 GRANT SELECT ON journal TO biblioteq_circulation;
@@ -706,8 +953,11 @@ GRANT SELECT ON dvd_copy_info_myoid_seq TO biblioteq_guest;
 GRANT SELECT ON dvd_myoid_seq TO biblioteq_guest;
 GRANT SELECT ON dvd_ratings TO biblioteq_guest;
 GRANT SELECT ON dvd_regions TO biblioteq_guest;
+GRANT SELECT ON file_chunks TO biblioteq_guest;
 GRANT SELECT ON grey_literature TO biblioteq_guest;
 GRANT SELECT (item_oid, type) ON item_borrower_vw TO biblioteq_guest;
+GRANT SELECT ON item_reservation_counts TO biblioteq_guest;
+GRANT SELECT ON item_search TO biblioteq_guest;
 GRANT SELECT ON journal TO biblioteq_guest;
 GRANT SELECT ON journal_copy_info TO biblioteq_guest;
 GRANT SELECT ON journal_copy_info_myoid_seq TO biblioteq_guest;
@@ -748,6 +998,7 @@ GRANT DELETE, INSERT, SELECT, UPDATE ON dvd_aspect_ratios TO biblioteq_librarian
 GRANT DELETE, INSERT, SELECT, UPDATE ON dvd_copy_info TO biblioteq_librarian;
 GRANT DELETE, INSERT, SELECT, UPDATE ON dvd_ratings TO biblioteq_librarian;
 GRANT DELETE, INSERT, SELECT, UPDATE ON dvd_regions TO biblioteq_librarian;
+GRANT DELETE, INSERT, SELECT, UPDATE ON file_chunks TO biblioteq_librarian;
 GRANT DELETE, INSERT, SELECT, UPDATE ON grey_literature TO biblioteq_librarian;
 GRANT DELETE, INSERT, SELECT, UPDATE ON journal TO biblioteq_librarian;
 GRANT DELETE, INSERT, SELECT, UPDATE ON journal_copy_info TO biblioteq_librarian;
@@ -768,6 +1019,8 @@ GRANT DELETE, INSERT, SELECT, UPDATE ON videogame_ratings TO biblioteq_librarian
 GRANT DELETE, SELECT ON member_history TO biblioteq_librarian;
 GRANT SELECT ON admin TO biblioteq_librarian;
 GRANT SELECT ON item_borrower_vw TO biblioteq_librarian;
+GRANT SELECT ON item_reservation_counts TO biblioteq_librarian;
+GRANT DELETE, INSERT, SELECT, UPDATE ON item_search TO biblioteq_librarian;
 GRANT SELECT ON item_request TO biblioteq_librarian;
 GRANT SELECT, UPDATE, USAGE ON book_myoid_seq TO biblioteq_librarian;
 GRANT SELECT, UPDATE, USAGE ON book_copy_info_myoid_seq TO biblioteq_librarian;
@@ -811,8 +1064,11 @@ GRANT SELECT ON dvd_copy_info_myoid_seq TO biblioteq_membership;
 GRANT SELECT ON dvd_myoid_seq TO biblioteq_membership;
 GRANT SELECT ON dvd_ratings TO biblioteq_membership;
 GRANT SELECT ON dvd_regions TO biblioteq_membership;
+GRANT SELECT ON file_chunks TO biblioteq_membership;
 GRANT SELECT ON grey_literature TO biblioteq_membership;
 GRANT SELECT ON item_borrower_vw TO biblioteq_membership;
+GRANT SELECT ON item_reservation_counts TO biblioteq_membership;
+GRANT SELECT ON item_search TO biblioteq_membership;
 GRANT SELECT ON journal TO biblioteq_membership;
 GRANT SELECT ON journal_copy_info TO biblioteq_membership;
 GRANT SELECT ON journal_copy_info_myoid_seq TO biblioteq_membership;
@@ -864,8 +1120,11 @@ GRANT SELECT ON dvd_copy_info_myoid_seq TO biblioteq_patron;
 GRANT SELECT ON dvd_myoid_seq TO biblioteq_patron;
 GRANT SELECT ON dvd_ratings TO biblioteq_patron;
 GRANT SELECT ON dvd_regions TO biblioteq_patron;
+GRANT SELECT ON file_chunks TO biblioteq_patron;
 GRANT SELECT ON grey_literature TO biblioteq_patron;
 GRANT SELECT ON item_borrower_vw TO biblioteq_patron;
+GRANT SELECT ON item_reservation_counts TO biblioteq_patron;
+GRANT SELECT ON item_search TO biblioteq_patron;
 GRANT SELECT ON journal TO biblioteq_patron;
 GRANT SELECT ON journal_copy_info TO biblioteq_patron;
 GRANT SELECT ON journal_copy_info_myoid_seq TO biblioteq_patron;
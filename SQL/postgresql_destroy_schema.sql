@@ -1,11 +1,22 @@
 DROP DATABASE IF EXISTS xbook_db;
+DROP FUNCTION IF EXISTS decrease_reservation_count();
 DROP FUNCTION IF EXISTS delete_book_history();
 DROP FUNCTION IF EXISTS delete_cd_history();
 DROP FUNCTION IF EXISTS delete_dvd_history();
+DROP FUNCTION IF EXISTS delete_item_search();
 DROP FUNCTION IF EXISTS delete_journal_history();
 DROP FUNCTION IF EXISTS delete_magazine_history();
 DROP FUNCTION IF EXISTS delete_request();
 DROP FUNCTION IF EXISTS delete_videogame_history();
+DROP FUNCTION IF EXISTS increase_reservation_count();
+DROP FUNCTION IF EXISTS update_book_search();
+DROP FUNCTION IF EXISTS update_cd_search();
+DROP FUNCTION IF EXISTS update_cd_songs_search();
+DROP FUNCTION IF EXISTS update_dvd_search();
+DROP FUNCTION IF EXISTS update_journal_search();
+DROP FUNCTION IF EXISTS update_magazine_search();
+DROP FUNCTION IF EXISTS update_photograph_collection_search();
+DROP FUNCTION IF EXISTS update_videogame_search();
 DROP TABLE IF EXISTS admin;
 DROP TABLE IF EXISTS book CASCADE;
 DROP TABLE IF EXISTS book_binding_types;
@@ -23,6 +34,8 @@ DROP TABLE IF EXISTS dvd_regions;
 DROP TABLE IF EXISTS grey_literature;
 DROP TABLE IF EXISTS item_borrower CASCADE;
 DROP TABLE IF EXISTS item_request;
+DROP TABLE IF EXISTS item_reservation_counts;
+DROP TABLE IF EXISTS item_search;
 DROP TABLE IF EXISTS journal CASCADE;
 DROP TABLE IF EXISTS journal_copy_info;
 DROP TABLE IF EXISTS journal_files;
@@ -1177,3 +1177,446 @@ GRANT SELECT ON magazine_files_myoid_seq TO biblioteq_patron;
 
 REVOKE ALL ON item_borrower_vw FROM biblioteq_guest;
 GRANT SELECT (item_oid, type) ON item_borrower_vw TO biblioteq_guest;
+
+CREATE TABLE item_reservation_counts
+(
+	item_oid	 BIGINT NOT NULL,
+	total_reserved	 INTEGER NOT NULL DEFAULT 0,
+	type		 VARCHAR(16) NOT NULL,
+	PRIMARY KEY(item_oid, type)
+);
+
+CREATE OR REPLACE FUNCTION increase_reservation_count() RETURNS trigger AS '
+BEGIN
+	INSERT INTO item_reservation_counts (item_oid, total_reserved, type)
+	VALUES (new.item_oid, 1, new.type)
+	ON CONFLICT (item_oid, type) DO UPDATE
+	SET total_reserved = item_reservation_counts.total_reserved + 1;
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER item_borrower_insert_trigger AFTER INSERT ON item_borrower
+FOR EACH row EXECUTE PROCEDURE increase_reservation_count();
+
+CREATE OR REPLACE FUNCTION decrease_reservation_count() RETURNS trigger AS '
+BEGIN
+	UPDATE item_reservation_counts SET total_reserved = total_reserved - 1
+	WHERE item_oid = old.item_oid AND type = old.type;
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER item_borrower_delete_trigger AFTER DELETE ON item_borrower
+FOR EACH row EXECUTE PROCEDURE decrease_reservation_count();
+
+INSERT INTO item_reservation_counts (item_oid, total_reserved, type)
+SELECT item_oid, COUNT(*), type FROM item_borrower GROUP BY item_oid, type;
+
+GRANT DELETE, INSERT, SELECT, UPDATE ON item_reservation_counts TO biblioteq_administrator;
+GRANT DELETE, INSERT, SELECT, UPDATE ON item_reservation_counts TO biblioteq_circulation;
+GRANT SELECT ON item_reservation_counts TO biblioteq_guest;
+GRANT SELECT ON item_reservation_counts TO biblioteq_librarian;
+GRANT SELECT ON item_reservation_counts TO biblioteq_membership;
+GRANT SELECT ON item_reservation_counts TO biblioteq_patron;
+
+CREATE INDEX item_borrower_item_oid_type_idx ON item_borrower(item_oid, type);
+CREATE INDEX item_borrower_memberid_idx ON item_borrower(memberid);
+CREATE INDEX item_request_memberid_idx ON item_request(memberid);
+CREATE INDEX member_history_item_oid_type_idx ON member_history(item_oid, type);
+CREATE INDEX member_history_memberid_idx ON member_history(memberid);
+CREATE INDEX photograph_collection_oid_id_idx ON photograph(collection_oid, id);
+
+CREATE TABLE item_search
+(
+	document	 TSVECTOR NOT NULL,
+	item_oid	 BIGINT NOT NULL,
+	keyword		 TSVECTOR NOT NULL,
+	title		 TSVECTOR NOT NULL,
+	type		 VARCHAR(32) NOT NULL,
+	PRIMARY KEY(item_oid, type)
+);
+
+CREATE INDEX item_search_document_idx ON item_search USING GIN (document);
+CREATE INDEX item_search_keyword_idx ON item_search USING GIN (keyword);
+CREATE INDEX item_search_title_idx ON item_search USING GIN (title);
+
+CREATE OR REPLACE FUNCTION delete_item_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = old.myoid AND
+	type = old.type;
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+
+CREATE OR REPLACE FUNCTION update_book_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.author, new.keyword, new.description,
+	new.publisher)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER book_search_trigger AFTER INSERT OR
+UPDATE OF title, author, keyword, description, publisher ON book
+FOR EACH row EXECUTE PROCEDURE update_book_search();
+CREATE TRIGGER book_search_delete_trigger AFTER DELETE ON book
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_cd_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.artist, new.keyword, new.description,
+	new.recording_label, (SELECT string_agg(songtitle, '' '') FROM
+	cd_songs WHERE item_oid = new.myoid))),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER cd_search_trigger AFTER INSERT OR
+UPDATE OF title, artist, keyword, description, recording_label ON cd
+FOR EACH row EXECUTE PROCEDURE update_cd_search();
+CREATE TRIGGER cd_search_delete_trigger AFTER DELETE ON cd
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_dvd_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, COALESCE(new.dvdactor, '''') || '' '' ||
+	COALESCE(new.dvddirector, ''''), new.keyword, new.description,
+	new.studio)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER dvd_search_trigger AFTER INSERT OR
+UPDATE OF title, dvdactor, dvddirector, keyword, description, studio ON dvd
+FOR EACH row EXECUTE PROCEDURE update_dvd_search();
+CREATE TRIGGER dvd_search_delete_trigger AFTER DELETE ON dvd
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_journal_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.keyword, new.description, new.publisher)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER journal_search_trigger AFTER INSERT OR
+UPDATE OF title, keyword, description, publisher ON journal
+FOR EACH row EXECUTE PROCEDURE update_journal_search();
+CREATE TRIGGER journal_search_delete_trigger AFTER DELETE ON journal
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_magazine_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.keyword, new.description, new.publisher)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER magazine_search_trigger AFTER INSERT OR
+UPDATE OF title, keyword, description, publisher ON magazine
+FOR EACH row EXECUTE PROCEDURE update_magazine_search();
+CREATE TRIGGER magazine_search_delete_trigger AFTER DELETE ON magazine
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_photograph_collection_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.about)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.about, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER photograph_collection_search_trigger AFTER INSERT OR
+UPDATE OF title, about ON photograph_collection
+FOR EACH row EXECUTE PROCEDURE update_photograph_collection_search();
+CREATE TRIGGER photograph_collection_search_delete_trigger AFTER DELETE ON photograph_collection
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_videogame_search() RETURNS trigger AS '
+BEGIN
+	DELETE FROM item_search WHERE item_oid = new.myoid AND
+	type = new.type;
+	INSERT INTO item_search (document, item_oid, keyword, title, type)
+	VALUES (to_tsvector(''simple'', concat_ws('' '',
+	new.title, new.developer, new.keyword, new.description,
+	new.publisher)),
+	new.myoid,
+	to_tsvector(''simple'', COALESCE(new.keyword, '''')),
+	to_tsvector(''simple'', new.title),
+	new.type);
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER videogame_search_trigger AFTER INSERT OR
+UPDATE OF title, developer, keyword, description, publisher ON videogame
+FOR EACH row EXECUTE PROCEDURE update_videogame_search();
+CREATE TRIGGER videogame_search_delete_trigger AFTER DELETE ON videogame
+FOR EACH row EXECUTE PROCEDURE delete_item_search();
+
+CREATE OR REPLACE FUNCTION update_cd_songs_search() RETURNS trigger AS '
+DECLARE
+	item BIGINT;
+BEGIN
+	IF TG_OP = ''DELETE'' THEN
+		item := old.item_oid;
+	ELSE
+		item := new.item_oid;
+	END IF;
+	UPDATE item_search SET document =
+	to_tsvector(''simple'', concat_ws('' '', cd.title, cd.artist, cd.keyword,
+	cd.description, cd.recording_label,
+	(SELECT string_agg(songtitle, '' '') FROM cd_songs
+	WHERE item_oid = item)))
+	FROM cd WHERE cd.myoid = item AND item_search.item_oid = item AND
+	item_search.type = cd.type;
+	RETURN NULL;
+END;
+' LANGUAGE plpgsql;
+CREATE TRIGGER cd_songs_search_trigger AFTER INSERT OR UPDATE OR DELETE
+ON cd_songs
+FOR EACH row EXECUTE PROCEDURE update_cd_songs_search();
+
+INSERT INTO item_search (document, item_oid, keyword, title, type)
+SELECT to_tsvector('simple', concat_ws(' ',
+book.title, book.author, book.keyword, book.description,
+book.publisher)),
+myoid,
+to_tsvector('simple', COALESCE(book.keyword, '')),
+to_tsvector('simple', title),
+type
+FROM book;
+
+INSERT INTO item_search (document, item_oid, keyword, title, type)
+SELECT to_tsvector('simple', concat_ws(' ',
+cd.title, cd.artist, cd.keyword, cd.description,
+cd.recording_label, (SELECT string_agg(songtitle, ' ') FROM
+cd_songs WHERE item_oid = cd.myoid))),
+myoid,
+to_tsvector('simple', COALESCE(cd.keyword, '')),
+to_tsvector('simple', title),
+type
+FROM cd;
+
+INSERT INTO item_search (document, item_oid, keyword, title, type)
+SELECT to_tsvector('simple', concat_ws(' ',
+dvd.title, COALESCE(dvd.dvdactor, '') || ' ' ||
+COALESCE(dvd.dvddirector, ''), dvd.keyword, dvd.description,
+dvd.studio)),
+myoid,
+to_tsvector('simple', COALESCE(dvd.keyword, '')),
+to_tsvector('simple', title),
+type
+FROM dvd;
+
+INSERT INTO item_search (document, item_oid, keyword, title, type)
+SELECT to_tsvector('simple', concat_ws(' ',
+journal.title, journal.keyword, journal.description,
+journal.publisher)),
+myoid,
+to_tsvector('simple', COALESCE(journal.keyword, '')),
+to_tsvector('simple', title),
+type
+FROM journal;
+
+INSERT INTO item_search (document, item_oid, keyword, title, type)
+SELECT to_tsvector('simple', concat_ws(' ',
+magazine.title, magazine.keyword, magazine.description,
+magazine.publisher)),
+myoid,
+to_tsvector('simple', COALESCE(magazine.keyword, '')),
+to_tsvector('simple', title),
+type
+FROM magazine;
+
+INSERT INTO item_search (document, item_oid, keyword, title, type)
+SELECT to_tsvector('simple', concat_ws(' ',
+photograph_collection.title, photograph_collection.about)),
+myoid,
+to_tsvector('simple', COALESCE(photograph_collection.about, '')),
+to_tsvector('simple', title),
+type
+FROM photograph_collection;
+
+INSERT INTO item_search (document, item_oid, keyword, title, type)
+SELECT to_tsvector('simple', concat_ws(' ',
+videogame.title, videogame.developer, videogame.keyword,
+videogame.description, videogame.publisher)),
+myoid,
+to_tsvector('simple', COALESCE(videogame.keyword, '')),
+to_tsvector('simple', title),
+type
+FROM videogame;
+
+GRANT DELETE, INSERT, SELECT, UPDATE ON item_search TO biblioteq_administrator;
+GRANT SELECT ON item_search TO biblioteq_circulation;
+GRANT SELECT ON item_search TO biblioteq_guest;
+GRANT DELETE, INSERT, SELECT, UPDATE ON item_search TO biblioteq_librarian;
+GRANT SELECT ON item_search TO biblioteq_membership;
+GRANT SELECT ON item_search TO biblioteq_patron;
+
+/* Images were once stored as base64 text. */
+/* Each column is converted in batches of 50 rows, keyed by myoid. */
+
+CREATE OR REPLACE FUNCTION convert_image_to_binary(tablename TEXT, columnname TEXT) RETURNS VOID AS '
+DECLARE
+	first_oid BIGINT;
+	last_oid BIGINT;
+BEGIN
+	first_oid := 0;
+	LOOP
+		EXECUTE ''SELECT MAX(myoid) FROM (SELECT myoid FROM '' ||
+		quote_ident(tablename) ||
+		'' WHERE myoid > $1 ORDER BY myoid LIMIT 50) AS batch''
+		INTO last_oid USING first_oid;
+		EXIT WHEN last_oid IS NULL;
+		EXECUTE ''UPDATE '' || quote_ident(tablename) ||
+		'' SET '' || quote_ident(columnname) ||
+		'' = decode(encode('' || quote_ident(columnname) ||
+		'', ''''escape''''), ''''base64'''') '' ||
+		''WHERE myoid > $1 AND myoid <= $2 AND encode('' ||
+		quote_ident(columnname) ||
+		'', ''''escape'''') ~ ''''^[A-Za-z0-9+/=]+$''''''
+		USING first_oid, last_oid;
+		first_oid := last_oid;
+	END LOOP;
+END;
+' LANGUAGE plpgsql;
+
+SELECT convert_image_to_binary('book', 'back_cover');
+SELECT convert_image_to_binary('book', 'front_cover');
+SELECT convert_image_to_binary('cd', 'back_cover');
+SELECT convert_image_to_binary('cd', 'front_cover');
+SELECT convert_image_to_binary('dvd', 'back_cover');
+SELECT convert_image_to_binary('dvd', 'front_cover');
+SELECT convert_image_to_binary('journal', 'back_cover');
+SELECT convert_image_to_binary('journal', 'front_cover');
+SELECT convert_image_to_binary('magazine', 'back_cover');
+SELECT convert_image_to_binary('magazine', 'front_cover');
+SELECT convert_image_to_binary('photograph', 'image');
+SELECT convert_image_to_binary('photograph', 'image_scaled');
+SELECT convert_image_to_binary('photograph_collection', 'image');
+SELECT convert_image_to_binary('photograph_collection', 'image_scaled');
+SELECT convert_image_to_binary('videogame', 'back_cover');
+SELECT convert_image_to_binary('videogame', 'front_cover');
+DROP FUNCTION convert_image_to_binary(TEXT, TEXT);
+
+/* Attachments are stored once, as compressed chunks. */
+
+CREATE TABLE file_chunks
+(
+	chunk		BYTEA NOT NULL,
+	chunk_number	INTEGER NOT NULL,
+	file_digest	TEXT NOT NULL,
+	PRIMARY KEY(file_digest, chunk_number)
+);
+
+GRANT DELETE, INSERT, SELECT, UPDATE ON file_chunks TO biblioteq_administrator;
+GRANT SELECT ON file_chunks TO biblioteq_circulation;
+GRANT SELECT ON file_chunks TO biblioteq_guest;
+GRANT DELETE, INSERT, SELECT, UPDATE ON file_chunks TO biblioteq_librarian;
+GRANT SELECT ON file_chunks TO biblioteq_membership;
+GRANT SELECT ON file_chunks TO biblioteq_patron;
+
+/* The members browser filters members by prefix. */
+
+CREATE INDEX member_last_name_pattern_idx ON member(last_name varchar_pattern_ops);
+CREATE INDEX member_memberid_pattern_idx ON member(memberid varchar_pattern_ops);
+
+/* Circulation dates are stored as yyyy-MM-dd. */
+
+UPDATE item_borrower SET duedate = SUBSTR(duedate, 7, 4) || '-' || SUBSTR(duedate, 1, 2) || '-' || SUBSTR(duedate, 4, 2)
+WHERE duedate LIKE '__/__/____';
+
+UPDATE item_borrower SET reserved_date = SUBSTR(reserved_date, 7, 4) || '-' || SUBSTR(reserved_date, 1, 2) || '-' || SUBSTR(reserved_date, 4, 2)
+WHERE reserved_date LIKE '__/__/____';
+
+UPDATE member_history SET duedate = SUBSTR(duedate, 7, 4) || '-' || SUBSTR(duedate, 1, 2) || '-' || SUBSTR(duedate, 4, 2)
+WHERE duedate LIKE '__/__/____';
+
+UPDATE member_history SET reserved_date = SUBSTR(reserved_date, 7, 4) || '-' || SUBSTR(reserved_date, 1, 2) || '-' || SUBSTR(reserved_date, 4, 2)
+WHERE reserved_date LIKE '__/__/____';
+
+UPDATE member_history SET returned_date = SUBSTR(returned_date, 7, 4) || '-' || SUBSTR(returned_date, 1, 2) || '-' || SUBSTR(returned_date, 4, 2)
+WHERE returned_date LIKE '__/__/____';
+
+CREATE INDEX item_borrower_duedate_idx ON item_borrower(duedate);
+
+/* Photographs and their collections are retrieved by myoid. */
+
+CREATE INDEX photograph_collection_myoid_idx ON photograph_collection(myoid);
+CREATE INDEX photograph_myoid_idx ON photograph(myoid);
+
+/* Member, publication and request dates are stored as yyyy-MM-dd. */
+
+UPDATE book SET pdate = SUBSTR(pdate, 7, 4) || '-' || SUBSTR(pdate, 1, 2) || '-' || SUBSTR(pdate, 4, 2)
+WHERE pdate LIKE '__/__/____';
+
+UPDATE cd SET rdate = SUBSTR(rdate, 7, 4) || '-' || SUBSTR(rdate, 1, 2) || '-' || SUBSTR(rdate, 4, 2)
+WHERE rdate LIKE '__/__/____';
+
+UPDATE dvd SET rdate = SUBSTR(rdate, 7, 4) || '-' || SUBSTR(rdate, 1, 2) || '-' || SUBSTR(rdate, 4, 2)
+WHERE rdate LIKE '__/__/____';
+
+UPDATE item_request SET requestdate = SUBSTR(requestdate, 7, 4) || '-' || SUBSTR(requestdate, 1, 2) || '-' || SUBSTR(requestdate, 4, 2)
+WHERE requestdate LIKE '__/__/____';
+
+UPDATE journal SET pdate = SUBSTR(pdate, 7, 4) || '-' || SUBSTR(pdate, 1, 2) || '-' || SUBSTR(pdate, 4, 2)
+WHERE pdate LIKE '__/__/____';
+
+UPDATE magazine SET pdate = SUBSTR(pdate, 7, 4) || '-' || SUBSTR(pdate, 1, 2) || '-' || SUBSTR(pdate, 4, 2)
+WHERE pdate LIKE '__/__/____';
+
+UPDATE member SET dob = SUBSTR(dob, 7, 4) || '-' || SUBSTR(dob, 1, 2) || '-' || SUBSTR(dob, 4, 2)
+WHERE dob LIKE '__/__/____';
+
+UPDATE member SET expiration_date = SUBSTR(expiration_date, 7, 4) || '-' || SUBSTR(expiration_date, 1, 2) || '-' || SUBSTR(expiration_date, 4, 2)
+WHERE expiration_date LIKE '__/__/____';
+
+UPDATE member SET membersince = SUBSTR(membersince, 7, 4) || '-' || SUBSTR(membersince, 1, 2) || '-' || SUBSTR(membersince, 4, 2)
+WHERE membersince LIKE '__/__/____';
+
+UPDATE photograph SET pdate = SUBSTR(pdate, 7, 4) || '-' || SUBSTR(pdate, 1, 2) || '-' || SUBSTR(pdate, 4, 2)
+WHERE pdate LIKE '__/__/____';
+
+UPDATE videogame SET rdate = SUBSTR(rdate, 7, 4) || '-' || SUBSTR(rdate, 1, 2) || '-' || SUBSTR(rdate, 4, 2)
+WHERE rdate LIKE '__/__/____';
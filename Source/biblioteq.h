@@ -19,6 +19,7 @@
 #include <QMessageBox>
 #include <QSqlDatabase>
 #include <QStringList>
+#include <QTimer>
 #include <QtDebug>
 
 /*
@@ -36,6 +37,9 @@
 #include "biblioteq_myqstring.h"
 #include "biblioteq_numeric_table_item.h"
 #include "biblioteq_photographcollection.h"
+#include "biblioteq_query_thread.h"
+#include "biblioteq_sru_client.h"
+#include "biblioteq_thumbnail_loader.h"
 #include "biblioteq_videogame.h"
 #include "ui_biblioteq_adminsetup.h"
 #include "ui_biblioteq_allinfo.h"
@@ -193,6 +197,7 @@ class biblioteq: public QMainWindow
   static QTranslator *s_qtTranslator;
   static const int CUSTOM_QUERY = 0;
   static const int EDITABLE = 0;
+  static const int MEMBERS_PAGE_SIZE = 500;
   static const int NEW_PAGE = 0;
   static const int NEXT_PAGE = 1;
   static const int POPULATE_ALL = 1;
@@ -217,6 +222,7 @@ class biblioteq: public QMainWindow
   QVector<QString> getBBColumnIndexes(void) const;
   Ui_mainWindow getUI(void) const;
   Ui_membersBrowser getBB(void) const;
+  biblioteq_sru_client *getSRUClient(void) const;
   bool isGuest(void) const;
   int populateTable(const int search_type_arg,
 		    const QString &typefilter,
@@ -278,6 +284,7 @@ class biblioteq: public QMainWindow
   QDialog *m_pass_diag;
   QHash<QString, QString> m_amazonImages;
   QHash<QString, QString> m_selectedBranch;
+  QList<QVariantList> m_keysetPages;
   QLabel *m_connected_bar_label;
   QLabel *m_status_bar_label;
   QMainWindow *m_admin_diag;
@@ -291,11 +298,16 @@ class biblioteq: public QMainWindow
   QMap<QString, QHash<QString, QString> > m_z3950Maps;
   QSqlDatabase m_db;
   QString m_engUserinfoTitle;
+  QString m_keysetQuery;
   QString m_lastCategory;
+  QString m_lastQueryStr;
   QString m_lastSearchStr;
+  QString m_membersBrowserKey;
   QString m_previousTypeFilter;
   QString m_roles;
   QStringList m_deletedAdmins;
+  QTimer m_coverTimer;
+  QTimer m_z3950Timer;
   QToolButton *m_error_bar_label;
   QVector<QString> m_abColumnHeaderIndexes;
   QVector<QString> m_bbColumnHeaderIndexes;
@@ -310,12 +322,24 @@ class biblioteq: public QMainWindow
   Ui_membersBrowser bb;
   Ui_passSelect pass;
   biblioteq_dbenumerations *db_enumerations;
+  biblioteq_query_thread::connection m_connection;
+  biblioteq_sru_client *m_sruClient;
+  biblioteq_thumbnail_loader *m_thumbnailLoader;
   int m_lastSearchType;
   qint64 m_pages;
   qint64 m_queryOffset;
   quint64 m_idCt;
   userinfo_diag_class *userinfo_diag;
+  bool m_membersBrowserExhausted;
   bool emptyContainers(void);
+  bool eventFilter(QObject *object, QEvent *event);
+  bool prepareKeysetQuery(QString &querystr,
+			  QVariantList &values,
+			  const QString &roles,
+			  const QString &limitStr,
+			  const int limit,
+			  qint64 &page,
+			  const bool reset);
   void addConfigOptions(const QString &typefilter);
   void adminSetup(void);
   void changeEvent(QEvent *event);
@@ -324,14 +348,21 @@ class biblioteq: public QMainWindow
   void createSqliteMenuActions(void);
   void deleteItem(const QString &oid, const QString &itemType);
   void initialUpdate(void);
+  void populateMembersBrowser(void);
   void prepareFilter(void);
   void preparePhotographsPerPageMenu(void);
   void prepareRequestToolButton(const QString &typefilter);
+  void printReport(QWidget *parent,
+		   QPrinter *printer,
+		   const QString &title,
+		   const QStringList &headers,
+		   const QList<QStringList> &rows);
   void readConfig(void);
   void readGlobalSetup(void);
   void resetAdminBrowser(void);
   void resetAllSearchWidgets(void);
   void resetMembersBrowser(void);
+  void upgradeSqliteIndexes(void);
 
  private slots:
   void slotAbout(void);
@@ -362,6 +393,7 @@ class biblioteq: public QMainWindow
   void slotExit(void);
   void slotExportAsCSV(void);
   void slotGrantPrivileges(void);
+  void slotImportMARC(void);
   void slotInsertBook(void);
   void slotInsertCD(void);
   void slotInsertDVD(void);
@@ -373,7 +405,9 @@ class biblioteq: public QMainWindow
   void slotLanguageChanged(void);
   void slotListOverdueItems(void);
   void slotListReservedItems(void);
+  void slotLoadVisibleCovers(void);
   void slotMagSearch(void);
+  void slotMembersBrowserScrolled(int value);
   void slotModify(void);
   void slotModifyBorrower(void);
   void slotNextPage(void);
@@ -382,6 +416,7 @@ class biblioteq: public QMainWindow
   void slotPhotographSearch(void);
   void slotPopulateMembersBrowser(void);
   void slotPreviousPage(void);
+  void slotPruneZ3950Connections(void);
   void slotPrintReservationHistory(void);
   void slotPrintReserved(void);
   void slotPrintView(void);
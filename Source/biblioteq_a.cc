@@ -31,7 +31,9 @@
 
 #include <QClipboard>
 #include <QDesktopWidget>
+#include <QEventLoop>
 #include <QFontDialog>
+#include <QInputDialog>
 #include <QLibraryInfo>
 #ifdef Q_OS_MAC
 #if QT_VERSION < 0x050000
@@ -75,7 +77,11 @@ extern "C"
 #include "biblioteq.h"
 #include "biblioteq_architecture.h"
 #include "biblioteq_bgraphicsscene.h"
+#include "biblioteq_csv_export_thread.h"
+#include "biblioteq_marc_import.h"
+#include "biblioteq_report_thread.h"
 #include "biblioteq_sqlite_create_schema.h"
+#include "biblioteq_z3950_pool.h"
 
 /*
 ** -- Global Variables --
@@ -206,6 +212,8 @@ void biblioteq::cleanup(void)
 {
   if(m_db.isOpen())
     m_db.close();
+
+  biblioteq_z3950_pool::clear();
 }
 
 /*
@@ -272,7 +280,9 @@ biblioteq::biblioteq(void):QMainWindow()
   m_error_bar_label = 0;
   m_status_bar_label = 0;
   m_lastSearchType = POPULATE_ALL;
+  m_connection.m_port = -1;
   m_idCt = 0;
+  m_membersBrowserExhausted = true;
   m_previousTypeFilter = "";
 
   if((m_branch_diag = new(std::nothrow) QDialog(this)) == 0)
@@ -306,6 +316,13 @@ biblioteq::biblioteq(void):QMainWindow()
   if((db_enumerations = new(std::nothrow) biblioteq_dbenumerations(this)) == 0)
     biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
 
+  if((m_sruClient = new(std::nothrow) biblioteq_sru_client(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  if((m_thumbnailLoader = new(std::nothrow)
+      biblioteq_thumbnail_loader(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
   if((m_configToolMenu = new(std::nothrow) QMenu(this)) == 0)
     biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
 
@@ -398,6 +415,35 @@ biblioteq::biblioteq(void):QMainWindow()
 	  this,
 	  SLOT(slotSceneSelectionChanged(void)));
   ui.graphicsView->setScene(scene);
+  m_coverTimer.setInterval(100);
+  m_coverTimer.setSingleShot(true);
+  connect(&m_coverTimer,
+	  SIGNAL(timeout(void)),
+	  this,
+	  SLOT(slotLoadVisibleCovers(void)));
+  connect(ui.graphicsView->horizontalScrollBar(),
+	  SIGNAL(valueChanged(int)),
+	  &m_coverTimer,
+	  SLOT(start(void)));
+  connect(ui.graphicsView->verticalScrollBar(),
+	  SIGNAL(valueChanged(int)),
+	  &m_coverTimer,
+	  SLOT(start(void)));
+  connect(ui.stackedWidget,
+	  SIGNAL(currentChanged(int)),
+	  &m_coverTimer,
+	  SLOT(start(void)));
+  ui.graphicsView->viewport()->installEventFilter(this);
+
+  /*
+  ** Idle Z39.50 sessions are also discarded between queries.
+  */
+
+  connect(&m_z3950Timer,
+	  SIGNAL(timeout(void)),
+	  this,
+	  SLOT(slotPruneZ3950Connections(void)));
+  m_z3950Timer.start(1000 * biblioteq_z3950_pool::IDLE_TIMEOUT / 3);
   ui.graphicsView->setDragMode(QGraphicsView::RubberBandDrag);
   ui.graphicsView->setRubberBandSelectionMode(Qt::IntersectsItemShape);
   bb.setupUi(m_members_diag);
@@ -447,6 +493,8 @@ biblioteq::biblioteq(void):QMainWindow()
 	  SLOT(slotCopyError(void)));
   connect(bb.table->horizontalHeader(), SIGNAL(sectionClicked(int)),
 	  this, SLOT(slotResizeColumnsAfterSort(void)));
+  connect(bb.table->verticalScrollBar(), SIGNAL(valueChanged(int)),
+	  this, SLOT(slotMembersBrowserScrolled(int)));
   connect(history.table->horizontalHeader(), SIGNAL(sectionClicked(int)),
 	  this, SLOT(slotResizeColumnsAfterSort(void)));
   connect(ui.table, SIGNAL(itemSelectionChanged(void)), this,
@@ -627,6 +675,10 @@ biblioteq::biblioteq(void):QMainWindow()
 	  SIGNAL(triggered(void)),
 	  this,
 	  SLOT(slotExportAsCSV(void)));
+  connect(ui.actionImport_MARC_Records,
+	  SIGNAL(triggered(void)),
+	  this,
+	  SLOT(slotImportMARC(void)));
 #if QT_VERSION >= 0x050000
   ab.table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
   bb.table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
@@ -647,6 +699,7 @@ biblioteq::biblioteq(void):QMainWindow()
   ui.printTool->setEnabled(false);
   ui.deleteTool->setEnabled(false);
   ui.menu_Add_Item->setEnabled(false);
+  ui.actionImport_MARC_Records->setEnabled(false);
   ui.actionDeleteEntry->setEnabled(false);
   ui.actionDuplicateEntry->setEnabled(false);
   ui.createTool->setEnabled(false);
@@ -975,6 +1028,7 @@ void biblioteq::adminSetup(void)
   if(m_roles.contains("administrator") || m_roles.contains("librarian"))
     {
       ui.menu_Add_Item->setEnabled(true);
+      ui.actionImport_MARC_Records->setEnabled(true);
       ui.actionDeleteEntry->setEnabled(true);
       ui.actionDuplicateEntry->setEnabled(true);
       ui.createTool->setEnabled(true);
@@ -1858,7 +1912,7 @@ void biblioteq::slotDelete(void)
     {
       i = index.row();
 
-      if(ui.table->item(i, col) == 0)
+      if(ui.table->text(i, col).isEmpty())
 	continue;
 
       oid = biblioteq_misc_functions::getColumnString
@@ -1969,10 +2023,10 @@ void biblioteq::slotDelete(void)
       QApplication::processEvents();
 #endif
 
-      if(ui.table->item(i, col) == 0)
+      if(ui.table->text(i, col).isEmpty())
 	continue;
 
-      str = ui.table->item(i, col)->text();
+      str = ui.table->text(i, col);
       itemType = biblioteq_misc_functions::getColumnString
 	(ui.table, i, ui.table->columnNumber("Type")).
 	toLower();
@@ -2087,9 +2141,7 @@ void biblioteq::slotResizeColumnsAfterSort(void)
 
 void biblioteq::slotUpdateIndicesAfterSort(int column)
 {
-  int i = 0;
-  QString oid = "";
-  QString itemType = "";
+  QHash<QString, biblioteq_item *> items;
   Qt::SortOrder order;
 
   QApplication::setOverrideCursor(Qt::WaitCursor);
@@ -2100,17 +2152,52 @@ void biblioteq::slotUpdateIndicesAfterSort(int column)
   else
     order = Qt::AscendingOrder;
 
-  ui.table->horizontalHeader()->setSortIndicator(column, order);
-  ui.table->sortByColumn(column, order);
+  ui.table->sortStore(column, order);
 
-  for(i = 0; i < ui.table->rowCount(); i++)
+  /*
+  ** Only the rows of open item windows need to be located.
+  */
+
+  foreach(QWidget *w, QApplication::topLevelWidgets())
     {
-      oid = biblioteq_misc_functions::getColumnString
-	(ui.table, i, ui.table->columnNumber("MYOID"));
-      itemType = biblioteq_misc_functions::getColumnString
-	(ui.table, i, ui.table->columnNumber("Type"));
-      itemType = itemType.toLower().remove(" ");
-      updateRows(oid, i, itemType);
+      biblioteq_book *book = qobject_cast<biblioteq_book *> (w);
+      biblioteq_cd *cd = qobject_cast<biblioteq_cd *> (w);
+      biblioteq_dvd *dvd = qobject_cast<biblioteq_dvd *> (w);
+      biblioteq_journal *journal = qobject_cast<biblioteq_journal *> (w);
+      biblioteq_magazine *magazine = qobject_cast<biblioteq_magazine *> (w);
+      biblioteq_photographcollection *photograph =
+	qobject_cast<biblioteq_photographcollection *> (w);
+      biblioteq_videogame *videogame = qobject_cast<biblioteq_videogame *> (w);
+
+      if(book)
+	items["book" + book->getID()] = book;
+      else if(cd)
+	items["cd" + cd->getID()] = cd;
+      else if(dvd)
+	items["dvd" + dvd->getID()] = dvd;
+      else if(journal)
+	items["journal" + journal->getID()] = journal;
+      else if(magazine)
+	items["magazine" + magazine->getID()] = magazine;
+      else if(photograph)
+	items["photographcollection" + photograph->getID()] = photograph;
+      else if(videogame)
+	items["videogame" + videogame->getID()] = videogame;
+    }
+
+  int oidColumn = ui.table->columnNumber("MYOID");
+  int typeColumn = ui.table->columnNumber("Type");
+
+  for(int i = 0; !items.isEmpty() && i < ui.table->rowCount(); i++)
+    {
+      QString itemType
+	(biblioteq_misc_functions::getColumnString(ui.table, i, typeColumn));
+      biblioteq_item *item = items.take
+	(itemType.toLower().remove(" ") +
+	 biblioteq_misc_functions::getColumnString(ui.table, i, oidColumn));
+
+      if(item)
+	item->updateRow(i);
     }
 
   QApplication::restoreOverrideCursor();
@@ -2339,7 +2426,7 @@ void biblioteq::slotSaveUser(void)
     }
 
   checksum.append(userinfo_diag->m_userinfo.dob->date().
-		  toString("MM/dd/yyyy"));
+		  toString(Qt::ISODate));
   checksum.append(userinfo_diag->m_userinfo.sex->currentText());
   checksum.append(userinfo_diag->m_userinfo.firstName->text());
   checksum.append(userinfo_diag->m_userinfo.middle->text());
@@ -2407,9 +2494,9 @@ void biblioteq::slotSaveUser(void)
 		    "?, ?, ?, ?, ?)");
       query.bindValue(0, userinfo_diag->m_userinfo.memberid->text().trimmed());
       query.bindValue(1, userinfo_diag->m_userinfo.membersince->
-		      date().toString("MM/dd/yyyy"));
+		      date().toString(Qt::ISODate));
       query.bindValue(2, userinfo_diag->m_userinfo.dob->date().
-		      toString("MM/dd/yyyy"));
+		      toString(Qt::ISODate));
       query.bindValue(3, userinfo_diag->m_userinfo.sex->currentText());
       query.bindValue(4, userinfo_diag->m_userinfo.firstName->text().trimmed());
       query.bindValue(5, userinfo_diag->m_userinfo.middle->text().trimmed());
@@ -2421,7 +2508,7 @@ void biblioteq::slotSaveUser(void)
       query.bindValue(11, userinfo_diag->m_userinfo.zip->text());
       query.bindValue(12, userinfo_diag->m_userinfo.email->text().trimmed());
       query.bindValue(13, userinfo_diag->m_userinfo.expirationdate->
-		      date().toString("MM/dd/yyyy"));
+		      date().toString(Qt::ISODate));
       query.bindValue(14, userinfo_diag->m_userinfo.overduefees->value());
       query.bindValue
 	(15, userinfo_diag->m_userinfo.comments->toPlainText().trimmed());
@@ -2453,9 +2540,9 @@ void biblioteq::slotSaveUser(void)
 		    "memberclass = ? "
 		    "WHERE memberid = ?");
       query.bindValue(0, userinfo_diag->m_userinfo.membersince->date().
-		      toString("MM/dd/yyyy"));
+		      toString(Qt::ISODate));
       query.bindValue(1, userinfo_diag->m_userinfo.dob->date().
-		      toString("MM/dd/yyyy"));
+		      toString(Qt::ISODate));
       query.bindValue(2, userinfo_diag->m_userinfo.sex->currentText());
       query.bindValue
 	(3, userinfo_diag->m_userinfo.firstName->text().trimmed());
@@ -2468,7 +2555,7 @@ void biblioteq::slotSaveUser(void)
       query.bindValue(10, userinfo_diag->m_userinfo.zip->text());
       query.bindValue(11, userinfo_diag->m_userinfo.email->text().trimmed());
       query.bindValue(12, userinfo_diag->m_userinfo.expirationdate->
-		      date().toString("MM/dd/yyyy"));
+		      date().toString(Qt::ISODate));
       query.bindValue(13, userinfo_diag->m_userinfo.overduefees->value());
       query.bindValue(14, userinfo_diag->m_userinfo.comments->toPlainText().
 		      trimmed());
@@ -3284,10 +3371,8 @@ void biblioteq::slotSceneSelectionChanged(void)
       int column2 = ui.table->columnNumber("Type");
 
       for(int i = 0; i < ui.table->rowCount(); i++)
-	if(ui.table->item(i, column1) &&
-	   oids.contains(ui.table->item(i, column1)->text()) &&
-	   ui.table->item(i, column2) &&
-	   types.contains(ui.table->item(i, column2)->text()))
+	if(oids.contains(ui.table->text(i, column1)) &&
+	   types.contains(ui.table->text(i, column2)))
 	  ui.table->selectRow(i);
 
       oids.clear();
@@ -3327,15 +3412,16 @@ void biblioteq::slotDisplaySummary(void)
 
 	  QPainterPath painterPath;
 	  QList<QGraphicsItem *> items(ui.graphicsView->scene()->items());
-	  QList<QTableWidgetItem *> tableItems(ui.table->selectedItems());
+	  QModelIndexList tableRows
+	    (ui.table->selectionModel()->selectedRows());
 
-	  for(int ii = 0; ii < tableItems.size(); ii++)
+	  for(int ii = 0; ii < tableRows.size(); ii++)
 	    {
 	      QString oid = biblioteq_misc_functions::getColumnString
-		(ui.table, tableItems.at(ii)->row(),
+		(ui.table, tableRows.at(ii).row(),
 		 ui.table->columnNumber("MYOID"));
 	      QString type =  biblioteq_misc_functions::getColumnString
-		(ui.table, tableItems.at(ii)->row(),
+		(ui.table, tableRows.at(ii).row(),
 		 ui.table->columnNumber("Type"));
 
 	      for(int jj = 0; jj < items.size(); jj++)
@@ -3899,16 +3985,32 @@ void biblioteq::slotConnectDB(void)
 
   QApplication::setOverrideCursor(Qt::WaitCursor);
 
+  /*
+  ** Background queries open private connections. Their parameters,
+  ** including the password, are retained for the session only. The
+  ** password is not stored in m_db.
+  */
+
+  m_connection = biblioteq_query_thread::connection();
+  m_connection.m_port = -1;
+
   if(tmphash.value("database_type") == "sqlite")
     (void) m_db.open();
   else
     {
-      (void) m_db.open(br.userid->text().trimmed(), br.password->text());
+      if(m_db.open(br.userid->text().trimmed(), br.password->text()))
+	m_connection.m_password = br.password->text();
 
       if(br.role->currentIndex() != 1)
 	br.password->clear();
     }
 
+  m_connection.m_connectOptions = m_db.connectOptions();
+  m_connection.m_databaseName = m_db.databaseName();
+  m_connection.m_driverName = m_db.driverName();
+  m_connection.m_hostName = m_db.hostName();
+  m_connection.m_port = m_db.port();
+  m_connection.m_userName = m_db.userName();
   QApplication::restoreOverrideCursor();
 
   if(!m_db.isOpen())
@@ -4071,6 +4173,8 @@ void biblioteq::slotConnectDB(void)
 
   if(error)
     {
+      m_connection = biblioteq_query_thread::connection();
+      m_connection.m_port = -1;
       m_db = QSqlDatabase();
       QSqlDatabase::removeDatabase("Default");
       return;
@@ -4124,6 +4228,7 @@ void biblioteq::slotConnectDB(void)
 
       setWindowTitle(tr("BiblioteQ: ") +
 		     QFileInfo(br.filename->text()).fileName());
+      upgradeSqliteIndexes();
     }
   else
     {
@@ -4274,6 +4379,8 @@ void biblioteq::slotDisconnect(void)
     return;
 
   m_roles = "";
+  m_keysetPages.clear();
+  m_keysetQuery.clear();
   m_pages = 0;
   m_queryOffset = 0;
   userinfo_diag->m_memberProperties.clear();
@@ -4300,6 +4407,7 @@ void biblioteq::slotDisconnect(void)
   ui.actionChangePassword->setEnabled(false);
   ui.deleteTool->setEnabled(false);
   ui.menu_Add_Item->setEnabled(false);
+  ui.actionImport_MARC_Records->setEnabled(false);
   ui.actionDeleteEntry->setEnabled(false);
   ui.actionDuplicateEntry->setEnabled(false);
   ui.createTool->setEnabled(false);
@@ -4427,6 +4535,8 @@ void biblioteq::slotDisconnect(void)
     m_db.close();
 
   QApplication::restoreOverrideCursor();
+  m_connection = biblioteq_query_thread::connection();
+  m_connection.m_port = -1;
   m_db = QSqlDatabase();
 
   if(QSqlDatabase::contains("Default"))
@@ -4493,6 +4603,8 @@ void biblioteq::resetMembersBrowser(void)
 {
   QStringList list;
 
+  m_membersBrowserExhausted = true;
+  m_membersBrowserKey.clear();
   bb.table->clear();
   bb.table->setCurrentItem(0);
   bb.table->setColumnCount(0);
@@ -4572,90 +4684,138 @@ void biblioteq::slotShowMembersBrowser(void)
     slotPopulateMembersBrowser();
 }
 
+/*
+** -- slotMembersBrowserScrolled() --
+*/
+
+void biblioteq::slotMembersBrowserScrolled(int value)
+{
+  /*
+  ** The next page of members is loaded once the last row is reached.
+  */
+
+  if(m_membersBrowserExhausted || !m_db.isOpen())
+    return;
+
+  if(value >= bb.table->verticalScrollBar()->maximum())
+    populateMembersBrowser();
+}
+
 /*
 ** -- slotPopulateMembersBrowser() --
 */
 
 void biblioteq::slotPopulateMembersBrowser(void)
 {
-  int i = -1;
-  int j = 0;
-  QString str = "";
-  QSqlQuery query(m_db);
-  QProgressDialog progress(m_members_diag);
-  QTableWidgetItem *item = 0;
+  resetMembersBrowser();
+  m_membersBrowserExhausted = false;
+  populateMembersBrowser();
+
+  for(int i = 0; i < bb.table->columnCount() - 1; i++)
+    bb.table->resizeColumnToContents(i);
 
 #ifdef Q_OS_MAC
-#if QT_VERSION < 0x050000
-  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
-#endif
+  bb.table->hide();
+  bb.table->show();
 #endif
-  str = "SELECT member.memberid, "
-    "member.first_name, "
-    "member.last_name, "
-    "member.membersince, "
-    "member.expiration_date, "
-    "COUNT(DISTINCT ib1.myoid) AS numbooks, "
-    "COUNT(DISTINCT ib2.myoid) AS numcds, "
-    "COUNT(DISTINCT ib3.myoid) AS numdvds, "
-    "COUNT(DISTINCT ib4.myoid) AS numjournals, "
-    "COUNT(DISTINCT ib5.myoid) AS nummagazines, "
-    "COUNT(DISTINCT ib6.myoid) AS numvideogames "
-    "FROM member member "
-    "LEFT JOIN item_borrower_vw ib1 ON "
-    "member.memberid = ib1.memberid AND ib1.type = 'Book' "
-    "LEFT JOIN item_borrower_vw ib2 ON "
-    "member.memberid = ib2.memberid AND ib2.type = 'CD' "
-    "LEFT JOIN item_borrower_vw ib3 ON "
-    "member.memberid = ib3.memberid AND ib3.type = 'DVD' "
-    "LEFT JOIN item_borrower_vw ib4 ON "
-    "member.memberid = ib4.memberid AND ib4.type = 'Journal' "
-    "LEFT JOIN item_borrower_vw ib5 ON "
-    "member.memberid = ib5.memberid AND ib5.type = 'Magazine' "
-    "LEFT JOIN item_borrower_vw ib6 ON "
-    "member.memberid = ib6.memberid AND ib6.type = 'Video Game' ";
-
-  if(bb.filterBox->isChecked())
-    {
-      str.append("WHERE ");
-
-      QString E("");
+}
 
-      if(m_db.driverName() != "QSQLITE")
-	E = "E";
+/*
+** -- populateMembersBrowser() --
+*/
+
+void biblioteq::populateMembersBrowser(void)
+{
+  /*
+  ** Members are loaded a page at a time, in the order of their
+  ** identifiers. A page is selected by the last identifier of the
+  ** previous page. The reserved items of a page's members are counted
+  ** in a single pass over item_borrower_vw.
+  */
+
+  QSqlQuery query(m_db);
+  QString filter(bb.filter->text().trimmed());
+  QString str("");
+  QStringList conditions;
+  QTableWidgetItem *item = 0;
+  QVariantList values;
+
+  if(!m_membersBrowserKey.isEmpty())
+    {
+      conditions.append("memberid > ?");
+      values.append(m_membersBrowserKey);
+    }
+
+  if(bb.filterBox->isChecked() && !filter.isEmpty())
+    {
+      /*
+      ** Prefix matches may use the member_*_pattern_idx (PostgreSQL)
+      ** and member_*_nocase_idx (SQLite) indexes.
+      */
+
+      QString escape("");
+
+      if(m_db.driverName() == "QSQLITE")
+	escape = " ESCAPE '\\'";
+
+      filter.replace("\\", "\\\\");
+      filter.replace("%", "\\%");
+      filter.replace("_", "\\_");
 
       if(bb.filtertype->currentText() == "Member ID")
-	{
-	  str.append("member.memberid LIKE " + E + "'%' || ");
-	  str.append("?");
-	}
+	conditions.append("memberid LIKE ?" + escape);
       else
-	{
-	  str.append("member.last_name LIKE " + E + "'%' || ");
-	  str.append("?");
-	}
+	conditions.append("last_name LIKE ?" + escape);
 
-      str.append("|| '%' ");
+      values.append(filter + "%");
     }
 
-  str.append("GROUP BY "
+  str = "SELECT member.memberid, "
+    "member.first_name, "
+    "member.last_name, "
+    "member.membersince, "
+    "member.expiration_date, "
+    "SUM(CASE WHEN ib.type = 'Book' THEN 1 ELSE 0 END) AS numbooks, "
+    "SUM(CASE WHEN ib.type = 'CD' THEN 1 ELSE 0 END) AS numcds, "
+    "SUM(CASE WHEN ib.type = 'DVD' THEN 1 ELSE 0 END) AS numdvds, "
+    "SUM(CASE WHEN ib.type = 'Journal' THEN 1 ELSE 0 END) "
+    "AS numjournals, "
+    "SUM(CASE WHEN ib.type = 'Magazine' THEN 1 ELSE 0 END) "
+    "AS nummagazines, "
+    "SUM(CASE WHEN ib.type = 'Video Game' THEN 1 ELSE 0 END) "
+    "AS numvideogames "
+    "FROM (SELECT memberid, "
+    "first_name, "
+    "last_name, "
+    "membersince, "
+    "expiration_date "
+    "FROM member ";
+
+  if(!conditions.isEmpty())
+    str.append("WHERE " + conditions.join(" AND ") + " ");
+
+  str.append(QString("ORDER BY memberid LIMIT %1) member ").
+	     arg(MEMBERS_PAGE_SIZE));
+  str.append("LEFT JOIN item_borrower_vw ib ON "
+	     "member.memberid = ib.memberid "
+	     "GROUP BY "
 	     "member.memberid, "
 	     "member.first_name, "
 	     "member.last_name, "
 	     "member.membersince, "
-	     "member.expiration_date ");
-  str.append("ORDER BY member.memberid");
+	     "member.expiration_date "
+	     "ORDER BY member.memberid");
   query.setForwardOnly(true);
   query.prepare(str);
 
-  if(bb.filterBox->isChecked())
-    query.bindValue
-      (0, biblioteq_myqstring::escape(bb.filter->text().trimmed()));
+  for(int i = 0; i < values.size(); i++)
+    query.addBindValue(values.at(i));
 
   QApplication::setOverrideCursor(Qt::WaitCursor);
 
   if(!query.exec())
     {
+      m_membersBrowserExhausted = true;
       QApplication::restoreOverrideCursor();
       addError(QString(tr("Database Error")),
 	       QString(tr("Unable to retrieve member data for table "
@@ -4668,91 +4828,55 @@ void biblioteq::slotPopulateMembersBrowser(void)
       return;
     }
 
-  QApplication::restoreOverrideCursor();
-  resetMembersBrowser();
   bb.table->setSortingEnabled(false);
 
-  if(m_db.driverName() != "QSQLITE")
-    bb.table->setRowCount(query.size());
-  else
-    bb.table->setRowCount
-      (biblioteq_misc_functions::sqliteQuerySize(query.lastQuery(),
-						 query.boundValues(),
-						 m_db, __FILE__, __LINE__));
-
-  progress.setModal(true);
-  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
-  progress.setLabelText(tr("Populating the table..."));
-  progress.setMinimum(0);
-
-  if(m_db.driverName() == "QSQLITE")
-    progress.setMaximum
-      (biblioteq_misc_functions::sqliteQuerySize(query.lastQuery(),
-						 query.boundValues(),
-						 m_db, __FILE__, __LINE__));
-  else
-    progress.setMaximum(query.size());
+  int count = 0;
+  int row = bb.table->rowCount();
 
-  progress.show();
-#ifndef Q_OS_MAC
-  progress.repaint();
-  QApplication::processEvents();
-#endif
-  i = -1;
-
-  while(i++, !progress.wasCanceled() && query.next())
+  while(query.next())
     {
-      if(query.isValid())
-	for(j = 0; j < query.record().count(); j++)
-	  {
-	    if(query.record().fieldName(j).contains("date") ||
-	       query.record().fieldName(j).contains("membersince"))
-	      {
-		QDate date(QDate::fromString(query.value(j).toString(),
-					     "MM/dd/yyyy"));
+      bb.table->setRowCount(row + 1);
 
-		str = date.toString(Qt::ISODate);
-	      }
-	    else
-	      str = query.value(j).toString();
+      for(int j = 0; j < query.record().count(); j++)
+	{
+	  if(query.record().fieldName(j).contains("date") ||
+	     query.record().fieldName(j).contains("membersince"))
+	    {
+	      QDate date(biblioteq_misc_functions::dateFromString
+			 (query.value(j).toString()));
 
-	    if(str == "0")
-	      str = "";
+	      str = date.toString(Qt::ISODate);
+	    }
+	  else
+	    str = query.value(j).toString();
 
-	    if((item = new(std::nothrow) QTableWidgetItem()) != 0)
-	      {
-		item->setText(str);
-		item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-		bb.table->setItem(i, j, item);
-	      }
-	    else
-	      addError(QString(tr("Memory Error")),
-		       QString(tr("Unable to allocate memory for the "
-				  "\"item\" object. "
-				  "This is a serious problem!")),
-		       QString(""), __FILE__, __LINE__);
-	  }
+	  if(str == "0")
+	    str = "";
 
-      if(i + 1 <= progress.maximum())
-	progress.setValue(i + 1);
+	  if((item = new(std::nothrow) QTableWidgetItem()) != 0)
+	    {
+	      item->setText(str);
+	      item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+	      bb.table->setItem(row, j, item);
+	    }
+	  else
+	    addError(QString(tr("Memory Error")),
+		     QString(tr("Unable to allocate memory for the "
+				"\"item\" object. "
+				"This is a serious problem!")),
+		     QString(""), __FILE__, __LINE__);
+	}
 
-#ifndef Q_OS_MAC
-      progress.repaint();
-      QApplication::processEvents();
-#endif
+      m_membersBrowserKey = query.value(0).toString();
+      count += 1;
+      row += 1;
     }
 
-  progress.close();
-  bb.table->setSortingEnabled(true);
-  bb.table->setRowCount(i); // Support cancellation.
+  if(count < MEMBERS_PAGE_SIZE)
+    m_membersBrowserExhausted = true;
 
-  for(int i = 0; i < bb.table->columnCount() - 1; i++)
-    bb.table->resizeColumnToContents(i);
-
-#ifdef Q_OS_MAC
-  bb.table->hide();
-  bb.table->show();
-#endif
+  bb.table->setSortingEnabled(true);
+  QApplication::restoreOverrideCursor();
 }
 
 /*
@@ -5008,10 +5132,10 @@ void biblioteq::slotModifyBorrower(void)
 	    userinfo_diag->m_userinfo.memberid->setText(var.toString());
 	  else if(fieldname == "membersince")
 	    userinfo_diag->m_userinfo.membersince->setDate
-	      (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+	      (biblioteq_misc_functions::dateFromString(var.toString()));
 	  else if(fieldname == "dob")
 	    userinfo_diag->m_userinfo.dob->setDate
-	      (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+	      (biblioteq_misc_functions::dateFromString(var.toString()));
 	  else if(fieldname == "sex")
 	    {
 	      if(userinfo_diag->m_userinfo.sex->findText(var.toString()) > -1)
@@ -5047,7 +5171,7 @@ void biblioteq::slotModifyBorrower(void)
 	    userinfo_diag->m_userinfo.email->setText(var.toString());
 	  else if(fieldname == "expiration_date")
 	    userinfo_diag->m_userinfo.expirationdate->setDate
-	      (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+	      (biblioteq_misc_functions::dateFromString(var.toString()));
 	  else if(fieldname == "overdue_fees")
 	    userinfo_diag->m_userinfo.overduefees->setValue(var.toDouble());
 	  else if(fieldname == "comments")
@@ -5062,7 +5186,7 @@ void biblioteq::slotModifyBorrower(void)
 	     fieldname.contains("date") ||
 	     fieldname.contains("membersince"))
 	    userinfo_diag->m_memberProperties[fieldname] =
-	      QDate::fromString(var.toString(), "MM/dd/yyyy").
+	      biblioteq_misc_functions::dateFromString(var.toString()).
 	      toString(Qt::ISODate);
 	  else if(fieldname == "overdue_fees")
 	    userinfo_diag->m_memberProperties[fieldname] =
@@ -7044,56 +7168,111 @@ void biblioteq::slotExecuteCustomQuery(void)
     }
 }
 
+/*
+** -- printReport() --
+*/
+
+void biblioteq::printReport(QWidget *parent,
+			    QPrinter *printer,
+			    const QString &title,
+			    const QStringList &headers,
+			    const QList<QStringList> &rows)
+{
+  /*
+  ** The pages are laid out and printed by a separate thread.
+  */
+
+  QEventLoop loop;
+  QProgressDialog progress(parent);
+  QTimer timer;
+  biblioteq_report_thread thread(0);
+
+#ifdef Q_OS_MAC
+#if QT_VERSION < 0x050000
+  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
+#endif
+#endif
+  connect(&progress, SIGNAL(canceled(void)), &loop, SLOT(quit(void)));
+  connect(&thread, SIGNAL(finished(void)), &loop, SLOT(quit(void)));
+  connect(&timer, SIGNAL(timeout(void)), &loop, SLOT(quit(void)));
+  progress.setMaximum(rows.size());
+  progress.setMinimum(0);
+  progress.setModal(true);
+  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
+  progress.setLabelText(tr("Printing..."));
+  progress.show();
+  progress.update();
+  thread.setPrinter(printer);
+  thread.setReport(title, headers, rows);
+  thread.start();
+  timer.start(100);
+
+  while(!thread.isFinished())
+    {
+      if(progress.wasCanceled())
+	thread.cancel();
+      else
+	{
+	  progress.setLabelText
+	    (QString(tr("Printed %1 page(s)...")).
+	     arg(thread.pagesPrinted()));
+	  progress.setValue(thread.rowsPrinted());
+	}
+
+      loop.exec();
+    }
+
+  thread.wait();
+  timer.stop();
+  progress.close();
+
+  if(!thread.wasCanceled() && !thread.getErrorStr().isEmpty())
+    QMessageBox::critical(parent, tr("BiblioteQ: Error"),
+			  thread.getErrorStr());
+}
+
 /*
 ** -- slotPrintView() --
 */
 
 void biblioteq::slotPrintView(void)
 {
-  QString html = "<html>";
+  QList<QStringList> rows;
   QPrinter printer;
   QPrintDialog dialog(&printer, this);
-  QTextDocument document;
+  QStringList headers;
 
 #ifdef Q_OS_MAC
 #if QT_VERSION < 0x050000
   dialog.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
 #endif
 #endif
+  printer.setPaperSize(QPrinter::Letter);
+  printer.setColorMode(QPrinter::GrayScale);
+  printer.setOrientation(QPrinter::Landscape);
+
+  if(dialog.exec() != QDialog::Accepted)
+    return;
+
   QApplication::setOverrideCursor(Qt::WaitCursor);
-  html += "<table border=1>";
-  html += "<tr>";
 
   for(int i = 0; i < ui.table->columnCount(); i++)
     if(!ui.table->isColumnHidden(i))
-      html += "<th>" + ui.table->horizontalHeaderItem(i)->text() +
-	"</th>";
+      headers.append(ui.table->horizontalHeaderItem(i)->text());
 
-  html += "</tr>";
-  
   for(int i = 0; i < ui.table->rowCount(); i++)
     {
-      html += "<tr>";
+      QStringList row;
 
       for(int j = 0; j < ui.table->columnCount(); j++)
 	if(!ui.table->isColumnHidden(j))
-	  html += "<td>" + ui.table->item(i, j)->text() + "</td>";
+	  row.append(ui.table->text(i, j));
 
-      html += "</tr>";
+      rows.append(row);
     }
 
-  html += "</table>";
-  html += "</html>";
   QApplication::restoreOverrideCursor();
-  printer.setPaperSize(QPrinter::Letter);
-  printer.setColorMode(QPrinter::GrayScale);
-  printer.setOrientation(QPrinter::Landscape);
-
-  if(dialog.exec() == QDialog::Accepted)
-    {
-      document.setHtml(html);
-      document.print(&printer);
-    }
+  printReport(this, &printer, tr("BiblioteQ"), headers, rows);
 }
 
 /*
@@ -7110,7 +7289,6 @@ void biblioteq::slotPrintReserved(void)
   QPrinter printer;
   QStringList itemsList;
   QPrintDialog dialog(&printer, m_members_diag);
-  QTextDocument document;
   QMap<QString, QString> memberinfo;
 
 #ifdef Q_OS_MAC
@@ -7170,23 +7348,21 @@ void biblioteq::slotPrintReserved(void)
 
   if(errorstr.isEmpty())
     {
-      str = "<html>\n";
-      str += tr("Reserved Items for ") + memberinfo.value("lastname") +
-	tr(", ") + memberinfo.value("firstname") + "<br><br>";
+      QList<QStringList> rows;
+
+      str = tr("Reserved Items for ") + memberinfo.value("lastname") +
+	tr(", ") + memberinfo.value("firstname");
 
       for(int i = 0; i < itemsList.size(); i++)
-	str += itemsList[i] + "<br><br>";
+	rows.append(QStringList() << QString(itemsList[i]).
+		    replace("<br>", "\n"));
 
-      str = str.mid(0, str.length() - 8);
-      str += "</html>";
       printer.setPageSize(QPrinter::Letter);
       printer.setColorMode(QPrinter::GrayScale);
 
       if(dialog.exec() == QDialog::Accepted)
-	{
-	  document.setHtml(str);
-	  document.print(&printer);
-	}
+	printReport(m_members_diag, &printer, str,
+		    QStringList() << tr("Reserved Items"), rows);
     }
   else
     {
@@ -7562,8 +7738,8 @@ void biblioteq::slotShowHistory(void)
 	  {
 	    if(query.record().fieldName(j).contains("date"))
 	      {
-		QDate date(QDate::fromString(query.value(j).toString(),
-					     "MM/dd/yyyy"));
+		QDate date(biblioteq_misc_functions::dateFromString
+			   (query.value(j).toString()));
 
 		str = date.toString(Qt::ISODate);
 	      }
@@ -7645,10 +7821,10 @@ QMainWindow *biblioteq::getMembersBrowser(void) const
 
 void biblioteq::slotPrintReservationHistory(void)
 {
-  QString html = "<html>";
+  QList<QStringList> rows;
   QPrinter printer;
   QPrintDialog dialog(&printer, m_history_diag);
-  QTextDocument document;
+  QStringList headers;
 
 #ifdef Q_OS_MAC
 #if QT_VERSION < 0x050000
@@ -7670,40 +7846,37 @@ void biblioteq::slotPrintReservationHistory(void)
       return;
     }
 
+  printer.setPageSize(QPrinter::Letter);
+  printer.setColorMode(QPrinter::GrayScale);
+
+  if(dialog.exec() != QDialog::Accepted)
+    return;
+
   QApplication::setOverrideCursor(Qt::WaitCursor);
-  html = tr("Reservation History") + "<br><br>";
-  html += "<table border=1>";
-  html += "<tr>";
 
   for(int i = 0; i < history.table->columnCount(); i++)
     if(!history.table->isColumnHidden(i))
-      html += "<th>" + history.table->horizontalHeaderItem(i)->text() +
-	"</th>";
-
-  html += "</tr>";
+      headers.append(history.table->horizontalHeaderItem(i)->text());
 
   for(int i = 0; i < history.table->rowCount(); i++)
     {
-      html += "<tr>";
+      QStringList row;
 
       for(int j = 0; j < history.table->columnCount(); j++)
 	if(!history.table->isColumnHidden(j))
-	  html += "<td>" + history.table->item(i, j)->text() + "</td>";
+	  {
+	    if(history.table->item(i, j))
+	      row.append(history.table->item(i, j)->text());
+	    else
+	      row.append("");
+	  }
 
-      html += "</tr>";
+      rows.append(row);
     }
 
-  html += "</table>";
-  html += "</html>";
   QApplication::restoreOverrideCursor();
-  printer.setPageSize(QPrinter::Letter);
-  printer.setColorMode(QPrinter::GrayScale);
-
-  if(dialog.exec() == QDialog::Accepted)
-    {
-      document.setHtml(html);
-      document.print(&printer);
-    }
+  printReport(m_history_diag, &printer, tr("Reservation History"),
+	      headers, rows);
 }
 
 /*
@@ -7778,13 +7951,10 @@ void biblioteq::updateReservationHistoryBrowser(const QString &memberid,
 
 	    if(value1 == ioid && value2 == copyid && value3 == itemType)
 	      {
-		QDate date(QDate::fromString(returnedDate,
-					     "MM/dd/yyyy"));
-
 		biblioteq_misc_functions::updateColumn
 		  (history.table, i,
 		   m_historyColumnHeaderIndexes.indexOf("Returned Date"),
-		   date.toString(Qt::ISODate));
+		   returnedDate);
 		break;
 	      }
 	  }
@@ -7843,6 +8013,9 @@ void biblioteq::slotSavePassword(void)
   else
     biblioteq_misc_functions::setRole(m_db, errorstr, m_roles);
 
+  if(errorstr.isEmpty())
+    m_connection.m_password = pass.password->text();
+
   QApplication::restoreOverrideCursor();
   pass.password->clear();
   pass.passwordAgain->clear();
@@ -8618,7 +8791,7 @@ void biblioteq::slotRequest(void)
 			    "requestdate, type) VALUES (?, ?, ?, ?)");
 	      query.bindValue(0, oid);
 	      query.bindValue(1, m_db.userName());
-	      query.bindValue(2, now.toString("MM/dd/yyyy"));
+	      query.bindValue(2, now.toString(Qt::ISODate));
 	      query.bindValue(3, itemType);
 	    }
 	  else
@@ -8941,6 +9114,15 @@ void biblioteq::slotPreviousPage(void)
 			 m_lastSearchStr, PREVIOUS_PAGE);
 }
 
+/*
+** -- slotPruneZ3950Connections() --
+*/
+
+void biblioteq::slotPruneZ3950Connections(void)
+{
+  biblioteq_z3950_pool::pruneIdle();
+}
+
 /*
 ** -- slotNextPage() --
 */
@@ -9043,6 +9225,11 @@ void biblioteq::slotDisplayNewSqliteDialog(void)
 			  sqlite_create_schema_text,
 			  0,
 			  0,
+			  &errorstr) == SQLITE_OK &&
+	     sqlite3_exec(ppDb,
+			  sqlite_create_indexes_text,
+			  0,
+			  0,
 			  &errorstr) == SQLITE_OK)
 	    error = false;
 	  else
@@ -9140,6 +9327,130 @@ void biblioteq::slotDisplayNewSqliteDialog(void)
     }
 }
 
+/*
+** -- upgradeSqliteIndexes() --
+*/
+
+void biblioteq::upgradeSqliteIndexes(void)
+{
+  if(m_db.driverName() != "QSQLITE")
+    return;
+
+  QSqlQuery query(m_db);
+
+  if(query.exec("PRAGMA user_version") && query.next())
+    if(query.value(0).toInt() >= BIBLIOTEQ_SQLITE_INDEXES_VERSION)
+      return;
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+
+  QStringList list
+    (QString(sqlite_create_indexes_text).split(';',
+					       QString::SkipEmptyParts));
+
+  bool ok = true;
+
+  m_db.transaction();
+
+  for(int i = 0; i < list.size(); i++)
+    {
+      QString statement(list.at(i).trimmed());
+
+      if(statement.isEmpty())
+	continue;
+
+      /*
+      ** Legacy databases may lack some of the indexed tables.
+      ** Create the remaining indexes and try again on the next
+      ** connection.
+      */
+
+      if(!query.exec(statement))
+	{
+	  ok = false;
+	  addError(QString(tr("Database Error")),
+		   QString(tr("Unable to create an index.")),
+		   query.lastError().text(), __FILE__, __LINE__);
+	}
+    }
+
+  for(int i = 0; sqlite_create_reservation_counts_statements[i] != 0; i++)
+    if(!query.exec(sqlite_create_reservation_counts_statements[i]))
+      {
+	ok = false;
+	addError(QString(tr("Database Error")),
+		 QString(tr("Unable to create the reservation counts.")),
+		 query.lastError().text(), __FILE__, __LINE__);
+      }
+
+  /*
+  ** Full-text search. If neither FTS5 nor FTS4 is available,
+  ** searches continue to use LIKE.
+  */
+
+  bool search = false;
+
+  if(query.exec("SELECT COUNT(*) FROM sqlite_master "
+		"WHERE name = 'item_search'") && query.next())
+    search = query.value(0).toLongLong() > 0;
+
+  if(!search)
+    if(query.exec(sqlite_create_search_fts5_text) ||
+       query.exec(sqlite_create_search_fts4_text))
+      {
+	for(int i = 0; sqlite_populate_search_statements[i] != 0; i++)
+	  if(!query.exec(sqlite_populate_search_statements[i]))
+	    {
+	      ok = false;
+	      addError(QString(tr("Database Error")),
+		       QString(tr("Unable to populate the full-text "
+				  "search table.")),
+		       query.lastError().text(), __FILE__, __LINE__);
+	    }
+
+	search = true;
+      }
+
+  if(search)
+    for(int i = 0; sqlite_create_search_statements[i] != 0; i++)
+      if(!query.exec(sqlite_create_search_statements[i]))
+	{
+	  ok = false;
+	  addError(QString(tr("Database Error")),
+		   QString(tr("Unable to create a full-text search "
+			      "trigger.")),
+		   query.lastError().text(), __FILE__, __LINE__);
+	}
+
+  m_db.commit();
+
+  /*
+  ** Images were once stored as base64 text.
+  */
+
+  if(ok)
+    {
+      QString errorstr("");
+
+      if(!biblioteq_misc_functions::convertImagesToBinary(m_db, errorstr))
+	{
+	  ok = false;
+	  addError(QString(tr("Database Error")),
+		   QString(tr("Unable to convert images to binary.")),
+		   errorstr, __FILE__, __LINE__);
+	}
+    }
+
+  if(ok)
+    if(!query.exec(QString("PRAGMA user_version = %1").
+		   arg(BIBLIOTEQ_SQLITE_INDEXES_VERSION)))
+      addError(QString(tr("Database Error")),
+	       QString(tr("Unable to record the index version.")),
+	       query.lastError().text(), __FILE__, __LINE__);
+
+  QApplication::restoreOverrideCursor();
+}
+
 /*
 ** -- slotShowDbEnumerations() --
 */
@@ -9183,6 +9494,9 @@ void biblioteq::slotChangeView(bool checked)
 
 void biblioteq::slotExportAsCSV(void)
 {
+  if(!m_db.isOpen() || m_lastQueryStr.isEmpty())
+    return;
+
   QFileDialog dialog(this);
 
 #ifdef Q_OS_MAC
@@ -9192,72 +9506,172 @@ void biblioteq::slotExportAsCSV(void)
 #endif
   dialog.setFileMode(QFileDialog::AnyFile);
   dialog.setDirectory(QDir::homePath());
-  dialog.setNameFilter(tr("CSV (*.csv)"));
+  dialog.setNameFilters(QStringList() << tr("CSV (*.csv)")
+			<< tr("TSV (*.tsv)"));
   dialog.setAcceptMode(QFileDialog::AcceptSave);
-  dialog.setWindowTitle(tr("BiblioteQ: Export Table View as CSV"));
+  dialog.setWindowTitle(tr("BiblioteQ: Export Results as CSV"));
   dialog.setDefaultSuffix("csv");
   dialog.exec();
 
-  if(dialog.result() == QDialog::Accepted)
+  if(dialog.result() != QDialog::Accepted)
+    return;
+
+  /*
+  ** The last search is executed again, without its limit, so that
+  ** every result is exported rather than only the current page.
+  ** The visible columns are exported in their original order.
+  */
+
+  QChar delimiter(',');
+  QList<int> columns;
+  QString fileName(dialog.selectedFiles().value(0));
+  QStringList headers;
+
+  if(fileName.endsWith(".tsv", Qt::CaseInsensitive))
+    delimiter = '\t';
+
+  for(int i = 0; i < ui.table->columnCount(); i++)
+    if(!ui.table->isColumnHidden(i))
+      {
+	columns.append(i);
+
+	if(ui.table->horizontalHeaderItem(i))
+	  headers.append(ui.table->horizontalHeaderItem(i)->text());
+	else
+	  headers.append("");
+      }
+
+  QEventLoop loop;
+  QProgressDialog progress(this);
+  QString roles(m_roles);
+  QTimer timer;
+  biblioteq_csv_export_thread thread(0);
+
+#ifdef Q_OS_MAC
+#if QT_VERSION < 0x050000
+  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
+#endif
+#endif
+
+  if(roles.isEmpty())
     {
-      QApplication::setOverrideCursor(Qt::WaitCursor);
+      if(br.role->currentIndex() == 1)
+	roles = "guest";
+      else
+	roles = "patron";
+    }
+
+  connect(&progress, SIGNAL(canceled(void)), &loop, SLOT(quit(void)));
+  connect(&thread, SIGNAL(finished(void)), &loop, SLOT(quit(void)));
+  connect(&timer, SIGNAL(timeout(void)), &loop, SLOT(quit(void)));
+  progress.setMaximum(0);
+  progress.setMinimum(0);
+  progress.setModal(true);
+  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
+  progress.setLabelText(tr("Exporting the results..."));
+  raise();
+  progress.show();
+  progress.update();
+  thread.setDatabase(m_connection, roles);
+  thread.setQuery(m_lastQueryStr);
+  thread.setOutput(fileName, columns, headers, delimiter);
+  thread.start();
+  timer.start(100);
 
-      QFile file(dialog.selectedFiles().value(0));
+  while(!thread.isFinished())
+    {
+      if(progress.wasCanceled())
+	thread.cancel();
+      else
+	progress.setLabelText
+	  (QString(tr("Exported %1 row(s)...")).arg(thread.rowsWritten()));
 
-      if(file.open(QIODevice::WriteOnly | QIODevice::Truncate |
-		   QIODevice::Text))
-	{
-	  QString str("");
-	  QTextStream stream(&file);
+      loop.exec();
+    }
 
-	  for(int i = 0; i < ui.table->columnCount(); i++)
-	    if(!ui.table->isColumnHidden(i))
-	      {
-		if(ui.table->horizontalHeaderItem(i)->text().contains(","))
-		  str += QString("\"%1\",").arg
-		    (ui.table->horizontalHeaderItem(i)->text());
-		else
-		  str += QString("%1,").arg
-		    (ui.table->horizontalHeaderItem(i)->text());
-	      }
+  thread.wait();
+  timer.stop();
+  progress.close();
+
+  if(!thread.wasCanceled() && !thread.getErrorStr().isEmpty())
+    {
+      addError(QString(tr("Database Error")),
+	       QString(tr("Unable to export the results.")),
+	       thread.getErrorStr(), __FILE__, __LINE__);
+      QMessageBox::critical(this, tr("BiblioteQ: Database Error"),
+			    tr("Unable to export the results."));
+    }
+}
 
-	  if(str.endsWith(","))
-	    str = str.mid(0, str.length() - 1);
+/*
+** -- slotImportMARC() --
+*/
 
-	  if(!str.isEmpty())
-	    stream << str << endl;
+void biblioteq::slotImportMARC(void)
+{
+  if(!m_db.isOpen())
+    return;
 
-	  for(int i = 0; i < ui.table->rowCount(); i++)
-	    {
-	      str = "";
+  QFileDialog dialog(this);
 
-	      for(int j = 0; j < ui.table->columnCount(); j++)
-		if(!ui.table->isColumnHidden(j))
-		  {
-		    QString cleaned(ui.table->item(i, j)->text());
+#ifdef Q_OS_MAC
+#if QT_VERSION < 0x050000
+  dialog.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
+#endif
+#endif
+  dialog.setFileMode(QFileDialog::ExistingFile);
+  dialog.setDirectory(QDir::homePath());
+  dialog.setNameFilter(tr("MARC (*.marc *.mrc *.xml)"));
+  dialog.setWindowTitle(tr("BiblioteQ: Import MARC Records"));
+  dialog.exec();
 
-		    cleaned.replace("\n", " ");
-		    cleaned.replace("\r\n", " ");
-		    cleaned = cleaned.trimmed();
+  if(dialog.result() != QDialog::Accepted)
+    return;
 
-		    if(cleaned.contains(","))
-		      str += QString("\"%1\",").arg(cleaned);
-		    else
-		      str += QString("%1,").arg(cleaned);
-		  }
+  QStringList types;
+  bool ok = false;
 
-	      if(str.endsWith(","))
-		str = str.mid(0, str.length() - 1);
+  types << tr("Book") << tr("Journal") << tr("Magazine");
 
-	      if(!str.isEmpty())
-		stream << str << endl;
-	    }
+  int index = types.indexOf
+    (QInputDialog::getItem(this,
+			   tr("BiblioteQ: Import MARC Records"),
+			   tr("Import the records as"),
+			   types,
+			   0,
+			   false,
+			   &ok));
 
-	  file.close();
-	}
+  if(!ok || index < 0)
+    return;
 
-      QApplication::restoreOverrideCursor();
+  QString errorstr("");
+  QString itemType("Book");
+  biblioteq_marc_import importer(this);
+
+  if(index == 1)
+    itemType = "Journal";
+  else if(index == 2)
+    itemType = "Magazine";
+
+  if(!importer.import(dialog.selectedFiles().value(0), itemType, errorstr))
+    {
+      if(!errorstr.isEmpty())
+	addError(QString(tr("Database Error")),
+		 QString(tr("Unable to import the MARC records.")),
+		 errorstr, __FILE__, __LINE__);
     }
+
+  QMessageBox::information
+    (this, tr("BiblioteQ: Information"),
+     tr("Imported %1 record(s) at %2 record(s) per second. "
+	"%3 record(s) were already in the catalog.").
+     arg(importer.imported()).
+     arg(static_cast<int> (importer.recordsPerSecond())).
+     arg(importer.skipped()));
+
+  if(importer.imported() > 0)
+    slotRefresh();
 }
 
 /*
@@ -9469,6 +9883,24 @@ void biblioteq::slotLanguageChanged(void)
     }
 }
 
+/*
+** -- eventFilter() --
+*/
+
+bool biblioteq::eventFilter(QObject *object, QEvent *event)
+{
+  /*
+  ** Enlarging the icon view may reveal icons whose covers
+  ** have not been retrieved.
+  */
+
+  if(event && event->type() == QEvent::Resize &&
+     object == ui.graphicsView->viewport())
+    m_coverTimer.start();
+
+  return QMainWindow::eventFilter(object, event);
+}
+
 /*
 ** -- changeEvent() --
 */
@@ -9518,6 +9950,15 @@ void biblioteq::changeEvent(QEvent *event)
   QMainWindow::changeEvent(event);
 }
 
+/*
+** -- getSRUClient() --
+*/
+
+biblioteq_sru_client *biblioteq::getSRUClient(void) const
+{
+  return m_sruClient;
+}
+
 /*
 ** -- getSRUMaps() --
 */
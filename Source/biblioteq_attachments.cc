@@ -0,0 +1,620 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QProgressDialog>
+#include <QRunnable>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThreadPool>
+#include <QTimer>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq.h"
+#include "biblioteq_attachments.h"
+#include "biblioteq_misc_functions.h"
+
+extern biblioteq *qmain;
+
+/*
+** Reads a single file on the pool's thread. The file is either
+** digested or divided into compressed chunks.
+*/
+
+class biblioteq_attachments_task: public QRunnable
+{
+ public:
+  biblioteq_attachments_task(biblioteq_attachments *attachments,
+			     const QString &fileName,
+			     const bool compress):QRunnable()
+  {
+    m_attachments = attachments;
+    m_compress = compress;
+    m_fileName = fileName;
+    setAutoDelete(true);
+  }
+
+  void run(void)
+  {
+    QCryptographicHash digest(QCryptographicHash::Sha1);
+    QFile file(m_fileName);
+    bool ok = file.open(QIODevice::ReadOnly);
+
+    if(ok)
+      while(!file.atEnd())
+	{
+	  QByteArray bytes(file.read(biblioteq_attachments::CHUNK_SIZE));
+
+	  if(bytes.isEmpty())
+	    {
+	      ok = false;
+	      break;
+	    }
+
+	  if(!m_compress)
+	    digest.addData(bytes);
+	  else if(!m_attachments->deliver(qCompress(bytes, 9)))
+	    {
+	      ok = false;
+	      break;
+	    }
+	}
+
+    m_attachments->finish(ok, m_compress ? QByteArray() : digest.result());
+  }
+
+ private:
+  QString m_fileName;
+  biblioteq_attachments *m_attachments;
+  bool m_compress;
+};
+
+/*
+** -- biblioteq_attachments() --
+*/
+
+biblioteq_attachments::biblioteq_attachments(QWidget *parent):QObject(parent)
+{
+  m_canceled = false;
+  m_finished = false;
+  m_ok = false;
+  m_parent = parent;
+  m_progress = 0;
+
+  if((m_pool = new(std::nothrow) QThreadPool(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  m_pool->setMaxThreadCount(1);
+}
+
+/*
+** -- ~biblioteq_attachments() --
+*/
+
+biblioteq_attachments::~biblioteq_attachments()
+{
+  stop();
+}
+
+/*
+** -- attach() --
+*/
+
+bool biblioteq_attachments::attach(const QStringList &fileNames,
+				   const QString &itemType,
+				   const QString &itemOid,
+				   QString &errorstr)
+{
+  errorstr = "";
+
+  if(fileNames.isEmpty())
+    return true;
+
+  QProgressDialog progress(m_parent);
+  bool ok = true;
+  qint64 done = 0;
+  qint64 total = 0;
+
+  for(int i = 0; i < fileNames.size(); i++)
+    total += QFileInfo(fileNames.at(i)).size();
+
+#ifdef Q_OS_MAC
+#if QT_VERSION < 0x050000
+  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
+#endif
+#endif
+  progress.setLabelText(tr("Uploading files..."));
+  progress.setMaximum(qMax(1, static_cast<int> (total / 1024)));
+  progress.setMinimum(0);
+  progress.setModal(true);
+  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
+  progress.show();
+  progress.update();
+  m_progress = &progress;
+
+  for(int i = 0; i < fileNames.size(); i++)
+    {
+      if(!store(fileNames.at(i), itemType, itemOid, done, errorstr))
+	{
+	  ok = false;
+	  break;
+	}
+
+      done += QFileInfo(fileNames.at(i)).size();
+      progress.setValue(static_cast<int> (done / 1024));
+    }
+
+  m_progress = 0;
+  progress.close();
+  return ok;
+}
+
+/*
+** -- deliver() --
+*/
+
+bool biblioteq_attachments::deliver(const QByteArray &chunk)
+{
+  QMutexLocker locker(&m_mutex);
+
+  while(!m_canceled && m_chunks.size() >= QUEUE_SIZE)
+    m_condition.wait(&m_mutex);
+
+  if(m_canceled)
+    return false;
+
+  m_chunks.append(chunk);
+  locker.unlock();
+  QMetaObject::invokeMethod(this, "slotProgressed", Qt::QueuedConnection);
+  return true;
+}
+
+/*
+** -- exportFiles() --
+*/
+
+bool biblioteq_attachments::exportFiles(const QStringList &myoids,
+					const QString &itemType,
+					const QString &itemOid,
+					const QString &directory,
+					QString &errorstr)
+{
+  errorstr = "";
+
+  QProgressDialog progress(m_parent);
+
+#ifdef Q_OS_MAC
+#if QT_VERSION < 0x050000
+  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
+#endif
+#endif
+  progress.setLabelText(tr("Exporting file(s)..."));
+  progress.setMaximum(myoids.size());
+  progress.setMinimum(0);
+  progress.setModal(true);
+  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
+  progress.show();
+#ifndef Q_OS_MAC
+  progress.repaint();
+  QApplication::processEvents();
+#endif
+
+  QSqlQuery chunks(qmain->getDB());
+  QSqlQuery query(qmain->getDB());
+
+  chunks.setForwardOnly(true);
+  query.setForwardOnly(true);
+
+  for(int i = 0; i < myoids.size() && !progress.wasCanceled(); i++)
+    {
+      query.prepare(QString("SELECT file_digest, file_name, LENGTH(file) "
+			    "FROM %1_files "
+			    "WHERE item_oid = ? AND myoid = ?").arg(itemType));
+      query.bindValue(0, itemOid);
+      query.bindValue(1, myoids.at(i));
+
+      if(!query.exec() || !query.next())
+	continue;
+
+      QFile file(directory + QDir::separator() + query.value(1).toString());
+      QString digest(query.value(0).toString());
+      qint64 length = query.value(2).toLongLong();
+
+      if(!file.open(QIODevice::Truncate | QIODevice::WriteOnly))
+	continue;
+
+      progress.setLabelText
+	(tr("Exporting %1...").arg(query.value(1).toString()));
+
+      if(length > 0)
+	{
+	  /*
+	  ** The file was stored before it could be divided
+	  ** into chunks.
+	  */
+
+	  query.prepare(QString("SELECT file FROM %1_files "
+				"WHERE item_oid = ? AND myoid = ?").
+			arg(itemType));
+	  query.bindValue(0, itemOid);
+	  query.bindValue(1, myoids.at(i));
+
+	  if(query.exec() && query.next())
+	    file.write(qUncompress(query.value(0).toByteArray()));
+	}
+      else
+	{
+	  chunks.prepare("SELECT chunk FROM file_chunks "
+			 "WHERE file_digest = ? AND chunk_number = ?");
+
+	  for(int j = 0; !progress.wasCanceled(); j++)
+	    {
+	      chunks.bindValue(0, digest);
+	      chunks.bindValue(1, j);
+
+	      if(!chunks.exec())
+		{
+		  errorstr = chunks.lastError().text();
+		  break;
+		}
+
+	      if(!chunks.next())
+		break;
+
+	      QByteArray bytes(qUncompress(chunks.value(0).toByteArray()));
+
+	      if(file.write(bytes) != static_cast<qint64> (bytes.size()))
+		{
+		  errorstr = file.errorString();
+		  break;
+		}
+
+	      QApplication::processEvents();
+	    }
+	}
+
+      file.close();
+
+      if(!errorstr.isEmpty() || progress.wasCanceled())
+	{
+	  file.remove();
+	  break;
+	}
+
+      progress.setValue(i + 1);
+#ifndef Q_OS_MAC
+      progress.repaint();
+      QApplication::processEvents();
+#endif
+    }
+
+  bool canceled = progress.wasCanceled();
+
+  progress.close();
+  return errorstr.isEmpty() && !canceled;
+}
+
+/*
+** -- finish() --
+*/
+
+void biblioteq_attachments::finish(const bool ok, const QByteArray &digest)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_digest = digest;
+  m_finished = true;
+  m_ok = ok;
+  locker.unlock();
+  QMetaObject::invokeMethod(this, "slotProgressed", Qt::QueuedConnection);
+}
+
+/*
+** -- purge() --
+*/
+
+bool biblioteq_attachments::purge(QString &errorstr)
+{
+  /*
+  ** Removes the chunks of files which are no longer attached
+  ** to any item.
+  */
+
+  QSqlQuery query(qmain->getDB());
+
+  errorstr = "";
+
+  if(!query.exec("DELETE FROM file_chunks WHERE file_digest NOT IN "
+		 "(SELECT file_digest FROM book_files UNION "
+		 "SELECT file_digest FROM journal_files UNION "
+		 "SELECT file_digest FROM magazine_files)"))
+    {
+      errorstr = query.lastError().text();
+      return false;
+    }
+
+  return true;
+}
+
+/*
+** -- sizeColumn() --
+*/
+
+QString biblioteq_attachments::sizeColumn(const QString &itemType)
+{
+  /*
+  ** The stored, that is, compressed, size of an attachment.
+  */
+
+  return QString("(LENGTH(%1_files.file) + "
+		 "COALESCE((SELECT SUM(LENGTH(chunk)) FROM file_chunks "
+		 "WHERE file_chunks.file_digest = %1_files.file_digest), 0))").
+    arg(itemType);
+}
+
+/*
+** -- slotProgressed() --
+*/
+
+void biblioteq_attachments::slotProgressed(void)
+{
+  emit progressed();
+}
+
+/*
+** -- start() --
+*/
+
+void biblioteq_attachments::start(const QString &fileName,
+				  const bool compress)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_canceled = false;
+  m_chunks.clear();
+  m_digest.clear();
+  m_finished = false;
+  m_ok = false;
+  locker.unlock();
+
+  biblioteq_attachments_task *task = 0;
+
+  if((task = new(std::nothrow)
+      biblioteq_attachments_task(this, fileName, compress)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  m_pool->start(task);
+}
+
+/*
+** -- stop() --
+*/
+
+void biblioteq_attachments::stop(void)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_canceled = true;
+  m_condition.wakeAll();
+  locker.unlock();
+  m_pool->waitForDone();
+}
+
+/*
+** -- store() --
+*/
+
+bool biblioteq_attachments::store(const QString &fileName,
+				  const QString &itemType,
+				  const QString &itemOid,
+				  const qint64 done,
+				  QString &errorstr)
+{
+  QFileInfo fileInfo(fileName);
+
+  if(fileInfo.size() <= 0)
+    return true;
+
+  m_progress->setLabelText(tr("Digesting %1...").arg(fileInfo.fileName()));
+  start(fileName, false);
+
+  if(!wait())
+    {
+      stop();
+      return false;
+    }
+
+  m_pool->waitForDone();
+
+  if(!m_ok)
+    return true; // Unreadable files are ignored.
+
+  QSqlDatabase db(qmain->getDB());
+  QSqlQuery query(db);
+  QString digest(m_digest.toHex());
+  bool stored = false;
+
+  query.setForwardOnly(true);
+  query.prepare(QString("SELECT COUNT(*) FROM %1_files "
+			"WHERE file_digest = ? AND item_oid = ?").
+		arg(itemType));
+  query.bindValue(0, digest);
+  query.bindValue(1, itemOid);
+
+  if(query.exec() && query.next() && query.value(0).toLongLong() > 0)
+    return true; // The file is already attached to the item.
+
+  query.prepare("SELECT COUNT(*) FROM file_chunks WHERE file_digest = ?");
+  query.bindValue(0, digest);
+
+  if(query.exec() && query.next())
+    stored = query.value(0).toLongLong() > 0;
+
+  if(!db.transaction())
+    {
+      errorstr = db.lastError().text();
+      return false;
+    }
+
+  if(db.driverName() != "QSQLITE")
+    query.prepare(QString("INSERT INTO %1_files "
+			  "(file, file_digest, file_name, item_oid) "
+			  "VALUES (?, ?, ?, ?)").arg(itemType));
+  else
+    query.prepare(QString("INSERT INTO %1_files "
+			  "(file, file_digest, file_name, item_oid, myoid) "
+			  "VALUES (?, ?, ?, ?, ?)").arg(itemType));
+
+  query.bindValue(0, QByteArray(""));
+  query.bindValue(1, digest);
+  query.bindValue(2, fileInfo.fileName());
+  query.bindValue(3, itemOid);
+
+  if(db.driverName() == "QSQLITE")
+    {
+      qint64 value = biblioteq_misc_functions::getSqliteUniqueId
+	(db, errorstr);
+
+      if(!errorstr.isEmpty())
+	{
+	  db.rollback();
+	  return false;
+	}
+
+      query.bindValue(4, value);
+    }
+
+  if(!query.exec())
+    {
+      errorstr = query.lastError().text();
+      db.rollback();
+      return false;
+    }
+
+  if(!stored)
+    {
+      /*
+      ** The chunks are inserted as they are compressed.
+      */
+
+      m_progress->setLabelText(tr("Storing %1...").arg(fileInfo.fileName()));
+      query.prepare("INSERT INTO file_chunks "
+		    "(chunk, chunk_number, file_digest) "
+		    "VALUES (?, ?, ?)");
+      start(fileName, true);
+
+      int number = 0;
+
+      while(true)
+	{
+	  if(!wait())
+	    {
+	      stop();
+	      db.rollback();
+	      return false;
+	    }
+
+	  QList<QByteArray> chunks;
+	  bool finished = false;
+
+	  {
+	    QMutexLocker locker(&m_mutex);
+
+	    chunks = m_chunks;
+	    finished = m_finished;
+	    m_chunks.clear();
+	    m_condition.wakeAll();
+	  }
+
+	  for(int i = 0; i < chunks.size(); i++)
+	    {
+	      query.bindValue(0, chunks.at(i));
+	      query.bindValue(1, number);
+	      query.bindValue(2, digest);
+
+	      if(!query.exec())
+		{
+		  errorstr = query.lastError().text();
+		  stop();
+		  db.rollback();
+		  return false;
+		}
+
+	      number += 1;
+	    }
+
+	  m_progress->setValue
+	    (static_cast<int> ((done + qMin(fileInfo.size(),
+					    static_cast<qint64> (number) *
+					    CHUNK_SIZE)) / 1024));
+
+	  if(finished)
+	    break;
+	}
+
+      m_pool->waitForDone();
+
+      if(!m_ok)
+	{
+	  /*
+	  ** The file could not be read completely.
+	  */
+
+	  db.rollback();
+	  return true;
+	}
+    }
+
+  if(!db.commit())
+    {
+      errorstr = db.lastError().text();
+      db.rollback();
+      return false;
+    }
+
+  return true;
+}
+
+/*
+** -- wait() --
+*/
+
+bool biblioteq_attachments::wait(void)
+{
+  /*
+  ** Returns false if the process was canceled.
+  */
+
+  QEventLoop loop;
+  QTimer timer;
+
+  connect(m_progress, SIGNAL(canceled(void)), &loop, SLOT(quit(void)));
+  connect(&timer, SIGNAL(timeout(void)), &loop, SLOT(quit(void)));
+  connect(this, SIGNAL(progressed(void)), &loop, SLOT(quit(void)));
+  timer.start(100);
+
+  while(!m_progress->wasCanceled())
+    {
+      {
+	QMutexLocker locker(&m_mutex);
+
+	if(m_finished || !m_chunks.isEmpty())
+	  return true;
+      }
+
+      loop.exec();
+    }
+
+  return false;
+}
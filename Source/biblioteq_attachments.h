@@ -0,0 +1,80 @@
+#ifndef _BIBLIOTEQ_ATTACHMENTS_H_
+#define _BIBLIOTEQ_ATTACHMENTS_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QWaitCondition>
+
+class QProgressDialog;
+class QThreadPool;
+class QWidget;
+class biblioteq_attachments_task;
+
+/*
+** Stores and exports the files which are attached to books, journals
+** and magazines. A file's contents are kept in the file_chunks table
+** as compressed chunks, keyed by the file's digest, and are shared by
+** every item to which the file is attached. Files are digested and
+** compressed on a separate thread. Only a bounded number of chunks
+** are held in memory.
+*/
+
+class biblioteq_attachments: public QObject
+{
+  Q_OBJECT
+
+ public:
+  static const int CHUNK_SIZE = 1024 * 1024;
+  static const int QUEUE_SIZE = 8;
+  biblioteq_attachments(QWidget *parent);
+  ~biblioteq_attachments();
+  static QString sizeColumn(const QString &itemType);
+  static bool purge(QString &errorstr);
+  bool attach(const QStringList &fileNames,
+	      const QString &itemType,
+	      const QString &itemOid,
+	      QString &errorstr);
+  bool exportFiles(const QStringList &myoids,
+		   const QString &itemType,
+		   const QString &itemOid,
+		   const QString &directory,
+		   QString &errorstr);
+
+ private:
+  QByteArray m_digest;
+  QList<QByteArray> m_chunks;
+  QMutex m_mutex;
+  QProgressDialog *m_progress;
+  QThreadPool *m_pool;
+  QWaitCondition m_condition;
+  QWidget *m_parent;
+  bool m_canceled;
+  bool m_finished;
+  bool m_ok;
+  friend class biblioteq_attachments_task;
+  bool deliver(const QByteArray &chunk);
+  bool store(const QString &fileName,
+	     const QString &itemType,
+	     const QString &itemOid,
+	     const qint64 done,
+	     QString &errorstr);
+  bool wait(void);
+  void finish(const bool ok, const QByteArray &digest);
+  void start(const QString &fileName, const bool compress);
+  void stop(void);
+
+ private slots:
+  void slotProgressed(void);
+
+ signals:
+  void progressed(void);
+};
+
+#endif
@@ -2,8 +2,11 @@
 ** -- Qt Includes --
 */
 
+#include <QEventLoop>
+#include <QRegExp>
 #include <QSettings>
 #include <QSqlRecord>
+#include <QTimer>
 #include <QtDebug>
 
 /*
@@ -18,6 +21,7 @@
 
 #include "biblioteq.h"
 #include "biblioteq_graphicsitempixmap.h"
+#include "biblioteq_query_thread.h"
 
 /*
 ** -- populateTable() --
@@ -38,7 +42,6 @@ int biblioteq::populateTable(const int search_type_arg,
   QString type = "";
   QStringList tmplist; // Used for custom queries.
   QStringList types;
-  QTableWidgetItem *item = 0;
   int i = -1;
   int search_type = search_type_arg;
 
@@ -127,10 +130,10 @@ int biblioteq::populateTable(const int search_type_arg,
 
 	    if(typefilter == "All Available")
 	      checkAvailability =
-		" HAVING (quantity - COUNT(item_borrower_vw.item_oid)) > 0 ";
+		" WHERE quantity - COALESCE(irc.total_reserved, 0) > 0 ";
 
 	    searchstr = QString
-	      ("SELECT DISTINCT book.title, "
+	      ("SELECT book.title, "
 	       "book.id, "
 	       "book.publisher, book.pdate, "
 	       "book.category, "
@@ -138,30 +141,18 @@ int biblioteq::populateTable(const int search_type_arg,
 	       "book.price, book.monetary_units, "
 	       "book.quantity, "
 	       "book.location, "
-	       "book.quantity - COUNT(item_borrower_vw.item_oid) "
+	       "book.quantity - COALESCE(irc.total_reserved, 0) "
 	       "AS availability, "
-	       "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	       "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	       "book.type, "
-	       "book.myoid, "
-	       "book.front_cover "
+	       "book.myoid "
 	       "FROM "
-	       "book LEFT JOIN item_borrower_vw ON "
-	       "book.myoid = item_borrower_vw.item_oid "
-	       "AND item_borrower_vw.type = 'Book' "
-	       "GROUP BY book.title, "
-	       "book.id, "
-	       "book.publisher, book.pdate, "
-	       "book.category, "
-	       "book.language, "
-	       "book.price, book.monetary_units, "
-	       "book.quantity, "
-	       "book.location, "
-	       "book.type, "
-	       "book.myoid, "
-	       "book.front_cover "
+	       "book LEFT JOIN item_reservation_counts irc ON "
+	       "book.myoid = irc.item_oid "
+	       "AND irc.type = 'Book' "
 	       " %1 "
-	       "UNION "
-	       "SELECT DISTINCT cd.title, "
+	       "UNION ALL "
+	       "SELECT cd.title, "
 	       "cd.id, "
 	       "cd.recording_label, cd.rdate, "
 	       "cd.category, "
@@ -169,30 +160,18 @@ int biblioteq::populateTable(const int search_type_arg,
 	       "cd.price, cd.monetary_units, "
 	       "cd.quantity, "
 	       "cd.location, "
-	       "cd.quantity - COUNT(item_borrower_vw.item_oid) "
+	       "cd.quantity - COALESCE(irc.total_reserved, 0) "
 	       "AS availability, "
-	       "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	       "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	       "cd.type, "
-	       "cd.myoid, "
-	       "cd.front_cover "
+	       "cd.myoid "
 	       "FROM "
-	       "cd LEFT JOIN item_borrower_vw ON "
-	       "cd.myoid = item_borrower_vw.item_oid "
-	       "AND item_borrower_vw.type = 'CD' "
-	       "GROUP BY cd.title, "
-	       "cd.id, "
-	       "cd.recording_label, cd.rdate, "
-	       "cd.category, "
-	       "cd.language, "
-	       "cd.price, cd.monetary_units, "
-	       "cd.quantity, "
-	       "cd.location, "
-	       "cd.type, "
-	       "cd.myoid, "
-	       "cd.front_cover "
+	       "cd LEFT JOIN item_reservation_counts irc ON "
+	       "cd.myoid = irc.item_oid "
+	       "AND irc.type = 'CD' "
 	       " %1 "
-	       "UNION "
-	       "SELECT DISTINCT dvd.title, "
+	       "UNION ALL "
+	       "SELECT dvd.title, "
 	       "dvd.id, "
 	       "dvd.studio, dvd.rdate, "
 	       "dvd.category, "
@@ -200,30 +179,18 @@ int biblioteq::populateTable(const int search_type_arg,
 	       "dvd.price, dvd.monetary_units, "
 	       "dvd.quantity, "
 	       "dvd.location, "
-	       "dvd.quantity - COUNT(item_borrower_vw.item_oid) AS "
+	       "dvd.quantity - COALESCE(irc.total_reserved, 0) AS "
 	       "availability, "
-	       "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	       "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	       "dvd.type, "
-	       "dvd.myoid, "
-	       "dvd.front_cover "
+	       "dvd.myoid "
 	       "FROM "
-	       "dvd LEFT JOIN item_borrower_vw ON "
-	       "dvd.myoid = item_borrower_vw.item_oid "
-	       "AND item_borrower_vw.type = 'DVD' "
-	       "GROUP BY dvd.title, "
-	       "dvd.id, "
-	       "dvd.studio, dvd.rdate, "
-	       "dvd.category, "
-	       "dvd.language, "
-	       "dvd.price, dvd.monetary_units, "
-	       "dvd.quantity, "
-	       "dvd.location, "
-	       "dvd.type, "
-	       "dvd.myoid, "
-	       "dvd.front_cover "
+	       "dvd LEFT JOIN item_reservation_counts irc ON "
+	       "dvd.myoid = irc.item_oid "
+	       "AND irc.type = 'DVD' "
 	       " %1 "
-	       "UNION "
-	       "SELECT DISTINCT journal.title, "
+	       "UNION ALL "
+	       "SELECT journal.title, "
 	       "journal.id, "
 	       "journal.publisher, journal.pdate, "
 	       "journal.category, "
@@ -231,30 +198,18 @@ int biblioteq::populateTable(const int search_type_arg,
 	       "journal.price, journal.monetary_units, "
 	       "journal.quantity, "
 	       "journal.location, "
-	       "journal.quantity - COUNT(item_borrower_vw.item_oid) AS "
+	       "journal.quantity - COALESCE(irc.total_reserved, 0) AS "
 	       "availability, "
-	       "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	       "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	       "journal.type, "
-	       "journal.myoid, "
-	       "journal.front_cover "
+	       "journal.myoid "
 	       "FROM "
-	       "journal LEFT JOIN item_borrower_vw ON "
-	       "journal.myoid = item_borrower_vw.item_oid "
-	       "AND item_borrower_vw.type = journal.type "
-	       "GROUP BY journal.title, "
-	       "journal.id, "
-	       "journal.publisher, journal.pdate, "
-	       "journal.category, "
-	       "journal.language, "
-	       "journal.price, journal.monetary_units, "
-	       "journal.quantity, "
-	       "journal.location, "
-	       "journal.type, "
-	       "journal.myoid, "
-	       "journal.front_cover "
+	       "journal LEFT JOIN item_reservation_counts irc ON "
+	       "journal.myoid = irc.item_oid "
+	       "AND irc.type = journal.type "
 	       " %1 "
-	       "UNION "
-	       "SELECT DISTINCT magazine.title, "
+	       "UNION ALL "
+	       "SELECT magazine.title, "
 	       "magazine.id, "
 	       "magazine.publisher, magazine.pdate, "
 	       "magazine.category, "
@@ -262,30 +217,18 @@ int biblioteq::populateTable(const int search_type_arg,
 	       "magazine.price, magazine.monetary_units, "
 	       "magazine.quantity, "
 	       "magazine.location, "
-	       "magazine.quantity - COUNT(item_borrower_vw.item_oid) AS "
+	       "magazine.quantity - COALESCE(irc.total_reserved, 0) AS "
 	       "availability, "
-	       "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	       "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	       "magazine.type, "
-	       "magazine.myoid, "
-	       "magazine.front_cover "
+	       "magazine.myoid "
 	       "FROM "
-	       "magazine LEFT JOIN item_borrower_vw ON "
-	       "magazine.myoid = item_borrower_vw.item_oid "
-	       "AND item_borrower_vw.type = magazine.type "
-	       "GROUP BY magazine.title, "
-	       "magazine.id, "
-	       "magazine.publisher, magazine.pdate, "
-	       "magazine.category, "
-	       "magazine.language, "
-	       "magazine.price, magazine.monetary_units, "
-	       "magazine.quantity, "
-	       "magazine.location, "
-	       "magazine.type, "
-	       "magazine.myoid, "
-	       "magazine.front_cover "
+	       "magazine LEFT JOIN item_reservation_counts irc ON "
+	       "magazine.myoid = irc.item_oid "
+	       "AND irc.type = magazine.type "
 	       " %1 "
-	       "UNION "
-	       "SELECT DISTINCT photograph_collection.title, "
+	       "UNION ALL "
+	       "SELECT photograph_collection.title, "
 	       "photograph_collection.id, "
 	       "'', '', "
 	       "'', "
@@ -296,18 +239,10 @@ int biblioteq::populateTable(const int search_type_arg,
 	       "0 AS availability, "
 	       "0 AS total_reserved, "
 	       "photograph_collection.type, "
-	       "photograph_collection.myoid, "
-	       "photograph_collection.image_scaled "
+	       "photograph_collection.myoid "
 	       "FROM photograph_collection "
-	       "GROUP BY "
-	       "photograph_collection.title, "
-	       "photograph_collection.id, "
-	       "photograph_collection.location, "
-	       "photograph_collection.type, "
-	       "photograph_collection.myoid, "
-	       "photograph_collection.image_scaled "
-	       "UNION "
-	       "SELECT DISTINCT videogame.title, "
+	       "UNION ALL "
+	       "SELECT videogame.title, "
 	       "videogame.id, "
 	       "videogame.publisher, videogame.rdate, "
 	       "videogame.genre, "
@@ -315,28 +250,16 @@ int biblioteq::populateTable(const int search_type_arg,
 	       "videogame.price, videogame.monetary_units, "
 	       "videogame.quantity, "
 	       "videogame.location, "
-	       "videogame.quantity - COUNT(item_borrower_vw.item_oid) "
+	       "videogame.quantity - COALESCE(irc.total_reserved, 0) "
 	       "AS "
 	       "availability, "
-	       "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	       "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	       "videogame.type, "
-	       "videogame.myoid, "
-	       "videogame.front_cover "
+	       "videogame.myoid "
 	       "FROM "
-	       "videogame LEFT JOIN item_borrower_vw ON "
-	       "videogame.myoid = item_borrower_vw.item_oid "
-	       "AND item_borrower_vw.type = 'Video Game' "
-	       "GROUP BY videogame.title, "
-	       "videogame.id, "
-	       "videogame.publisher, videogame.rdate, "
-	       "videogame.genre, "
-	       "videogame.language, "
-	       "videogame.price, videogame.monetary_units, "
-	       "videogame.quantity, "
-	       "videogame.location, "
-	       "videogame.type, "
-	       "videogame.myoid, "
-	       "videogame.front_cover "
+	       "videogame LEFT JOIN item_reservation_counts irc ON "
+	       "videogame.myoid = irc.item_oid "
+	       "AND irc.type = 'Video Game' "
 	       " %1 "
 	       "ORDER BY 1").arg(checkAvailability) +
 	      limitStr + offsetStr;
@@ -365,8 +288,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover "
+				 "book.myoid "
 				 "FROM "
 				 "book LEFT JOIN item_borrower_vw ON "
 				 "book.myoid = item_borrower_vw.item_oid "
@@ -375,11 +297,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "item_borrower_vw.memberid = '");
 		searchstr.append(searchstrArg);
 		searchstr.append("' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower_vw.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower_vw.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' ");
 		searchstr.append("GROUP BY "
 				 "item_borrower_vw.copyid, "
@@ -394,8 +313,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "book.quantity, "
 				 "book.location, "
 				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover ");
+				 "book.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -415,8 +333,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover "
+				 "cd.myoid "
 				 "FROM "
 				 "cd LEFT JOIN item_borrower_vw ON "
 				 "cd.myoid = item_borrower_vw.item_oid "
@@ -425,11 +342,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "item_borrower_vw.memberid = '");
 		searchstr.append(searchstrArg);
 		searchstr.append("' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower_vw.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower_vw.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' ");
 		searchstr.append("GROUP BY "
 				 "item_borrower_vw.copyid, "
@@ -444,8 +358,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "cd.quantity, "
 				 "cd.location, "
 				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover ");
+				 "cd.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -465,8 +378,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover "
+				 "dvd.myoid "
 				 "FROM "
 				 "dvd LEFT JOIN item_borrower_vw ON "
 				 "dvd.myoid = item_borrower_vw.item_oid "
@@ -475,11 +387,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "item_borrower_vw.memberid = '");
 		searchstr.append(searchstrArg);
 		searchstr.append("' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower_vw.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower_vw.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' ");
 		searchstr.append("GROUP BY "
 				 "item_borrower_vw.copyid, "
@@ -494,8 +403,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "dvd.quantity, "
 				 "dvd.location, "
 				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover ");
+				 "dvd.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -515,8 +423,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover "
+				 "journal.myoid "
 				 "FROM "
 				 "journal LEFT JOIN item_borrower_vw ON "
 				 "journal.myoid = item_borrower_vw.item_oid "
@@ -525,11 +432,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "item_borrower_vw.memberid = '");
 		searchstr.append(searchstrArg);
 		searchstr.append("' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower_vw.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower_vw.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' ");
 		searchstr.append("GROUP BY "
 				 "item_borrower_vw.copyid, "
@@ -544,8 +448,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "journal.quantity, "
 				 "journal.location, "
 				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover ");
+				 "journal.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -565,8 +468,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover "
+				 "magazine.myoid "
 				 "FROM "
 				 "magazine LEFT JOIN item_borrower_vw ON "
 				 "magazine.myoid = item_borrower_vw.item_oid "
@@ -575,11 +477,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "item_borrower_vw.memberid = '");
 		searchstr.append(searchstrArg);
 		searchstr.append("' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower_vw.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower_vw.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' ");
 		searchstr.append("GROUP BY "
 				 "item_borrower_vw.copyid, "
@@ -594,8 +493,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "magazine.quantity, "
 				 "magazine.location, "
 				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover ");
+				 "magazine.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -615,8 +513,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover "
+				 "videogame.myoid "
 				 "FROM "
 				 "videogame LEFT JOIN item_borrower_vw ON "
 				 "videogame.myoid = "
@@ -626,11 +523,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "item_borrower_vw.memberid = '");
 		searchstr.append(searchstrArg);
 		searchstr.append("' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower_vw.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower_vw.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower_vw.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' ");
 		searchstr.append("GROUP BY "
 				 "item_borrower_vw.copyid, "
@@ -645,8 +539,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "videogame.quantity, "
 				 "videogame.location, "
 				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover ");
+				 "videogame.myoid ");
 		searchstr.append("ORDER BY 1");
 		searchstr.append(limitStr + offsetStr);
 	      }
@@ -673,8 +566,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover "
+				 "book.myoid "
 				 "FROM "
 				 "member, "
 				 "book LEFT JOIN item_borrower ON "
@@ -684,11 +576,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "member.memberid LIKE '%");
 		searchstr.append(searchstrArg);
 		searchstr.append("%' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' AND ");
 		searchstr.append("item_borrower.memberid = member.memberid ");
 		searchstr.append("GROUP BY "
@@ -706,8 +595,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "book.quantity, "
 				 "book.location, "
 				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover ");
+				 "book.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -730,8 +618,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover "
+				 "cd.myoid "
 				 "FROM "
 				 "member, "
 				 "cd LEFT JOIN item_borrower ON "
@@ -741,11 +628,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "member.memberid LIKE '%");
 		searchstr.append(searchstrArg);
 		searchstr.append("%' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' AND ");
 		searchstr.append("item_borrower.memberid = member.memberid ");
 		searchstr.append("GROUP BY "
@@ -763,8 +647,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "cd.quantity, "
 				 "cd.location, "
 				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover ");
+				 "cd.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -787,8 +670,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover "
+				 "dvd.myoid "
 				 "FROM "
 				 "member, "
 				 "dvd LEFT JOIN item_borrower ON "
@@ -798,11 +680,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "member.memberid LIKE '%");
 		searchstr.append(searchstrArg);
 		searchstr.append("%' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' AND ");
 		searchstr.append("item_borrower.memberid = member.memberid ");
 		searchstr.append("GROUP BY "
@@ -820,8 +699,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "dvd.quantity, "
 				 "dvd.location, "
 				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover ");
+				 "dvd.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -844,8 +722,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover "
+				 "journal.myoid "
 				 "FROM "
 				 "member, "
 				 "journal LEFT JOIN item_borrower ON "
@@ -855,11 +732,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "member.memberid LIKE '%");
 		searchstr.append(searchstrArg);
 		searchstr.append("%' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' AND ");
 		searchstr.append("item_borrower.memberid = "
 				 "member.memberid ");
@@ -878,8 +752,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "journal.quantity, "
 				 "journal.location, "
 				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover ");
+				 "journal.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -902,8 +775,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover "
+				 "magazine.myoid "
 				 "FROM "
 				 "member, "
 				 "magazine LEFT JOIN item_borrower ON "
@@ -913,11 +785,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "member.memberid LIKE '%");
 		searchstr.append(searchstrArg);
 		searchstr.append("%' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' AND ");
 		searchstr.append("item_borrower.memberid = "
 				 "member.memberid ");
@@ -936,8 +805,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "magazine.quantity, "
 				 "magazine.location, "
 				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover ");
+				 "magazine.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -960,8 +828,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover "
+				 "videogame.myoid "
 				 "FROM "
 				 "member, "
 				 "videogame LEFT JOIN item_borrower ON "
@@ -972,11 +839,8 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "member.memberid LIKE '%");
 		searchstr.append(searchstrArg);
 		searchstr.append("%' AND ");
-		searchstr.append
-		  ("SUBSTR(item_borrower.duedate, 7, 4) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 1, 2) || '/' || "
-		   "SUBSTR(item_borrower.duedate, 4, 2) < '");
-		searchstr.append(now.toString("yyyy/MM/dd"));
+		searchstr.append("item_borrower.duedate < '");
+		searchstr.append(now.toString(Qt::ISODate));
 		searchstr.append("' AND ");
 		searchstr.append("item_borrower.memberid = "
 				 "member.memberid ");
@@ -995,8 +859,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "videogame.quantity, "
 				 "videogame.location, "
 				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover ");
+				 "videogame.myoid ");
 		searchstr.append("ORDER BY 1");
 		searchstr.append(limitStr + offsetStr);
 	      }
@@ -1019,8 +882,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "book.location, "
 				 "book.type, "
 				 "book.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "book.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "book LEFT JOIN item_request ON "
 				 "book.myoid = item_request.item_oid "
@@ -1041,8 +903,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "book.location, "
 				 "book.type, "
 				 "book.myoid, "
-				 "item_request.myoid, "
-				 "book.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_request.requestdate, "
@@ -1056,8 +917,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "cd.location, "
 				 "cd.type, "
 				 "cd.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "cd.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "cd LEFT JOIN item_request ON "
 				 "cd.myoid = item_request.item_oid "
@@ -1078,8 +938,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "cd.location, "
 				 "cd.type, "
 				 "cd.myoid, "
-				 "item_request.myoid, "
-				 "cd.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_request.requestdate, "
@@ -1093,8 +952,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "dvd.location, "
 				 "dvd.type, "
 				 "dvd.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "dvd.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "dvd LEFT JOIN item_request ON "
 				 "dvd.myoid = item_request.item_oid "
@@ -1115,8 +973,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "dvd.location, "
 				 "dvd.type, "
 				 "dvd.myoid, "
-				 "item_request.myoid, "
-				 "dvd.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_request.requestdate, "
@@ -1130,8 +987,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "journal.location, "
 				 "journal.type, "
 				 "journal.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "journal.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "journal LEFT JOIN item_request ON "
 				 "journal.myoid = "
@@ -1153,8 +1009,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "journal.location, "
 				 "journal.type, "
 				 "journal.myoid, "
-				 "item_request.myoid, "
-				 "journal.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_request.requestdate, "
@@ -1168,8 +1023,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "magazine.location, "
 				 "magazine.type, "
 				 "magazine.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "magazine.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "magazine LEFT JOIN item_request ON "
 				 "magazine.myoid = "
@@ -1191,8 +1045,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "magazine.location, "
 				 "magazine.type, "
 				 "magazine.myoid, "
-				 "item_request.myoid, "
-				 "magazine.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_request.requestdate, "
@@ -1206,8 +1059,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "videogame.location, "
 				 "videogame.type, "
 				 "videogame.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "videogame.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "videogame LEFT JOIN item_request ON "
 				 "videogame.myoid = "
@@ -1229,8 +1081,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "videogame.location, "
 				 "videogame.type, "
 				 "videogame.myoid, "
-				 "item_request.myoid, "
-				 "videogame.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("ORDER BY 1");
 		searchstr.append(limitStr + offsetStr);
 	      }
@@ -1251,8 +1102,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "book.location, "
 				 "book.type, "
 				 "book.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "book.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "member, "
 				 "book LEFT JOIN item_request ON "
@@ -1275,8 +1125,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "book.location, "
 				 "book.type, "
 				 "book.myoid, "
-				 "item_request.myoid, "
-				 "book.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -1293,8 +1142,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "cd.location, "
 				 "cd.type, "
 				 "cd.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "cd.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "member, "
 				 "cd LEFT JOIN item_request ON "
@@ -1317,8 +1165,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "cd.location, "
 				 "cd.type, "
 				 "cd.myoid, "
-				 "item_request.myoid, "
-				 "cd.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -1335,8 +1182,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "dvd.location, "
 				 "dvd.type, "
 				 "dvd.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "dvd.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "member, "
 				 "dvd LEFT JOIN item_request ON "
@@ -1359,8 +1205,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "dvd.location, "
 				 "dvd.type, "
 				 "dvd.myoid, "
-				 "item_request.myoid, "
-				 "dvd.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -1377,8 +1222,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "journal.location, "
 				 "journal.type, "
 				 "journal.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "journal.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "member, "
 				 "journal LEFT JOIN item_request ON "
@@ -1402,8 +1246,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "journal.location, "
 				 "journal.type, "
 				 "journal.myoid, "
-				 "item_request.myoid, "
-				 "journal.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -1420,8 +1263,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "magazine.location, "
 				 "magazine.type, "
 				 "magazine.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "magazine.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "member, "
 				 "magazine LEFT JOIN item_request ON "
@@ -1445,8 +1287,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "magazine.location, "
 				 "magazine.type, "
 				 "magazine.myoid, "
-				 "item_request.myoid, "
-				 "magazine.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -1463,8 +1304,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "videogame.location, "
 				 "videogame.type, "
 				 "videogame.myoid, "
-				 "item_request.myoid AS requestoid, "
-				 "videogame.front_cover "
+				 "item_request.myoid AS requestoid "
 				 "FROM "
 				 "member, "
 				 "videogame LEFT JOIN item_request ON "
@@ -1488,8 +1328,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "videogame.location, "
 				 "videogame.type, "
 				 "videogame.myoid, "
-				 "item_request.myoid, "
-				 "videogame.front_cover ");
+				 "item_request.myoid ");
 		searchstr.append("ORDER BY 1");
 		searchstr.append(limitStr + offsetStr);
 	      }
@@ -1518,8 +1357,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover "
+				 "book.myoid "
 				 "FROM "
 				 "book LEFT JOIN item_borrower_vw ON "
 				 "book.myoid = item_borrower_vw.item_oid "
@@ -1541,8 +1379,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "book.quantity, "
 				 "book.location, "
 				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover ");
+				 "book.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -1562,8 +1399,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover "
+				 "cd.myoid "
 				 "FROM "
 				 "cd LEFT JOIN item_borrower_vw ON "
 				 "cd.myoid = item_borrower_vw.item_oid "
@@ -1585,8 +1421,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "cd.quantity, "
 				 "cd.location, "
 				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover ");
+				 "cd.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -1606,8 +1441,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover "
+				 "dvd.myoid "
 				 "FROM "
 				 "dvd LEFT JOIN item_borrower_vw ON "
 				 "dvd.myoid = item_borrower_vw.item_oid "
@@ -1629,8 +1463,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "dvd.quantity, "
 				 "dvd.location, "
 				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover ");
+				 "dvd.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -1650,8 +1483,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover "
+				 "journal.myoid "
 				 "FROM "
 				 "journal LEFT JOIN item_borrower_vw ON "
 				 "journal.myoid = "
@@ -1674,8 +1506,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "journal.quantity, "
 				 "journal.location, "
 				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover ");
+				 "journal.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -1695,8 +1526,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover "
+				 "magazine.myoid "
 				 "FROM "
 				 "magazine LEFT JOIN item_borrower_vw ON "
 				 "magazine.myoid = "
@@ -1719,8 +1549,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "magazine.quantity, "
 				 "magazine.location, "
 				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover ");
+				 "magazine.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "item_borrower_vw.copyid, "
@@ -1740,8 +1569,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower_vw.item_oid) AS "
 				 "total_reserved, "
 				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover "
+				 "videogame.myoid "
 				 "FROM "
 				 "videogame LEFT JOIN item_borrower_vw ON "
 				 "videogame.myoid = "
@@ -1764,8 +1592,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "videogame.quantity, "
 				 "videogame.location, "
 				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover ");
+				 "videogame.myoid ");
 		searchstr.append("ORDER BY 1");
 		searchstr.append(limitStr + offsetStr);
 	      }
@@ -1792,8 +1619,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover "
+				 "book.myoid "
 				 "FROM "
 				 "member, "
 				 "book LEFT JOIN item_borrower ON "
@@ -1820,8 +1646,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "book.quantity, "
 				 "book.location, "
 				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover ");
+				 "book.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -1844,8 +1669,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover "
+				 "cd.myoid "
 				 "FROM "
 				 "member, "
 				 "cd LEFT JOIN item_borrower ON "
@@ -1872,8 +1696,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "cd.quantity, "
 				 "cd.location, "
 				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover ");
+				 "cd.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -1896,8 +1719,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover "
+				 "dvd.myoid "
 				 "FROM "
 				 "member, "
 				 "dvd LEFT JOIN item_borrower ON "
@@ -1924,8 +1746,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "dvd.quantity, "
 				 "dvd.location, "
 				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover ");
+				 "dvd.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -1948,8 +1769,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover "
+				 "journal.myoid "
 				 "FROM "
 				 "member, "
 				 "journal LEFT JOIN item_borrower ON "
@@ -1977,8 +1797,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "journal.quantity, "
 				 "journal.location, "
 				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover ");
+				 "journal.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -2001,8 +1820,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover "
+				 "magazine.myoid "
 				 "FROM "
 				 "member, "
 				 "magazine LEFT JOIN item_borrower ON "
@@ -2030,8 +1848,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "magazine.quantity, "
 				 "magazine.location, "
 				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover ");
+				 "magazine.myoid ");
 		searchstr.append("UNION ");
 		searchstr.append("SELECT DISTINCT "
 				 "member.last_name || ', ' || "
@@ -2054,8 +1871,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "COUNT(item_borrower.item_oid) AS "
 				 "total_reserved, "
 				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover "
+				 "videogame.myoid "
 				 "FROM "
 				 "member, "
 				 "videogame LEFT JOIN item_borrower ON "
@@ -2083,15 +1899,14 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "videogame.quantity, "
 				 "videogame.location, "
 				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover ");
+				 "videogame.myoid ");
 		searchstr.append("ORDER BY 1");
 		searchstr.append(limitStr + offsetStr);
 	      }
 	  }
 	else if(typefilter == "Video Games")
 	  {
-	    searchstr = "SELECT DISTINCT videogame.title, "
+	    searchstr = "SELECT videogame.title, "
 	      "videogame.vgrating, "
 	      "videogame.vgplatform, "
 	      "videogame.vgmode, "
@@ -2106,41 +1921,22 @@ int biblioteq::populateTable(const int search_type_arg,
 	      "videogame.quantity, "
 	      "videogame.location, "
 	      "videogame.quantity - "
-	      "COUNT(item_borrower_vw.item_oid) "
+	      "COALESCE(irc.total_reserved, 0) "
 	      "AS availability, "
-	      "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	      "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	      "videogame.type, "
-	      "videogame.myoid, "
-	      "videogame.front_cover "
+	      "videogame.myoid "
 	      "FROM "
-	      "videogame LEFT JOIN item_borrower_vw ON "
-	      "videogame.myoid = item_borrower_vw.item_oid "
-	      "AND item_borrower_vw.type = 'Video Game' "
-	      "GROUP BY "
-	      "videogame.title, "
-	      "videogame.vgrating, "
-	      "videogame.vgplatform, "
-	      "videogame.vgmode, "
-	      "videogame.publisher, "
-	      "videogame.rdate, "
-	      "videogame.place, "
-	      "videogame.genre, "
-	      "videogame.language, "
-	      "videogame.id, "
-	      "videogame.price, "
-	      "videogame.monetary_units, "
-	      "videogame.quantity, "
-	      "videogame.location, "
-	      "videogame.type, "
-	      "videogame.myoid, "
-	      "videogame.front_cover "
+	      "videogame LEFT JOIN item_reservation_counts irc ON "
+	      "videogame.myoid = irc.item_oid "
+	      "AND irc.type = 'Video Game' "
 	      "ORDER BY "
 	      "videogame.title" +
 	      limitStr + offsetStr;
 	  }
 	else if(typefilter == "Books")
 	  {
-	    searchstr = "SELECT DISTINCT book.title, "
+	    searchstr = "SELECT book.title, "
 	      "book.author, "
 	      "book.publisher, book.pdate, book.place, "
 	      "book.edition, "
@@ -2155,45 +1951,24 @@ int biblioteq::populateTable(const int search_type_arg,
 	      "book.callnumber, "
 	      "book.deweynumber, "
 	      "book.quantity - "
-	      "COUNT(item_borrower_vw.item_oid) "
+	      "COALESCE(irc.total_reserved, 0) "
 	      "AS availability, "
-	      "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	      "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	      "book.originality, "
 	      "book.condition, "
 	      "book.type, "
-	      "book.myoid, "
-	      "book.front_cover "
+	      "book.myoid "
 	      "FROM "
-	      "book LEFT JOIN item_borrower_vw ON "
-	      "book.myoid = item_borrower_vw.item_oid "
-	      "AND item_borrower_vw.type = 'Book' "
-	      "GROUP BY "
-	      "book.title, "
-	      "book.author, "
-	      "book.publisher, book.pdate, book.place, "
-	      "book.edition, "
-	      "book.category, book.language, "
-	      "book.id, "
-	      "book.price, book.monetary_units, "
-	      "book.quantity, "
-	      "book.binding_type, "
-	      "book.location, "
-	      "book.isbn13, "
-	      "book.lccontrolnumber, "
-	      "book.callnumber, "
-	      "book.deweynumber, "
-	      "book.originality, "
-	      "book.condition, "
-	      "book.type, "
-	      "book.myoid, "
-	      "book.front_cover "
+	      "book LEFT JOIN item_reservation_counts irc ON "
+	      "book.myoid = irc.item_oid "
+	      "AND irc.type = 'Book' "
 	      "ORDER BY "
 	      "book.title" +
 	      limitStr + offsetStr;
 	  }
 	else if(typefilter == "DVDs")
 	  {
-	    searchstr = "SELECT DISTINCT dvd.title, "
+	    searchstr = "SELECT dvd.title, "
 	      "dvd.dvdformat, "
 	      "dvd.studio, "
 	      "dvd.rdate, "
@@ -2210,43 +1985,22 @@ int biblioteq::populateTable(const int search_type_arg,
 	      "dvd.dvdregion, "
 	      "dvd.dvdaspectratio, "
 	      "dvd.quantity - "
-	      "COUNT(item_borrower_vw.item_oid) "
+	      "COALESCE(irc.total_reserved, 0) "
 	      "AS availability, "
-	      "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	      "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	      "dvd.type, "
-	      "dvd.myoid, "
-	      "dvd.front_cover "
+	      "dvd.myoid "
 	      "FROM "
-	      "dvd LEFT JOIN item_borrower_vw ON "
-	      "dvd.myoid = item_borrower_vw.item_oid "
-	      "AND item_borrower_vw.type = 'DVD' "
-	      "GROUP BY "
-	      "dvd.title, "
-	      "dvd.dvdformat, "
-	      "dvd.studio, "
-	      "dvd.rdate, "
-	      "dvd.dvddiskcount, "
-	      "dvd.dvdruntime, "
-	      "dvd.category, "
-	      "dvd.language, "
-	      "dvd.id, "
-	      "dvd.price, "
-	      "dvd.monetary_units, "
-	      "dvd.quantity, "
-	      "dvd.location, "
-	      "dvd.dvdrating, "
-	      "dvd.dvdregion, "
-	      "dvd.dvdaspectratio, "
-	      "dvd.type, "
-	      "dvd.myoid, "
-	      "dvd.front_cover "
+	      "dvd LEFT JOIN item_reservation_counts irc ON "
+	      "dvd.myoid = irc.item_oid "
+	      "AND irc.type = 'DVD' "
 	      "ORDER BY "
 	      "dvd.title" +
 	      limitStr + offsetStr;
 	  }
 	else if(typefilter == "Music CDs")
 	  {
-	    searchstr = "SELECT DISTINCT cd.title, "
+	    searchstr = "SELECT cd.title, "
 	      "cd.artist, "
 	      "cd.cdformat, "
 	      "cd.recording_label, "
@@ -2262,62 +2016,32 @@ int biblioteq::populateTable(const int search_type_arg,
 	      "cd.location, "
 	      "cd.cdaudio, "
 	      "cd.cdrecording, "
-	      "cd.quantity - COUNT(item_borrower_vw.item_oid) AS "
+	      "cd.quantity - COALESCE(irc.total_reserved, 0) AS "
 	      "availability, "
-	      "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	      "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	      "cd.type, "
-	      "cd.myoid, "
-	      "cd.front_cover "
+	      "cd.myoid "
 	      "FROM "
-	      "cd LEFT JOIN item_borrower_vw ON "
-	      "cd.myoid = item_borrower_vw.item_oid "
-	      "AND item_borrower_vw.type = 'CD' "
-	      "GROUP BY "
-	      "cd.title, "
-	      "cd.artist, "
-	      "cd.cdformat, "
-	      "cd.recording_label, "
-	      "cd.rdate, "
-	      "cd.cddiskcount, "
-	      "cd.cdruntime, "
-	      "cd.category, "
-	      "cd.language, "
-	      "cd.id, "
-	      "cd.price, "
-	      "cd.monetary_units, "
-	      "cd.quantity, "
-	      "cd.location, "
-	      "cd.cdaudio, "
-	      "cd.cdrecording, "
-	      "cd.type, "
-	      "cd.myoid, "
-	      "cd.front_cover "
+	      "cd LEFT JOIN item_reservation_counts irc ON "
+	      "cd.myoid = irc.item_oid "
+	      "AND irc.type = 'CD' "
 	      "ORDER BY "
 	      "cd.title" +
 	      limitStr + offsetStr;
 	  }
 	else if(typefilter == "Photograph Collections")
 	  {
-	    searchstr = "SELECT DISTINCT photograph_collection.title, "
+	    searchstr = "SELECT photograph_collection.title, "
 	      "photograph_collection.id, "
 	      "photograph_collection.location, "
-	      "COUNT(photograph.myoid) AS photograph_count, "
+	      "(SELECT COUNT(*) FROM photograph "
+	      "WHERE photograph.collection_oid = "
+	      "photograph_collection.myoid) AS photograph_count, "
 	      "photograph_collection.about, "
 	      "photograph_collection.type, "
-	      "photograph_collection.myoid, "
-	      "photograph_collection.image_scaled "
+	      "photograph_collection.myoid "
 	      "FROM "
 	      "photograph_collection "
-	      "LEFT JOIN photograph "
-	      "ON photograph_collection.myoid = photograph.collection_oid "
-	      "GROUP BY "
-	      "photograph_collection.title, "
-	      "photograph_collection.id, "
-	      "photograph_collection.location, "
-	      "photograph_collection.about, "
-	      "photograph_collection.type, "
-	      "photograph_collection.myoid, "
-	      "photograph_collection.image_scaled "
 	      "ORDER BY "
 	      "photograph_collection.title" +
 	      limitStr + offsetStr;
@@ -2329,7 +2053,7 @@ int biblioteq::populateTable(const int search_type_arg,
 	    else
 	      type = "Magazine";
 
-	    searchstr = QString("SELECT DISTINCT %1.title, "
+	    searchstr = QString("SELECT %1.title, "
 				"%1.publisher, %1.pdate, "
 				"%1.place, "
 				"%1.issuevolume, %1.issueno, "
@@ -2342,36 +2066,19 @@ int biblioteq::populateTable(const int search_type_arg,
 				"%1.callnumber, "
 				"%1.deweynumber, "
 				"%1.quantity - "
-				"COUNT(item_borrower_vw.item_oid) AS "
+				"COALESCE(irc.total_reserved, 0) AS "
 				"availability, "
-				"COUNT(item_borrower_vw.item_oid) AS "
+				"COALESCE(irc.total_reserved, 0) AS "
 				"total_reserved, "
 				"%1.type, "
-				"%1.myoid, "
-				"%1.front_cover "
+				"%1.myoid "
 				"FROM "
-				"%1 LEFT JOIN item_borrower_vw ON "
+				"%1 LEFT JOIN item_reservation_counts irc ON "
 				"%1.myoid = "
-				"item_borrower_vw.item_oid "
-				"AND item_borrower_vw.type = %1.type "
+				"irc.item_oid "
+				"AND irc.type = %1.type "
 				"WHERE "
 				"%1.type = '%1' "
-				"GROUP BY "
-				"%1.title, "
-				"%1.publisher, %1.pdate, "
-				"%1.place, "
-				"%1.issuevolume, %1.issueno, "
-				"%1.category, %1.language, "
-				"%1.id, "
-				"%1.price, %1.monetary_units, "
-				"%1.quantity, "
-				"%1.location, "
-				"%1.lccontrolnumber, "
-				"%1.callnumber, "
-				"%1.deweynumber, "
-				"%1.type, "
-				"%1.myoid, "
-				"%1.front_cover "
 				"ORDER BY "
 				"%1.title").arg(type);
 	    searchstr += limitStr + offsetStr;
@@ -2394,12 +2101,14 @@ int biblioteq::populateTable(const int search_type_arg,
 	    types.append("Video Game");
 	    searchstr = "";
 
+	    bool fullText = biblioteq_misc_functions::hasFullTextSearch(m_db);
+
 	    while(!types.isEmpty())
 	      {
 		type = types.takeFirst();
 
 		if(type == "Photograph Collection")
-		  str = "SELECT DISTINCT photograph_collection.title, "
+		  str = "SELECT photograph_collection.title, "
 		    "photograph_collection.id, "
 		    "'', '', "
 		    "'', "
@@ -2410,14 +2119,13 @@ int biblioteq::populateTable(const int search_type_arg,
 		    "0 AS availability, "
 		    "0 AS total_reserved, "
 		    "photograph_collection.type, "
-		    "photograph_collection.myoid, "
-		    "photograph_collection.image_scaled "
+		    "photograph_collection.myoid "
 		    "FROM photograph_collection "
 		    "WHERE ";
 		else
 		  {
 		    str = QString
-		      ("SELECT DISTINCT %1.title, "
+		      ("SELECT %1.title, "
 		       "%1.id, "
 		       "%1.publisher, %1.pdate, "
 		       "%1.category, "
@@ -2426,17 +2134,16 @@ int biblioteq::populateTable(const int search_type_arg,
 		       "%1.quantity, "
 		       "%1.location, "
 		       "%1.quantity - "
-		       "COUNT(item_borrower_vw.item_oid) AS availability, "
-		       "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+		       "COALESCE(irc.total_reserved, 0) AS availability, "
+		       "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 		       "%1.type, ").
 		      arg(type.toLower().remove(" "));
-		    str += QString("%1.myoid, "
-				   "%1.front_cover "
+		    str += QString("%1.myoid "
 				   "FROM "
-				   "%1 LEFT JOIN item_borrower_vw ON "
+				   "%1 LEFT JOIN item_reservation_counts irc ON "
 				   "%1.myoid = "
-				   "item_borrower_vw.item_oid "
-				   "AND item_borrower_vw.type = '%2' "
+				   "irc.item_oid "
+				   "AND irc.type = '%2' "
 				   "WHERE ").arg(type.toLower().remove(" ")).
 		      arg(type);
 		  }
@@ -2477,7 +2184,16 @@ int biblioteq::populateTable(const int search_type_arg,
 
 		str.append(" AND ");
 
-		if(caseinsensitive)
+		QString condition("");
+
+		if(fullText)
+		  condition = biblioteq_misc_functions::
+		    getFullTextSearchCondition(m_db, type, "title",
+					       al.title->text());
+
+		if(!condition.isEmpty())
+		  str.append(condition);
+		else if(caseinsensitive)
 		  str.append
 		    ("LOWER(title) LIKE " + E + "'%" +
 		     biblioteq_myqstring::
@@ -2496,9 +2212,9 @@ int biblioteq::populateTable(const int search_type_arg,
 		    if(al.publication_date->date().toString
 		       ("MM/yyyy") != "01/7999")
 		      str.append
-			("SUBSTR(pdate, 1, 3) || SUBSTR(pdate, 7) = '" +
+			("SUBSTR(pdate, 1, 7) = '" +
 			 al.publication_date->date().toString
-			 ("MM/yyyy") + "' AND ");
+			 ("yyyy-MM") + "' AND ");
 
 		    if(caseinsensitive)
 		      str.append("LOWER(category) LIKE " + E + "'%" +
@@ -2581,7 +2297,16 @@ int biblioteq::populateTable(const int search_type_arg,
 			 escape(al.description->
 				toPlainText().trimmed()) + "%' ");
 
-		    if(caseinsensitive)
+		    condition.clear();
+
+		    if(fullText)
+		      condition = biblioteq_misc_functions::
+			getFullTextSearchCondition
+			(m_db, type, "keyword", al.keyword->toPlainText());
+
+		    if(!condition.isEmpty())
+		      str.append("AND " + condition + " ");
+		    else if(caseinsensitive)
 		      str.append("AND COALESCE(LOWER(keyword), '') LIKE " +
 				 E + "'%" +
 				 biblioteq_myqstring::escape
@@ -2613,32 +2338,7 @@ int biblioteq::populateTable(const int search_type_arg,
 			     biblioteq_myqstring::escape
 			     (al.location->currentText().trimmed()) + "' ");
 		      }
-
-		    str += QString("GROUP BY "
-				   "%1.title, "
-				   "%1.id, "
-				   "%1.publisher, %1.pdate, "
-				   "%1.category, "
-				   "%1.language, "
-				   "%1.price, "
-				   "%1.monetary_units, "
-				   "%1.quantity, "
-				   "%1.location, "
-				   "%1.keyword, "
-				   "%1.type, "
-				   "%1.myoid, "
-				   "%1.front_cover "
-				   ).arg
-		      (type.toLower().remove(" "));
 		  }
-		else
-		  str += "GROUP BY "
-		    "photograph_collection.title, "
-		    "photograph_collection.id, "
-		    "photograph_collection.location, "
-		    "photograph_collection.type, "
-		    "photograph_collection.myoid, "
-		    "photograph_collection.image_scaled ";
 
 		if(type == "CD")
 		  {
@@ -2660,8 +2360,8 @@ int biblioteq::populateTable(const int search_type_arg,
 		  {
 		    if(al.available->isChecked())
 		      str.append
-			(QString("HAVING (%1.quantity - "
-				 "COUNT(item_borrower_vw.item_oid)) > 0 ").
+			(QString("AND (%1.quantity - "
+				 "COALESCE(irc.total_reserved, 0)) > 0 ").
 			 arg(type.toLower().remove(" ")));
 		  }
 
@@ -2681,27 +2381,7 @@ int biblioteq::populateTable(const int search_type_arg,
 	    if(!searchstr.contains("ORDER BY"))
 	      {
 		searchstr.append(searchstrArg);
-		searchstr.append("GROUP BY book.title, "
-				 "book.author, "
-				 "book.publisher, book.pdate, book.place, "
-				 "book.edition, "
-				 "book.category, book.language, "
-				 "book.id, "
-				 "book.price, "
-				 "book.monetary_units, "
-				 "book.quantity, "
-				 "book.binding_type, "
-				 "book.location, "
-				 "book.isbn13, "
-				 "book.lccontrolnumber, "
-				 "book.callnumber, "
-				 "book.deweynumber, "
-				 "book.originality, "
-				 "book.condition, "
-				 "book.type, "
-				 "book.myoid, "
-				 "book.front_cover "
-				 "ORDER BY book.title");
+		searchstr.append("ORDER BY book.title");
 	      }
 
 	    if(searchstr.lastIndexOf("LIMIT") != -1)
@@ -2715,26 +2395,7 @@ int biblioteq::populateTable(const int search_type_arg,
 	    if(!searchstr.contains("ORDER BY"))
 	      {
 		searchstr.append(searchstrArg);
-		searchstr.append("GROUP BY "
-				 "videogame.title, "
-				 "videogame.vgrating, "
-				 "videogame.vgplatform, "
-				 "videogame.vgmode, "
-				 "videogame.publisher, "
-				 "videogame.rdate, "
-				 "videogame.place, "
-				 "videogame.genre, "
-				 "videogame.language, "
-				 "videogame.id, "
-				 "videogame.price, "
-				 "videogame.monetary_units, "
-				 "videogame.quantity, "
-				 "videogame.location, "
-				 "videogame.type, "
-				 "videogame.myoid, "
-				 "videogame.front_cover "
-				 "ORDER BY "
-				 "videogame.title");
+		searchstr.append("ORDER BY videogame.title");
 	      }
 
 	    if(searchstr.lastIndexOf("LIMIT") != -1)
@@ -2748,28 +2409,7 @@ int biblioteq::populateTable(const int search_type_arg,
 	    if(!searchstr.contains("ORDER BY"))
 	      {
 		searchstr.append(searchstrArg);
-		searchstr.append("GROUP BY "
-				 "cd.title, "
-				 "cd.artist, "
-				 "cd.cdformat, "
-				 "cd.recording_label, "
-				 "cd.rdate, "
-				 "cd.cddiskcount, "
-				 "cd.cdruntime, "
-				 "cd.category, "
-				 "cd.language, "
-				 "cd.id, "
-				 "cd.price, "
-				 "cd.monetary_units, "
-				 "cd.quantity, "
-				 "cd.location, "
-				 "cd.cdaudio, "
-				 "cd.cdrecording, "
-				 "cd.type, "
-				 "cd.myoid, "
-				 "cd.front_cover "
-				 "ORDER BY "
-				 "cd.title");
+		searchstr.append("ORDER BY cd.title");
 	      }
 
 	    if(searchstr.lastIndexOf("LIMIT") != -1)
@@ -2783,28 +2423,7 @@ int biblioteq::populateTable(const int search_type_arg,
 	    if(!searchstr.contains("ORDER BY"))
 	      {
 		searchstr.append(searchstrArg);
-		searchstr.append("GROUP BY "
-				 "dvd.title, "
-				 "dvd.dvdformat, "
-				 "dvd.studio, "
-				 "dvd.rdate, "
-				 "dvd.dvddiskcount, "
-				 "dvd.dvdruntime, "
-				 "dvd.category, "
-				 "dvd.language, "
-				 "dvd.id, "
-				 "dvd.price, "
-				 "dvd.monetary_units, "
-				 "dvd.quantity, "
-				 "dvd.location, "
-				 "dvd.dvdrating, "
-				 "dvd.dvdregion, "
-				 "dvd.dvdaspectratio, "
-				 "dvd.type, "
-				 "dvd.myoid, "
-				 "dvd.front_cover "
-				 "ORDER BY "
-				 "dvd.title");
+		searchstr.append("ORDER BY dvd.title");
 	      }
 
 	    if(searchstr.lastIndexOf("LIMIT") != -1)
@@ -2818,24 +2437,7 @@ int biblioteq::populateTable(const int search_type_arg,
 	    if(!searchstr.contains("ORDER BY"))
 	      {
 		searchstr.append(searchstrArg);
-		searchstr.append("GROUP BY journal.title, "
-				 "journal.publisher, journal.pdate, "
-				 "journal.place, "
-				 "journal.issuevolume, "
-				 "journal.issueno, "
-				 "journal.category, journal.language, "
-				 "journal.id, "
-				 "journal.price, "
-				 "journal.monetary_units, "
-				 "journal.quantity, "
-				 "journal.location, "
-				 "journal.lccontrolnumber, "
-				 "journal.callnumber, "
-				 "journal.deweynumber, "
-				 "journal.type, "
-				 "journal.myoid, "
-				 "journal.front_cover "
-				 "ORDER BY journal.title, "
+		searchstr.append("ORDER BY journal.title, "
 				 "journal.issuevolume, journal.issueno");
 	      }
 
@@ -2850,24 +2452,7 @@ int biblioteq::populateTable(const int search_type_arg,
 	    if(!searchstr.contains("ORDER BY"))
 	      {
 		searchstr.append(searchstrArg);
-		searchstr.append("GROUP BY magazine.title, "
-				 "magazine.publisher, magazine.pdate, "
-				 "magazine.place, "
-				 "magazine.issuevolume, "
-				 "magazine.issueno, "
-				 "magazine.category, magazine.language, "
-				 "magazine.id, "
-				 "magazine.price, "
-				 "magazine.monetary_units, "
-				 "magazine.quantity, "
-				 "magazine.location, "
-				 "magazine.lccontrolnumber, "
-				 "magazine.callnumber, "
-				 "magazine.deweynumber, "
-				 "magazine.type, "
-				 "magazine.myoid, "
-				 "magazine.front_cover "
-				 "ORDER BY magazine.title, "
+		searchstr.append("ORDER BY magazine.title, "
 				 "magazine.issuevolume, magazine.issueno");
 	      }
 
@@ -2887,8 +2472,7 @@ int biblioteq::populateTable(const int search_type_arg,
 				 "photograph_collection.location, "
 				 "photograph_collection.about, "
 				 "photograph_collection.type, "
-				 "photograph_collection.myoid, "
-				 "photograph_collection.image_scaled "
+				 "photograph_collection.myoid "
 				 "ORDER BY photograph_collection.title");
 	      }
 
@@ -2912,12 +2496,17 @@ int biblioteq::populateTable(const int search_type_arg,
 	types.append("Video Game");
 	searchstr = "";
 
+	bool fullText = false;
+
+	if(ui.searchType->currentIndex() >= 2)
+	  fullText = biblioteq_misc_functions::hasFullTextSearch(m_db);
+
 	while(!types.isEmpty())
 	  {
 	    type = types.takeFirst();
 
 	    if(type == "Photograph Collection")
-	      str = "SELECT DISTINCT photograph_collection.title, "
+	      str = "SELECT photograph_collection.title, "
 		"photograph_collection.id, "
 		"'', '', "
 		"'', "
@@ -2928,14 +2517,13 @@ int biblioteq::populateTable(const int search_type_arg,
 		"0 AS availability, "
 		"0 AS total_reserved, "
 		"photograph_collection.type, "
-		"photograph_collection.myoid, "
-		"photograph_collection.image_scaled "
+		"photograph_collection.myoid "
 		"FROM photograph_collection "
 		"WHERE ";
 	    else
 	      {
 		str = QString
-		  ("SELECT DISTINCT %1.title, "
+		  ("SELECT %1.title, "
 		   "%1.id, "
 		   "%1.publisher, %1.pdate, "
 		   "%1.category, "
@@ -2944,17 +2532,16 @@ int biblioteq::populateTable(const int search_type_arg,
 		   "%1.quantity, "
 		   "%1.location, "
 		   "%1.quantity - "
-		   "COUNT(item_borrower_vw.item_oid) AS availability, "
-		   "COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+		   "COALESCE(irc.total_reserved, 0) AS availability, "
+		   "COALESCE(irc.total_reserved, 0) AS total_reserved, "
 		   "%1.type, ").
 		  arg(type.toLower().remove(" "));
-		str += QString("%1.myoid, "
-			       "%1.front_cover "
+		str += QString("%1.myoid "
 			       "FROM "
-			       "%1 LEFT JOIN item_borrower_vw ON "
+			       "%1 LEFT JOIN item_reservation_counts irc ON "
 			       "%1.myoid = "
-			       "item_borrower_vw.item_oid "
-			       "AND item_borrower_vw.type = '%2' "
+			       "irc.item_oid "
+			       "AND irc.type = '%2' "
 			       "WHERE ").arg(type.toLower().remove(" ")).
 		  arg(type);
 	      }
@@ -3029,7 +2616,16 @@ int biblioteq::populateTable(const int search_type_arg,
 	      }
 	    else if(ui.searchType->currentIndex() == 2) // Keyword
 	      {
-		if(type != "Photograph Collection")
+		QString condition("");
+
+		if(fullText)
+		  condition = biblioteq_misc_functions::
+		    getFullTextSearchCondition(m_db, type, "keyword",
+					       searchstrArg);
+
+		if(!condition.isEmpty())
+		  str.append(condition + " ");
+		else if(type != "Photograph Collection")
 		  {
 		    if(ui.case_insensitive->isChecked())
 		      str.append("COALESCE(LOWER(keyword), '') LIKE " +
@@ -3062,7 +2658,16 @@ int biblioteq::populateTable(const int search_type_arg,
 	      }
 	    else // Title
 	      {
-		if(ui.case_insensitive->isChecked())
+		QString condition("");
+
+		if(fullText)
+		  condition = biblioteq_misc_functions::
+		    getFullTextSearchCondition(m_db, type, "title",
+					       searchstrArg);
+
+		if(!condition.isEmpty())
+		  str.append(condition + " ");
+		else if(ui.case_insensitive->isChecked())
 		  str.append("LOWER(title) LIKE " + E + "'%" +
 			     biblioteq_myqstring::
 			     escape(searchstrArg.toLower().trimmed()) +
@@ -3074,31 +2679,6 @@ int biblioteq::populateTable(const int search_type_arg,
 			     "%' ");
 	      }
 
-	    if(type != "Photograph Collection")
-	      str += QString("GROUP BY "
-			     "%1.title, "
-			     "%1.id, "
-			     "%1.publisher, %1.pdate, "
-			     "%1.category, "
-			     "%1.language, "
-			     "%1.price, "
-			     "%1.monetary_units, "
-			     "%1.quantity, "
-			     "%1.location, "
-			     "%1.keyword, "
-			     "%1.type, "
-			     "%1.myoid, "
-			     "%1.front_cover "
-			     ).arg(type.toLower().remove(" "));
-	    else
-	      str += "GROUP BY "
-		"photograph_collection.title, "
-		"photograph_collection.id, "
-		"photograph_collection.location, "
-		"photograph_collection.type, "
-		"photograph_collection.myoid, "
-		"photograph_collection.image_scaled ";
-
 	    if(type == "CD")
 	      {
 		str = str.replace("pdate", "rdate");
@@ -3133,12 +2713,91 @@ int biblioteq::populateTable(const int search_type_arg,
   ui.itemsCountLabel->setText(QString(tr("%1 Result(s)")).
 			      arg(ui.table->rowCount()));
 
-  QSqlQuery query(m_db);
+  /*
+  ** Item listings are paged by their (title, type, myoid) keys so
+  ** that a page does not require skipping the rows of the earlier
+  ** pages.
+  */
+
+  QString querystr(searchstr);
+  QString roles(m_roles);
+  QVariantList values;
+  bool keyset = false;
+
+  if(roles.isEmpty())
+    {
+      if(br.role->currentIndex() == 1)
+	roles = "guest";
+      else
+	roles = "patron";
+    }
+
+  if(limit > 0 &&
+     search_type != CUSTOM_QUERY &&
+     typefilter != "All Overdue" &&
+     typefilter != "All Requested" &&
+     typefilter != "All Reserved")
+    {
+      qint64 page = offset / limit + 1;
+
+      if((keyset = prepareKeysetQuery(querystr, values, roles,
+				      limitStr + offsetStr, limit, page,
+				      pagingType == NEW_PAGE)))
+	offset = (page - 1) * limit;
+    }
+
+  /*
+  ** The query is executed and its rows are decoded by a separate thread.
+  ** The rows are delivered in batches so that the table may be
+  ** populated progressively.
+  */
+
+  QEventLoop loop;
+  QTimer timer;
+  biblioteq_query_thread thread(0);
+
+  connect(&progress, SIGNAL(canceled(void)), &loop, SLOT(quit(void)));
+  connect(&thread, SIGNAL(finished(void)), &loop, SLOT(quit(void)));
+  connect(&thread, SIGNAL(rowsReady(void)), &loop, SLOT(quit(void)));
+  connect(&timer, SIGNAL(timeout(void)), &loop, SLOT(quit(void)));
+  progress.setModal(true);
+  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
+  progress.setLabelText(tr("Populating the table..."));
+
+  if(limit == -1)
+    {
+      progress.setMaximum(0);
+      progress.setMinimum(0);
+    }
+  else
+    {
+      progress.setMinimum(0);
+      progress.setMaximum(limit);
+    }
+
+  raise();
+  progress.show();
+  progress.update();
+  thread.setDatabase(m_connection, roles);
+  thread.setQuery(querystr, values);
+  thread.start();
+
+  /*
+  ** Signals that are delivered while the progress dialog is processing
+  ** events do not terminate the loop. The timer prevents stalls.
+  */
+
+  timer.start(100);
+
+  while(!progress.wasCanceled() && !thread.hasRows() && !thread.isFinished())
+    loop.exec();
 
-  query.setForwardOnly(true);
+  if(progress.wasCanceled())
+    thread.cancel();
 
-  if(!query.exec(searchstr))
+  if(thread.isFinished() && !thread.getErrorStr().isEmpty())
     {
+      progress.close();
       QApplication::restoreOverrideCursor();
 
       if(!m_previousTypeFilter.isEmpty())
@@ -3157,7 +2816,7 @@ int biblioteq::populateTable(const int search_type_arg,
       addError(QString(tr("Database Error")),
 	       QString(tr("Unable to retrieve the data required for "
 			  "populating the main table.")),
-	       query.lastError().text(), __FILE__, __LINE__);
+	       thread.getErrorStr(), __FILE__, __LINE__);
       QMessageBox::critical(this, tr("BiblioteQ: Database Error"),
 			    tr("Unable to retrieve the data required for "
 			       "populating the main table."));
@@ -3207,16 +2866,22 @@ int biblioteq::populateTable(const int search_type_arg,
   else
     currentPage = offset / limit + 1;
 
-  if(pagingType == NEW_PAGE)
-    m_pages = 0;
+  if(keyset)
+    m_pages = qMax(static_cast<qint64> (1),
+		   static_cast<qint64> (m_keysetPages.size()));
+  else
+    {
+      if(pagingType == NEW_PAGE)
+	m_pages = 0;
 
-  if(pagingType >= 0 &&
-     pagingType != PREVIOUS_PAGE &&
-     currentPage > m_pages)
-    m_pages += 1;
+      if(pagingType >= 0 &&
+	 pagingType != PREVIOUS_PAGE &&
+	 currentPage > m_pages)
+	m_pages += 1;
 
-  if(limit == -1)
-    m_pages = 1;
+      if(limit == -1)
+	m_pages = 1;
+    }
 
   if(m_pages == 1)
     ui.pagesLabel->setText("1");
@@ -3274,36 +2939,30 @@ int biblioteq::populateTable(const int search_type_arg,
   else
     m_lastSearchStr = searchstrArg;
 
+  /*
+  ** The unpaged query is retained so that the complete result set
+  ** may be exported.
+  */
+
+  m_lastQueryStr = searchstr;
+
+  if(!limitStr.isEmpty() && m_lastQueryStr.endsWith(limitStr + offsetStr))
+    m_lastQueryStr.chop(limitStr.length() + offsetStr.length());
+
   m_lastSearchType = search_type;
   ui.table->scrollToTop();
   ui.table->horizontalScrollBar()->setValue(0);
   ui.table->clearSelection();
   ui.table->setCurrentItem(0);
   slotDisplaySummary();
+  m_thumbnailLoader->clear();
   ui.graphicsView->scene()->clear();
   ui.graphicsView->resetTransform();
   ui.graphicsView->verticalScrollBar()->setValue(0);
   ui.graphicsView->horizontalScrollBar()->setValue(0);
-  ui.table->setSortingEnabled(false);
-  progress.setModal(true);
-  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
-  progress.setLabelText(tr("Populating the table..."));
-
-  if(limit == -1)
-    {
-      progress.setMaximum(0);
-      progress.setMinimum(0);
-    }
-  else
-    {
-      progress.setMinimum(0);
-      progress.setMaximum(limit);
-    }
-
-  raise();
-  progress.show();
-  progress.update();
 
+  QPixmap placeholder
+    (QPixmap::fromImage(biblioteq_thumbnail_loader::placeholder()));
   biblioteq_graphicsitempixmap *pixmapItem = 0;
   int iconTableColumnIdx = 0;
   int iconTableRowIdx = 0;
@@ -3328,159 +2987,124 @@ int biblioteq::populateTable(const int search_type_arg,
 				      std::numeric_limits<int>::max());
     }
 
+  QStringList fieldNames;
+
   i = -1;
 
-  while(i++, !progress.wasCanceled() && query.next())
+  while(true)
     {
-      pixmapItem = 0;
+      QList<QVariantList> rows(thread.takeRows());
 
-      if(query.isValid())
-	for(int j = 0; j < query.record().count(); j++)
-	  {
-	    item = 0;
+      if(fieldNames.isEmpty())
+	{
+	  fieldNames = thread.getFieldNames();
+	  ui.table->setFieldNames(fieldNames);
+	}
 
-	    if(!query.record().fieldName(j).endsWith("front_cover") &&
-	       !query.record().fieldName(j).endsWith("image_scaled"))
-	      {
-		if(query.record().fieldName(j).contains("date") ||
-		   query.record().fieldName(j).contains("membersince"))
-		  {
-		    QDate date(QDate::fromString(query.value(j).toString(),
-						 "MM/dd/yyyy"));
+      while(!progress.wasCanceled() && !rows.isEmpty())
+	{
+	  QByteArray cover;
+	  QStringList values;
+	  QVariant myoid;
+	  QVariant type;
+	  QVariantList row(rows.takeFirst());
+	  bool hasCover = false;
 
-		    str = date.toString(Qt::ISODate);
-		  }
-		else
-		  str = query.value(j).toString();
-	      }
+	  i += 1;
+	  pixmapItem = 0;
 
-	    if(search_type == CUSTOM_QUERY)
-	      if(!tmplist.contains(query.record().fieldName(j)))
-		{
-		  tmplist.append(query.record().fieldName(j));
-		  ui.table->setColumnCount(tmplist.size());
-		}
+	  for(int j = 0; j < fieldNames.size(); j++)
+	    {
+	      str = "";
 
-	    if(query.record().fieldName(j).endsWith("issue") ||
-	       query.record().fieldName(j).endsWith("price") ||
-	       query.record().fieldName(j).endsWith("volume") ||
-	       query.record().fieldName(j).endsWith("quantity") ||
-	       query.record().fieldName(j).endsWith("issueno") ||
-	       query.record().fieldName(j).endsWith("issuevolume") ||
-	       query.record().fieldName(j).endsWith("cddiskcount") ||
-	       query.record().fieldName(j).endsWith("dvddiskcount") ||
-	       query.record().fieldName(j).endsWith("availability") ||
-	       query.record().fieldName(j).endsWith("total_reserved") ||
-	       query.record().fieldName(j).endsWith("photograph_count"))
-	      {
-		if(query.record().fieldName(j).endsWith("price"))
+	      if(search_type == CUSTOM_QUERY)
+		if(!tmplist.contains(fieldNames.at(j)))
 		  {
-		    item = new(std::nothrow) biblioteq_numeric_table_item
-		      (query.value(j).toDouble());
-		    str = QString::number(query.value(j).toDouble(), 'f', 2);
+		    tmplist.append(fieldNames.at(j));
+		    ui.table->setColumnCount(tmplist.size());
 		  }
-		else
-		  item = new(std::nothrow) biblioteq_numeric_table_item
-		    (query.value(j).toInt());
-	      }
-	    else if(query.record().fieldName(j).endsWith("callnumber"))
-	      {
-		str = query.value(j).toString();
-		item = new(std::nothrow) biblioteq_callnum_table_item(str);
-	      }
-	    else if(query.record().fieldName(j).endsWith("front_cover") ||
-		    query.record().fieldName(j).endsWith("image_scaled"))
-	      {
-		QImage image;
-
-		image.loadFromData
-		  (QByteArray::fromBase64(query.value(j).
-					  toByteArray()));
 
-		if(image.isNull())
-		  image.loadFromData(query.value(j).toByteArray());
-
-		if(image.isNull())
-		  image = QImage(":/no_image.png");
-
-		/*
-		** The size of no_image.png is 126x187.
-		*/
+	      if(fieldNames.at(j).endsWith("price"))
+		str = QString::number(row.at(j).toDouble(), 'f', 2);
+	      else if(fieldNames.at(j).endsWith("front_cover") ||
+		      fieldNames.at(j).endsWith("image_scaled"))
+		{
+		  /*
+		  ** Custom queries may select images.
+		  */
 
-		if(!image.isNull())
-		  image = image.scaled
-		    (126, 187, Qt::KeepAspectRatio,
-		     Qt::SmoothTransformation);
+		  cover = row.at(j).toByteArray();
+		  hasCover = true;
+		}
+	      else
+		str = row.at(j).toString();
 
-		pixmapItem = new(std::nothrow) biblioteq_graphicsitempixmap
-		  (QPixmap::fromImage(image), 0);
+	      values.append(str);
 
-		if(pixmapItem)
-		  {
-		    if(iconTableRowIdx == 0)
-		      pixmapItem->setPos(140 * iconTableColumnIdx, 15);
-		    else
-		      pixmapItem->setPos(140 * iconTableColumnIdx,
-					 200 * iconTableRowIdx + 15);
+	      if(fieldNames.at(j).endsWith("type"))
+		{
+		  type = row.at(j);
+		  itemType = str;
+		  itemType = itemType.toLower().remove(" ");
+		}
 
-		    pixmapItem->setFlag(QGraphicsItem::ItemIsSelectable, true);
-		    ui.graphicsView->scene()->addItem(pixmapItem);
-		  }
+	      if(fieldNames.at(j).endsWith("myoid"))
+		{
+		  myoid = row.at(j);
+		  updateRows(str, i, itemType);
+		}
+	    }
 
-		iconTableColumnIdx += 1;
+	  /*
+	  ** Rows are kept in the table's columnar store. Items are
+	  ** only created for the rows that are visible.
+	  */
 
-		if(iconTableColumnIdx >= 5)
-		  {
-		    iconTableRowIdx += 1;
-		    iconTableColumnIdx = 0;
-		  }
-	      }
-	    else
-	      item = new(std::nothrow) QTableWidgetItem();
+	  ui.table->appendRow(values);
 
-	    if(item != 0)
-	      {
-		item->setText(str);
-		item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+	  /*
+	  ** Listings do not select images. The covers of the icons
+	  ** that are scrolled into view are retrieved by
+	  ** slotLoadVisibleCovers().
+	  */
 
-		if(j == 0)
-		  {
-		    ui.table->setRowCount(ui.table->rowCount() + 1);
-		    ui.itemsCountLabel->setText(QString(tr("%1 Result(s)")).
-						arg(ui.table->rowCount()));
-		  }
+	  if(!hasCover && (myoid.isNull() || type.isNull()))
+	    continue;
 
-		ui.table->setItem(i, j, item);
+	  pixmapItem = new(std::nothrow) biblioteq_graphicsitempixmap
+	    (placeholder, 0);
 
-		if(query.record().fieldName(j).endsWith("type"))
-		  {
-		    itemType = str;
-		    itemType = itemType.toLower().remove(" ");
-		  }
+	  if(pixmapItem)
+	    {
+	      if(iconTableRowIdx == 0)
+		pixmapItem->setPos(140 * iconTableColumnIdx, 15);
+	      else
+		pixmapItem->setPos(140 * iconTableColumnIdx,
+				   200 * iconTableRowIdx + 15);
+
+	      pixmapItem->setData(0, myoid);
+	      pixmapItem->setData(1, type);
+	      pixmapItem->setFlag(QGraphicsItem::ItemIsSelectable, true);
+	      ui.graphicsView->scene()->addItem(pixmapItem);
+
+	      if(hasCover)
+		m_thumbnailLoader->load(pixmapItem, cover);
+	      else
+		pixmapItem->setData(2, true); // The cover is pending.
+	    }
 
-		if(query.record().fieldName(j).endsWith("myoid"))
-		  updateRows(str, i, itemType);
-	      }
-	    else if(!query.record().fieldName(j).endsWith("front_cover") &&
-		    !query.record().fieldName(j).endsWith("image_scaled"))
-	      addError(QString(tr("Memory Error")),
-		       QString(tr("Unable to allocate "
-				  "memory for the \"item\" "
-				  "object. "
-				  "This is a serious "
-				  "problem!")), QString(""),
-		       __FILE__, __LINE__);
-	  }
+	  iconTableColumnIdx += 1;
 
-      if(query.isValid())
-	if(pixmapItem)
-	  for(int ii = 0; ii < query.record().count(); ii++)
+	  if(iconTableColumnIdx >= 5)
 	    {
-	      if(query.record().fieldName(ii).endsWith("myoid"))
-		pixmapItem->setData(0, query.value(ii));
-	      else if(query.record().fieldName(ii).endsWith("type"))
-		pixmapItem->setData(1, query.value(ii));
+	      iconTableRowIdx += 1;
+	      iconTableColumnIdx = 0;
 	    }
+	}
+
+      ui.table->updateRowCount();
+      ui.itemsCountLabel->setText(QString(tr("%1 Result(s)")).
+				  arg(ui.table->rowCount()));
 
       if(i + 1 <= progress.maximum())
 	progress.setValue(i + 1);
@@ -3489,18 +3113,46 @@ int biblioteq::populateTable(const int search_type_arg,
       progress.repaint();
       QApplication::processEvents();
 #endif
+
+      if(progress.wasCanceled())
+	{
+	  thread.cancel();
+	  break;
+	}
+      else if(thread.hasRows())
+	continue;
+      else if(thread.isFinished())
+	break;
+      else
+	loop.exec();
     }
 
+  timer.stop();
+  thread.wait();
+
+  if(!progress.wasCanceled() && !thread.getErrorStr().isEmpty())
+    addError(QString(tr("Database Error")),
+	     QString(tr("Unable to retrieve the data required for "
+			"populating the main table.")),
+	     thread.getErrorStr(), __FILE__, __LINE__);
+
   progress.close();
-  ui.table->setSortingEnabled(true);
+
+  /*
+  ** Order the results as the header's sort indicator shows.
+  */
+
+  ui.table->sortStore(ui.table->horizontalHeader()->sortIndicatorSection(),
+		      ui.table->horizontalHeader()->sortIndicatorOrder());
+  m_coverTimer.start();
 
   if(search_type == CUSTOM_QUERY)
     {
       if(tmplist.isEmpty())
-	for(int ii = 0; ii < query.record().count(); ii++)
-	  if(!tmplist.contains(query.record().fieldName(ii)))
+	for(int ii = 0; ii < fieldNames.size(); ii++)
+	  if(!tmplist.contains(fieldNames.at(ii)))
 	    {
-	      tmplist.append(query.record().fieldName(ii));
+	      tmplist.append(fieldNames.at(ii));
 	      ui.table->setColumnCount(tmplist.size());
 	    }
 
@@ -3543,6 +3195,8 @@ int biblioteq::populateTable(const int search_type_arg,
 
   if(limit == -1)
     ui.nextPageButton->setEnabled(false);
+  else if(keyset)
+    ui.nextPageButton->setEnabled(currentPage < m_pages);
   else if(ui.table->rowCount() < limit)
     ui.nextPageButton->setEnabled(false);
   else
@@ -3555,6 +3209,241 @@ int biblioteq::populateTable(const int search_type_arg,
   return 0;
 }
 
+/*
+** -- slotLoadVisibleCovers() --
+*/
+
+void biblioteq::slotLoadVisibleCovers(void)
+{
+  if(ui.stackedWidget->currentIndex() != 0)
+    return;
+
+  /*
+  ** Retrieve the covers of the icons that are within the viewport.
+  ** Covers are requested in batches, one query per item type.
+  */
+
+  QList<QGraphicsItem *> items
+    (ui.graphicsView->scene()->
+     items(ui.graphicsView->
+	   mapToScene(ui.graphicsView->viewport()->rect()).boundingRect()));
+  QMap<QString, QMultiHash<QString, biblioteq_graphicsitempixmap *> > pending;
+
+  for(int i = 0; i < items.size(); i++)
+    {
+      biblioteq_graphicsitempixmap *item =
+	qgraphicsitem_cast<biblioteq_graphicsitempixmap *> (items.at(i));
+
+      if(!item || !item->data(2).toBool())
+	continue;
+
+      item->setData(2, false);
+      pending[item->data(1).toString()].insert
+	(item->data(0).toString(), item);
+    }
+
+  QMapIterator<QString, QMultiHash<QString, biblioteq_graphicsitempixmap *> >
+    it(pending);
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      QString column("front_cover");
+      QString table("");
+
+      if(it.key() == "Book")
+	table = "book";
+      else if(it.key() == "CD")
+	table = "cd";
+      else if(it.key() == "DVD")
+	table = "dvd";
+      else if(it.key() == "Journal")
+	table = "journal";
+      else if(it.key() == "Magazine")
+	table = "magazine";
+      else if(it.key() == "Photograph Collection")
+	{
+	  column = "image_scaled";
+	  table = "photograph_collection";
+	}
+      else if(it.key() == "Video Game")
+	table = "videogame";
+      else
+	continue;
+
+      QStringList oids(it.value().uniqueKeys());
+
+      while(!oids.isEmpty())
+	{
+	  QSqlQuery query(m_db);
+	  QStringList batch(oids.mid(0, 100));
+	  QString querystr("");
+
+	  oids = oids.mid(batch.size());
+	  querystr = QString("SELECT myoid, %1 FROM %2 WHERE myoid IN (").
+	    arg(column).arg(table);
+
+	  for(int i = 0; i < batch.size(); i++)
+	    if(i == batch.size() - 1)
+	      querystr.append("?)");
+	    else
+	      querystr.append("?, ");
+
+	  query.setForwardOnly(true);
+	  query.prepare(querystr);
+
+	  for(int i = 0; i < batch.size(); i++)
+	    query.addBindValue(batch.at(i).toLongLong());
+
+	  if(query.exec())
+	    while(query.next())
+	      {
+		QList<biblioteq_graphicsitempixmap *> list
+		  (it.value().values(query.value(0).toString()));
+
+		for(int i = 0; i < list.size(); i++)
+		  m_thumbnailLoader->load
+		    (list.at(i), query.value(1).toByteArray());
+	      }
+	  else
+	    addError(QString(tr("Database Error")),
+		     QString(tr("Unable to retrieve the covers.")),
+		     query.lastError().text(), __FILE__, __LINE__);
+	}
+    }
+}
+
+/*
+** -- prepareKeysetQuery() --
+*/
+
+bool biblioteq::prepareKeysetQuery(QString &querystr,
+				   QVariantList &values,
+				   const QString &roles,
+				   const QString &limitStr,
+				   const int limit,
+				   qint64 &page,
+				   const bool reset)
+{
+  if(limit <= 0 || limitStr.isEmpty() || !querystr.endsWith(limitStr))
+    return false;
+
+  QString inner(querystr);
+
+  inner.chop(limitStr.length());
+
+  /*
+  ** The outermost ORDER BY clause is replaced by the key order.
+  ** Queries that do not end with an ORDER BY clause of plain column
+  ** names are paged by offset.
+  */
+
+  int index = inner.lastIndexOf
+    (QRegExp("ORDER BY\\s+[\\w.]+(\\s*,\\s*[\\w.]+)*\\s*$"));
+
+  if(index == -1)
+    return false;
+
+  inner.remove(index, inner.length());
+
+  if(reset || inner != m_keysetQuery || m_keysetPages.isEmpty())
+    {
+      /*
+      ** Record the first key of every page. The keys are numbered by
+      ** the database and only the first key of each page and the
+      ** total count are returned. The scan is performed by a query
+      ** thread. Databases without window functions are paged
+      ** by offset.
+      */
+
+      QEventLoop loop;
+      QTimer timer;
+      biblioteq_query_thread thread(0);
+
+      m_keysetPages.clear();
+      m_keysetQuery.clear();
+      connect(&thread, SIGNAL(finished(void)), &loop, SLOT(quit(void)));
+      connect(&timer, SIGNAL(timeout(void)), &loop, SLOT(quit(void)));
+      thread.setDatabase(m_connection, roles);
+      thread.setQuery
+	(QString("SELECT title, type, myoid, biblioteq_total FROM "
+		 "(SELECT title, type, myoid, "
+		 "ROW_NUMBER() OVER (ORDER BY title, type, myoid) "
+		 "AS biblioteq_row, "
+		 "COUNT(*) OVER () AS biblioteq_total "
+		 "FROM (%1) AS biblioteq_keyset) AS biblioteq_keys "
+		 "WHERE (biblioteq_row - 1) % %2 = 0 "
+		 "ORDER BY biblioteq_row").arg(inner).arg(limit));
+      thread.start();
+      timer.start(100);
+
+      while(!thread.isFinished())
+	loop.exec();
+
+      timer.stop();
+      thread.wait();
+
+      if(!thread.getErrorStr().isEmpty())
+	{
+	  addError(QString(tr("Database Error")),
+		   QString(tr("Unable to determine the page boundaries.")),
+		   thread.getErrorStr(), __FILE__, __LINE__);
+	  return false;
+	}
+
+      QList<QVariantList> rows(thread.takeRows());
+      qint64 total = 0;
+
+      for(int i = 0; i < rows.size(); i++)
+	{
+	  QVariantList key(rows.at(i).mid(0, 3));
+
+	  if(key.size() == 3)
+	    m_keysetPages.append(key);
+
+	  total = rows.at(i).value(3).toLongLong();
+	}
+
+      /*
+      ** The count of keys and the count of pages must agree.
+      */
+
+      if(m_keysetPages.size() != (total + limit - 1) / limit)
+	{
+	  m_keysetPages.clear();
+	  return false;
+	}
+
+      m_keysetQuery = inner;
+    }
+
+  if(page > m_keysetPages.size())
+    page = m_keysetPages.size();
+
+  if(page < 1)
+    page = 1;
+
+  values.clear();
+  querystr = QString("SELECT * FROM (%1) AS biblioteq_keyset ").arg(inner);
+
+  if(page > 1)
+    {
+      QVariantList key(m_keysetPages.at(static_cast<int> (page - 1)));
+
+      querystr.append("WHERE title > ? OR "
+		      "(title = ? AND (type > ? OR "
+		      "(type = ? AND myoid >= ?))) ");
+      values << key.at(0) << key.at(0)
+	     << key.at(1) << key.at(1)
+	     << key.at(2);
+    }
+
+  querystr.append(QString("ORDER BY title, type, myoid LIMIT %1").
+		  arg(limit));
+  return true;
+}
+
 /*
 ** -- slotSearchBasic() --
 */
@@ -3930,6 +3819,41 @@ void biblioteq::slotUpgradeSqliteScheme(void)
 	      "myoid BIGINT UNIQUE,"
 	      "notes TEXT,"
 	      "type VARCHAR(16) NOT NULL DEFAULT 'Grey Literature');");
+  list.append("CREATE TABLE IF NOT EXISTS item_reservation_counts "
+	      "("
+	      "item_oid BIGINT NOT NULL,"
+	      "total_reserved INTEGER NOT NULL DEFAULT 0,"
+	      "type VARCHAR(16) NOT NULL,"
+	      "PRIMARY KEY(item_oid, type));");
+  list.append("CREATE TRIGGER IF NOT EXISTS item_borrower_insert_trigger "
+	      "AFTER INSERT ON item_borrower "
+	      "FOR EACH row "
+	      "BEGIN "
+	      "INSERT OR IGNORE INTO item_reservation_counts (item_oid, type) "
+	      "VALUES (new.item_oid, new.type); "
+	      "UPDATE item_reservation_counts "
+	      "SET total_reserved = total_reserved + 1 "
+	      "WHERE item_oid = new.item_oid AND type = new.type; "
+	      "END;");
+  list.append("CREATE TRIGGER IF NOT EXISTS item_borrower_delete_trigger "
+	      "AFTER DELETE ON item_borrower "
+	      "FOR EACH row "
+	      "BEGIN "
+	      "UPDATE item_reservation_counts "
+	      "SET total_reserved = total_reserved - 1 "
+	      "WHERE item_oid = old.item_oid AND type = old.type; "
+	      "END;");
+  list.append("DELETE FROM item_reservation_counts;");
+  list.append("INSERT INTO item_reservation_counts "
+	      "(item_oid, total_reserved, type) "
+	      "SELECT item_oid, COUNT(*), type FROM item_borrower "
+	      "GROUP BY item_oid, type;");
+
+  /*
+  ** Some of the tables above are recreated, discarding their indexes.
+  */
+
+  list.append("PRAGMA user_version = 0;");
 
   QString errors("");
   int ct = 0;
@@ -3947,6 +3871,7 @@ void biblioteq::slotUpgradeSqliteScheme(void)
     }
 
   QApplication::restoreOverrideCursor();
+  upgradeSqliteIndexes();
 
   if(!errors.isEmpty())
     QMessageBox::critical(this, tr("BiblioteQ: Database Error"),
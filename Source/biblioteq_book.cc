@@ -4,10 +4,12 @@
 
 #include <QAuthenticator>
 #include <QCryptographicHash>
+#include <QEventLoop>
 #include <QInputDialog>
 #include <QNetworkProxy>
 #include <QSqlField>
 #include <QSqlRecord>
+#include <QTimer>
 #include <QXmlStreamReader>
 
 /*
@@ -19,6 +21,7 @@
 */
 
 #include "biblioteq.h"
+#include "biblioteq_attachments.h"
 #include "biblioteq_book.h"
 #include "biblioteq_borrowers_editor.h"
 #include "biblioteq_marc.h"
@@ -35,6 +38,7 @@ biblioteq_book::biblioteq_book(QMainWindow *parentArg,
   QMainWindow(), biblioteq_item(rowArg)
 {
   m_duplicate = false;
+  m_thread = 0;
 
   QGraphicsScene *scene1 = 0;
   QGraphicsScene *scene2 = 0;
@@ -79,12 +83,6 @@ biblioteq_book::biblioteq_book(QMainWindow *parentArg,
 	biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
 #endif
     }
-  else
-    {
-      if((m_sruManager = new(std::nothrow)
-	  QNetworkAccessManager(this)) == 0)
-	biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
-    }
 
   if((m_sruWorking = new(std::nothrow)
       biblioteq_item_working_dialog(qobject_cast<QMainWindow *> (this))) == 0)
@@ -429,6 +427,8 @@ biblioteq_book::biblioteq_book(QMainWindow *parentArg,
 
 biblioteq_book::~biblioteq_book()
 {
+  if(m_sruSearch)
+    m_sruSearch->abort();
 }
 
 /*
@@ -693,7 +693,7 @@ void biblioteq_book::slotGo(void)
       query.bindValue(1, id.title->text().trimmed());
       query.bindValue(2, id.edition->currentText().trimmed());
       query.bindValue(3, id.author->toPlainText().trimmed());
-      query.bindValue(4, id.publication_date->date().toString("MM/dd/yyyy"));
+      query.bindValue(4, id.publication_date->date().toString(Qt::ISODate));
       query.bindValue(5, id.publisher->toPlainText().trimmed());
       query.bindValue(6, id.category->toPlainText().trimmed());
       query.bindValue(7, id.price->value());
@@ -734,7 +734,7 @@ void biblioteq_book::slotGo(void)
 	    {
 	      id.front_image->m_image.save
 		(&buffer, id.front_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(18, bytes.toBase64());
+	      query.bindValue(18, bytes);
 	    }
 	  else
 	    query.bindValue(18, QVariant(QVariant::ByteArray));
@@ -756,7 +756,7 @@ void biblioteq_book::slotGo(void)
 	    {
 	      id.back_image->m_image.save
 		(&buffer, id.back_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(19, bytes.toBase64());
+	      query.bindValue(19, bytes);
 	    }
 	  else
 	    query.bindValue(19, QVariant(QVariant::ByteArray));
@@ -956,78 +956,78 @@ void biblioteq_book::slotGo(void)
 		 (qmain->getUI().table,
 		  m_row, qmain->getUI().table->columnNumber("Type")) == "Book")
 		{
-		  qmain->getUI().table->setSortingEnabled(false);
-
 		  QStringList names(qmain->getUI().table->columnNames());
 
 		  for(i = 0; i < names.size(); i++)
 		    {
 		      if(names.at(i) == "ISBN-10" ||
 			 names.at(i) == "ID Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.id->text());
+			qmain->getUI().table->setText
+			  (m_row, i, id.id->text());
 		      else if(names.at(i) == "Title")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.title->text());
+			qmain->getUI().table->setText
+			  (m_row, i, id.title->text());
 		      else if(names.at(i) == "Edition")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.edition->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, id.edition->currentText().trimmed());
 		      else if(names.at(i) == "Author(s)")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.author->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, id.author->toPlainText());
 		      else if(names.at(i) == "Publication Date")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.publication_date->date().toString
+			qmain->getUI().table->setText
+			  (m_row, i, id.publication_date->date().toString
 			   (Qt::ISODate));
 		      else if(names.at(i) == "Publisher")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.publisher->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, id.publisher->toPlainText());
 		      else if(names.at(i) == "Place of Publication")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.place->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, id.place->toPlainText());
 		      else if(names.at(i) == "Categories")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.category->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, id.category->toPlainText());
 		      else if(names.at(i) == "Price")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.price->cleanText());
+			qmain->getUI().table->setText
+			  (m_row, i, id.price->cleanText());
 		      else if(names.at(i) == "Language")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.language->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, id.language->currentText().trimmed());
 		      else if(names.at(i) == "Monetary Units")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.monetary_units->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i,
+			   id.monetary_units->currentText().trimmed());
 		      else if(names.at(i) == "Quantity")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.quantity->text());
+			qmain->getUI().table->setText
+			  (m_row, i, id.quantity->text());
 		      else if(names.at(i) == "Book Binding Type")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.binding->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, id.binding->currentText().trimmed());
 		      else if(names.at(i) == "Location")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.location->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, id.location->currentText().trimmed());
 		      else if(names.at(i) == "ISBN-13")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.isbn13->text());
+			qmain->getUI().table->setText
+			  (m_row, i, id.isbn13->text());
 		      else if(names.at(i) == "LC Control Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.lcnum->text());
+			qmain->getUI().table->setText
+			  (m_row, i, id.lcnum->text());
 		      else if(names.at(i) == "Call Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.callnum->text());
+			qmain->getUI().table->setText
+			  (m_row, i, id.callnum->text());
 		      else if(names.at(i) == "Dewey Class Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.deweynum->text());
+			qmain->getUI().table->setText
+			  (m_row, i, id.deweynum->text());
 		      else if(names.at(i) == "Originality")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.originality->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, id.originality->currentText().trimmed());
 		      else if(names.at(i) == "Condition")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (id.condition->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, id.condition->currentText().trimmed());
 		      else if(names.at(i) == "Availability")
 			{
-			  qmain->getUI().table->item(m_row, i)->setText
-			    (biblioteq_misc_functions::getAvailability
+			  qmain->getUI().table->setText
+			    (m_row, i,
+			     biblioteq_misc_functions::getAvailability
 			     (m_oid, qmain->getDB(), "Book",
 			      errorstr));
 
@@ -1039,8 +1039,6 @@ void biblioteq_book::slotGo(void)
 			}
 		    }
 
-		  qmain->getUI().table->setSortingEnabled(true);
-
 		  foreach(QLineEdit *textfield, findChildren<QLineEdit *>())
 		    textfield->setCursorPosition(0);
 
@@ -1084,7 +1082,7 @@ void biblioteq_book::slotGo(void)
     }
   else
     {
-      searchstr = "SELECT DISTINCT book.title, "
+      searchstr = "SELECT book.title, "
 	"book.author, "
 	"book.publisher, book.pdate, book.place, book.edition, "
 	"book.category, book.language, book.id, "
@@ -1096,18 +1094,17 @@ void biblioteq_book::slotGo(void)
 	"book.lccontrolnumber, "
 	"book.callnumber, "
 	"book.deweynumber, "
-	"book.quantity - COUNT(item_borrower_vw.item_oid) "
+	"book.quantity - COALESCE(irc.total_reserved, 0) "
 	"AS availability, "
-	"COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	"COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	"book.originality, "
 	"book.condition, "
 	"book.type, "
-	"book.myoid, "
-	"book.front_cover "
+	"book.myoid "
 	"FROM "
-	"book LEFT JOIN item_borrower_vw ON "
-	"book.myoid = item_borrower_vw.item_oid "
-	"AND item_borrower_vw.type = 'Book' "
+	"book LEFT JOIN item_reservation_counts irc ON "
+	"book.myoid = irc.item_oid "
+	"AND irc.type = 'Book' "
 	"WHERE ";
 
       if(!id.id->text().trimmed().isEmpty())
@@ -1119,10 +1116,21 @@ void biblioteq_book::slotGo(void)
       if(qmain->getDB().driverName() != "QSQLITE")
 	E = "E";
 
-      searchstr.append("title LIKE " + E + "'%" +
-		       biblioteq_myqstring::
-		       escape(id.title->text().trimmed()) +
-		       "%' AND ");
+      bool fullText = biblioteq_misc_functions::hasFullTextSearch
+	(qmain->getDB());
+      QString condition("");
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "Book", "title", id.title->text());
+
+      if(!condition.isEmpty())
+	searchstr.append(condition + " AND ");
+      else
+	searchstr.append("title LIKE " + E + "'%" +
+			 biblioteq_myqstring::
+			 escape(id.title->text().trimmed()) +
+			 "%' AND ");
 
       if(!m_engWindowTitle.isEmpty())
 	if(!id.isbn13->text().trimmed().isEmpty())
@@ -1153,9 +1161,9 @@ void biblioteq_book::slotGo(void)
 			      trimmed()) + "%' AND ");
 
       if(id.publication_date->date().toString("MM/yyyy") != "01/7999")
-	searchstr.append("SUBSTR(pdate, 1, 3) || SUBSTR(pdate, 7) = '" +
+	searchstr.append("SUBSTR(pdate, 1, 7) = '" +
 			 id.publication_date->date().toString
-			 ("MM/yyyy") +
+			 ("yyyy-MM") +
 			 "' AND ");
 
       searchstr.append("publisher LIKE " + E + "'%" +
@@ -1215,10 +1223,19 @@ void biblioteq_book::slotGo(void)
 		       biblioteq_myqstring::escape
 		       (id.marc_tags->toPlainText().trimmed()) +
 		       "%' ");
-      searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
-		       biblioteq_myqstring::escape
-		       (id.keyword->toPlainText().trimmed()) +
-		       "%' ");
+      condition.clear();
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "Book", "keyword", id.keyword->toPlainText());
+
+      if(!condition.isEmpty())
+	searchstr.append("AND " + condition + " ");
+      else
+	searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape
+			 (id.keyword->toPlainText().trimmed()) +
+			 "%' ");
 
       if(id.originality->currentIndex() != 0)
 	searchstr.append("AND originality = " + E + "'" +
@@ -1553,7 +1570,7 @@ void biblioteq_book::modify(const int state)
 				       var.toString());
 	  else if(fieldname == "pdate")
 	    id.publication_date->setDate
-	      (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+	      (biblioteq_misc_functions::dateFromString(var.toString()));
 	  else if(fieldname == "edition")
 	    {
 	      if(id.edition->findText(var.toString()) > -1)
@@ -1671,10 +1688,7 @@ void biblioteq_book::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  id.front_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(id.front_image->m_image.isNull())
-		    id.front_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	  else if(fieldname == "back_cover")
@@ -1682,10 +1696,7 @@ void biblioteq_book::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  id.back_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(id.back_image->m_image.isNull())
-		    id.back_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	}
@@ -2183,18 +2194,60 @@ void biblioteq_book::slotSRUQuery(void)
 	return;
 #endif
     }
-  else
-    {
-      if(m_sruManager->findChild<QNetworkReply *> ())
-	return;
-    }
+  else if(m_sruSearch)
+    return;
 
   m_sruWorking->reset(); // Qt 5.5.x adjustment.
   m_sruWorking->setMaximum(0);
   m_sruWorking->setMinimum(0);
   m_sruWorking->show();
   m_sruWorking->update();
+  m_sruResults.clear();
+
+  if(!useHttp())
+    {
+      /*
+      ** Every site is queried. The first site that
+      ** produces a record wins.
+      */
+
+      QMap<QString, QHash<QString, QString> > hashes(qmain->getSRUMaps());
+      QMap<QString, QUrl> urls;
+      QMapIterator<QString, QHash<QString, QString> > it(hashes);
+
+      while(it.hasNext())
+	{
+	  it.next();
+
+	  QString searchstr(it.value().value("url_isbn"));
+
+	  if(searchstr.isEmpty())
+	    continue;
+
+	  if(!id.id->text().trimmed().isEmpty())
+	    searchstr.replace("%1", id.id->text().trimmed());
+	  else
+	    searchstr.replace("%1", id.isbn13->text().trimmed());
 
+	  if(!id.isbn13->text().trimmed().isEmpty())
+	    searchstr.replace("%2", id.isbn13->text().trimmed());
+	  else
+	    searchstr.replace("%2", id.id->text().trimmed());
+
+	  urls[it.key()] = QUrl::fromUserInput(searchstr);
+	}
+
+      m_sruSearch = qmain->getSRUClient()->search(urls, this);
+      connect(m_sruSearch,
+	      SIGNAL(resultReady(const QString &, const QByteArray &)),
+	      this,
+	      SLOT(slotSRUResultReady(const QString &, const QByteArray &)));
+      connect(m_sruSearch, SIGNAL(finished(void)),
+	      this, SLOT(slotSRUSearchFinished(void)));
+      return;
+    }
+
+#if QT_VERSION < 0x050000
   QString name("");
   bool found = false;
 
@@ -2230,50 +2283,20 @@ void biblioteq_book::slotSRUQuery(void)
 
   if(hash.contains("proxy_type"))
     type = hash.value("proxy_type").toLower().trimmed();
-  else if(hash.contains("proxy_type"))
-    type = hash.value("proxy_type").toLower().trimmed();
 
   if(type == "none")
     proxy.setType(QNetworkProxy::NoProxy);
   else
     {
       if(type == "http" || type == "socks5" || type == "system")
-	{
-	  if(useHttp())
-	    {
-#if QT_VERSION < 0x050000
-	      connect
-		(m_sruHttp,
-		 SIGNAL(proxyAuthenticationRequired(const QNetworkProxy &,
-						    QAuthenticator *)),
-		 this,
-		 SLOT(slotProxyAuthenticationRequired(const QNetworkProxy &,
-						      QAuthenticator *)),
-		 Qt::UniqueConnection);
-#endif
-	    }
-	  else
-	    {
-	      /*
-	      ** This is required to resolve an odd error.
-	      */
-
-	      QNetworkReply *reply = m_sruManager->get
-		(QNetworkRequest(QUrl::fromUserInput("http://0.0.0.0")));
-
-	      if(reply)
-		reply->deleteLater();
-
-	      connect
-		(m_sruManager,
-		 SIGNAL(proxyAuthenticationRequired(const QNetworkProxy &,
-						    QAuthenticator *)),
-		 this,
-		 SLOT(slotProxyAuthenticationRequired(const QNetworkProxy &,
-						      QAuthenticator *)),
-		 Qt::UniqueConnection);
-	    }
-	}
+	connect
+	  (m_sruHttp,
+	   SIGNAL(proxyAuthenticationRequired(const QNetworkProxy &,
+					      QAuthenticator *)),
+	   this,
+	   SLOT(slotProxyAuthenticationRequired(const QNetworkProxy &,
+						QAuthenticator *)),
+	   Qt::UniqueConnection);
 
       if(type == "http" || type == "socks5")
 	{
@@ -2300,14 +2323,7 @@ void biblioteq_book::slotSRUQuery(void)
 	  if(!password.isEmpty())
 	    proxy.setPassword(password);
 
-	  if(useHttp())
-	    {
-#if QT_VERSION < 0x050000
-	      m_sruHttp->setProxy(proxy);
-#endif
-	    }
-	  else
-	    m_sruManager->setProxy(proxy);
+	  m_sruHttp->setProxy(proxy);
 	}
       else if(type == "system")
 	{
@@ -2319,60 +2335,26 @@ void biblioteq_book::slotSRUQuery(void)
 	  if(!list.isEmpty())
 	    proxy = list.at(0);
 
-	  if(useHttp())
-	    {
-#if QT_VERSION < 0x050000
-	      m_sruHttp->setProxy(proxy);
-#endif
-	    }
-	  else
-	    m_sruManager->setProxy(proxy);
+	  m_sruHttp->setProxy(proxy);
 	}
     }
 
-  if(useHttp())
-    {
-#if QT_VERSION < 0x050000
-      if(url.port() == -1)
-	url.setPort(80);
-
-      m_sruHttp->abort();
-      m_sruResults.clear();
-      connect(m_sruHttp, SIGNAL(done(bool)),
-	      this, SLOT(slotSRUDownloadFinished(bool)),
-	      Qt::UniqueConnection);
-      connect(m_sruHttp, SIGNAL(readyRead(const QHttpResponseHeader &)),
-	      this, SLOT(slotSRUReadyRead(const QHttpResponseHeader &)),
-	      Qt::UniqueConnection);
-      connect(m_sruHttp, SIGNAL(sslErrors(const QList<QSslError> &)),
-	      this, SLOT(slotSRUSslErrors(const QList<QSslError> &)),
-	      Qt::UniqueConnection);
-      m_sruHttp->setHost(url.host(), url.port());
-      m_sruHttp->get(url.toEncoded());
+  if(url.port() == -1)
+    url.setPort(80);
+
+  m_sruHttp->abort();
+  connect(m_sruHttp, SIGNAL(done(bool)),
+	  this, SLOT(slotSRUDownloadFinished(bool)),
+	  Qt::UniqueConnection);
+  connect(m_sruHttp, SIGNAL(readyRead(const QHttpResponseHeader &)),
+	  this, SLOT(slotSRUReadyRead(const QHttpResponseHeader &)),
+	  Qt::UniqueConnection);
+  connect(m_sruHttp, SIGNAL(sslErrors(const QList<QSslError> &)),
+	  this, SLOT(slotSRUSslErrors(const QList<QSslError> &)),
+	  Qt::UniqueConnection);
+  m_sruHttp->setHost(url.host(), url.port());
+  m_sruHttp->get(url.toEncoded());
 #endif
-    }
-  else
-    {
-      QNetworkReply *reply = m_sruManager->get(QNetworkRequest(url));
-
-      if(reply)
-	{
-	  m_sruResults.clear();
-	  connect(reply, SIGNAL(readyRead(void)),
-		  this, SLOT(slotSRUReadyRead(void)));
-	  connect(reply, SIGNAL(finished(void)),
-		  this, SLOT(slotSRUDownloadFinished(void)));
-	  connect(reply, SIGNAL(error(QNetworkReply::NetworkError)),
-		  this, SLOT(slotSRUError(QNetworkReply::NetworkError)));
-	  connect(reply, SIGNAL(sslErrors(const QList<QSslError> &)),
-		  this, SLOT(slotSRUSslErrors(const QList<QSslError> &)));
-	}
-      else
-	{
-	  m_sruWorking->reset(); // Qt 5.5.x adjustment.
-	  m_sruWorking->close();
-	}
-    }
 }
 
 /*
@@ -2381,7 +2363,7 @@ void biblioteq_book::slotSRUQuery(void)
 
 void biblioteq_book::slotZ3950Query(void)
 {
-  if(findChild<biblioteq_generic_thread *> ())
+  if(m_thread)
     return;
 
   QString errorstr = "";
@@ -2403,7 +2385,7 @@ void biblioteq_book::slotZ3950Query(void)
       return;
     }
 
-  if((m_thread = new(std::nothrow) biblioteq_generic_thread(this)) != 0)
+  if((m_thread = new(std::nothrow) biblioteq_generic_thread(0)) != 0)
     {
       biblioteq_item_working_dialog working
 	(qobject_cast<QMainWindow *> (this));
@@ -2439,39 +2421,52 @@ void biblioteq_book::slotZ3950Query(void)
 	searchstr = QString("@attr 1=7 @or %1 %2").arg(isbns.at(0)).
 	  arg(isbns.at(1));
 
-      bool found = false;
+      QEventLoop loop;
+      QStringList names;
 
       for(i = 0; i < id.z3950QueryButton->actions().size(); i++)
 	if(id.z3950QueryButton->actions().at(i)->isChecked())
 	  {
-	    found = true;
-	    recordSyntax = qmain->getZ3950Maps().value
-	      (id.z3950QueryButton->actions().at(i)->text()).
-	      value("RecordSyntax");
-	    m_thread->setZ3950Name
-	      (id.z3950QueryButton->actions().at(i)->text());
+	    names.append(id.z3950QueryButton->actions().at(i)->text());
 	    break;
 	  }
 
-      if(!found)
-	{
-	  recordSyntax = qmain->getZ3950Maps().value
-	    (qmain->getPreferredZ3950Site()).value("RecordSyntax");
-	  m_thread->setZ3950Name(qmain->getPreferredZ3950Site());
-	}
+      if(names.isEmpty())
+	names.append(qmain->getPreferredZ3950Site());
 
+      /*
+      ** The remaining sites are also queried.
+      */
+
+      foreach(const QString &name, qmain->getZ3950Maps().keys())
+	if(!names.contains(name))
+	  names.append(name);
+
+      connect(&working, SIGNAL(canceled(void)), &loop, SLOT(quit(void)));
+      connect(m_thread, SIGNAL(finished(void)), &loop, SLOT(quit(void)));
+      connect(m_thread, SIGNAL(z3950ResultsReady(void)),
+	      &loop, SLOT(quit(void)));
       m_thread->setType(biblioteq_generic_thread::Z3950_QUERY);
+      m_thread->setZ3950Identifiers(isbns);
+      m_thread->setZ3950Names(names);
       m_thread->setZ3950SearchString(searchstr);
       m_thread->start();
 
-      while(m_thread->isRunning())
-	{
-#ifndef Q_OS_MAC
-	  QApplication::processEvents();
-#endif
-	  m_thread->msleep(100);
-	}
+      /*
+      ** The first site that responds with a record wins.
+      */
 
+      if(!working.wasCanceled() && !m_thread->hasZ3950Results())
+	loop.exec();
+
+      QList<QByteArray> records(m_thread->getZ3950Records());
+      QStringList results(m_thread->getZ3950Results());
+      QStringList sites(m_thread->getZ3950Sites());
+
+      errorstr = m_thread->getErrorStr();
+      etype = m_thread->getEType();
+      m_thread->abandon();
+      m_thread = 0;
       working.close();
 
       bool canceled = working.wasCanceled();
@@ -2479,13 +2474,17 @@ void biblioteq_book::slotZ3950Query(void)
       working.reset(); // Qt 5.5.x adjustment.
 
       if(canceled)
-	{
-	  m_thread->deleteLater();
-	  return;
-	}
+	return;
 
-      if((errorstr = m_thread->getErrorStr()).isEmpty() &&
-	 !m_thread->getZ3950Results().isEmpty())
+      /*
+      ** The record's syntax is that of the site which produced it.
+      */
+
+      if(!sites.isEmpty())
+	recordSyntax = qmain->getZ3950Maps().value(sites.at(0)).
+	  value("RecordSyntax", "MARC21").trimmed();
+
+      if(errorstr.isEmpty() && !results.isEmpty())
 	{
 	  if(QMessageBox::question
 	     (this, tr("BiblioteQ: Question"),
@@ -2504,13 +2503,13 @@ void biblioteq_book::slotZ3950Query(void)
 		m.initialize(biblioteq_marc::BOOK, biblioteq_marc::Z3950,
 			     biblioteq_marc::UNIMARC);
 
-	      m.setData(m_thread->getZ3950Results()[0]);
-	      list = QString(m_thread->getZ3950Results()[0]).split("\n");
+	      m.setRecord(records.value(0));
+	      list = QString(results.at(0)).split("\n");
 	      id.edition->setCurrentIndex(0);
 	      id.edition->setStyleSheet
 		("background-color: rgb(162, 205, 90)");
 	      id.marc_tags->setPlainText
-		(m_thread->getZ3950Results()[0].trimmed());
+		(results.at(0).trimmed());
 	      biblioteq_misc_functions::highlightWidget
 		(id.marc_tags->viewport(), QColor(162, 205, 90));
 
@@ -2652,14 +2651,10 @@ void biblioteq_book::slotZ3950Query(void)
 		textfield->setCursorPosition(0);
 	    }
 	}
-      else if(errorstr.isEmpty() && m_thread->getZ3950Results().isEmpty())
+      else if(errorstr.isEmpty() && results.isEmpty())
 	QMessageBox::critical
 	  (this, tr("BiblioteQ: Z39.50 Query Error"),
 	   tr("A Z39.50 entry may not yet exist for the provided ISBN(s)."));
-      else
-	etype = m_thread->getEType();
-
-      m_thread->deleteLater();
     }
   else
     {
@@ -3251,11 +3246,6 @@ void biblioteq_book::slotSRUDownloadFinished(bool error)
 
 void biblioteq_book::slotSRUDownloadFinished(void)
 {
-  QNetworkReply *reply = qobject_cast<QNetworkReply *> (sender());
-
-  if(reply)
-    reply->deleteLater();
-
   sruDownloadFinished();
 }
 
@@ -3489,33 +3479,49 @@ void biblioteq_book::slotSRUReadyRead(const QHttpResponseHeader &resp)
 #endif
 
 /*
-** -- slotSRUReadyRead() --
+** -- slotSRUResultReady() --
 */
 
-void biblioteq_book::slotSRUReadyRead(void)
+void biblioteq_book::slotSRUResultReady(const QString &site,
+					const QByteArray &data)
 {
-  QNetworkReply *reply = qobject_cast<QNetworkReply *> (sender());
+  Q_UNUSED(site);
 
-  if(reply)
-    m_sruResults.append(reply->readAll());
+  if(!m_sruSearch)
+    return;
+
+  /*
+  ** The remaining sites are abandoned. The record is processed
+  ** after the search has returned control to the event loop.
+  */
+
+  m_sruResults = data;
+  m_sruSearch->abort();
+  m_sruSearch = 0;
+  QTimer::singleShot(0, this, SLOT(slotSRUDownloadFinished(void)));
 }
 
 /*
-** -- slotSRUError() --
+** -- slotSRUSearchFinished() --
 */
 
-void biblioteq_book::slotSRUError(QNetworkReply::NetworkError error)
+void biblioteq_book::slotSRUSearchFinished(void)
 {
-  QNetworkReply *reply = qobject_cast<QNetworkReply *> (sender());
+  biblioteq_sru_search *search = qobject_cast<biblioteq_sru_search *>
+    (sender());
 
-  if(reply)
+  m_sruWorking->reset(); // Qt 5.5.x adjustment.
+  m_sruWorking->close();
+  update();
+
+  if(search && !search->errorString().isEmpty())
     QMessageBox::critical
       (this, tr("BiblioteQ: SRU Query Error"),
-       tr("A network error (%1) occurred.").arg(reply->errorString()));
+       tr("A network error (%1) occurred.").arg(search->errorString()));
   else
     QMessageBox::critical
       (this, tr("BiblioteQ: SRU Query Error"),
-       tr("A network error (%1) occurred.").arg(error));
+       tr("An SRU entry may not yet exist for the provided ISBN(s)."));
 }
 
 /*
@@ -3570,114 +3576,19 @@ void biblioteq_book::slotAttachFiles(void)
       QApplication::processEvents();
 #endif
 
-      QProgressDialog progress(this);
-      QStringList files(fileDialog.selectedFiles());
-      int i = -1;
-
-#ifdef Q_OS_MAC
-#if QT_VERSION < 0x050000
-      progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
-#endif
-#endif
-      progress.setLabelText(tr("Uploading files..."));
-      progress.setMaximum(files.size());
-      progress.setMinimum(0);
-      progress.setModal(true);
-      progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
-      progress.show();
-#ifndef Q_OS_MAC
-      progress.repaint();
-      QApplication::processEvents();
-#endif
-
-      while(i++, !files.isEmpty() && !progress.wasCanceled())
-	{
-	  QCryptographicHash digest(QCryptographicHash::Sha1);
-	  QFile file;
-	  QString fileName(files.takeFirst());
-
-	  file.setFileName(fileName);
-
-	  if(file.open(QIODevice::ReadOnly))
-	    {
-	      QByteArray bytes(4096, 0);
-	      QByteArray total;
-	      qint64 rc = 0;
-
-	      while((rc = file.read(bytes.data(), bytes.size())) > 0)
-		{
-		  digest.addData(bytes.mid(0, static_cast<int> (rc)));
-		  total.append(bytes.mid(0, static_cast<int> (rc)));
-		}
-
-	      if(!total.isEmpty())
-		{
-		  total = qCompress(total, 9);
-		  createFile(digest.result(), total,
-			     QFileInfo(fileName).fileName());
-		}
-	    }
-
-	  file.close();
-
-	  if(i + 1 <= progress.maximum())
-	    progress.setValue(i + 1);
-
-#ifndef Q_OS_MAC
-	  progress.repaint();
-	  QApplication::processEvents();
-#endif
-	}
-
-      QApplication::restoreOverrideCursor();
-      populateFiles();
-    }
-}
-
-/*
-** -- createFile() --
-*/
-
-void biblioteq_book::createFile(const QByteArray &digest,
-				const QByteArray &bytes,
-				const QString &fileName) const
-{
-  QSqlQuery query(qmain->getDB());
-
-  if(qmain->getDB().driverName() != "QSQLITE")
-    query.prepare("INSERT INTO book_files "
-		  "(file, file_digest, file_name, item_oid) "
-		  "VALUES (?, ?, ?, ?)");
-  else
-    query.prepare("INSERT INTO book_files "
-		  "(file, file_digest, file_name, item_oid, myoid) "
-		  "VALUES (?, ?, ?, ?, ?)");
-
-  query.bindValue(0, bytes);
-  query.bindValue(1, digest.toHex().constData());
-  query.bindValue(2, fileName);
-  query.bindValue(3, m_oid);
-
-  if(qmain->getDB().driverName() == "QSQLITE")
-    {
       QString errorstr("");
-      qint64 value = biblioteq_misc_functions::getSqliteUniqueId
-	(qmain->getDB(), errorstr);
+      biblioteq_attachments attachments(this);
 
-      if(errorstr.isEmpty())
-	query.bindValue(4, value);
-      else
+      if(!attachments.attach(fileDialog.selectedFiles(),
+			     "book",
+			     m_oid,
+			     errorstr) && !errorstr.isEmpty())
 	qmain->addError(QString(tr("Database Error")),
-			QString(tr("Unable to generate a unique "
-				   "integer.")),
-			errorstr);
-    }
+			QString(tr("Unable to attach the file(s).")),
+			errorstr, __FILE__, __LINE__);
 
-  if(!query.exec())
-    qmain->addError
-      (QString(tr("Database Error")),
-       QString(tr("Unable to create a database transaction.")),
-       query.lastError().text(), __FILE__, __LINE__);
+      populateFiles();
+    }
 }
 
 /*
@@ -3700,12 +3611,13 @@ void biblioteq_book::populateFiles(void)
     if(query.next())
       id.files->setRowCount(query.value(0).toInt());
 
-  query.prepare("SELECT file_name, "
-		"file_digest, "
-		"LENGTH(file) AS f_s, "
-		"description, "
-		"myoid FROM book_files "
-                "WHERE item_oid = ? ORDER BY file_name");
+  query.prepare(QString("SELECT file_name, "
+			"file_digest, "
+			"%1 AS f_s, "
+			"description, "
+			"myoid FROM book_files "
+			"WHERE item_oid = ? ORDER BY file_name").
+		arg(biblioteq_attachments::sizeColumn("book")));
   query.bindValue(0, m_oid);
   QApplication::setOverrideCursor(Qt::WaitCursor);
 
@@ -3785,6 +3697,13 @@ void biblioteq_book::slotDeleteFiles(void)
       query.exec();
     }
 
+  QString errorstr("");
+
+  if(!biblioteq_attachments::purge(errorstr))
+    qmain->addError(QString(tr("Database Error")),
+		    QString(tr("Unable to remove the unattached file data.")),
+		    errorstr, __FILE__, __LINE__);
+
   QApplication::restoreOverrideCursor();
   populateFiles();
 }
@@ -3821,56 +3740,21 @@ void biblioteq_book::slotExportFiles(void)
       QApplication::processEvents();
 #endif
 
-      QProgressDialog progress(this);
-
-#ifdef Q_OS_MAC
-#if QT_VERSION < 0x050000
-      progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
-#endif
-#endif
-      progress.setLabelText(QObject::tr("Exporting file(s)..."));
-      progress.setMaximum(list.size());
-      progress.setMinimum(0);
-      progress.setModal(true);
-      progress.setWindowTitle(QObject::tr("BiblioteQ: Progress Dialog"));
-      progress.show();
-#ifndef Q_OS_MAC
-      progress.repaint();
-      QApplication::processEvents();
-#endif
-
-      int i = -1;
-
-      while(i++, !list.isEmpty() && !progress.wasCanceled())
-	{
-	  QSqlQuery query(qmain->getDB());
-
-	  query.setForwardOnly(true);
-	  query.prepare("SELECT file, file_name FROM book_files "
-			"WHERE item_oid = ? AND myoid = ?");
-	  query.bindValue(0, m_oid);
-	  query.bindValue(1, list.takeFirst().data());
-
-	  if(query.exec() && query.next())
-	    {
-	      QFile file(dialog.selectedFiles().value(0) + QDir::separator() +
-			 query.value(1).toString());
-
-	      if(file.open(QIODevice::WriteOnly))
-		file.write(qUncompress(query.value(0).toByteArray()));
-
-	      file.flush();
-	      file.close();
-	    }
-
-	  if(i + 1 <= progress.maximum())
-	    progress.setValue(i + 1);
-
-#ifndef Q_OS_MAC
-	  progress.repaint();
-	  QApplication::processEvents();
-#endif
-	}
+      QString errorstr("");
+      QStringList myoids;
+      biblioteq_attachments attachments(this);
+
+      while(!list.isEmpty())
+	myoids.append(list.takeFirst().data().toString());
+
+      if(!attachments.exportFiles(myoids,
+				  "book",
+				  m_oid,
+				  dialog.selectedFiles().value(0),
+				  errorstr) && !errorstr.isEmpty())
+	qmain->addError(QString(tr("Error")),
+			QString(tr("Unable to export the file(s).")),
+			errorstr, __FILE__, __LINE__);
     }
 }
 
@@ -15,6 +15,7 @@
 #include <QMenu>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QPointer>
 #include <QStringList>
 
 /*
@@ -25,6 +26,7 @@
 #include "biblioteq_generic_thread.h"
 #include "biblioteq_item.h"
 #include "biblioteq_misc_functions.h"
+#include "biblioteq_sru_client.h"
 #include "ui_biblioteq_bookinfo.h"
 #include "ui_biblioteq_borrowers.h"
 #include "ui_biblioteq_passwordPrompt.h"
@@ -57,9 +59,9 @@ class biblioteq_book: public QMainWindow, public biblioteq_item
   QHttp *m_sruHttp;
 #endif
   QNetworkAccessManager *m_imageManager;
-  QNetworkAccessManager *m_sruManager;
   QPalette m_te_orig_pal;
   QPalette m_white_pal;
+  QPointer<biblioteq_sru_search> m_sruSearch;
   QString m_cb_orig_ss;
   QString m_dt_orig_ss;
   QString m_engWindowTitle;
@@ -72,9 +74,6 @@ class biblioteq_book: public QMainWindow, public biblioteq_item
   bool useHttp(void) const;
   void changeEvent(QEvent *event);
   void closeEvent(QCloseEvent *event);
-  void createFile(const QByteArray &digest,
-		  const QByteArray &bytes,
-		  const QString &fileName) const;
   void downloadFinished(void);
   void populateFiles(void);
   void sruDownloadFinished(void);
@@ -106,12 +105,12 @@ class biblioteq_book: public QMainWindow, public biblioteq_item
   void slotReset(void);
   void slotSRUDownloadFinished(bool error);
   void slotSRUDownloadFinished(void);
-  void slotSRUError(QNetworkReply::NetworkError error);
   void slotSRUQuery(void);
 #if QT_VERSION < 0x050000
   void slotSRUReadyRead(const QHttpResponseHeader &resp);
 #endif
-  void slotSRUReadyRead(void);
+  void slotSRUResultReady(const QString &site, const QByteArray &data);
+  void slotSRUSearchFinished(void);
   void slotSRUSslErrors(const QList<QSslError> &list);
   void slotSelectImage(void);
   void slotShowUsers(void);
@@ -309,14 +309,14 @@ void biblioteq_borrowers_editor::showUsers(void)
 	      str = QString::number(i + 1);
 	    else if(j == 5 && m_state == biblioteq::EDITABLE)
 	      {
-		date = QDate::fromString(query.value(j).toString(),
-					 "MM/dd/yyyy");
+		date = biblioteq_misc_functions::dateFromString
+		  (query.value(j).toString());
 		str = date.toString(Qt::ISODate);
 	      }
 	    else if((j == 2 || j == 3) && m_state != biblioteq::EDITABLE)
 	      {
-		date = QDate::fromString(query.value(j).toString(),
-					 "MM/dd/yyyy");
+		date = biblioteq_misc_functions::dateFromString
+		  (query.value(j).toString());
 		str = date.toString(Qt::ISODate);
 	      }
 	    else
@@ -329,7 +329,8 @@ void biblioteq_borrowers_editor::showUsers(void)
 
 		if(de)
 		  {
-		    de->setDate(QDate::fromString(str, "MM/dd/yyyy"));
+		    de->setDate
+		      (biblioteq_misc_functions::dateFromString(str));
 		    de->setEnabled(true);
 		    de->setMinimumDate(tomorrow);
 		  }
@@ -370,7 +371,7 @@ void biblioteq_borrowers_editor::slotEraseBorrower(void)
   QString errorstr = "";
   QString memberid = "";
   QString oid = "";
-  QString returnedDate = QDateTime::currentDateTime().toString("MM/dd/yyyy");
+  QString returnedDate = QDate::currentDate().toString(Qt::ISODate);
   int row = m_bd.table->currentRow();
 
   if(row < 0)
@@ -548,7 +549,7 @@ void biblioteq_borrowers_editor::slotSave(void)
 			    "SET duedate = ? "
 			    "WHERE myoid = ? AND "
 			    "type = ?");
-	      query.bindValue(0, dueDate->date().toString("MM/dd/yyyy"));
+	      query.bindValue(0, dueDate->date().toString(Qt::ISODate));
 	      query.bindValue(1, oid);
 	      query.bindValue(2, m_itemType);
 
@@ -19,16 +19,43 @@
 
 #undef BIBLIOTEQ_CALLNUM_DEBUG
 
+/*
+** Kinds of call numbers, in their sort order, and the separator of
+** a key's fields. Call numbers consist of letters, digits and spaces,
+** all of which are greater than these bytes.
+*/
+
+static const char DEWEY_KEY = '\x02';
+static const char LC_KEY = '\x03';
+static const char OTHER_KEY = '\x04';
+static const char SEPARATOR = '\x01';
+
 biblioteq_callnum_table_item::biblioteq_callnum_table_item
-(const QString &str):QTableWidgetItem(str)
+(const QString &str):QTableWidgetItem(str, CALLNUMBER_TYPE)
 {
+  m_sortKey = sortKey(str);
 }
 
-static int callnum_lt(QString m, QString n)
+/*
+** -- sortKey() --
+*/
+
+QByteArray biblioteq_callnum_table_item::sortKey(const QString &str)
 {
+  /*
+  ** Computes a key whose bytes compare as the call numbers do so that
+  ** sorting does not parse call numbers. Dewey numbers precede Library
+  ** of Congress numbers, which precede anything else.
+  */
+
+  QByteArray key;
+
+  if(str.isEmpty())
+    return key;
+
   // In all of its glory.
 
-  QString lc_regexp
+  static const QRegExp lc_regexp
     ("([A-Za-z]+) *([0-9]+)(?: *\\.([0-9]+))?"
      "(?: *\\.([A-Za-z][0-9]+))?(?: *([A-Za-z][0-9]+))?(?: +([0-9]{4}))? *");
 
@@ -42,54 +69,100 @@ static int callnum_lt(QString m, QString n)
   //   6. Year (space is required before it).
   // (http://geography.about.com/library/congress/blhowto.htm)
 
-  QRegExp match1(lc_regexp);
-  QRegExp match2(match1); // Copy constructor should be faster than re-parse.
-  bool res1 = match1.exactMatch(m);
-  bool res2 = match2.exactMatch(n);
+  static const QRegExp dewey_regexp("([0-9]{1,3})(?:\\.([0-9]+))? *(.*)");
 
-#ifdef BIBLIOTEQ_CALLNUM_DEBUG
-  qDebug() << "result: " << res1 << " " << res2 << endl;
-  qDebug() << "matches: " << endl;
+  // CAPTURE FIELDS
+  //   1. Class.
+  //   2. Decimal places.
+  //   3. Cutter number, year, etc.
+
+  QRegExp match(lc_regexp); // Copy constructor should be faster than re-parse.
 
-  for(int i = 1; i <= 6; i++)
-    qDebug() << match1.cap(i) << " " << match2.cap(i) << endl;
+  if(match.exactMatch(str))
+    {
+#ifdef BIBLIOTEQ_CALLNUM_DEBUG
+      for(int i = 1; i <= 6; i++)
+	qDebug() << match.cap(i) << endl;
 #endif
 
-  // First, make sure the regex matched.
+      /*
+      ** Call numbers are compared as integers. Their leading zeros
+      ** are removed and their lengths precede their digits. The
+      ** remaining fields are compared lexicographically; an empty
+      ** field is less than anything.
+      */
 
-  if(res1 && res2)
-    {
-      if(match1.cap(1) == match2.cap(1))
+      QString number(match.cap(2));
+
+      while(number.length() > 1 && number.startsWith('0'))
+	number.remove(0, 1);
+
+      key.append(LC_KEY);
+      key.append(match.cap(1).toUpper().toLatin1());
+      key.append(SEPARATOR);
+      key.append(static_cast<char> (qMin(number.length(), 127)));
+      key.append(number.toLatin1());
+
+      for(int i = 3; i <= 6; i++)
 	{
-	  if(match1.cap(2) == match2.cap(2))
-	    {
-	      // From here on out we can lexicographically sort.
-
-	      for(int i = 3; i <= 5; i++)
-		{
-		  if(match1.cap(i) != match2.cap(i))
-		    // Empty string is less than anything.
-
-		    return match1.cap(i) < match2.cap(i);
-		}
-
-	      return match1.cap(6) < match2.cap(6);
-	    }
-	  else // Different call numbers.
-	    return match1.cap(2).toInt() < match2.cap(2).toInt();
+	  key.append(SEPARATOR);
+	  key.append(match.cap(i).toLatin1());
 	}
-      else // Different call letters.
-	return match1.cap(1).toUpper() < match2.cap(1).toUpper();
+
+      return key;
+    }
+
+  match = dewey_regexp;
+
+  if(match.exactMatch(str))
+    {
+      key.append(DEWEY_KEY);
+      key.append(match.cap(1).rightJustified(3, '0').toLatin1());
+      key.append(match.cap(2).toLatin1());
+      key.append(SEPARATOR);
+      key.append(match.cap(3).toUpper().toUtf8());
+      return key;
     }
 
 #ifdef BIBLIOTEQ_CALLNUM_DEBUG
   qDebug() << "Call number regex match failed." << endl;
 #endif
-  return m < n;
+  key.append(OTHER_KEY);
+  key.append(str.toUtf8());
+  return key;
 }
 
+/*
+** -- operator <() --
+*/
+
 bool biblioteq_callnum_table_item::
 operator <(const QTableWidgetItem &other) const
 {
-  return callnum_lt(text(), other.text());
+  if(other.type() == CALLNUMBER_TYPE)
+    return m_sortKey <
+      static_cast<const biblioteq_callnum_table_item &> (other).m_sortKey;
+  else
+    return m_sortKey < sortKey(other.text());
+}
+
+/*
+** -- lessThan() --
+*/
+
+bool biblioteq_callnum_table_item::lessThan(const QString &m, const QString &n)
+{
+  return sortKey(m) < sortKey(n);
+}
+
+/*
+** -- setData() --
+*/
+
+void biblioteq_callnum_table_item::setData(int role, const QVariant &value)
+{
+  QTableWidgetItem::setData(role, value);
+
+  if(role == Qt::DisplayRole || role == Qt::EditRole)
+    m_sortKey = sortKey(text());
 }
@@ -9,13 +9,21 @@
 ** -- Qt Includes --
 */
 
+#include <QByteArray>
 #include <QTableWidgetItem>
 
 class biblioteq_callnum_table_item: public QTableWidgetItem
 {
  public:
+  static const int CALLNUMBER_TYPE = QTableWidgetItem::UserType + 1;
   biblioteq_callnum_table_item(const QString &str);
   bool operator <(const QTableWidgetItem &other) const;
+  static QByteArray sortKey(const QString &str);
+  static bool lessThan(const QString &m, const QString &n);
+  void setData(int role, const QVariant &value);
+
+ private:
+  QByteArray m_sortKey;
 };
 
 #endif
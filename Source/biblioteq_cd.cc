@@ -482,7 +482,7 @@ void biblioteq_cd::slotGo(void)
       query.bindValue(3, cd.artist->toPlainText());
       query.bindValue(4, cd.no_of_discs->text());
       query.bindValue(5, cd.runtime->text());
-      query.bindValue(6, cd.release_date->date().toString("MM/dd/yyyy"));
+      query.bindValue(6, cd.release_date->date().toString(Qt::ISODate));
       query.bindValue(7, cd.recording_label->toPlainText());
       query.bindValue(8, cd.category->toPlainText());
       query.bindValue(9, cd.price->value());
@@ -503,7 +503,7 @@ void biblioteq_cd::slotGo(void)
 	    {
 	      cd.front_image->m_image.save
 		(&buffer, cd.front_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(17, bytes.toBase64());
+	      query.bindValue(17, bytes);
 	    }
 	  else
 	    query.bindValue(17, QVariant(QVariant::ByteArray));
@@ -523,7 +523,7 @@ void biblioteq_cd::slotGo(void)
 	    {
 	      cd.back_image->m_image.save
 		(&buffer, cd.back_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(18, bytes.toBase64());
+	      query.bindValue(18, bytes);
 	    }
 	  else
 	    query.bindValue(18, QVariant(QVariant::ByteArray));
@@ -675,68 +675,69 @@ void biblioteq_cd::slotGo(void)
 		 (qmain->getUI().table,
 		  m_row, qmain->getUI().table->columnNumber("Type")) == "CD")
 		{
-		  qmain->getUI().table->setSortingEnabled(false);
-
 		  QStringList names(qmain->getUI().table->columnNames());
 
 		  for(i = 0; i < names.size(); i++)
 		    {
 		      if(names.at(i) == "Catalog Number" ||
 			 names.at(i) == "ID Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.id->text());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.id->text());
 		      else if(names.at(i) == "Title")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.title->text());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.title->text());
 		      else if(names.at(i) == "Format")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.format->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.format->currentText().trimmed());
 		      else if(names.at(i) == "Artist")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.artist->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.artist->toPlainText());
 		      else if(names.at(i) == "Number of Discs")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.no_of_discs->text());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.no_of_discs->text());
 		      else if(names.at(i) == "Runtime")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.runtime->text());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.runtime->text());
 		      else if(names.at(i) == "Release Date" ||
 			      names.at(i) == "Publication Date")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.release_date->date().toString
+			qmain->getUI().table->setText
+			  (m_row, i, cd.release_date->date().toString
 			   (Qt::ISODate));
 		      else if(names.at(i) == "Recording Label" ||
 			      names.at(i) == "Publisher")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.recording_label->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.recording_label->toPlainText());
 		      else if(names.at(i) == "Categories")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.category->toPlainText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.category->toPlainText().trimmed());
 		      else if(names.at(i) == "Price")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.price->cleanText());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.price->cleanText());
 		      else if(names.at(i) == "Language")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.language->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.language->currentText().trimmed());
 		      else if(names.at(i) == "Monetary Units")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.monetary_units->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i,
+			   cd.monetary_units->currentText().trimmed());
 		      else if(names.at(i) == "Quantity")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.quantity->text());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.quantity->text());
 		      else if(names.at(i) == "Location")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.location->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.location->currentText().trimmed());
 		      else if(names.at(i) == "Recording Type")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.recording_type->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i,
+			   cd.recording_type->currentText().trimmed());
 		      else if(names.at(i) == "Audio")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (cd.audio->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, cd.audio->currentText().trimmed());
 		      else if(names.at(i) == "Availability")
 			{
-			  qmain->getUI().table->item(m_row, i)->setText
-			    (biblioteq_misc_functions::getAvailability
+			  qmain->getUI().table->setText
+			    (m_row, i,
+			     biblioteq_misc_functions::getAvailability
 			     (m_oid, qmain->getDB(), "CD", errorstr));
 
 			  if(!errorstr.isEmpty())
@@ -747,8 +748,6 @@ void biblioteq_cd::slotGo(void)
 			}
 		    }
 
-		  qmain->getUI().table->setSortingEnabled(true);
-
 		  foreach(QLineEdit *textfield, findChildren<QLineEdit *>())
 		    textfield->setCursorPosition(0);
 
@@ -811,7 +810,7 @@ void biblioteq_cd::slotGo(void)
     }
   else
     {
-      searchstr = "SELECT DISTINCT cd.title, "
+      searchstr = "SELECT cd.title, "
 	"cd.artist, "
 	"cd.cdformat, "
 	"cd.recording_label, "
@@ -827,15 +826,14 @@ void biblioteq_cd::slotGo(void)
 	"cd.location, "
 	"cd.cdaudio, "
 	"cd.cdrecording, "
-	"cd.quantity - COUNT(item_borrower_vw.item_oid) AS availability, "
-	"COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	"cd.quantity - COALESCE(irc.total_reserved, 0) AS availability, "
+	"COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	"cd.type, "
-	"cd.myoid, "
-	"cd.front_cover "
+	"cd.myoid "
 	"FROM "
-	"cd LEFT JOIN item_borrower_vw ON "
-	"cd.myoid = item_borrower_vw.item_oid "
-	"AND item_borrower_vw.type = 'CD' "
+	"cd LEFT JOIN item_reservation_counts irc ON "
+	"cd.myoid = irc.item_oid "
+	"AND irc.type = 'CD' "
 	"WHERE ";
       searchstr.append("id LIKE '%").append(cd.id->text().
 					    trimmed()).
@@ -892,14 +890,25 @@ void biblioteq_cd::slotGo(void)
 			 cd.recording_type->currentText().trimmed() +
 			 "' AND ");
 
-      searchstr.append("title LIKE " + E + "'%").append
-	(biblioteq_myqstring::
-	 escape(cd.title->text().trimmed())).append("%' AND ");
+      bool fullText = biblioteq_misc_functions::hasFullTextSearch
+	(qmain->getDB());
+      QString condition("");
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "CD", "title", cd.title->text());
+
+      if(!condition.isEmpty())
+	searchstr.append(condition + " AND ");
+      else
+	searchstr.append("title LIKE " + E + "'%").append
+	  (biblioteq_myqstring::
+	   escape(cd.title->text().trimmed())).append("%' AND ");
 
       if(cd.release_date->date().toString("MM/yyyy") != "01/7999")
-	searchstr.append("SUBSTR(rdate, 1, 3) || SUBSTR(rdate, 7) = '" +
+	searchstr.append("SUBSTR(rdate, 1, 7) = '" +
 			 cd.release_date->date().toString
-			 ("MM/yyyy") +
+			 ("yyyy-MM") +
 			 "' AND ");
 
       searchstr.append("recording_label LIKE " + E + "'%" +
@@ -935,10 +944,19 @@ void biblioteq_cd::slotGo(void)
       searchstr.append("description LIKE " + E + "'%" +
 		       biblioteq_myqstring::escape
 		       (cd.description->toPlainText().trimmed()) + "%' ");
-      searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
-		       biblioteq_myqstring::escape
-		       (cd.keyword->toPlainText().trimmed()) +
-		       "%' ");
+      condition.clear();
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "CD", "keyword", cd.keyword->toPlainText());
+
+      if(!condition.isEmpty())
+	searchstr.append("AND " + condition + " ");
+      else
+	searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape
+			 (cd.keyword->toPlainText().trimmed()) +
+			 "%' ");
 
       if(cd.quantity->value() != 0)
 	searchstr.append(" AND quantity = " + cd.quantity->text());
@@ -1227,7 +1245,7 @@ void biblioteq_cd::modify(const int state)
 	       var.toString());
 	  else if(fieldname == "rdate")
 	    cd.release_date->setDate
-	      (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+	      (biblioteq_misc_functions::dateFromString(var.toString()));
 	  else if(fieldname == "price")
 	    cd.price->setValue(var.toDouble());
 	  else if(fieldname == "category")
@@ -1323,10 +1341,7 @@ void biblioteq_cd::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  cd.front_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(cd.front_image->m_image.isNull())
-		    cd.front_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	  else if(fieldname == "back_cover")
@@ -1334,10 +1349,7 @@ void biblioteq_cd::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  cd.back_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(cd.back_image->m_image.isNull())
-		    cd.back_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	}
@@ -0,0 +1,410 @@
+/*
+** -- C++ Includes --
+*/
+
+#include <algorithm>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq_callnum_table_item.h"
+#include "biblioteq_columnar_store.h"
+
+/*
+** Orders dictionary entries of interned and numeric columns.
+*/
+
+class biblioteq_columnar_store_dictionary_less
+{
+ public:
+  biblioteq_columnar_store_dictionary_less(const QVector<QString> *dictionary,
+					   const bool numeric)
+  {
+    m_dictionary = dictionary;
+    m_numeric = numeric;
+  }
+
+  bool operator()(const int a, const int b) const
+  {
+    if(m_numeric)
+      return m_dictionary->at(a).toDouble() < m_dictionary->at(b).toDouble();
+    else
+      return m_dictionary->at(a).localeAwareCompare(m_dictionary->at(b)) < 0;
+  }
+
+ private:
+  const QVector<QString> *m_dictionary;
+  bool m_numeric;
+};
+
+/*
+** Orders row numbers by the values of a single column.
+*/
+
+class biblioteq_columnar_store_row_less
+{
+ public:
+  biblioteq_columnar_store_row_less
+    (const biblioteq_columnar_store::ColumnKind kind,
+     const QVector<int> *ranks,
+     const QVector<quint32> *indexes,
+     const QVector<QByteArray> *keys,
+     const QVector<QString> *strings,
+     const bool ascending)
+  {
+    m_ascending = ascending;
+    m_indexes = indexes;
+    m_keys = keys;
+    m_kind = kind;
+    m_ranks = ranks;
+    m_strings = strings;
+  }
+
+  bool operator()(const int a, const int b) const
+  {
+    if(m_ascending)
+      return lessThan(a, b);
+    else
+      return lessThan(b, a);
+  }
+
+ private:
+  biblioteq_columnar_store::ColumnKind m_kind;
+  bool m_ascending;
+  const QVector<QByteArray> *m_keys;
+  const QVector<QString> *m_strings;
+  const QVector<int> *m_ranks;
+  const QVector<quint32> *m_indexes;
+
+  bool lessThan(const int a, const int b) const
+  {
+    switch(m_kind)
+      {
+      case biblioteq_columnar_store::CALLNUMBER_COLUMN:
+	return m_keys->at(a) < m_keys->at(b);
+      case biblioteq_columnar_store::INTERNED_COLUMN:
+      case biblioteq_columnar_store::NUMERIC_COLUMN:
+	return m_ranks->at(static_cast<int> (m_indexes->at(a))) <
+	  m_ranks->at(static_cast<int> (m_indexes->at(b)));
+      case biblioteq_columnar_store::TEXT_COLUMN:
+	return m_strings->at(a).localeAwareCompare(m_strings->at(b)) < 0;
+      default:
+	return false;
+      }
+  }
+};
+
+/*
+** -- biblioteq_columnar_store() --
+*/
+
+biblioteq_columnar_store::biblioteq_columnar_store(void)
+{
+  m_rowCount = 0;
+}
+
+/*
+** -- columnKindForField() --
+*/
+
+biblioteq_columnar_store::ColumnKind
+biblioteq_columnar_store::columnKindForField(const QString &fieldName)
+{
+  QString name(fieldName.toLower());
+
+  if(name.endsWith("front_cover") || name.endsWith("image_scaled"))
+    return EMPTY_COLUMN;
+  else if(name.endsWith("issue") ||
+	  name.endsWith("price") ||
+	  name.endsWith("volume") ||
+	  name.endsWith("quantity") ||
+	  name.endsWith("issueno") ||
+	  name.endsWith("issuevolume") ||
+	  name.endsWith("cddiskcount") ||
+	  name.endsWith("dvddiskcount") ||
+	  name.endsWith("availability") ||
+	  name.endsWith("total_reserved") ||
+	  name.endsWith("photograph_count"))
+    return NUMERIC_COLUMN;
+  else if(name.endsWith("callnumber"))
+    return CALLNUMBER_COLUMN;
+  else if(name.endsWith("binding_type") ||
+	  name.endsWith("category") ||
+	  name.endsWith("condition") ||
+	  name.endsWith("dvdaspectratio") ||
+	  name.endsWith("dvdformat") ||
+	  name.endsWith("dvdrating") ||
+	  name.endsWith("dvdregion") ||
+	  name.endsWith("cdaudio") ||
+	  name.endsWith("cdformat") ||
+	  name.endsWith("cdrecording") ||
+	  name.endsWith("genre") ||
+	  name.endsWith("language") ||
+	  name.endsWith("location") ||
+	  name.endsWith("monetary_units") ||
+	  name.endsWith("originality") ||
+	  name.endsWith("place") ||
+	  name.endsWith("publisher") ||
+	  name.endsWith("recording_label") ||
+	  name.endsWith("studio") ||
+	  name.endsWith("type") ||
+	  name.endsWith("vgmode") ||
+	  name.endsWith("vgplatform") ||
+	  name.endsWith("vgrating"))
+    return INTERNED_COLUMN;
+  else
+    return TEXT_COLUMN;
+}
+
+/*
+** -- columnKind() --
+*/
+
+biblioteq_columnar_store::ColumnKind
+biblioteq_columnar_store::columnKind(const int column) const
+{
+  if(column >= 0 && column < m_columns.size())
+    return m_columns.at(column).kind;
+  else
+    return EMPTY_COLUMN;
+}
+
+/*
+** -- columnCount() --
+*/
+
+int biblioteq_columnar_store::columnCount(void) const
+{
+  return m_columns.size();
+}
+
+/*
+** -- rowCount() --
+*/
+
+int biblioteq_columnar_store::rowCount(void) const
+{
+  return m_rowCount;
+}
+
+/*
+** -- clear() --
+*/
+
+void biblioteq_columnar_store::clear(void)
+{
+  m_columns.clear();
+  m_rowCount = 0;
+}
+
+/*
+** -- setColumns() --
+*/
+
+void biblioteq_columnar_store::setColumns(const QStringList &fieldNames)
+{
+  clear();
+  m_columns.resize(fieldNames.size());
+
+  for(int i = 0; i < fieldNames.size(); i++)
+    m_columns[i].kind = columnKindForField(fieldNames.at(i));
+}
+
+/*
+** -- intern() --
+*/
+
+quint32 biblioteq_columnar_store::intern(Column &column, const QString &text)
+{
+  QHash<QString, quint32>::const_iterator it(column.lookup.constFind(text));
+
+  if(it != column.lookup.constEnd())
+    return it.value();
+
+  quint32 index = static_cast<quint32> (column.dictionary.size());
+
+  column.dictionary.append(text);
+  column.lookup.insert(text, index);
+  return index;
+}
+
+/*
+** -- appendRow() --
+*/
+
+void biblioteq_columnar_store::appendRow(const QStringList &values)
+{
+  for(int i = 0; i < m_columns.size(); i++)
+    {
+      Column &column = m_columns[i];
+
+      switch(column.kind)
+	{
+	case INTERNED_COLUMN:
+	case NUMERIC_COLUMN:
+	  column.indexes.append(intern(column, values.value(i)));
+	  break;
+	case CALLNUMBER_COLUMN:
+	  /*
+	  ** Call numbers are sorted by keys that are computed once.
+	  */
+
+	  column.keys.append
+	    (biblioteq_callnum_table_item::sortKey(values.value(i)));
+	  column.strings.append(values.value(i));
+	  break;
+	case TEXT_COLUMN:
+	  column.strings.append(values.value(i));
+	  break;
+	default:
+	  break;
+	}
+    }
+
+  m_rowCount += 1;
+}
+
+/*
+** -- text() --
+*/
+
+QString biblioteq_columnar_store::text(const int row, const int column) const
+{
+  if(column < 0 || column >= m_columns.size() || row < 0 || row >= m_rowCount)
+    return QString("");
+
+  const Column &c = m_columns.at(column);
+
+  switch(c.kind)
+    {
+    case INTERNED_COLUMN:
+    case NUMERIC_COLUMN:
+      return c.dictionary.at(static_cast<int> (c.indexes.at(row)));
+    case CALLNUMBER_COLUMN:
+    case TEXT_COLUMN:
+      return c.strings.at(row);
+    default:
+      return QString("");
+    }
+}
+
+/*
+** -- setText() --
+*/
+
+void biblioteq_columnar_store::setText(const int row, const int column,
+				       const QString &text)
+{
+  if(column < 0 || column >= m_columns.size() || row < 0 || row >= m_rowCount)
+    return;
+
+  Column &c = m_columns[column];
+
+  switch(c.kind)
+    {
+    case INTERNED_COLUMN:
+    case NUMERIC_COLUMN:
+      c.indexes[row] = intern(c, text);
+      break;
+    case CALLNUMBER_COLUMN:
+      c.keys[row] = biblioteq_callnum_table_item::sortKey(text);
+      c.strings[row] = text;
+      break;
+    case TEXT_COLUMN:
+      c.strings[row] = text;
+      break;
+    default:
+      break;
+    }
+}
+
+/*
+** -- sort() --
+*/
+
+void biblioteq_columnar_store::sort(const int column, const bool ascending)
+{
+  if(column < 0 || column >= m_columns.size() || m_rowCount < 2)
+    return;
+
+  const Column &c = m_columns.at(column);
+
+  if(c.kind == EMPTY_COLUMN)
+    return;
+
+  /*
+  ** Interned values are ranked once so that comparing two rows
+  ** is an integer comparison.
+  */
+
+  QVector<int> ranks;
+
+  if(c.kind == INTERNED_COLUMN || c.kind == NUMERIC_COLUMN)
+    {
+      QVector<int> order(c.dictionary.size());
+
+      for(int i = 0; i < order.size(); i++)
+	order[i] = i;
+
+      biblioteq_columnar_store_dictionary_less dictionaryLess
+	(&c.dictionary, c.kind == NUMERIC_COLUMN);
+
+      std::sort(order.begin(), order.end(), dictionaryLess);
+      ranks.resize(order.size());
+
+      for(int i = 0; i < order.size(); i++)
+	if(i > 0 && !dictionaryLess(order.at(i - 1), order.at(i)))
+	  ranks[order.at(i)] = ranks.at(order.at(i - 1));
+	else
+	  ranks[order.at(i)] = i;
+    }
+
+  QVector<int> permutation(m_rowCount);
+
+  for(int i = 0; i < permutation.size(); i++)
+    permutation[i] = i;
+
+  std::stable_sort(permutation.begin(), permutation.end(),
+		   biblioteq_columnar_store_row_less(c.kind,
+						     &ranks,
+						     &c.indexes,
+						     &c.keys,
+						     &c.strings,
+						     ascending));
+
+  for(int i = 0; i < m_columns.size(); i++)
+    {
+      Column &current = m_columns[i];
+
+      if(!current.indexes.isEmpty())
+	{
+	  QVector<quint32> indexes(current.indexes.size());
+
+	  for(int j = 0; j < permutation.size(); j++)
+	    indexes[j] = current.indexes.at(permutation.at(j));
+
+	  current.indexes = indexes;
+	}
+
+      if(!current.keys.isEmpty())
+	{
+	  QVector<QByteArray> keys(current.keys.size());
+
+	  for(int j = 0; j < permutation.size(); j++)
+	    keys[j] = current.keys.at(permutation.at(j));
+
+	  current.keys = keys;
+	}
+
+      if(!current.strings.isEmpty())
+	{
+	  QVector<QString> strings(current.strings.size());
+
+	  for(int j = 0; j < permutation.size(); j++)
+	    strings[j] = current.strings.at(permutation.at(j));
+
+	  current.strings = strings;
+	}
+    }
+}
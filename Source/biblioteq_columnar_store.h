@@ -0,0 +1,60 @@
+#ifndef _BIBLIOTEQ_COLUMNAR_STORE_H_
+#define _BIBLIOTEQ_COLUMNAR_STORE_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*
+** A compact, column-oriented copy of the main table's results.
+** Values that repeat heavily (types, languages, locations, etc.) are
+** interned so that a row costs a single index per such column.
+*/
+
+class biblioteq_columnar_store
+{
+ public:
+  enum ColumnKind
+  {
+    CALLNUMBER_COLUMN = 0,
+    EMPTY_COLUMN,
+    INTERNED_COLUMN,
+    NUMERIC_COLUMN,
+    TEXT_COLUMN
+  };
+
+  biblioteq_columnar_store(void);
+  ColumnKind columnKind(const int column) const;
+  QString text(const int row, const int column) const;
+  int columnCount(void) const;
+  int rowCount(void) const;
+  static ColumnKind columnKindForField(const QString &fieldName);
+  void appendRow(const QStringList &values);
+  void clear(void);
+  void setColumns(const QStringList &fieldNames);
+  void setText(const int row, const int column, const QString &text);
+  void sort(const int column, const bool ascending);
+
+ private:
+  struct Column
+  {
+    ColumnKind kind;
+    QHash<QString, quint32> lookup;
+    QVector<QByteArray> keys;
+    QVector<QString> dictionary;
+    QVector<QString> strings;
+    QVector<quint32> indexes;
+  };
+
+  QVector<Column> m_columns;
+  int m_rowCount;
+  static quint32 intern(Column &column, const QString &text);
+};
+
+#endif
@@ -1,3 +1,9 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QSet>
+
 /*
 ** -- Local Includes --
 */
@@ -74,6 +80,7 @@ biblioteq_copy_editor::biblioteq_copy_editor
 biblioteq_copy_editor::~biblioteq_copy_editor()
 {
   clearCopiesList();
+  clearStoredCopies();
 }
 
 /*
@@ -301,7 +308,8 @@ void biblioteq_copy_editor::populateCopiesEditor(void)
 			"%1_copy_info.copyid, "
 			"(1 - COUNT(item_borrower_vw.copyid)), "
 			"%1_copy_info.item_oid, "
-			"%1_copy_info.copy_number "
+			"%1_copy_info.copy_number, "
+			"%1_copy_info.myoid "
 			"FROM "
 			"%1, "
 			"%1_copy_info LEFT JOIN item_borrower_vw ON "
@@ -315,7 +323,8 @@ void biblioteq_copy_editor::populateCopiesEditor(void)
 			"GROUP BY %1.title, "
 			"%1_copy_info.copyid, "
 			"%1_copy_info.item_oid, "
-			"%1_copy_info.copy_number "
+			"%1_copy_info.copy_number, "
+			"%1_copy_info.myoid "
 			"ORDER BY %1_copy_info.copy_number").
 		arg(m_itemType.toLower().remove(" ")));
   query.bindValue(0, m_itemType);
@@ -359,11 +368,39 @@ void biblioteq_copy_editor::populateCopiesEditor(void)
 #endif
   i = -1;
 
+  if(!m_showForLending)
+    clearStoredCopies();
+
   while(i++, !progress2.wasCanceled() && query.next())
     {
       if(query.isValid())
 	{
-	  row = query.value(4).toInt() - 1;
+	  /*
+	  ** The copies are ordered by their copy numbers. Each row
+	  ** retains its copy's myoid so that a save only writes what
+	  ** was changed.
+	  */
+
+	  row = i;
+
+	  if(!m_showForLending && m_cb.table->item(row, 1) != 0)
+	    {
+	      copy_class *copy = new(std::nothrow) copy_class
+		(query.value(1).toString(), m_ioid);
+
+	      if(copy)
+		{
+		  copy->m_copyNumber = query.value(4).toInt();
+		  copy->m_myoid = query.value(5).toString();
+		  storeCopy(row, copy);
+		}
+	      else
+		qmain->addError
+		  (QString(tr("Memory Error")),
+		   QString(tr("Unable to allocate memory for the \"copy\" "
+			      "object. This is a serious problem!")),
+		   QString(""), __FILE__, __LINE__);
+	    }
 
 	  for(j = 0; j < m_cb.table->columnCount(); j++)
 	    if(m_cb.table->item(row, j) != 0)
@@ -426,10 +463,10 @@ void biblioteq_copy_editor::slotCheckoutCopy(void)
   QDate now = QDate::currentDate();
   QSqlQuery query(qmain->getDB());
   QString availability = "";
-  QString checkedout = now.toString("MM/dd/yyyy");
+  QString checkedout = now.toString(Qt::ISODate);
   QString copyid = "";
   QString copynumber = "";
-  QString duedate = m_cb.dueDate->date().toString("MM/dd/yyyy");
+  QString duedate = m_cb.dueDate->date().toString(Qt::ISODate);
   QString errorstr = "";
   QString memberid = "";
   QString name = "";
@@ -590,12 +627,10 @@ void biblioteq_copy_editor::slotCheckoutCopy(void)
     {
     biblioteq_misc_functions::updateColumn
     (qmain->getUI().table, bitem->getRow(), tr("Due Date"),
-    QDate::fromString(duedate, "MM/dd/yyyy").
-    toString(Qt::ISODate));
+    duedate);
     biblioteq_misc_functions::updateColumn
     (qmain->getUI().table, bitem->getRow(), tr("Reservation Date"),
-    QDate::fromString(checkedout, "MM/dd/yyyy").toString
-    (Qt::ISODate));
+    checkedout);
     biblioteq_misc_functions::updateColumn
     (qmain->getUI().table, bitem->getRow(), tr("Member ID"),
     memberid);
@@ -707,7 +742,11 @@ void biblioteq_copy_editor::slotSaveCopies(void)
 
       if((copy = new(std::nothrow) copy_class(item1->text().trimmed(),
 					      item2->text())) != 0)
-	m_copies.append(copy);
+	{
+	  copy->m_myoid = item1->data(Qt::UserRole).toString();
+	  copy->m_row = i;
+	  m_copies.append(copy);
+	}
       else
 	qmain->addError
 	  (QString(tr("Memory Error")),
@@ -766,6 +805,18 @@ void biblioteq_copy_editor::slotSaveCopies(void)
       return;
     }
 
+  clearStoredCopies();
+
+  for(i = 0; i < m_copies.size(); i++)
+    if((copy = new(std::nothrow) copy_class(*m_copies.at(i))) != 0)
+      storeCopy(copy->m_row, copy);
+    else
+      qmain->addError
+	(QString(tr("Memory Error")),
+	 QString(tr("Unable to allocate memory for the \"copy\" object. "
+		    "This is a serious problem!")),
+	 QString(""), __FILE__, __LINE__);
+
   QApplication::restoreOverrideCursor();
 
   if(m_spinbox)
@@ -805,113 +856,262 @@ void biblioteq_copy_editor::slotSaveCopies(void)
 
 QString biblioteq_copy_editor::saveCopies(void)
 {
-  QProgressDialog progress(this);
+  /*
+  ** The copies are matched with the stored copies by their myoids.
+  ** Only the differences are written. Each kind of change is
+  ** applied as a single batch.
+  */
+
+  QList<copy_class *> inserted;
+  QList<copy_class *> updated;
+  QSet<QString> retained;
   QSqlQuery query(qmain->getDB());
-  QString lastError = "";
-  copy_class *copy = 0;
-  int i = 0;
+  QString lastError("");
+  QString table(m_itemType.toLower().remove(" "));
+  bool renamed = false;
+
+  for(int i = 0; i < m_copies.size(); i++)
+    {
+      copy_class *copy = m_copies.at(i);
+
+      if(!copy)
+	continue;
+
+      copy->m_copyNumber = i + 1;
+
+      if(m_storedCopies.contains(copy->m_myoid))
+	{
+	  copy_class *stored = m_storedCopies.value(copy->m_myoid);
+
+	  retained.insert(copy->m_myoid);
+
+	  if(stored->m_copyid != copy->m_copyid)
+	    renamed = true;
+
+	  if(stored->m_copyNumber != copy->m_copyNumber ||
+	     stored->m_copyid != copy->m_copyid)
+	    updated.append(copy);
+	}
+      else
+	inserted.append(copy);
+    }
 
-#ifdef Q_OS_MAC
-#if QT_VERSION < 0x050000
-  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
-#endif
-#endif
-  query.prepare(QString("DELETE FROM %1_copy_info WHERE "
-			"item_oid = ?").arg(m_itemType.
-					    toLower().remove(" ")));
-  query.bindValue(0, m_ioid);
   QApplication::setOverrideCursor(Qt::WaitCursor);
 
-  if(!query.exec())
+  QHashIterator<QString, copy_class *> it(m_storedCopies);
+  QVariantList itemOids;
+  QVariantList myoids;
+
+  while(it.hasNext())
     {
-      QApplication::restoreOverrideCursor();
-      qmain->addError(QString(tr("Database Error")),
-		      QString(tr("Unable to purge copy data.")),
-		      query.lastError().text(), __FILE__, __LINE__);
-      return query.lastError().text();
+      it.next();
+
+      if(!retained.contains(it.key()))
+	{
+	  itemOids << m_ioid;
+	  myoids << it.key();
+	}
     }
-  else
+
+  if(!myoids.isEmpty())
     {
-      QApplication::restoreOverrideCursor();
-      progress.setCancelButton(0);
-      progress.setModal(true);
-      progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
-      progress.setLabelText(tr("Saving the copy data..."));
-      progress.setMaximum(m_copies.size());
-      progress.setMinimum(0);
-      progress.show();
-#ifndef Q_OS_MAC
-      progress.repaint();
-      QApplication::processEvents();
-#endif
+      query.prepare(QString("DELETE FROM %1_copy_info WHERE "
+			    "item_oid = ? AND myoid = ?").arg(table));
+      query.addBindValue(itemOids);
+      query.addBindValue(myoids);
 
-      for(i = 0; i < m_copies.size(); i++)
+      if(!query.execBatch())
 	{
-	  copy = m_copies.at(i);
-
-	  if(!copy)
-	    goto continue_label;
-
-	  if(qmain->getDB().driverName() != "QSQLITE")
-	    query.prepare(QString("INSERT INTO %1_copy_info "
-				  "(item_oid, copy_number, "
-				  "copyid) "
-				  "VALUES (?, "
-				  "?, ?)").arg
-			  (m_itemType.toLower().remove(" ")));
-	  else
-	    query.prepare(QString("INSERT INTO %1_copy_info "
-				  "(item_oid, copy_number, "
-				  "copyid, myoid) "
-				  "VALUES (?, "
-				  "?, ?, ?)").arg
-			  (m_itemType.toLower().remove(" ")));
-
-	  query.bindValue(0, copy->m_itemoid);
-	  query.bindValue(1, i + 1);
-	  query.bindValue(2, copy->m_copyid);
-
-	  if(qmain->getDB().driverName() == "QSQLITE")
-	    {
-	      qint64 value = 0;
-	      QString errorstr("");
+	  lastError = query.lastError().text();
+	  qmain->addError(QString(tr("Database Error")),
+			  QString(tr("Unable to purge copy data.")),
+			  query.lastError().text(), __FILE__, __LINE__);
+	}
+    }
 
-	      value = biblioteq_misc_functions::getSqliteUniqueId
-		(qmain->getDB(),
-		 errorstr);
+  if(lastError.isEmpty() && !updated.isEmpty())
+    {
+      QVariantList copyNumbers;
+      QVariantList copyids;
+      QVariantList temporary;
+
+      itemOids.clear();
+      myoids.clear();
+
+      for(int i = 0; i < updated.size(); i++)
+	{
+	  copyNumbers << updated.at(i)->m_copyNumber;
+	  copyids << updated.at(i)->m_copyid;
+	  itemOids << m_ioid;
+	  myoids << updated.at(i)->m_myoid;
+	  temporary << QString("\t%1").arg(updated.at(i)->m_myoid);
+	}
+
+      if(renamed)
+	{
+	  /*
+	  ** Barcodes are unique within an item. Copies may exchange
+	  ** barcodes only if their barcodes are first made
+	  ** distinct.
+	  */
+
+	  query.prepare(QString("UPDATE %1_copy_info SET copyid = ? "
+				"WHERE item_oid = ? AND myoid = ?").
+			arg(table));
+	  query.addBindValue(temporary);
+	  query.addBindValue(itemOids);
+	  query.addBindValue(myoids);
+
+	  if(!query.execBatch())
+	    lastError = query.lastError().text();
+	}
+
+      if(lastError.isEmpty())
+	{
+	  query.prepare(QString("UPDATE %1_copy_info SET copyid = ?, "
+				"copy_number = ? "
+				"WHERE item_oid = ? AND myoid = ?").
+			arg(table));
+	  query.addBindValue(copyids);
+	  query.addBindValue(copyNumbers);
+	  query.addBindValue(itemOids);
+	  query.addBindValue(myoids);
+
+	  if(!query.execBatch())
+	    lastError = query.lastError().text();
+	}
+
+      if(!lastError.isEmpty())
+	qmain->addError(QString(tr("Database Error")),
+			QString(tr("Unable to update copy data.")),
+			lastError, __FILE__, __LINE__);
+    }
+
+  if(lastError.isEmpty() && !inserted.isEmpty())
+    {
+      QString errorstr("");
+      QVariantList copyNumbers;
+      QVariantList copyids;
+      qint64 oid = -1;
+
+      itemOids.clear();
+      myoids.clear();
+
+      if(qmain->getDB().driverName() == "QSQLITE")
+	oid = biblioteq_misc_functions::getSqliteUniqueIds
+	  (qmain->getDB(), inserted.size(), errorstr);
+
+      for(int i = 0; i < inserted.size(); i++)
+	{
+	  copyNumbers << inserted.at(i)->m_copyNumber;
+	  copyids << inserted.at(i)->m_copyid;
+	  itemOids << inserted.at(i)->m_itemoid;
+	  myoids << oid + i;
+	}
+
+      if(!errorstr.isEmpty())
+	{
+	  lastError = errorstr;
+	  qmain->addError(QString(tr("Database Error")),
+			  QString(tr("Unable to generate a unique "
+				     "integer.")),
+			  errorstr);
+	}
+      else if(qmain->getDB().driverName() != "QSQLITE")
+	{
+	  /*
+	  ** The PostgreSQL driver executes batches one row at a time.
+	  ** Inserting each copy separately costs nothing more and
+	  ** returns the copy's myoid.
+	  */
+
+	  query.prepare(QString("INSERT INTO %1_copy_info "
+				"(item_oid, copy_number, "
+				"copyid) "
+				"VALUES (?, "
+				"?, ?) RETURNING myoid").arg(table));
+
+	  for(int i = 0; i < inserted.size(); i++)
+	    {
+	      query.addBindValue(itemOids.at(i));
+	      query.addBindValue(copyNumbers.at(i));
+	      query.addBindValue(copyids.at(i));
 
-	      if(errorstr.isEmpty())
-		query.bindValue(3, value);
+	      if(query.exec() && query.next())
+		inserted.at(i)->m_myoid = query.value(0).toString();
 	      else
-		qmain->addError(QString(tr("Database Error")),
-				QString(tr("Unable to generate a unique "
-					   "integer.")),
-				errorstr);
+		{
+		  lastError = query.lastError().text();
+		  qmain->addError(QString(tr("Database Error")),
+				  QString(tr("Unable to create copy data.")),
+				  query.lastError().text(),
+				  __FILE__, __LINE__);
+		  break;
+		}
 	    }
-
-	  if(!query.exec())
+	}
+      else
+	{
+	  query.prepare(QString("INSERT INTO %1_copy_info "
+				"(item_oid, copy_number, "
+				"copyid, myoid) "
+				"VALUES (?, "
+				"?, ?, ?)").arg(table));
+	  query.addBindValue(itemOids);
+	  query.addBindValue(copyNumbers);
+	  query.addBindValue(copyids);
+	  query.addBindValue(myoids);
+
+	  if(!query.execBatch())
 	    {
 	      lastError = query.lastError().text();
 	      qmain->addError(QString(tr("Database Error")),
 			      QString(tr("Unable to create copy data.")),
 			      query.lastError().text(), __FILE__, __LINE__);
 	    }
+	  else
+	    for(int i = 0; i < inserted.size(); i++)
+	      inserted.at(i)->m_myoid = myoids.at(i).toString();
+	}
+    }
 
-	continue_label:
+  QApplication::restoreOverrideCursor();
+  return lastError;
+}
 
-	  if(i + 1 <= progress.maximum())
-	    progress.setValue(i + 1);
+/*
+** -- storeCopy() --
+*/
 
-#ifndef Q_OS_MAC
-	  progress.repaint();
-	  QApplication::processEvents();
-#endif
-	}
+void biblioteq_copy_editor::storeCopy(const int row, copy_class *copy)
+{
+  if(!copy)
+    return;
+
+  if(m_storedCopies.contains(copy->m_myoid))
+    delete m_storedCopies.take(copy->m_myoid);
+
+  m_storedCopies.insert(copy->m_myoid, copy);
 
-      progress.close();
+  if(m_cb.table->item(row, 1))
+    m_cb.table->item(row, 1)->setData(Qt::UserRole, copy->m_myoid);
+}
+
+/*
+** -- clearStoredCopies() --
+*/
+
+void biblioteq_copy_editor::clearStoredCopies(void)
+{
+  QHashIterator<QString, copy_class *> it(m_storedCopies);
+
+  while(it.hasNext())
+    {
+      it.next();
+      delete it.value();
     }
 
-  return lastError;
+  m_storedCopies.clear();
 }
 
 /*
@@ -6,6 +6,7 @@
 */
 
 #include <QDialog>
+#include <QHash>
 #include <QMainWindow>
 #include <QMessageBox>
 #include <QSpinBox>
@@ -41,15 +42,21 @@ class biblioteq_copy_editor: public QDialog
   public:
     copy_class(const QString &copyid_arg, const QString &itemoid_arg)
     {
+      m_copyNumber = 0;
       m_copyid = copyid_arg;
       m_itemoid = itemoid_arg;
+      m_row = -1;
     };
 
   public:
     QString m_copyid;
     QString m_itemoid;
+    QString m_myoid;
+    int m_copyNumber;
+    int m_row;
   };
 
+  QHash<QString, copy_class *> m_storedCopies;
   QList<copy_class *> m_copies;
   QSpinBox *m_spinbox;
   QString m_ioid;
@@ -62,8 +69,10 @@ class biblioteq_copy_editor: public QDialog
   int m_quantity;
   QString saveCopies(void);
   void changeEvent(QEvent *event);
+  void clearStoredCopies(void);
   void closeEvent(QCloseEvent *event);
   void keyPressEvent(QKeyEvent *event);
+  void storeCopy(const int row, copy_class *copy);
 
  protected:
   void clearCopiesList(void);
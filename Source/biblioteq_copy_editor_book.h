@@ -6,6 +6,7 @@
 */
 
 #include <QDialog>
+#include <QHash>
 #include <QMainWindow>
 #include <QMessageBox>
 #include <QSpinBox>
@@ -44,18 +45,24 @@ class biblioteq_copy_editor_book: public biblioteq_copy_editor
 	       const QString &originality_arg)
     {
       m_condition = condition_arg;
+      m_copyNumber = 0;
       m_copyid = copyid_arg;
       m_itemoid = itemoid_arg;
       m_originality = originality_arg;
+      m_row = -1;
     };
 
   public:
     QString m_condition;
     QString m_copyid;
     QString m_itemoid;
+    QString m_myoid;
     QString m_originality;
+    int m_copyNumber;
+    int m_row;
   };
 
+  QHash<QString, copy_class *> m_storedCopies;
   QList<copy_class *> m_copies;
   QSpinBox *m_spinbox;
   QString m_ioid;
@@ -68,8 +75,10 @@ class biblioteq_copy_editor_book: public biblioteq_copy_editor
   int m_quantity;
   QString saveCopies(void);
   void changeEvent(QEvent *event);
+  void clearStoredCopies(void);
   void closeEvent(QCloseEvent *event);
   void keyPressEvent(QKeyEvent *event);
+  void storeCopy(const int row, copy_class *copy);
 
  private slots:
   void slotDeleteCopy(void);
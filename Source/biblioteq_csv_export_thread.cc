@@ -0,0 +1,191 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QSqlRecord>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq_csv_export_thread.h"
+
+/*
+** -- biblioteq_csv_export_thread() --
+*/
+
+biblioteq_csv_export_thread::biblioteq_csv_export_thread(QObject *parent):
+  biblioteq_query_thread(parent)
+{
+  m_delimiter = ',';
+  m_rowsWritten = 0;
+}
+
+/*
+** -- ~biblioteq_csv_export_thread() --
+*/
+
+biblioteq_csv_export_thread::~biblioteq_csv_export_thread()
+{
+  cancel();
+  wait();
+}
+
+/*
+** -- field() --
+*/
+
+QByteArray biblioteq_csv_export_thread::field(const QString &value) const
+{
+  QString str(value);
+
+  if(m_delimiter == '\t')
+    {
+      /*
+      ** TSV does not provide quoting.
+      */
+
+      str.replace("\r\n", " ");
+      str.replace('\r', ' ');
+      str.replace('\n', ' ');
+      str.replace('\t', ' ');
+      return str.toUtf8();
+    }
+
+  if(str.contains(m_delimiter) || str.contains('"') ||
+     str.contains('\n') || str.contains('\r'))
+    {
+      str.replace("\"", "\"\"");
+      str.prepend('"');
+      str.append('"');
+    }
+
+  return str.toUtf8();
+}
+
+/*
+** -- processQuery() --
+*/
+
+void biblioteq_csv_export_thread::processQuery(QSqlQuery &query)
+{
+  QFile file(m_fileName);
+
+  if(!file.open(QIODevice::Truncate | QIODevice::WriteOnly))
+    {
+      setErrorStr(file.errorString());
+      return;
+    }
+
+  QByteArray buffer;
+  QSqlRecord record(query.record());
+  bool ok = true;
+  qint64 rows = 0;
+
+  buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 8);
+
+  if(!m_headers.isEmpty())
+    {
+      for(int i = 0; i < m_headers.size(); i++)
+	{
+	  if(i > 0)
+	    buffer.append(QString(m_delimiter).toUtf8());
+
+	  buffer.append(field(m_headers.at(i)));
+	}
+
+      buffer.append("\r\n");
+    }
+
+  while(!wasCanceled() && query.next())
+    {
+      for(int i = 0; i < m_columns.size(); i++)
+	{
+	  if(i > 0)
+	    buffer.append(QString(m_delimiter).toUtf8());
+
+	  int column = m_columns.at(i);
+
+	  if(column < 0 || column >= record.count())
+	    continue;
+
+	  QString fieldName(record.fieldName(column));
+	  QVariant value(query.value(column));
+
+	  if(fieldName.endsWith("price"))
+	    buffer.append(field(QString::number(value.toDouble(), 'f', 2)));
+	  else
+	    {
+	      value = decode(fieldName, value);
+
+	      /*
+	      ** Images are not exported.
+	      */
+
+	      if(value.type() != QVariant::ByteArray)
+		buffer.append(field(value.toString()));
+	    }
+	}
+
+      buffer.append("\r\n");
+      rows += 1;
+
+      if(buffer.size() >= BUFFER_SIZE)
+	{
+	  if(file.write(buffer) != buffer.size())
+	    {
+	      ok = false;
+	      break;
+	    }
+
+	  buffer.truncate(0);
+
+	  QMutexLocker locker(&m_mutex);
+
+	  m_rowsWritten = rows;
+	}
+    }
+
+  if(ok && !buffer.isEmpty())
+    ok = file.write(buffer) == buffer.size();
+
+  if(!ok)
+    setErrorStr(file.errorString());
+
+  file.close();
+
+  if(!ok || wasCanceled())
+    file.remove();
+
+  QMutexLocker locker(&m_mutex);
+
+  m_rowsWritten = rows;
+}
+
+/*
+** -- rowsWritten() --
+*/
+
+qint64 biblioteq_csv_export_thread::rowsWritten(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_rowsWritten;
+}
+
+/*
+** -- setOutput() --
+*/
+
+void biblioteq_csv_export_thread::setOutput(const QString &fileName,
+					    const QList<int> &columns,
+					    const QStringList &headers,
+					    const QChar &delimiter)
+{
+  m_columns = columns;
+  m_delimiter = delimiter;
+  m_fileName = fileName;
+  m_headers = headers;
+}
@@ -0,0 +1,51 @@
+#ifndef _BIBLIOTEQ_CSV_EXPORT_THREAD_H_
+#define _BIBLIOTEQ_CSV_EXPORT_THREAD_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QByteArray>
+#include <QChar>
+#include <QList>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq_query_thread.h"
+
+/*
+** Writes the complete result set of a query to a CSV (RFC 4180) or
+** a TSV file. Rows are read with a forward-only cursor on the thread's
+** own connection and are written through a large buffer, so memory
+** use does not depend on the size of the result set.
+*/
+
+class biblioteq_csv_export_thread: public biblioteq_query_thread
+{
+  Q_OBJECT
+
+ public:
+  static const int BUFFER_SIZE = 1024 * 1024;
+  biblioteq_csv_export_thread(QObject *parent);
+  ~biblioteq_csv_export_thread();
+  qint64 rowsWritten(void) const;
+  void setOutput(const QString &fileName,
+		 const QList<int> &columns,
+		 const QStringList &headers,
+		 const QChar &delimiter);
+
+ protected:
+  void processQuery(QSqlQuery &query);
+
+ private:
+  QChar m_delimiter;
+  QList<int> m_columns;
+  QString m_fileName;
+  QStringList m_headers;
+  qint64 m_rowsWritten;
+  QByteArray field(const QString &value) const;
+};
+
+#endif
@@ -514,7 +514,7 @@ void biblioteq_dvd::slotGo(void)
       query.bindValue(7, dvd.region->currentText().trimmed());
       query.bindValue(8, dvd.aspectratio->currentText().trimmed());
       query.bindValue(9, dvd.title->text());
-      query.bindValue(10, dvd.release_date->date().toString("MM/dd/yyyy"));
+      query.bindValue(10, dvd.release_date->date().toString(Qt::ISODate));
       query.bindValue(11, dvd.studio->toPlainText());
       query.bindValue(12, dvd.category->toPlainText());
       query.bindValue(13, dvd.price->value());
@@ -533,7 +533,7 @@ void biblioteq_dvd::slotGo(void)
 	    {
 	      dvd.front_image->m_image.save
 		(&buffer, dvd.front_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(19, bytes.toBase64());
+	      query.bindValue(19, bytes);
 	    }
 	  else
 	    query.bindValue(19, QVariant(QVariant::ByteArray));
@@ -553,7 +553,7 @@ void biblioteq_dvd::slotGo(void)
 	    {
 	      dvd.back_image->m_image.save
 		(&buffer, dvd.back_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(20, bytes.toBase64());
+	      query.bindValue(20, bytes);
 	    }
 	  else
 	    query.bindValue(20, QVariant(QVariant::ByteArray));
@@ -707,68 +707,68 @@ void biblioteq_dvd::slotGo(void)
 		 (qmain->getUI().table,
 		  m_row, qmain->getUI().table->columnNumber("Type")) == "DVD")
 		{
-		  qmain->getUI().table->setSortingEnabled(false);
-
 		  QStringList names(qmain->getUI().table->columnNames());
 
 		  for(i = 0; i < names.size(); i++)
 		    {
 		      if(names.at(i) == "UPC" ||
 			 names.at(i) == "ID Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.id->text());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.id->text());
 		      else if(names.at(i) == "Rating")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.rating->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.rating->currentText().trimmed());
 		      else if(names.at(i) == "Number of Discs")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.no_of_discs->text());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.no_of_discs->text());
 		      else if(names.at(i) == "Runtime")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.runtime->text());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.runtime->text());
 		      else if(names.at(i) == "Format")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.format->text());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.format->text());
 		      else if(names.at(i) == "Region")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.region->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.region->currentText().trimmed());
 		      else if(names.at(i) == "Aspect Ratio")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.aspectratio->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.aspectratio->currentText().trimmed());
 		      else if(names.at(i) == "Title")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.title->text());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.title->text());
 		      else if(names.at(i) == "Release Date" ||
 			      names.at(i) == "Publication Date")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.release_date->date().toString
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.release_date->date().toString
 			   (Qt::ISODate));
 		      else if(names.at(i) == "Studio" ||
 			      names.at(i) == "Publisher")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.studio->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.studio->toPlainText());
 		      else if(names.at(i) == "Categories")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.category->toPlainText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.category->toPlainText().trimmed());
 		      else if(names.at(i) == "Price")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.price->cleanText());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.price->cleanText());
 		      else if(names.at(i) == "Language")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.language->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.language->currentText().trimmed());
 		      else if(names.at(i) == "Monetary Units")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.monetary_units->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i,
+			   dvd.monetary_units->currentText().trimmed());
 		      else if(names.at(i) == "Quantity")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.quantity->text());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.quantity->text());
 		      else if(names.at(i) == "Location")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (dvd.location->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, dvd.location->currentText().trimmed());
 		      else if(names.at(i) == "Availability")
 			{
-			  qmain->getUI().table->item(m_row, i)->setText
-			    (biblioteq_misc_functions::getAvailability
+			  qmain->getUI().table->setText
+			    (m_row, i,
+			     biblioteq_misc_functions::getAvailability
 			     (m_oid, qmain->getDB(), "DVD", errorstr));
 
 			  if(!errorstr.isEmpty())
@@ -779,8 +779,6 @@ void biblioteq_dvd::slotGo(void)
 			}
 		    }
 
-		  qmain->getUI().table->setSortingEnabled(true);
-
 		  foreach(QLineEdit *textfield, findChildren<QLineEdit *>())
 		    textfield->setCursorPosition(0);
 
@@ -843,7 +841,7 @@ void biblioteq_dvd::slotGo(void)
     }
   else
     {
-      searchstr = "SELECT DISTINCT dvd.title, "
+      searchstr = "SELECT dvd.title, "
 	"dvd.dvdformat, "
 	"dvd.studio, "
 	"dvd.rdate, "
@@ -860,16 +858,15 @@ void biblioteq_dvd::slotGo(void)
 	"dvd.dvdregion, "
 	"dvd.dvdaspectratio, "
 	"dvd.quantity - "
-	"COUNT(item_borrower_vw.item_oid) "
+	"COALESCE(irc.total_reserved, 0) "
 	"AS availability, "
-	"COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	"COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	"dvd.type, "
-	"dvd.myoid, "
-	"dvd.front_cover "
+	"dvd.myoid "
 	"FROM "
-	"dvd LEFT JOIN item_borrower_vw ON "
-	"dvd.myoid = item_borrower_vw.item_oid "
-	"AND item_borrower_vw.type = 'DVD' "
+	"dvd LEFT JOIN item_reservation_counts irc ON "
+	"dvd.myoid = irc.item_oid "
+	"AND irc.type = 'DVD' "
 	"WHERE ";
       searchstr.append("id LIKE '%").append
 	(dvd.id->text().trimmed()).append("%' AND ");
@@ -917,15 +914,26 @@ void biblioteq_dvd::slotGo(void)
 			  trimmed()) +
 			 "' AND ");
 
-      searchstr.append("title LIKE " + E + "'%").append
-	(biblioteq_myqstring::escape
-	 (dvd.title->text().trimmed())).append("%' AND ");
+      bool fullText = biblioteq_misc_functions::hasFullTextSearch
+	(qmain->getDB());
+      QString condition("");
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "DVD", "title", dvd.title->text());
+
+      if(!condition.isEmpty())
+	searchstr.append(condition + " AND ");
+      else
+	searchstr.append("title LIKE " + E + "'%").append
+	  (biblioteq_myqstring::escape
+	   (dvd.title->text().trimmed())).append("%' AND ");
 
       if(dvd.release_date->date().toString
 	 ("MM/yyyy") != "01/7999")
-	searchstr.append("SUBSTR(rdate, 1, 3) || SUBSTR(rdate, 7) = '" +
+	searchstr.append("SUBSTR(rdate, 1, 7) = '" +
 			 dvd.release_date->date().toString
-			 ("MM/yyyy") +
+			 ("yyyy-MM") +
 			 "' AND ");
 
       searchstr.append("studio LIKE " + E + "'%" +
@@ -960,10 +968,19 @@ void biblioteq_dvd::slotGo(void)
       searchstr.append("description LIKE " + E + "'%" +
 		       biblioteq_myqstring::escape
 		       (dvd.description->toPlainText().trimmed()) + "%' ");
-      searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
-		       biblioteq_myqstring::escape
-		       (dvd.keyword->toPlainText().trimmed()) +
-		       "%' ");
+      condition.clear();
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "DVD", "keyword", dvd.keyword->toPlainText());
+
+      if(!condition.isEmpty())
+	searchstr.append("AND " + condition + " ");
+      else
+	searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape
+			 (dvd.keyword->toPlainText().trimmed()) +
+			 "%' ");
 
       if(dvd.quantity->value() != 0)
 	searchstr.append("AND quantity = " + dvd.quantity->text() + " ");
@@ -1239,7 +1256,7 @@ void biblioteq_dvd::modify(const int state)
 	       var.toString());
 	  else if(fieldname == "rdate")
 	    dvd.release_date->setDate
-	      (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+	      (biblioteq_misc_functions::dateFromString(var.toString()));
 	  else if(fieldname == "price")
 	    dvd.price->setValue(var.toDouble());
 	  else if(fieldname == "category")
@@ -1343,10 +1360,7 @@ void biblioteq_dvd::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  dvd.front_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(dvd.front_image->m_image.isNull())
-		    dvd.front_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	  else if(fieldname == "back_cover")
@@ -1354,10 +1368,7 @@ void biblioteq_dvd::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  dvd.back_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(dvd.back_image->m_image.isNull())
-		    dvd.back_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	}
@@ -3,9 +3,11 @@
 */
 
 #include <QMutex>
+#include <QMutexLocker>
 #include <QNetworkAccessManager>
 #include <QNetworkProxy>
 #include <QNetworkReply>
+#include <QVector>
 #include <QXmlStreamReader>
 
 /*
@@ -14,6 +16,8 @@
 
 #include "biblioteq.h"
 #include "biblioteq_generic_thread.h"
+#include "biblioteq_marc.h"
+#include "biblioteq_z3950_pool.h"
 
 extern biblioteq *qmain;
 
@@ -24,10 +28,10 @@ extern biblioteq *qmain;
 biblioteq_generic_thread::biblioteq_generic_thread(QObject *parent):
   QThread(parent)
 {
+  m_canceled = false;
   m_type = -1;
   m_eType = "";
   m_errorStr = "";
-  m_z3950Name = "";
   setTerminationEnabled(true);
 }
 
@@ -38,7 +42,9 @@ biblioteq_generic_thread::biblioteq_generic_thread(QObject *parent):
 biblioteq_generic_thread::~biblioteq_generic_thread()
 {
   m_list.clear();
+  m_z3950Records.clear();
   m_z3950Results.clear();
+  m_z3950Sites.clear();
   m_outputListBool.clear();
 }
 
@@ -83,94 +89,221 @@ void biblioteq_generic_thread::run(void)
       }
     case Z3950_QUERY:
       {
-	QHash<QString, QString> hash
-	  (qmain->getZ3950Maps().value(m_z3950Name));
-	QString recordSyntax(hash.value("RecordSyntax").trimmed());
-	ZOOM_connection zoomConnection = 0;
-	ZOOM_options options = ZOOM_options_create();
-	ZOOM_resultset zoomResultSet = 0;
-	const char *rec = 0;
-	size_t i = 0;
-
-	ZOOM_options_set
-	  (options,
-	   "databaseName",
-	   hash.value("Database").toLatin1().constData());
-
-	if(recordSyntax.isEmpty())
-	  ZOOM_options_set(options, "preferredRecordSyntax", "MARC21");
-	else
-	  ZOOM_options_set(options, "preferredRecordSyntax", recordSyntax.
-			   toLatin1().constData());
-
-	if(!hash.value("proxy_host").isEmpty() &&
-	   !hash.value("proxy_port").isEmpty())
+	/*
+	** Every site is queried concurrently. ZOOM_event() reports
+	** the connection on which an event occurred. The records of
+	** a site are collected as soon as its search completes.
+	** Cached records are delivered without contacting their sites.
+	*/
+
+	QString errorStr("");
+	QString eType("");
+	QStringList formats;
+	QStringList keys;
+	QStringList names;
+	QVector<ZOOM_connection> connections;
+	QVector<ZOOM_resultset> resultSets;
+	QVector<bool> completed;
+	QVector<bool> healthy;
+	QVector<bool> retry;
+
+	for(int i = 0; i < m_z3950Names.size(); i++)
 	  {
-	    QString value(QString("%1:%2").
-			  arg(hash.value("proxy_host")).
-			  arg(hash.value("proxy_port")));
+	    QHash<QString, QString> hash
+	      (qmain->getZ3950Maps().value(m_z3950Names.at(i)));
+	    QString format(hash.value("Format").trimmed().toLower());
+	    QString key
+	      (biblioteq_z3950_pool::cacheKey(m_z3950Names.at(i), hash,
+					      m_z3950Identifier));
+	    QList<QByteArray> records
+	      (biblioteq_z3950_pool::cachedRecords(key));
+
+	    if(!records.isEmpty())
+	      {
+		QStringList texts;
 
-	    ZOOM_options_set(options, "proxy", value.toLatin1().constData());
-	  }
+		for(int j = 0; j < records.size(); j++)
+		  texts.append(biblioteq_marc::recordText(records.at(j)));
 
-	if(!hash.value("Userid").isEmpty())
-	  ZOOM_options_set
-	    (options,
-	     "user",
-	     hash.value("Userid").toLatin1().constData());
-
-	if(!hash.value("Password").isEmpty())
-	  ZOOM_options_set
-	    (options,
-	     "password",
-	     hash.value("Password").toLatin1().constData());
-
-	zoomConnection = ZOOM_connection_create(options);
-	ZOOM_connection_connect
-	  (zoomConnection, (hash.value("Address") + ":" +
-			    hash.value("Port")).toLatin1().constData(), 0);
- 	zoomResultSet = ZOOM_connection_search_pqf
-	  (zoomConnection,
-	   m_z3950SearchStr.toLatin1().constData());
-
-	QString format = hash.value("Format").trimmed().toLower();
-
-	if(format.isEmpty())
-	  format = "render";
-	else
-	  format.prepend("render; charset=");
-
-	while((rec = ZOOM_record_get(ZOOM_resultset_record(zoomResultSet, i),
-				     format.toLatin1().constData(), 0)) != 0)
-	  {
-	    i += 1;
-	    m_z3950Results.append(QString::fromUtf8(rec));
+		QMutexLocker locker(&m_mutex);
+
+		for(int j = 0; j < records.size(); j++)
+		  {
+		    m_z3950Records.append(records.at(j));
+		    m_z3950Results.append(texts.at(j));
+		    m_z3950Sites.append(m_z3950Names.at(i));
+		  }
+
+		locker.unlock();
+		emit z3950ResultsReady();
+		continue;
+	      }
+
+	    if(!format.isEmpty())
+	      format.prepend("; charset=");
+
+	    ZOOM_connection zoomConnection = 0;
+	    bool reused = false;
+
+	    zoomConnection = biblioteq_z3950_pool::acquire
+	      (m_z3950Names.at(i), hash, Z3950_MAXIMUM_RECORDS, &reused);
+	    completed.append(false);
+	    connections.append(zoomConnection);
+	    formats.append(format);
+	    healthy.append(false);
+	    keys.append(key);
+	    names.append(m_z3950Names.at(i));
+	    resultSets.append
+	      (ZOOM_connection_search_pqf(zoomConnection,
+					  m_z3950SearchStr.toLatin1().
+					  constData()));
+	    retry.append(reused);
 	  }
 
-	ZOOM_resultset_destroy(zoomResultSet);
+	int index = 0;
 
-	if(i == 0)
+	while(!wasCanceled() &&
+	      (index = ZOOM_event(connections.size(),
+				  connections.data())) > 0)
 	  {
-	    const char *addinfo;
-	    const char *errmsg;
+	    index -= 1;
+
+	    if(completed.at(index) ||
+	       ZOOM_connection_last_event(connections.at(index)) !=
+	       ZOOM_EVENT_END)
+	      continue;
 
-	    if(ZOOM_connection_error(zoomConnection, &errmsg, &addinfo) != 0)
+	    const char *addinfo = 0;
+	    const char *errmsg = 0;
+
+	    if(ZOOM_connection_error(connections.at(index),
+				     &errmsg, &addinfo) != 0)
 	      {
-		m_eType = errmsg;
-		m_errorStr = addinfo;
+		if(retry.at(index))
+		  {
+		    /*
+		    ** The site may have closed an idle session.
+		    ** A new session is established once.
+		    */
+
+		    bool reused = false;
+
+		    retry[index] = false;
+		    ZOOM_resultset_destroy(resultSets.at(index));
+		    biblioteq_z3950_pool::release(connections.at(index), false);
+		    connections[index] = biblioteq_z3950_pool::acquire
+		      (names.at(index),
+		       qmain->getZ3950Maps().value(names.at(index)),
+		       Z3950_MAXIMUM_RECORDS,
+		       &reused);
+		    resultSets[index] = ZOOM_connection_search_pqf
+		      (connections.at(index),
+		       m_z3950SearchStr.toLatin1().constData());
+		    continue;
+		  }
+
+		completed[index] = true;
+
+		if(eType.isEmpty())
+		  {
+		    eType = errmsg;
+		    errorStr = addinfo;
+
+		    if(errorStr.isEmpty())
+		      errorStr = eType;
+		  }
+
+		continue;
+	      }
+
+	    QByteArray raw(("raw" + formats.at(index)).toLatin1());
+	    QByteArray render(("render" + formats.at(index)).toLatin1());
+	    QList<QByteArray> results;
+	    QStringList texts;
+	    ZOOM_record record = 0;
+	    size_t i = 0;
+
+	    completed[index] = true;
+	    healthy[index] = true;
 
-		if(m_errorStr.isEmpty())
-		  m_errorStr = m_eType;
+	    while((record = ZOOM_resultset_record_immediate
+		   (resultSets.at(index), i)) != 0)
+	      {
+		QByteArray bytes;
+		int length = 0;
+		const char *rec = ZOOM_record_get
+		  (record, raw.constData(), &length);
+
+		i += 1;
+
+		if(rec && length > 0)
+		  bytes = QByteArray(rec, length);
+
+		if(!biblioteq_marc::isIso2709(bytes))
+		  {
+		    /*
+		    ** The site did not provide an ISO 2709 record.
+		    ** Its rendering is kept instead.
+		    */
+
+		    rec = ZOOM_record_get(record, render.constData(), 0);
+		    bytes = rec ? QByteArray(rec) : QByteArray();
+		  }
+
+		if(!bytes.isEmpty())
+		  {
+		    results.append(bytes);
+		    texts.append(biblioteq_marc::recordText(bytes));
+		  }
 	      }
-	    else if(m_z3950Results.isEmpty())
+
+	    biblioteq_z3950_pool::cacheRecords(keys.at(index), results);
+
+	    if(!results.isEmpty())
 	      {
-		m_eType = tr("Z39.50 Empty Results Set");
-		m_errorStr = tr("Z39.50 Empty Results Set");
+		QMutexLocker locker(&m_mutex);
+
+		for(int j = 0; j < results.size(); j++)
+		  {
+		    m_z3950Records.append(results.at(j));
+		    m_z3950Results.append(texts.at(j));
+		    m_z3950Sites.append(names.at(index));
+		  }
+
+		locker.unlock();
+		emit z3950ResultsReady();
 	      }
 	  }
 
-	ZOOM_options_destroy(options);
-	ZOOM_connection_destroy(zoomConnection);
+	{
+	  QMutexLocker locker(&m_mutex);
+
+	  if(m_z3950Results.isEmpty() && !m_canceled)
+	    {
+	      if(!eType.isEmpty())
+		{
+		  m_eType = eType;
+		  m_errorStr = errorStr;
+		}
+	      else
+		{
+		  m_eType = tr("Z39.50 Empty Results Set");
+		  m_errorStr = tr("Z39.50 Empty Results Set");
+		}
+	    }
+	}
+
+	/*
+	** Sessions which completed normally are returned to the pool.
+	** Abandoned sessions may still have requests in progress.
+	*/
+
+	for(int i = 0; i < connections.size(); i++)
+	  {
+	    ZOOM_resultset_destroy(resultSets.at(i));
+	    biblioteq_z3950_pool::release(connections.at(i), healthy.at(i));
+	  }
+
 	break;
       }
     default:
@@ -193,6 +326,8 @@ QStringList biblioteq_generic_thread::getList(void) const
 
 QString biblioteq_generic_thread::getErrorStr(void) const
 {
+  QMutexLocker locker(&m_mutex);
+
   return m_errorStr;
 }
 
@@ -241,32 +376,104 @@ void biblioteq_generic_thread::setZ3950SearchString(const QString &z3950SearchSt
 
 QStringList biblioteq_generic_thread::getZ3950Results(void) const
 {
+  QMutexLocker locker(&m_mutex);
+
   return m_z3950Results;
 }
 
+/*
+** -- getZ3950Records() --
+*/
+
+QList<QByteArray> biblioteq_generic_thread::getZ3950Records(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_z3950Records;
+}
+
+/*
+** -- getZ3950Sites() --
+*/
+
+QStringList biblioteq_generic_thread::getZ3950Sites(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_z3950Sites;
+}
+
+/*
+** -- hasZ3950Results() --
+*/
+
+bool biblioteq_generic_thread::hasZ3950Results(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return !m_z3950Results.isEmpty();
+}
+
 /*
 ** -- getEType() --
 */
 
 QString biblioteq_generic_thread::getEType(void) const
 {
+  QMutexLocker locker(&m_mutex);
+
   return m_eType;
 }
 
 /*
-** -- msleep() --
+** -- setZ3950Identifiers() --
 */
 
-void biblioteq_generic_thread::msleep(const int msecs)
+void biblioteq_generic_thread::setZ3950Identifiers
+(const QStringList &identifiers)
 {
-  QThread::msleep(msecs);
+  m_z3950Identifier = biblioteq_z3950_pool::normalizedIdentifier
+    (identifiers);
 }
 
 /*
-** -- setZ3950Name() --
+** -- setZ3950Names() --
 */
 
-void biblioteq_generic_thread::setZ3950Name(const QString &name)
+void biblioteq_generic_thread::setZ3950Names(const QStringList &names)
 {
-  m_z3950Name = name;
+  m_z3950Names = names;
+}
+
+/*
+** -- abandon() --
+*/
+
+void biblioteq_generic_thread::abandon(void)
+{
+  /*
+  ** The thread may still be waiting on slow sites. It is
+  ** deleted as soon as it notices the request. Calling
+  ** deleteLater() more than once is harmless.
+  */
+
+  QMutexLocker locker(&m_mutex);
+
+  m_canceled = true;
+  locker.unlock();
+  connect(this, SIGNAL(finished(void)), this, SLOT(deleteLater(void)));
+
+  if(!isRunning())
+    deleteLater();
+}
+
+/*
+** -- wasCanceled() --
+*/
+
+bool biblioteq_generic_thread::wasCanceled(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_canceled;
 }
@@ -5,7 +5,9 @@
 ** -- Qt Includes --
 */
 
+#include <QByteArray>
 #include <QFile>
+#include <QMutex>
 #include <QString>
 #include <QStringList>
 #include <QTextStream>
@@ -30,32 +32,46 @@ class biblioteq_generic_thread: public QThread
 
  public:
   static const int READ_GLOBAL_CONFIG_FILE = 200;
+  static const int Z3950_MAXIMUM_RECORDS = 25;
   static const int Z3950_QUERY = 300;
 
   biblioteq_generic_thread(QObject *parent);
   ~biblioteq_generic_thread();
   QString getEType(void) const;
   QString getErrorStr(void) const;
+  QList<QByteArray> getZ3950Records(void) const;
   QStringList getList(void) const;
   QStringList getZ3950Results(void) const;
-  void msleep(const int msecs);
+  QStringList getZ3950Sites(void) const;
+  bool hasZ3950Results(void) const;
+  void abandon(void);
   void run(void);
   void setFilename(const QString &filename);
   void setOutputList(const QList<bool> &list);
   void setType(const int type);
-  void setZ3950Name(const QString &name);
+  void setZ3950Identifiers(const QStringList &identifiers);
+  void setZ3950Names(const QStringList &names);
   void setZ3950SearchString(const QString &z3950SearchStr);
 
  private:
+  QList<QByteArray> m_z3950Records;
   QList<bool> m_outputListBool;
   QString m_eType;
   QString m_errorStr;
   QString m_filename;
-  QString m_z3950Name;
+  QString m_z3950Identifier;
   QString m_z3950SearchStr;
   QStringList m_list;
+  QStringList m_z3950Names;
   QStringList m_z3950Results;
+  QStringList m_z3950Sites;
+  bool m_canceled;
   int m_type;
+  mutable QMutex m_mutex;
+  bool wasCanceled(void) const;
+
+ signals:
+  void z3950ResultsReady(void);
 };
 
 #endif
@@ -1,6 +1,18 @@
 #ifndef _BIBLIOTEQ_GRAPHICSITEMPIXMAP_H_
 #define _BIBLIOTEQ_GRAPHICSITEMPIXMAP_H_
 
+/*
+** -- Qt Includes --
+*/
+
+#include <QPointer>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq_thumbnail_loader.h"
+
 static void qt_graphicsItem_highlightSelected
 (QGraphicsItem *item, QPainter *painter,
  const QStyleOptionGraphicsItem *option)
@@ -38,6 +50,12 @@ public:
 
   ~biblioteq_graphicsitempixmap()
   {
+    /*
+    ** A pending thumbnail must not be delivered to a deleted item.
+    */
+
+    if(m_thumbnailLoader)
+      m_thumbnailLoader->forget(this);
   }
 
   void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
@@ -49,6 +67,14 @@ public:
       if(option->state & (QStyle::State_Selected | QStyle::State_HasFocus))
 	qt_graphicsItem_highlightSelected(this, painter, option);
   }
+
+  void setThumbnailLoader(biblioteq_thumbnail_loader *loader)
+  {
+    m_thumbnailLoader = loader;
+  }
+
+ private:
+  QPointer<biblioteq_thumbnail_loader> m_thumbnailLoader;
 };
 
 #endif
@@ -4,6 +4,7 @@
 
 #include <QAuthenticator>
 #include <QCryptographicHash>
+#include <QEventLoop>
 #include <QInputDialog>
 #include <QNetworkAccessManager>
 #include <QNetworkProxy>
@@ -24,6 +25,7 @@
 */
 
 #include "biblioteq.h"
+#include "biblioteq_attachments.h"
 #include "biblioteq_borrowers_editor.h"
 #include "biblioteq_magazine.h"
 #include "biblioteq_marc.h"
@@ -42,6 +44,7 @@ biblioteq_magazine::biblioteq_magazine(QMainWindow *parentArg,
   QMainWindow(), biblioteq_item(rowArg)
 {
   m_duplicate = false;
+  m_thread = 0;
 
   QMenu *menu = 0;
   QRegExp rx("[0-9][0-9][0-9][0-9]-[0-9][0-9][0-9][0-9X]");
@@ -71,12 +74,6 @@ biblioteq_magazine::biblioteq_magazine(QMainWindow *parentArg,
 	biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
 #endif
     }
-  else
-    {
-      if((m_sruManager = new(std::nothrow)
-	  QNetworkAccessManager(this)) == 0)
-	biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
-    }
 
   if((m_sruWorking = new(std::nothrow)
       biblioteq_item_working_dialog(qobject_cast<QMainWindow *> (this))) == 0)
@@ -353,6 +350,8 @@ biblioteq_magazine::biblioteq_magazine(QMainWindow *parentArg,
 
 biblioteq_magazine::~biblioteq_magazine()
 {
+  if(m_sruSearch)
+    m_sruSearch->abort();
 }
 
 /*
@@ -579,7 +578,7 @@ void biblioteq_magazine::slotGo(void)
 	query.bindValue(0, QVariant::String);
 
       query.bindValue(1, ma.title->text());
-      query.bindValue(2, ma.publication_date->date().toString("MM/dd/yyyy"));
+      query.bindValue(2, ma.publication_date->date().toString(Qt::ISODate));
       query.bindValue(3, ma.publisher->toPlainText());
       query.bindValue(4, ma.category->toPlainText().trimmed());
       query.bindValue(5, ma.price->value());
@@ -615,7 +614,7 @@ void biblioteq_magazine::slotGo(void)
 	    {
 	      ma.front_image->m_image.save
 		(&buffer, ma.front_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(16, bytes.toBase64());
+	      query.bindValue(16, bytes);
 	    }
 	  else
 	    query.bindValue(16, QVariant(QVariant::ByteArray));
@@ -635,7 +634,7 @@ void biblioteq_magazine::slotGo(void)
 	    {
 	      ma.back_image->m_image.save
 		(&buffer, ma.back_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(17, bytes.toBase64());
+	      query.bindValue(17, bytes);
 	    }
 	  else
 	    query.bindValue(17, QVariant(QVariant::ByteArray));
@@ -859,66 +858,66 @@ void biblioteq_magazine::slotGo(void)
 		  m_row, qmain->getUI().table->columnNumber("Type")) ==
 		 m_subType)
 		{
-		  qmain->getUI().table->setSortingEnabled(false);
-
 		  QStringList names(qmain->getUI().table->columnNames());
 
 		  for(i = 0; i < names.size(); i++)
 		    {
 		      if(names.at(i) == "ISSN" ||
 			 names.at(i) == "ID Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.id->text());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.id->text());
 		      else if(names.at(i) == "Title")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.title->text());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.title->text());
 		      else if(names.at(i) == "Publication Date")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.publication_date->date().toString
+			qmain->getUI().table->setText
+			  (m_row, i, ma.publication_date->date().toString
 			   (Qt::ISODate));
 		      else if(names.at(i) == "Publisher")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.publisher->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.publisher->toPlainText());
 		      else if(names.at(i) == "Place of Publication")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.place->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.place->toPlainText());
 		      else if(names.at(i) == "Categories")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.category->toPlainText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.category->toPlainText().trimmed());
 		      else if(names.at(i) == "Price")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.price->cleanText());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.price->cleanText());
 		      else if(names.at(i) == "Language")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.language->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.language->currentText().trimmed());
 		      else if(names.at(i) == "Monetary Units")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.monetary_units->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i,
+			   ma.monetary_units->currentText().trimmed());
 		      else if(names.at(i) == "Quantity")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.quantity->text());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.quantity->text());
 		      else if(names.at(i) == "Location")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.location->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.location->currentText().trimmed());
 		      else if(names.at(i) == "Volume")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.volume->text());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.volume->text());
 		      else if(names.at(i) == "Issue")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.issue->text());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.issue->text());
 		      else if(names.at(i) == "LC Control Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.lcnum->text());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.lcnum->text());
 		      else if(names.at(i) == "Call Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.callnum->text());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.callnum->text());
 		      else if(names.at(i) == "Dewey Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (ma.deweynum->text());
+			qmain->getUI().table->setText
+			  (m_row, i, ma.deweynum->text());
 		      else if(names.at(i) == "Availability")
 			{
-			  qmain->getUI().table->item(m_row, i)->setText
-			    (biblioteq_misc_functions::getAvailability
+			  qmain->getUI().table->setText
+			    (m_row, i,
+			     biblioteq_misc_functions::getAvailability
 			     (m_oid, qmain->getDB(), m_subType,
 			      errorstr));
 
@@ -930,8 +929,6 @@ void biblioteq_magazine::slotGo(void)
 			}
 		    }
 
-		  qmain->getUI().table->setSortingEnabled(true);
-
 		  foreach(QLineEdit *textfield, findChildren<QLineEdit *>())
 		    textfield->setCursorPosition(0);
 
@@ -990,7 +987,7 @@ void biblioteq_magazine::slotGo(void)
     }
   else
     {
-      searchstr = QString("SELECT DISTINCT %1.title, "
+      searchstr = QString("SELECT %1.title, "
 			  "%1.publisher, %1.pdate, %1.place, "
 			  "%1.issuevolume, "
 			  "%1.issueno, "
@@ -1002,18 +999,17 @@ void biblioteq_magazine::slotGo(void)
 			  "%1.lccontrolnumber, "
 			  "%1.callnumber, "
 			  "%1.deweynumber, "
-			  "%1.quantity - COUNT(item_borrower_vw."
-			  "item_oid) "
+			  "%1.quantity - "
+			  "COALESCE(irc.total_reserved, 0) "
 			  "AS availability, "
-			  "COUNT(item_borrower_vw.item_oid) AS "
+			  "COALESCE(irc.total_reserved, 0) AS "
 			  "total_reserved, "
 			  "%1.type, "
-			  "%1.myoid, "
-			  "%1.front_cover "
+			  "%1.myoid "
 			  "FROM "
-			  "%1 LEFT JOIN item_borrower_vw ON "
-			  "%1.myoid = item_borrower_vw.item_oid "
-			  "AND item_borrower_vw.type = '%1' "
+			  "%1 LEFT JOIN item_reservation_counts irc ON "
+			  "%1.myoid = irc.item_oid "
+			  "AND irc.type = '%1' "
 			  "WHERE %1.type = '%1' AND ").arg(m_subType);
 
       if(!ma.id->text().trimmed().isEmpty())
@@ -1046,16 +1042,27 @@ void biblioteq_magazine::slotGo(void)
 	searchstr.append("issueno = " + ma.issue->text() +
 			 " AND ");
 
-      searchstr.append("title LIKE " + E + "'%" +
-		       biblioteq_myqstring::escape
-		       (ma.title->text().trimmed()) +
-		       "%' AND ");
+      bool fullText = biblioteq_misc_functions::hasFullTextSearch
+	(qmain->getDB());
+      QString condition("");
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), m_subType, "title", ma.title->text());
+
+      if(!condition.isEmpty())
+	searchstr.append(condition + " AND ");
+      else
+	searchstr.append("title LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape
+			 (ma.title->text().trimmed()) +
+			 "%' AND ");
 
       if(ma.publication_date->date().toString
 	 ("MM/yyyy") != "01/7999")
-	searchstr.append("SUBSTR(pdate, 1, 3) || SUBSTR(pdate, 7) = '" +
+	searchstr.append("SUBSTR(pdate, 1, 7) = '" +
 			 ma.publication_date->date().toString
-			 ("MM/yyyy") +
+			 ("yyyy-MM") +
 			 "' AND ");
 
       searchstr.append("publisher LIKE " + E+ "'%" +
@@ -1106,9 +1113,18 @@ void biblioteq_magazine::slotGo(void)
       searchstr.append("AND COALESCE(marc_tags, '') LIKE " + E + "'%" +
 		       biblioteq_myqstring::escape
 		       (ma.marc_tags->toPlainText().trimmed()) + "%' ");
-      searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
-		       biblioteq_myqstring::escape
-		       (ma.keyword->toPlainText().trimmed()) + "%' ");
+      condition.clear();
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), m_subType, "keyword", ma.keyword->toPlainText());
+
+      if(!condition.isEmpty())
+	searchstr.append("AND " + condition + " ");
+      else
+	searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape
+			 (ma.keyword->toPlainText().trimmed()) + "%' ");
 
       /*
       ** Search the database.
@@ -1463,7 +1479,7 @@ void biblioteq_magazine::modify(const int state)
 	    }
 	  else if(fieldname == "pdate")
 	    ma.publication_date->setDate
-	      (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+	      (biblioteq_misc_functions::dateFromString(var.toString()));
 	  else if(fieldname == "price")
 	    ma.price->setValue(var.toDouble());
 	  else if(fieldname == "place")
@@ -1598,10 +1614,7 @@ void biblioteq_magazine::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  ma.front_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(ma.front_image->m_image.isNull())
-		    ma.front_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	  else if(fieldname == "back_cover")
@@ -1609,10 +1622,7 @@ void biblioteq_magazine::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  ma.back_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(ma.back_image->m_image.isNull())
-		    ma.back_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	}
@@ -1989,7 +1999,7 @@ void biblioteq_magazine::slotShowUsers(void)
 
 void biblioteq_magazine::slotZ3950Query(void)
 {
-  if(findChild<biblioteq_generic_thread *> ())
+  if(m_thread)
     return;
 
   int i = 0;
@@ -2008,7 +2018,7 @@ void biblioteq_magazine::slotZ3950Query(void)
       return;
     }
 
-  if((m_thread = new(std::nothrow) biblioteq_generic_thread(this)) != 0)
+  if((m_thread = new(std::nothrow) biblioteq_generic_thread(0)) != 0)
     {
       biblioteq_item_working_dialog working
 	(qobject_cast<QMainWindow *> (this));
@@ -2022,41 +2032,48 @@ void biblioteq_magazine::slotZ3950Query(void)
       working.show();
       working.update();
 
-      QString recordSyntax("MARC21");
-      bool found = false;
+      QEventLoop loop;
+      QStringList names;
 
       for(i = 0; i < ma.z3950QueryButton->actions().size(); i++)
 	if(ma.z3950QueryButton->actions().at(i)->isChecked())
 	  {
-	    found = true;
-	    recordSyntax = qmain->getZ3950Maps().value
-	      (ma.z3950QueryButton->actions().at(i)->text()).
-	      value("RecordSyntax");
-	    m_thread->setZ3950Name
-	      (ma.z3950QueryButton->actions().at(i)->text());
+	    names.append(ma.z3950QueryButton->actions().at(i)->text());
 	    break;
 	  }
 
-      if(!found)
-	{
-	  recordSyntax = qmain->getZ3950Maps().value
-	    (qmain->getPreferredZ3950Site()).value("RecordSyntax");
-	  m_thread->setZ3950Name(qmain->getPreferredZ3950Site());
-	}
+      if(names.isEmpty())
+	names.append(qmain->getPreferredZ3950Site());
+
+      /*
+      ** The remaining sites are also queried. Their records are
+      ** merged so that they may be offered in a single dialog.
+      */
+
+      foreach(const QString &name, qmain->getZ3950Maps().keys())
+	if(!names.contains(name))
+	  names.append(name);
 
       searchstr = QString("@attr 1=8 %1").arg(ma.id->text());
+      connect(&working, SIGNAL(canceled(void)), &loop, SLOT(quit(void)));
+      connect(m_thread, SIGNAL(finished(void)), &loop, SLOT(quit(void)));
       m_thread->setType(biblioteq_generic_thread::Z3950_QUERY);
+      m_thread->setZ3950Identifiers(QStringList() << ma.id->text());
+      m_thread->setZ3950Names(names);
       m_thread->setZ3950SearchString(searchstr);
       m_thread->start();
 
-      while(m_thread->isRunning())
-	{
-#ifndef Q_OS_MAC
-	  QApplication::processEvents();
-#endif
-	  m_thread->msleep(100);
-	}
+      if(!working.wasCanceled())
+	loop.exec();
 
+      QStringList recordSyntaxes;
+      QStringList results(m_thread->getZ3950Results());
+      QStringList sites(m_thread->getZ3950Sites());
+
+      errorstr = m_thread->getErrorStr();
+      etype = m_thread->getEType();
+      m_thread->abandon();
+      m_thread = 0;
       working.close();
 
       bool canceled = working.wasCanceled();
@@ -2064,14 +2081,16 @@ void biblioteq_magazine::slotZ3950Query(void)
       working.reset(); // Qt 5.5.x adjustment.
 
       if(canceled)
-	{
-	  m_thread->deleteLater();
-	  return;
-	}
+	return;
+
+      for(i = 0; i < sites.size(); i++)
+	recordSyntaxes.append
+	  (qmain->getZ3950Maps().value(sites.at(i)).
+	   value("RecordSyntax", "MARC21").trimmed());
 
-      if((errorstr = m_thread->getErrorStr()).isEmpty())
+      if(errorstr.isEmpty())
 	{
-	  if(m_thread->getZ3950Results().size() == 1)
+	  if(results.size() == 1)
 	    {
 	      if(QMessageBox::question
 		 (this, tr("BiblioteQ: Question"),
@@ -2080,15 +2099,14 @@ void biblioteq_magazine::slotZ3950Query(void)
 		  QMessageBox::Yes | QMessageBox::No,
 		  QMessageBox::No) == QMessageBox::Yes)
 		{
-		  list = QString(m_thread->getZ3950Results()[0]).split("\n");
-		  populateDisplayAfterZ3950(list, recordSyntax);
+		  list = results.at(0).split("\n");
+		  populateDisplayAfterZ3950(list, recordSyntaxes.value(0));
 		  list.clear();
 		}
 	    }
-	  else if(m_thread->getZ3950Results().size() > 1)
+	  else if(results.size() > 1)
 	    {
-	      for(i = 0; i < m_thread->getZ3950Results().size(); i++)
-		list.append(m_thread->getZ3950Results()[i]);
+	      list = results;
 
 	      /*
 	      ** Display a selection dialog.
@@ -2096,7 +2114,7 @@ void biblioteq_magazine::slotZ3950Query(void)
 
 	      if((new(std::nothrow)
 		  biblioteq_z3950results(qobject_cast<QWidget *> (this), list,
-					 this, font(), recordSyntax)) == 0)
+					 this, font(), recordSyntaxes)) == 0)
 		{
 		  qmain->addError
 		    (QString(tr("Memory Error")),
@@ -2116,10 +2134,6 @@ void biblioteq_magazine::slotZ3950Query(void)
 	       tr("A Z39.50 entry may not yet exist for ") +
 	       ma.id->text() + tr("."));
 	}
-      else
-	etype = m_thread->getEType();
-
-      m_thread->deleteLater();
     }
   else
     {
@@ -3137,18 +3151,51 @@ void biblioteq_magazine::slotSRUQuery(void)
 	return;
 #endif
     }
-  else
-    {
-      if(m_sruManager->findChild<QNetworkReply *> ())
-	return;
-    }
+  else if(m_sruSearch)
+    return;
 
   m_sruWorking->reset(); // Qt 5.5.x adjustment.
   m_sruWorking->setMaximum(0);
   m_sruWorking->setMinimum(0);
   m_sruWorking->show();
   m_sruWorking->update();
+  m_sruResults.clear();
+
+  if(!useHttp())
+    {
+      /*
+      ** Every site is queried. The records of all sites are
+      ** offered once the last site has responded.
+      */
 
+      QMap<QString, QHash<QString, QString> > hashes(qmain->getSRUMaps());
+      QMap<QString, QUrl> urls;
+      QMapIterator<QString, QHash<QString, QString> > it(hashes);
+
+      while(it.hasNext())
+	{
+	  it.next();
+
+	  QString searchstr(it.value().value("url_issn"));
+
+	  if(searchstr.isEmpty())
+	    continue;
+
+	  searchstr.replace("%1", ma.id->text().trimmed());
+	  urls[it.key()] = QUrl::fromUserInput(searchstr);
+	}
+
+      m_sruSearch = qmain->getSRUClient()->search(urls, this);
+      connect(m_sruSearch,
+	      SIGNAL(resultReady(const QString &, const QByteArray &)),
+	      this,
+	      SLOT(slotSRUResultReady(const QString &, const QByteArray &)));
+      connect(m_sruSearch, SIGNAL(finished(void)),
+	      this, SLOT(slotSRUSearchFinished(void)));
+      return;
+    }
+
+#if QT_VERSION < 0x050000
   bool found = false;
   QString name("");
 
@@ -3175,50 +3222,20 @@ void biblioteq_magazine::slotSRUQuery(void)
 
   if(hash.contains("proxy_type"))
     type = hash.value("proxy_type").toLower().trimmed();
-  else if(hash.contains("proxy_type"))
-    type = hash.value("proxy_type").toLower().trimmed();
 
   if(type == "none")
     proxy.setType(QNetworkProxy::NoProxy);
   else
     {
       if(type == "http" || type == "socks5" || type == "system")
-	{
-	  if(useHttp())
-	    {
-#if QT_VERSION < 0x050000
-	      connect
-		(m_sruHttp,
-		 SIGNAL(proxyAuthenticationRequired(const QNetworkProxy &,
-						    QAuthenticator *)),
-		 this,
-		 SLOT(slotProxyAuthenticationRequired(const QNetworkProxy &,
-						      QAuthenticator *)),
-		 Qt::UniqueConnection);
-#endif
-	    }
-	  else
-	    {
-	      /*
-	      ** This is required to resolve an odd error.
-	      */
-
-	      QNetworkReply *reply = m_sruManager->get
-		(QNetworkRequest(QUrl::fromUserInput("http://0.0.0.0")));
-
-	      if(reply)
-		reply->deleteLater();
-
-	      connect
-		(m_sruManager,
-		 SIGNAL(proxyAuthenticationRequired(const QNetworkProxy &,
-						    QAuthenticator *)),
-		 this,
-		 SLOT(slotProxyAuthenticationRequired(const QNetworkProxy &,
-						      QAuthenticator *)),
-		 Qt::UniqueConnection);
-	    }
-	}
+	connect
+	  (m_sruHttp,
+	   SIGNAL(proxyAuthenticationRequired(const QNetworkProxy &,
+					      QAuthenticator *)),
+	   this,
+	   SLOT(slotProxyAuthenticationRequired(const QNetworkProxy &,
+						QAuthenticator *)),
+	   Qt::UniqueConnection);
 
       if(type == "http" || type == "socks5")
 	{
@@ -3245,14 +3262,7 @@ void biblioteq_magazine::slotSRUQuery(void)
 	  if(!password.isEmpty())
 	    proxy.setPassword(password);
 
-	  if(useHttp())
-	    {
-#if QT_VERSION < 0x050000
-	      m_sruHttp->setProxy(proxy);
-#endif
-	    }
-	  else
-	    m_sruManager->setProxy(proxy);
+	  m_sruHttp->setProxy(proxy);
 	}
       else if(type == "system")
 	{
@@ -3263,53 +3273,23 @@ void biblioteq_magazine::slotSRUQuery(void)
 	  if(!list.isEmpty())
 	    proxy = list.at(0);
 
-	  if(useHttp())
-	    {
-#if QT_VERSION < 0x050000
-	      m_sruHttp->setProxy(proxy);
-#endif
-	    }
-	  else
-	    m_sruManager->setProxy(proxy);
+	  m_sruHttp->setProxy(proxy);
 	}
     }
 
-  if(useHttp())
-    {
-#if QT_VERSION < 0x050000
-      if(url.port() == -1)
-	url.setPort(80);
-
-      m_sruHttp->abort();
-      m_sruResults.clear();
-      connect(m_sruHttp, SIGNAL(done(bool)),
-	      this, SLOT(slotSRUDownloadFinished(bool)),
-	      Qt::UniqueConnection);
-      connect(m_sruHttp, SIGNAL(readyRead(const QHttpResponseHeader &)),
-	      this, SLOT(slotSRUReadyRead(const QHttpResponseHeader &)),
-	      Qt::UniqueConnection);
-      m_sruHttp->setHost(url.host(), url.port());
-      m_sruHttp->get(url.toEncoded());
+  if(url.port() == -1)
+    url.setPort(80);
+
+  m_sruHttp->abort();
+  connect(m_sruHttp, SIGNAL(done(bool)),
+	  this, SLOT(slotSRUDownloadFinished(bool)),
+	  Qt::UniqueConnection);
+  connect(m_sruHttp, SIGNAL(readyRead(const QHttpResponseHeader &)),
+	  this, SLOT(slotSRUReadyRead(const QHttpResponseHeader &)),
+	  Qt::UniqueConnection);
+  m_sruHttp->setHost(url.host(), url.port());
+  m_sruHttp->get(url.toEncoded());
 #endif
-    }
-  else
-    {
-      QNetworkReply *reply = m_sruManager->get(QNetworkRequest(url));
-
-      if(reply)
-	{
-	  m_sruResults.clear();
-	  connect(reply, SIGNAL(readyRead(void)),
-		  this, SLOT(slotSRUReadyRead(void)));
-	  connect(reply, SIGNAL(finished(void)),
-		  this, SLOT(slotSRUDownloadFinished(void)));
-	}
-      else
-	{
-	  m_sruWorking->reset(); // Qt 5.5.x adjustment.
-	  m_sruWorking->close();
-	}
-    }
 }
 
 /*
@@ -3323,16 +3303,22 @@ void biblioteq_magazine::slotSRUDownloadFinished(bool error)
 }
 
 /*
-** -- slotSRUDownloadFinished() --
+** -- slotSRUResultReady() --
 */
 
-void biblioteq_magazine::slotSRUDownloadFinished(void)
+void biblioteq_magazine::slotSRUResultReady(const QString &site,
+					    const QByteArray &data)
 {
-  QNetworkReply *reply = qobject_cast<QNetworkReply *> (sender());
+  Q_UNUSED(site);
+  m_sruResults.append(data);
+}
 
-  if(reply)
-    reply->deleteLater();
+/*
+** -- slotSRUSearchFinished() --
+*/
 
+void biblioteq_magazine::slotSRUSearchFinished(void)
+{
   sruDownloadFinished();
 }
 
@@ -3410,18 +3396,6 @@ void biblioteq_magazine::slotSRUReadyRead(const QHttpResponseHeader &resp)
 }
 #endif
 
-/*
-** -- slotSRUReadyRead() --
-*/
-
-void biblioteq_magazine::slotSRUReadyRead(void)
-{
-  QNetworkReply *reply = qobject_cast<QNetworkReply *> (sender());
-
-  if(reply)
-    m_sruResults.append(reply->readAll());
-}
-
 /*
 ** -- slotProxyAuthenticationRequired() --
 */
@@ -3486,114 +3460,19 @@ void biblioteq_magazine::slotAttachFiles(void)
       QApplication::processEvents();
 #endif
 
-      QProgressDialog progress(this);
-      QStringList files(fileDialog.selectedFiles());
-      int i = -1;
-
-#ifdef Q_OS_MAC
-#if QT_VERSION < 0x050000
-      progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
-#endif
-#endif
-      progress.setLabelText(tr("Uploading files..."));
-      progress.setMaximum(files.size());
-      progress.setMinimum(0);
-      progress.setModal(true);
-      progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
-      progress.show();
-#ifndef Q_OS_MAC
-      progress.repaint();
-      QApplication::processEvents();
-#endif
-
-      while(i++, !files.isEmpty() && !progress.wasCanceled())
-	{
-	  QCryptographicHash digest(QCryptographicHash::Sha1);
-	  QFile file;
-	  QString fileName(files.takeFirst());
-
-	  file.setFileName(fileName);
-
-	  if(file.open(QIODevice::ReadOnly))
-	    {
-	      QByteArray bytes(4096, 0);
-	      QByteArray total;
-	      qint64 rc = 0;
-
-	      while((rc = file.read(bytes.data(), bytes.size())) > 0)
-		{
-		  digest.addData(bytes.mid(0, static_cast<int> (rc)));
-		  total.append(bytes.mid(0, static_cast<int> (rc)));
-		}
-
-	      if(!total.isEmpty())
-		{
-		  total = qCompress(total, 9);
-		  createFile(digest.result(), total,
-			     QFileInfo(fileName).fileName());
-		}
-	    }
-
-	  file.close();
-
-	  if(i + 1 <= progress.maximum())
-	    progress.setValue(i + 1);
-
-#ifndef Q_OS_MAC
-	  progress.repaint();
-	  QApplication::processEvents();
-#endif
-	}
-
-      QApplication::restoreOverrideCursor();
-      populateFiles();
-    }
-}
-
-/*
-** -- createFile() --
-*/
-
-void biblioteq_magazine::createFile(const QByteArray &digest,
-				    const QByteArray &bytes,
-				    const QString &fileName) const
-{
-  QSqlQuery query(qmain->getDB());
-
-  if(qmain->getDB().driverName() != "QSQLITE")
-    query.prepare(QString("INSERT INTO %1_files "
-			  "(file, file_digest, file_name, item_oid) "
-			  "VALUES (?, ?, ?, ?)").arg(m_subType));
-  else
-    query.prepare(QString("INSERT INTO %1_files "
-			  "(file, file_digest, file_name, item_oid, myoid) "
-			  "VALUES (?, ?, ?, ?, ?)").arg(m_subType));
-
-  query.bindValue(0, bytes);
-  query.bindValue(1, digest.toHex().constData());
-  query.bindValue(2, fileName);
-  query.bindValue(3, m_oid);
-
-  if(qmain->getDB().driverName() == "QSQLITE")
-    {
       QString errorstr("");
-      qint64 value = biblioteq_misc_functions::getSqliteUniqueId
-	(qmain->getDB(), errorstr);
+      biblioteq_attachments attachments(this);
 
-      if(errorstr.isEmpty())
-	query.bindValue(4, value);
-      else
+      if(!attachments.attach(fileDialog.selectedFiles(),
+			     m_subType.toLower(),
+			     m_oid,
+			     errorstr) && !errorstr.isEmpty())
 	qmain->addError(QString(tr("Database Error")),
-			QString(tr("Unable to generate a unique "
-				   "integer.")),
-			errorstr);
-    }
+			QString(tr("Unable to attach the file(s).")),
+			errorstr, __FILE__, __LINE__);
 
-  if(!query.exec())
-    qmain->addError
-      (QString(tr("Database Error")),
-       QString(tr("Unable to create a database transaction.")),
-       query.lastError().text(), __FILE__, __LINE__);
+      populateFiles();
+    }
 }
 
 /*
@@ -3623,11 +3502,12 @@ void biblioteq_magazine::populateFiles(void)
 
   query.prepare(QString("SELECT file_name, "
 			"file_digest, "
-			"LENGTH(file) AS f_s, "
+			"%1 AS f_s, "
 			"description, "
-			"myoid FROM %1_files "
+			"myoid FROM %2_files "
 			"WHERE item_oid = ? ORDER BY file_name").
-		arg(m_subType));
+		arg(biblioteq_attachments::sizeColumn(m_subType.toLower())).
+		arg(m_subType.toLower()));
   query.bindValue(0, m_oid);
   QApplication::setOverrideCursor(Qt::WaitCursor);
 
@@ -3712,6 +3592,13 @@ void biblioteq_magazine::slotDeleteFiles(void)
       query.exec();
     }
 
+  QString errorstr("");
+
+  if(!biblioteq_attachments::purge(errorstr))
+    qmain->addError(QString(tr("Database Error")),
+		    QString(tr("Unable to remove the unattached file data.")),
+		    errorstr, __FILE__, __LINE__);
+
   QApplication::restoreOverrideCursor();
   populateFiles();
 }
@@ -3753,62 +3640,21 @@ void biblioteq_magazine::slotExportFiles(void)
       QApplication::processEvents();
 #endif
 
-      QProgressDialog progress(this);
-
-#ifdef Q_OS_MAC
-#if QT_VERSION < 0x050000
-      progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
-#endif
-#endif
-      progress.setLabelText(QObject::tr("Exporting file(s)..."));
-      progress.setMaximum(list.size());
-      progress.setMinimum(0);
-      progress.setModal(true);
-      progress.setWindowTitle(QObject::tr("BiblioteQ: Progress Dialog"));
-      progress.show();
-#ifndef Q_OS_MAC
-      progress.repaint();
-      QApplication::processEvents();
-#endif
-
-      int i = -1;
-
-      while(i++, !list.isEmpty() && !progress.wasCanceled())
-	{
-	  QSqlQuery query(qmain->getDB());
-
-	  query.setForwardOnly(true);
-
-	  if(m_subType == "Journal")
-	    query.prepare("SELECT file, file_name FROM journal_files "
-			  "WHERE item_oid = ? AND myoid = ?");
-	  else
-	    query.prepare("SELECT file, file_name FROM magazine_files "
-			  "WHERE item_oid = ? AND myoid = ?");
-
-	  query.bindValue(0, m_oid);
-	  query.bindValue(1, list.takeFirst().data());
-
-	  if(query.exec() && query.next())
-	    {
-	      QFile file(dialog.selectedFiles().value(0) + QDir::separator() +
-			 query.value(1).toString());
-
-	      if(file.open(QIODevice::WriteOnly))
-		file.write(qUncompress(query.value(0).toByteArray()));
-
-	      file.flush();
-	      file.close();
-	    }
-
-	  if(i + 1 <= progress.maximum())
-	    progress.setValue(i + 1);
-
-#ifndef Q_OS_MAC
-	  progress.repaint();
-	  QApplication::processEvents();
-#endif
-	}
+      QString errorstr("");
+      QStringList myoids;
+      biblioteq_attachments attachments(this);
+
+      while(!list.isEmpty())
+	myoids.append(list.takeFirst().data().toString());
+
+      if(!attachments.exportFiles(myoids,
+				  m_subType.toLower(),
+				  m_oid,
+				  dialog.selectedFiles().value(0),
+				  errorstr) && !errorstr.isEmpty())
+	qmain->addError(QString(tr("Error")),
+			QString(tr("Unable to export the file(s).")),
+			errorstr, __FILE__, __LINE__);
     }
 }
 
@@ -12,6 +12,7 @@
 #include <QMainWindow>
 #include <QMenu>
 #include <QNetworkAccessManager>
+#include <QPointer>
 #include <QStringList>
 
 /*
@@ -22,6 +23,7 @@
 #include "biblioteq_generic_thread.h"
 #include "biblioteq_item.h"
 #include "biblioteq_misc_functions.h"
+#include "biblioteq_sru_client.h"
 #include "biblioteq_z3950results.h"
 #include "ui_biblioteq_borrowers.h"
 #include "ui_biblioteq_maginfo.h"
@@ -57,10 +59,10 @@ class biblioteq_magazine: public QMainWindow, public biblioteq_item
 #if QT_VERSION < 0x050000
   QHttp *m_sruHttp;
 #endif
-  QNetworkAccessManager *m_sruManager;
   QPalette m_cb_orig_pal;
   QPalette m_te_orig_pal;
   QPalette m_white_pal;
+  QPointer<biblioteq_sru_search> m_sruSearch;
   QString m_dt_orig_ss;
   QString m_engWindowTitle;
   QString m_subType;
@@ -71,9 +73,6 @@ class biblioteq_magazine: public QMainWindow, public biblioteq_item
   bool m_duplicate;
   bool useHttp(void) const;
   void changeEvent(QEvent *event);
-  void createFile(const QByteArray &digest,
-		  const QByteArray &bytes,
-		  const QString &fileName) const;
   void closeEvent(QCloseEvent *event);
   void populateFiles(void);
   void sruDownloadFinished(void);
@@ -91,12 +90,12 @@ class biblioteq_magazine: public QMainWindow, public biblioteq_item
     (const QNetworkProxy &proxy, QAuthenticator *authenticator);
   void slotReset(void);
   void slotSRUDownloadFinished(bool error);
-  void slotSRUDownloadFinished(void);
   void slotSRUQuery(void);
 #if QT_VERSION < 0x050000
   void slotSRUReadyRead(const QHttpResponseHeader &resp);
 #endif
-  void slotSRUReadyRead(void);
+  void slotSRUResultReady(const QString &site, const QByteArray &data);
+  void slotSRUSearchFinished(void);
   void slotSelectImage(void);
   void slotShowUsers(void);
   void slotZ3950Query(void);
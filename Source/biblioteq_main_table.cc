@@ -2,6 +2,7 @@
 ** -- Qt Includes --
 */
 
+#include <QResizeEvent>
 #include <QtDebug>
 
 /*
@@ -21,21 +22,40 @@ biblioteq_main_table::biblioteq_main_table(QWidget *parent):
   QTableWidget(parent)
 {
   m_lastType.clear();
+  m_materializing = false;
   setDragEnabled(false);
   setAcceptDrops(false);
 #if QT_VERSION >= 0x050000
+  horizontalHeader()->setSectionsClickable(true);
   horizontalHeader()->setSectionsMovable(true);
 #else
+  horizontalHeader()->setClickable(true);
   horizontalHeader()->setMovable(true);
 #endif
   horizontalHeader()->setSortIndicator(0, Qt::AscendingOrder);
   horizontalHeader()->setSortIndicatorShown(true);
   horizontalHeader()->setStretchLastSection(true);
+
+  /*
+  ** Qt's sorting remains disabled as it would only rearrange the
+  ** materialized rows. The store orders the rows, see sortStore().
+  ** A section click flips the sort indicator and must not select the
+  ** column.
+  */
+
+  disconnect(horizontalHeader(), SIGNAL(sectionEntered(int)),
+	     this, SLOT(_q_selectColumn(int)));
+  disconnect(horizontalHeader(), SIGNAL(sectionPressed(int)),
+	     this, SLOT(selectColumn(int)));
 #if QT_VERSION >= 0x050000
   verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 #else
   verticalHeader()->setResizeMode(QHeaderView::Fixed);
 #endif
+  connect(this, SIGNAL(itemChanged(QTableWidgetItem *)),
+	  this, SLOT(slotItemChanged(QTableWidgetItem *)));
+  connect(verticalScrollBar(), SIGNAL(valueChanged(int)),
+	  this, SLOT(slotMaterializeVisibleRows(void)));
 }
 
 /*
@@ -430,6 +450,8 @@ void biblioteq_main_table::resetTable(const QString &username,
     }
 
   setRowCount(0);
+  m_materializedRows.clear();
+  m_store.clear();
   scrollToTop();
   horizontalScrollBar()->setValue(0);
 
@@ -568,3 +590,228 @@ void biblioteq_main_table::setColumnNames(const QStringList &list)
   for(int i = 0; i < list.size(); i++)
     m_columnHeaderIndexes.append(list.at(i));
 }
+
+/*
+** -- setFieldNames() --
+*/
+
+void biblioteq_main_table::setFieldNames(const QStringList &fieldNames)
+{
+  m_store.setColumns(fieldNames);
+}
+
+/*
+** -- appendRow() --
+*/
+
+void biblioteq_main_table::appendRow(const QStringList &values)
+{
+  /*
+  ** The row is only recorded in the store. Table items are created
+  ** once the row becomes visible, see updateRowCount().
+  */
+
+  m_store.appendRow(values);
+}
+
+/*
+** -- updateRowCount() --
+*/
+
+void biblioteq_main_table::updateRowCount(void)
+{
+  if(rowCount() != m_store.rowCount())
+    setRowCount(m_store.rowCount());
+
+  slotMaterializeVisibleRows();
+}
+
+/*
+** -- text() --
+*/
+
+QString biblioteq_main_table::text(const int row, const int column) const
+{
+  if(row >= 0 && row < m_store.rowCount())
+    return m_store.text(row, column);
+
+  QTableWidgetItem *item = QTableWidget::item(row, column);
+
+  if(item)
+    return item->text();
+  else
+    return QString("");
+}
+
+/*
+** -- setText() --
+*/
+
+void biblioteq_main_table::setText(const int row, const int column,
+				   const QString &text)
+{
+  m_store.setText(row, column, text);
+
+  QTableWidgetItem *item = QTableWidget::item(row, column);
+
+  if(item)
+    {
+      m_materializing = true;
+      item->setText(text);
+      m_materializing = false;
+    }
+}
+
+/*
+** -- materializeRow() --
+*/
+
+void biblioteq_main_table::materializeRow(const int row)
+{
+  if(row < 0 || row >= rowCount() || row >= m_store.rowCount())
+    return;
+
+  int columns = columnCount();
+
+  if(columns > m_store.columnCount())
+    columns = m_store.columnCount();
+
+  m_materializing = true;
+
+  for(int i = 0; i < columns; i++)
+    {
+      if(QTableWidget::item(row, i))
+	continue;
+
+      QString str(m_store.text(row, i));
+      QTableWidgetItem *item = 0;
+
+      switch(m_store.columnKind(i))
+	{
+	case biblioteq_columnar_store::CALLNUMBER_COLUMN:
+	  {
+	    item = new(std::nothrow) biblioteq_callnum_table_item(str);
+	    break;
+	  }
+	case biblioteq_columnar_store::EMPTY_COLUMN:
+	  {
+	    break;
+	  }
+	case biblioteq_columnar_store::NUMERIC_COLUMN:
+	  {
+	    item = new(std::nothrow) biblioteq_numeric_table_item
+	      (str.toDouble());
+	    break;
+	  }
+	default:
+	  {
+	    item = new(std::nothrow) QTableWidgetItem();
+	    break;
+	  }
+	}
+
+      if(item)
+	{
+	  item->setText(str);
+	  item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+	  setItem(row, i, item);
+	}
+    }
+
+  m_materializedRows.insert(row);
+  m_materializing = false;
+}
+
+/*
+** -- slotMaterializeVisibleRows() --
+*/
+
+void biblioteq_main_table::slotMaterializeVisibleRows(void)
+{
+  if(rowCount() <= 0 || m_store.rowCount() <= 0)
+    return;
+
+  int first = rowAt(0);
+  int last = rowAt(viewport()->height() - 1);
+
+  if(first < 0)
+    first = 0;
+
+  if(last < 0 || last >= rowCount())
+    last = rowCount() - 1;
+
+  int page = last - first + 1;
+
+  /*
+  ** Discard the items of rows that have scrolled far away so that
+  ** the number of items remains proportional to the viewport.
+  */
+
+  if(m_materializedRows.size() > 8 * page)
+    {
+      QMutableSetIterator<int> it(m_materializedRows);
+
+      m_materializing = true;
+
+      while(it.hasNext())
+	{
+	  int row = it.next();
+
+	  if(row >= first - 2 * page && row <= last + 2 * page)
+	    continue;
+
+	  for(int i = 0; i < columnCount(); i++)
+	    delete takeItem(row, i);
+
+	  it.remove();
+	}
+
+      m_materializing = false;
+    }
+
+  for(int i = first; i <= last; i++)
+    if(!m_materializedRows.contains(i))
+      materializeRow(i);
+}
+
+/*
+** -- slotItemChanged() --
+*/
+
+void biblioteq_main_table::slotItemChanged(QTableWidgetItem *item)
+{
+  if(!item || m_materializing)
+    return;
+
+  /*
+  ** Items are discarded as rows scroll away. Keep the store, which
+  ** outlives them, current.
+  */
+
+  m_store.setText(item->row(), item->column(), item->text());
+}
+
+/*
+** -- resizeEvent() --
+*/
+
+void biblioteq_main_table::resizeEvent(QResizeEvent *event)
+{
+  QTableWidget::resizeEvent(event);
+  slotMaterializeVisibleRows();
+}
+
+/*
+** -- sortStore() --
+*/
+
+void biblioteq_main_table::sortStore(const int column,
+				     const Qt::SortOrder order)
+{
+  m_store.sort(column, order == Qt::AscendingOrder);
+  clearSelection();
+  clearContents();
+  m_materializedRows.clear();
+  horizontalHeader()->setSortIndicator(column, order);
+  slotMaterializeVisibleRows();
+}
@@ -9,9 +9,16 @@
 #include <QHash>
 #include <QHeaderView>
 #include <QScrollBar>
+#include <QSet>
 #include <QTableWidget>
 #include <QTableWidgetItem>
 
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq_columnar_store.h"
+
 class biblioteq_main_table: public QTableWidget
 {
   Q_OBJECT
@@ -19,8 +26,10 @@ class biblioteq_main_table: public QTableWidget
  public:
   biblioteq_main_table(QWidget *parent);
   QHash<QString, QString> friendlyStates(void) const;
+  QString text(const int row, const int column) const;
   QStringList columnNames(void) const;
   int columnNumber(const QString &name) const;
+  void appendRow(const QStringList &values);
   void parseStates(const QHash<QString, QString> &states);
   void recordColumnHidden(const QString &username,
 			  const QString &type,
@@ -30,14 +39,29 @@ class biblioteq_main_table: public QTableWidget
 		  const QString &type,
 		  const QString &roles);
   void setColumnNames(const QStringList &list);
+  void setFieldNames(const QStringList &fieldNames);
+  void setText(const int row, const int column, const QString &text);
+  void sortStore(const int column, const Qt::SortOrder order);
+  void updateRowCount(void);
+
+ protected:
+  void resizeEvent(QResizeEvent *event);
 
  private:
   QHash<QString, QList<int> > m_hiddenColumns;
+  QSet<int> m_materializedRows;
   QString m_lastType;
   QVector<QString> m_columnHeaderIndexes;
+  biblioteq_columnar_store m_store;
+  bool m_materializing;
+  void materializeRow(const int row);
   void setColumns(const QString &username,
 		  const QString &type,
 		  const QString &roles);
+
+ private slots:
+  void slotItemChanged(QTableWidgetItem *item);
+  void slotMaterializeVisibleRows(void);
 };
 
 #endif
@@ -1,10 +1,130 @@
 #include <QObject>
-#include <QStringList>
-#include <QXmlStreamReader>
 #include <QtDebug>
 
 #include "biblioteq_marc.h"
 
+/*
+** The field handlers of each item type and record syntax. The
+** handlers are selected once per record and dispatch on the
+** numeric tag.
+*/
+
+const biblioteq_marc::handlers biblioteq_marc::s_handlers[2][2] =
+  {
+    {
+      {&biblioteq_marc::parseBookSRUMarc21,
+       &biblioteq_marc::parseBookZ3950Marc21},
+      {&biblioteq_marc::parseBookSRUUnimarc,
+       &biblioteq_marc::parseBookZ3950Unimarc}
+    },
+    {
+      {&biblioteq_marc::parseMagazineSRUMarc21,
+       &biblioteq_marc::parseMagazineZ3950Marc21},
+      {0,
+       &biblioteq_marc::parseMagazineZ3950Unimarc}
+    }
+  };
+
+/*
+** ISO 2709 structural characters.
+*/
+
+static const char FIELD_TERMINATOR = 0x1e;
+static const char RECORD_TERMINATOR = 0x1d;
+static const char SUBFIELD_DELIMITER = 0x1f;
+
+static bool isElement(const QXmlStreamReader &reader, const char *name)
+{
+  return reader.name().compare(QLatin1String(name), Qt::CaseInsensitive) == 0;
+}
+
+static bool isSubfield(const QXmlStreamReader &reader, const char code)
+{
+  /*
+  ** Equivalent to comparing the trimmed and lowercased code
+  ** attribute, without producing temporary strings.
+  */
+
+  QStringRef value(reader.attributes().value("code"));
+  int i = 0;
+
+  while(i < value.length() && value.at(i).isSpace())
+    i += 1;
+
+  if(i >= value.length() || value.at(i).toLower() != QLatin1Char(code))
+    return false;
+
+  for(i += 1; i < value.length(); i++)
+    if(!value.at(i).isSpace())
+      return false;
+
+  return true;
+}
+
+static int fieldTag(const QStringRef &tag)
+{
+  /*
+  ** Returns the value of a three-digit tag, ignoring surrounding
+  ** whitespace, or -1.
+  */
+
+  int digits = 0;
+  int i = 0;
+  int value = 0;
+
+  while(i < tag.length() && tag.at(i).isSpace())
+    i += 1;
+
+  for(; i < tag.length() && tag.at(i).isDigit(); i++)
+    {
+      digits += 1;
+      value = 10 * value + tag.at(i).digitValue();
+    }
+
+  for(; i < tag.length(); i++)
+    if(!tag.at(i).isSpace())
+      return -1;
+
+  return digits == 3 ? value : -1;
+}
+
+static int lineTag(const QString &data, const int start, const int end)
+{
+  /*
+  ** Rendered fields begin with a three-digit tag and a space.
+  */
+
+  if(end - start < 4 || data.at(start + 3) != QLatin1Char(' '))
+    return -1;
+
+  int value = 0;
+
+  for(int i = start; i < start + 3; i++)
+    if(data.at(i).isDigit())
+      value = 10 * value + data.at(i).digitValue();
+    else
+      return -1;
+
+  return value;
+}
+
+static int numberAt(const char *data, const int length)
+{
+  /*
+  ** Leader and directory numbers are fixed-width decimals.
+  */
+
+  int value = 0;
+
+  for(int i = 0; i < length; i++)
+    if(data[i] >= '0' && data[i] <= '9')
+      value = 10 * value + data[i] - '0';
+    else
+      return -1;
+
+  return value;
+}
+
 biblioteq_marc::biblioteq_marc(const ITEM_TYPE itemType,
 			       const PROTOCOL protocol,
 			       const RECORD_SYNTAX recordSyntax)
@@ -16,6 +136,9 @@ biblioteq_marc::biblioteq_marc(const ITEM_TYPE itemType,
 
 biblioteq_marc::biblioteq_marc(void)
 {
+  m_itemType = BOOK;
+  m_protocol = SRU;
+  m_recordSyntax = MARC21;
 }
 
 biblioteq_marc::~biblioteq_marc()
@@ -33,6 +156,7 @@ void biblioteq_marc::clear(void)
   m_edition.clear();
   m_isbn10.clear();
   m_isbn13.clear();
+  m_issn.clear();
   m_lcnum.clear();
   m_place.clear();
   m_publicationDate = QDate();
@@ -49,1484 +173,1287 @@ void biblioteq_marc::initialize(const ITEM_TYPE itemType,
   m_recordSyntax = recordSyntax;
 }
 
-void biblioteq_marc::parseBookSRUMarc21(void)
+void biblioteq_marc::parseBookSRUMarc21(const int tag,
+					QXmlStreamReader &reader)
 {
-  clear();
-
-  QXmlStreamReader reader(m_data);
-
-  while(!reader.atEnd())
-    if(reader.readNextStartElement())
+  switch(tag)
+    {
+    case 10:
       {
-	if(reader.name().toString().toLower().
-	   trimmed() == "datafield")
-	  {
-	    QString tag(reader.attributes().value("tag").
-			toString().toLower().trimmed());
+	/*
+	** $a - LC control number (NR)
+	** $b - NUCMC control number (R)
+	** $z - Canceled/invalid LC control number (R)
+	** $8 - Field link and sequence number (R)
+	*/
 
-	    if(tag == "010")
-	      {
-		/*
-		** $a - LC control number (NR)
-		** $b - NUCMC control number (R)
-		** $z - Canceled/invalid LC control number (R)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    {
-		      if(reader.attributes().value("code").
-			 toString().toLower().trimmed() == "a")
-			{
-			  str.append(reader.readElementText());
-			  break;
-			}
-		    }
-		  else
-		    break;
-
-		str = str.trimmed();
-		m_lcnum = str;
-	      }
-	    else if(tag == "020")
-	      {
-		/*
-		** $a - International Standard Book Number (NR)
-		** $c - Terms of availability (NR)
-		** $z - Canceled/invalid ISBN (R)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    str.append(reader.readElementText());
-		  else
-		    break;
-
-		if(str.toLower().contains("hardcover"))
-		  m_binding = QObject::tr("hardcover");
-		else if(str.toLower().contains("pbk"))
-		  m_binding = QObject::tr("paperback");
-		else
-		  m_binding = QObject::tr("UNKNOWN");
-
-		if(str.contains(" ") && str.indexOf(" ") == 10)
-		  {
-		    str = str.mid(0, 10).trimmed();
-		    m_isbn10 = str;
-		  }
-		else if(str.contains(" ") &&
-			str.indexOf(" ") == 13)
-		  {
-		    str = str.mid(0, 13).trimmed();
-		    m_isbn13 = str;
-		  }
-		else if(str.length() == 10)
-		  m_isbn10 = str;
-	      }
-	    else if(tag == "050")
-	      {
-		/*
-		** $a - Classification number (R)
-		** $b - Item number (NR)
-		** $3 - Materials specified (NR)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    {
-		      if(reader.attributes().value("code").
-			 toString().toLower().trimmed() == "a" ||
-			 reader.attributes().value("code").
-			 toString().toLower().trimmed() == "b")
-			str.append(reader.readElementText());
-		    }
-		  else
-		    break;
-
-		m_callnum = str;
-	      }
-	    else if(tag == "082")
-	      {
-		/*
-		** $a - Classification number (R)
-		** $b - Item number (NR)
-		** $m - Standard or optional designation (NR)
-		** $q - Assigning agency (NR)
-		** $2 - Edition number (NR)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    {
-		      if(reader.attributes().value("code").
-			 toString().toLower().trimmed() == "a" ||
-			 reader.attributes().value("code").
-			 toString().toLower().trimmed() == "b" ||
-			 reader.attributes().value("code").
-			 toString().toLower().trimmed() == "m" ||
-			 reader.attributes().value("code").
-			 toString().toLower().trimmed() == "q")
-			str.append(reader.readElementText());
-		    }
-		  else
-		    break;
-
-		m_deweynum = str;
-	      }
-	    else if(tag == "100" || tag == "700")
-	      {
-		/*
-		** $a - Personal name (NR)
-		** $b - Numeration (NR)
-		** $c - Titles and words associated with a name (R)
-		** $d - Dates associated with a name (NR)
-		** $e - Relator term (R)
-		** $f - Date of a work (NR)
-		** $g - Miscellaneous information (NR)
-		** $j - Attribution qualifier (R)
-		** $k - Form subheading (R)
-		** $l - Language of a work (NR)
-		** $n - Number of part/section of a work (R)
-		** $p - Name of part/section of a work (R)
-		** $q - Fuller form of name (NR)
-		** $t - Title of a work (NR)
-		** $u - Affiliation (NR)
-		** $0 - Authority record control number (R)
-		** $4 - Relator code (R)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    {
-		      if(reader.attributes().value("code").
-			 toString().toLower().trimmed() == "a")
-			{
-			  str.append(reader.readElementText());
-			  break;
-			}
-		    }
-		  else
-		    break;
-
-		if(str.endsWith(","))
-		  str = str.mid(0, str.length() - 1).trimmed();
-
-		if(!m_author.contains(str))
-		  {
-		    if(tag == "100")
-		      m_author = str;
-		    else if(!m_author.isEmpty())
-		      m_author = m_author + "\n" + str;
-		    else
-		      m_author = str;
-		  }
-	      }
-	    else if(tag == "245")
-	      {
-		/*
-		** $a - Title (NR)
-		** $b - Remainder of title (NR)
-		** $c - Statement of responsibility, etc. (NR)
-		** $f - Inclusive dates (NR)
-		** $g - Bulk dates (NR)
-		** $h - Medium (NR)
-		** $k - Form (R)
-		** $n - Number of part/section of a work (R)
-		** $p - Name of part/section of a work (R)
-		** $s - Version (NR)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str;
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    {
-		      if(reader.attributes().value("code").
-			 toString().toLower().trimmed() == "a" ||
-			 reader.attributes().value("code").
-			 toString().toLower().trimmed() == "b")
-			str.append(reader.readElementText());
-		    }
-		  else
-		    break;
-
-		if(str.lastIndexOf('/') > -1)
-		  str = str.mid
-		    (0, str.lastIndexOf('/')).trimmed();
-
-		m_title = str;
-	      }
-	    else if(tag == "250")
-	      {
-		/*
-		** $a - Edition statement (NR)
-		** $b - Remainder of edition statement (NR)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    {
-		      if(reader.attributes().value("code").
-			 toString().toLower().trimmed() == "a")
-			{
-			  str.append(reader.readElementText());
-			  break;
-			}
-		    }
-		  else
-		    break;
-
-		if(str.indexOf(" ") > -1)
-		  str = str.mid(0, str.indexOf(" ")).trimmed();
-
-		int i = 0;
-
-		for(i = 0; i < str.size(); i++)
-		  if(!str.at(i).isDigit())
-		    break;
-
-		str = str.mid(0, i);
-		m_edition = str;
-	      }
-	    else if(tag == "260")
-	      {
-		/*
-		** $a - Place of publication, distribution,
-		**      etc. (R)
-		** $b - Name of publisher, distributor, etc. (R)
-		** $c - Date of publication, distribution, etc. (R)
-		** $e - Place of manufacture (R)
-		** $f - Manufacturer (R)
-		** $g - Date of manufacture (R)
-		** $3 - Materials specified (NR)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString date("");
-		QString place("");
-		QString publisher("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    {
-		      if(reader.attributes().value("code").
-			 toString().toLower().trimmed() == "a")
-			place = reader.readElementText();
-		      else if(reader.attributes().value("code").
-			      toString().toLower().trimmed() == "b")
-			publisher = reader.readElementText();
-		      else if(reader.attributes().value("code").
-			      toString().toLower().trimmed() == "c")
-			{
-			  date = reader.readElementText().toLower();
-
-			  for(int i = date.length() - 1; i >= 0; i--)
-			    if(!date.at(i).isNumber())
-			      date.remove(i, 1);
-			}
-		    }
-		  else
-		    break;
-
-		m_publicationDate = QDate::fromString
-		  ("01/01/" + date.mid(0, 4), "MM/dd/yyyy");
-
-		if(place.lastIndexOf(" ") > -1)
-		  place = place.mid(0, place.lastIndexOf(" ")).
-		    trimmed();
-
-		if(!place.isEmpty())
-		  if(!place[place.length() - 1].isLetter())
-		    place = place.remove(place.length() - 1, 1).
-		      trimmed();
-
-		m_place = place;
-
-		if(publisher.endsWith(","))
-		  publisher = publisher.mid
-		    (0, publisher.length() - 1).trimmed();
-
-		m_publisher = publisher;
-	      }
-	    else if(tag == "300")
-	      {
-		/*
-		** $a - Extent (R)
-		** $b - Other physical details (NR)
-		** $c - Dimensions (R)
-		** $e - Accompanying material (NR)
-		** $f - Type of unit (R)
-		** $g - Size of unit (R)
-		** $3 - Materials specified (NR)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    str.append(reader.readElementText());
-		  else
-		    break;
-
-		m_description = str;
-	      }
-	    else if(tag == "650")
-	      {
-		/*
-		** $a - Topical term or geographic name entry
-		**      element (NR)
-		** $b - Topical term following geographic name
-		**      entry element (NR)
-		** $c - Location of event (NR)
-		** $d - Active dates (NR)
-		** $e - Relator term (R)
-		** $4 - Relator code (R)
-		** $v - Form subdivision (R)
-		** $x - General subdivision (R)
-		** $y - Chronological subdivision (R)
-		** $z - Geographic subdivision (R)
-		** $0 - Authority record control number (R)
-		** $2 - Source of heading or term (NR)
-		** $3 - Materials specified (NR)
-		** $6 - Linkage (NR)
-		** $8 - Field link and sequence number (R)
-		*/
-
-		QString str("");
-
-		while(reader.readNextStartElement())
-		  if(reader.name().toString().toLower().
-		     trimmed() == "subfield")
-		    {
-		      if(reader.attributes().value("code").
-			 toString().toLower().trimmed() == "a")
-			{
-			  str.append(reader.readElementText());
-			  break;
-			}
-		    }
-		  else
-		    break;
-
-		if(!str.isEmpty())
-		  {
-		    if(!str[str.length() - 1].isPunct())
-		      str += ".";
-
-		    if(!m_category.contains(str))
-		      {
-			if(!m_category.isEmpty())
-			  m_category =
-			    m_category + "\n" + str;
-			else
-			  m_category = str;
-		      }
-		  }
-	      }
-	  }
-      }
-}
-
-void biblioteq_marc::parseBookSRUUnimarc(void)
-{
-}
-
-void biblioteq_marc::parseBookZ3950Marc21(void)
-{
-  clear();
+	QString str("");
 
-  QStringList list(m_data.split("\n"));
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a'))
+		{
+		  str.append(reader.readElementText());
+		  break;
+		}
+	    }
+	  else
+	    break;
 
-  for(int i = 0; i < list.size(); i++)
-    {
-      QString str = list[i];
+	str = str.trimmed();
+	m_lcnum = str;
+	break;
+      }
+    case 20:
+      {
+	/*
+	** $a - International Standard Book Number (NR)
+	** $c - Terms of availability (NR)
+	** $z - Canceled/invalid ISBN (R)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str("");
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    str.append(reader.readElementText());
+	  else
+	    break;
 
-      if(str.startsWith("010 "))
-	{
-	  str = str.mid(4);
+	if(str.toLower().contains("hardcover"))
+	  m_binding = QObject::tr("hardcover");
+	else if(str.toLower().contains("pbk"))
+	  m_binding = QObject::tr("paperback");
+	else
+	  m_binding = QObject::tr("UNKNOWN");
 
-	  /*
-	  ** $a - LC control number (NR)
-	  ** $b - NUCMC control number (R)
-	  ** $z - Canceled/invalid LC control number (R)
-	  ** $8 - Field link and sequence number (R)
-	  */
+	if(str.contains(" ") && str.indexOf(" ") == 10)
+	  {
+	    str = str.mid(0, 10).trimmed();
+	    m_isbn10 = str;
+	  }
+	else if(str.contains(" ") &&
+		str.indexOf(" ") == 13)
+	  {
+	    str = str.mid(0, 13).trimmed();
+	    m_isbn13 = str;
+	  }
+	else if(str.length() == 10)
+	  m_isbn10 = str;
+	break;
+      }
+    case 50:
+      {
+	/*
+	** $a - Classification number (R)
+	** $b - Item number (NR)
+	** $3 - Materials specified (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str("");
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a') ||
+		 isSubfield(reader, 'b'))
+		str.append(reader.readElementText());
+	    }
+	  else
+	    break;
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+	m_callnum = str;
+	break;
+      }
+    case 82:
+      {
+	/*
+	** $a - Classification number (R)
+	** $b - Item number (NR)
+	** $m - Standard or optional designation (NR)
+	** $q - Assigning agency (NR)
+	** $2 - Edition number (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str("");
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a') ||
+		 isSubfield(reader, 'b') ||
+		 isSubfield(reader, 'm') ||
+		 isSubfield(reader, 'q'))
+		str.append(reader.readElementText());
+	    }
+	  else
+	    break;
 
-	  QStringList subfields;
+	m_deweynum = str;
+	break;
+      }
+    case 100:
+    case 700:
+      {
+	/*
+	** $a - Personal name (NR)
+	** $b - Numeration (NR)
+	** $c - Titles and words associated with a name (R)
+	** $d - Dates associated with a name (NR)
+	** $e - Relator term (R)
+	** $f - Date of a work (NR)
+	** $g - Miscellaneous information (NR)
+	** $j - Attribution qualifier (R)
+	** $k - Form subheading (R)
+	** $l - Language of a work (NR)
+	** $n - Number of part/section of a work (R)
+	** $p - Name of part/section of a work (R)
+	** $q - Fuller form of name (NR)
+	** $t - Title of a work (NR)
+	** $u - Affiliation (NR)
+	** $0 - Authority record control number (R)
+	** $4 - Relator code (R)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str("");
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a'))
+		{
+		  str.append(reader.readElementText());
+		  break;
+		}
+	    }
+	  else
+	    break;
 
-	  subfields << "$b"
-		    << "$z"
-		    << "$8";
+	if(str.endsWith(","))
+	  str = str.mid(0, str.length() - 1).trimmed();
 
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
+	if(!m_author.contains(str))
+	  {
+	    if(tag == 100)
+	      m_author = str;
+	    else if(!m_author.isEmpty())
+	      m_author = m_author + "\n" + str;
 	    else
-	      subfields.takeFirst();
+	      m_author = str;
+	  }
+	break;
+      }
+    case 245:
+      {
+	/*
+	** $a - Title (NR)
+	** $b - Remainder of title (NR)
+	** $c - Statement of responsibility, etc. (NR)
+	** $f - Inclusive dates (NR)
+	** $g - Bulk dates (NR)
+	** $h - Medium (NR)
+	** $k - Form (R)
+	** $n - Number of part/section of a work (R)
+	** $p - Name of part/section of a work (R)
+	** $s - Version (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str;
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a') ||
+		 isSubfield(reader, 'b'))
+		str.append(reader.readElementText());
+	    }
+	  else
+	    break;
 
-	  m_lcnum = str;
-	}
-      else if(str.startsWith("020 "))
-	{
-	  str = str.mid(4);
+	if(str.lastIndexOf('/') > -1)
+	  str = str.mid
+	    (0, str.lastIndexOf('/')).trimmed();
 
-	  /*
-	  ** $a - International Standard Book Number (NR)
-	  ** $c - Terms of availability (NR)
-	  ** $z - Canceled/invalid ISBN (R)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
+	m_title = str;
+	break;
+      }
+    case 250:
+      {
+	/*
+	** $a - Edition statement (NR)
+	** $b - Remainder of edition statement (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+	QString str("");
 
-	  if(str.toLower().contains("hardcover"))
-	    m_binding = QObject::tr("hardcover");
-	  else if(str.toLower().contains("pbk"))
-	    m_binding = QObject::tr("paperback");
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a'))
+		{
+		  str.append(reader.readElementText());
+		  break;
+		}
+	    }
 	  else
-	    m_binding = QObject::tr("UNKNOWN");
-
-	  if(str.contains(" ") && str.indexOf(" ") == 10)
-	    m_isbn10 = str.mid(0, 10).trimmed();
-	  else if(str.contains(" ") && str.indexOf(" ") == 13)
-	    m_isbn13 = str.mid(0, 13).trimmed();
-	  else if(str.length() == 10)
-	    m_isbn10 = str;
-	}
-      else if(str.startsWith("050 "))
-	{
-	  str = str.mid(4);
+	    break;
 
-	  /*
-	  ** $a - Classification number (R)
-	  ** $b - Item number (NR)
-	  ** $3 - Materials specified (NR)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
+	if(str.indexOf(" ") > -1)
+	  str = str.mid(0, str.indexOf(" ")).trimmed();
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+	int i = 0;
 
-	  str = str.remove(" $b").trimmed();
+	for(i = 0; i < str.size(); i++)
+	  if(!str.at(i).isDigit())
+	    break;
 
-	  QStringList subfields;
+	str = str.mid(0, i);
+	m_edition = str;
+	break;
+      }
+    case 260:
+      {
+	/*
+	** $a - Place of publication, distribution,
+	**      etc. (R)
+	** $b - Name of publisher, distributor, etc. (R)
+	** $c - Date of publication, distribution, etc. (R)
+	** $e - Place of manufacture (R)
+	** $f - Manufacturer (R)
+	** $g - Date of manufacture (R)
+	** $3 - Materials specified (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString date("");
+	QString place("");
+	QString publisher("");
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a'))
+		place = reader.readElementText();
+	      else if(isSubfield(reader, 'b'))
+		publisher = reader.readElementText();
+	      else if(isSubfield(reader, 'c'))
+		{
+		  date = reader.readElementText().toLower();
 
-	  subfields << "$3"
-		    << "$6"
-		    << "$8";
+		  for(int i = date.length() - 1; i >= 0; i--)
+		    if(!date.at(i).isNumber())
+		      date.remove(i, 1);
+		}
+	    }
+	  else
+	    break;
 
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+	m_publicationDate = QDate::fromString
+	  ("01/01/" + date.mid(0, 4), "MM/dd/yyyy");
 
-	  m_callnum = str;
-	}
-      else if(str.startsWith("082 "))
-	{
-	  str = str.mid(4);
+	if(place.lastIndexOf(" ") > -1)
+	  place = place.mid(0, place.lastIndexOf(" ")).
+	    trimmed();
 
-	  /*
-	  ** $a - Classification number (R)
-	  ** $b - Item number (NR)
-	  ** $m - Standard or optional designation (NR)
-	  ** $q - Assigning agency (NR)
-	  ** $2 - Edition number (NR)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
+	if(!place.isEmpty())
+	  if(!place[place.length() - 1].isLetter())
+	    place = place.remove(place.length() - 1, 1).
+	      trimmed();
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+	m_place = place;
 
-	  str = str.remove(" $b").remove
-	    (" $m").remove(" $q").trimmed();
+	if(publisher.endsWith(","))
+	  publisher = publisher.mid
+	    (0, publisher.length() - 1).trimmed();
 
-	  QStringList subfields;
+	m_publisher = publisher;
+	break;
+      }
+    case 300:
+      {
+	/*
+	** $a - Extent (R)
+	** $b - Other physical details (NR)
+	** $c - Dimensions (R)
+	** $e - Accompanying material (NR)
+	** $f - Type of unit (R)
+	** $g - Size of unit (R)
+	** $3 - Materials specified (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str("");
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    str.append(reader.readElementText());
+	  else
+	    break;
 
-	  subfields << "$2"
-		    << "$6"
-		    << "$8";
+	m_description = str;
+	break;
+      }
+    case 650:
+      {
+	/*
+	** $a - Topical term or geographic name entry
+	**      element (NR)
+	** $b - Topical term following geographic name
+	**      entry element (NR)
+	** $c - Location of event (NR)
+	** $d - Active dates (NR)
+	** $e - Relator term (R)
+	** $4 - Relator code (R)
+	** $v - Form subdivision (R)
+	** $x - General subdivision (R)
+	** $y - Chronological subdivision (R)
+	** $z - Geographic subdivision (R)
+	** $0 - Authority record control number (R)
+	** $2 - Source of heading or term (NR)
+	** $3 - Materials specified (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str("");
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a'))
+		{
+		  str.append(reader.readElementText());
+		  break;
+		}
+	    }
+	  else
+	    break;
 
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+	if(!str.isEmpty())
+	  {
+	    if(!str[str.length() - 1].isPunct())
+	      str += ".";
 
-	  m_deweynum = str;
-	}
-      else if(str.startsWith("100 ") ||
-	      str.startsWith("700 "))
-	{
-	  str = str.mid(4);
+	    if(!m_category.contains(str))
+	      {
+		if(!m_category.isEmpty())
+		  m_category =
+		    m_category + "\n" + str;
+		else
+		  m_category = str;
+	      }
+	  }
+	break;
+      }
+    default:
+      break;
+    }
+}
 
-	  /*
-	  ** $a - Personal name (NR)
-	  ** $b - Numeration (NR)
-	  ** $c - Titles and words associated with a name (R)
-	  ** $d - Dates associated with a name (NR)
-	  ** $e - Relator term (R)
-	  ** $f - Date of a work (NR)
-	  ** $g - Miscellaneous information (NR)
-	  ** $j - Attribution qualifier (R)
-	  ** $k - Form subheading (R)
-	  ** $l - Language of a work (NR)
-	  ** $n - Number of part/section of a work (R)
-	  ** $p - Name of part/section of a work (R)
-	  ** $q - Fuller form of name (NR)
-	  ** $t - Title of a work (NR)
-	  ** $u - Affiliation (NR)
-	  ** $0 - Authority record control number (R)
-	  ** $4 - Relator code (R)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
+void biblioteq_marc::parseBookSRUUnimarc(const int tag,
+					 QXmlStreamReader &reader)
+{
+  Q_UNUSED(reader);
+  Q_UNUSED(tag);
+}
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
-
-	  QStringList subfields;
-
-	  subfields << "$b"
-		    << "$c"
-		    << "$d"
-		    << "$e"
-		    << "$f"
-		    << "$g"
-		    << "$j"
-		    << "$k"
-		    << "$l"
-		    << "$n"
-		    << "$p"
-		    << "$q"
-		    << "$t"
-		    << "$u"
-		    << "$0"
-		    << "$4"
-		    << "$6"
-		    << "$8";
-
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
+void biblioteq_marc::parseBookZ3950Marc21(const int tag,
+					  const QString &indicators,
+					  const QVector<subfield> &subfields)
+{
+  switch(tag)
+    {
+    case 10:
+      {
+	/*
+	** $a - LC control number (NR)
+	** $b - NUCMC control number (R)
+	** $z - Canceled/invalid LC control number (R)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	m_lcnum = subfieldText(subfields, "a");
+	break;
+      }
+    case 20:
+      {
+	/*
+	** $a - International Standard Book Number (NR)
+	** $c - Terms of availability (NR)
+	** $q - Qualifying information (R)
+	** $z - Canceled/invalid ISBN (R)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString qualifiers(subfieldText(subfields, "acq").toLower());
+	QString str(subfieldText(subfields, "a"));
+
+	if(qualifiers.contains("hardcover"))
+	  m_binding = QObject::tr("hardcover");
+	else if(qualifiers.contains("pbk"))
+	  m_binding = QObject::tr("paperback");
+	else
+	  m_binding = QObject::tr("UNKNOWN");
+
+	if(str.contains(" ") && str.indexOf(" ") == 10)
+	  m_isbn10 = str.mid(0, 10).trimmed();
+	else if(str.contains(" ") && str.indexOf(" ") == 13)
+	  m_isbn13 = str.mid(0, 13).trimmed();
+	else if(str.length() == 10)
+	  m_isbn10 = str;
+	else if(str.length() == 13)
+	  m_isbn13 = str;
+	break;
+      }
+    case 50:
+      {
+	/*
+	** $a - Classification number (R)
+	** $b - Item number (NR)
+	** $3 - Materials specified (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	m_callnum = subfieldText(subfields, "ab");
+	break;
+      }
+    case 82:
+      {
+	/*
+	** $a - Classification number (R)
+	** $b - Item number (NR)
+	** $m - Standard or optional designation (NR)
+	** $q - Assigning agency (NR)
+	** $2 - Edition number (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	m_deweynum = subfieldText(subfields, "abmq");
+	break;
+      }
+    case 100:
+    case 700:
+      {
+	/*
+	** $a - Personal name (NR)
+	** $b - Numeration (NR)
+	** $c - Titles and words associated with a name (R)
+	** $d - Dates associated with a name (NR)
+	** $e - Relator term (R)
+	** $f - Date of a work (NR)
+	** $g - Miscellaneous information (NR)
+	** $j - Attribution qualifier (R)
+	** $k - Form subheading (R)
+	** $l - Language of a work (NR)
+	** $n - Number of part/section of a work (R)
+	** $p - Name of part/section of a work (R)
+	** $q - Fuller form of name (NR)
+	** $t - Title of a work (NR)
+	** $u - Affiliation (NR)
+	** $0 - Authority record control number (R)
+	** $4 - Relator code (R)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str(subfieldText(subfields, "a"));
+
+	if(str.endsWith(","))
+	  str = str.mid(0, str.length() - 1).trimmed();
+
+	if(!m_author.contains(str))
+	  {
+	    if(tag == 100)
+	      m_author = str;
+	    else if(!m_author.isEmpty())
+	      m_author = m_author + "\n" + str;
 	    else
-	      subfields.takeFirst();
+	      m_author = str;
+	  }
+	break;
+      }
+    case 245:
+      {
+	/*
+	** $a - Title (NR)
+	** $b - Remainder of title (NR)
+	** $c - Statement of responsibility, etc. (NR)
+	** $f - Inclusive dates (NR)
+	** $g - Bulk dates (NR)
+	** $h - Medium (NR)
+	** $k - Form (R)
+	** $n - Number of part/section of a work (R)
+	** $p - Name of part/section of a work (R)
+	** $s - Version (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str(subfieldText(subfields, "ab"));
+
+	if(str.lastIndexOf('/') > -1)
+	  str = str.mid(0, str.lastIndexOf('/')).trimmed();
+
+	m_title = str;
+	break;
+      }
+    case 250:
+      {
+	/*
+	** $a - Edition statement (NR)
+	** $b - Remainder of edition statement (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str(subfieldText(subfields, "a"));
+
+	if(str.indexOf(" ") > -1)
+	  str = str.mid(0, str.indexOf(" ")).trimmed();
+
+	str = str.remove("d").remove("h").remove("n").
+	  remove("r").remove("s").remove("t").trimmed();
+	m_edition = str;
+	break;
+      }
+    case 260:
+    case 264:
+      {
+	/*
+	** $a - Place of publication, distribution, etc. (R)
+	** $b - Name of publisher, distributor, etc. (R)
+	** $c - Date of publication, distribution, etc. (R)
+	** $e - Place of manufacture (R) (260)
+	** $f - Manufacturer (R) (260)
+	** $g - Date of manufacture (R) (260)
+	** $3 - Materials specified (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	/*
+	** The second indicator of 264 distinguishes publication (1)
+	** from production, distribution, manufacture and copyright.
+	*/
+
+	if(tag == 264 && indicators.mid(1, 1) != "1")
+	  break;
+
+	parsePublication(subfields, 'a', 'b', 'c');
+	break;
+      }
+    case 300:
+      {
+	/*
+	** $a - Extent (R)
+	** $b - Other physical details (NR)
+	** $c - Dimensions (R)
+	** $e - Accompanying material (NR)
+	** $f - Type of unit (R)
+	** $g - Size of unit (R)
+	** $3 - Materials specified (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	m_description = subfieldText(subfields, "abcefg");
+	break;
+      }
+    case 650:
+      {
+	/*
+	** $a - Topical term or geographic name entry
+	**      element (NR)
+	** $b - Topical term following geographic name entry
+	**      element (NR)
+	** $c - Location of event (NR)
+	** $d - Active dates (NR)
+	** $e - Relator term (R)
+	** $4 - Relator code (R)
+	** $v - Form subdivision (R)
+	** $x - General subdivision (R)
+	** $y - Chronological subdivision (R)
+	** $z - Geographic subdivision (R)
+	** $0 - Authority record control number (R)
+	** $2 - Source of heading or term (NR)
+	** $3 - Materials specified (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	appendCategory(subfieldText(subfields, "a"));
+	break;
+      }
+    default:
+      break;
+    }
+}
 
-	  if(str.endsWith(","))
-	    str = str.mid(0, str.length() - 1).trimmed();
+void biblioteq_marc::parseBookZ3950Unimarc(const int tag,
+					   const QString &indicators,
+					   const QVector<subfield> &subfields)
+{
+  Q_UNUSED(indicators);
 
-	  if(!m_author.contains(str))
+  switch(tag)
+    {
+    case 10:
+      {
+	/*
+	** $a - Number (ISMN)
+	** $b - Qualification
+	** $d - Terms of Availability and/or Price
+	** $z - Erroneous ISMN
+	** $6 - Interfield Linking Data
+	*/
+
+	QString qualifiers(subfieldText(subfields, "abd").toLower());
+	QString str(subfieldText(subfields, "a"));
+
+	if(qualifiers.contains("hardcover"))
+	  m_binding = QObject::tr("hardcover");
+	else if(qualifiers.contains("pbk"))
+	  m_binding = QObject::tr("paperback");
+	else
+	  m_binding = QObject::tr("UNKNOWN");
+
+	str = str.remove("#").remove("M-").remove("-").trimmed();
+
+	if(str.length() == 10)
+	  m_isbn10 = str;
+	else if(str.length() == 13)
+	  m_isbn13 = str;
+	break;
+      }
+    case 200:
+      {
+	/*
+	** $a - Title Proper
+	** $b - General Material Designation
+	** $c - Title Proper by Another Author
+	** $d - Parallel Title Proper
+	** $e - Other Title Information
+	** $f - First Statement of Responsibility
+	** $g - Subsequent Statement of Responsibility
+	** $h - Number of a Part
+	** $i - Name of a Part
+	** $v - Volume Designation
+	** $z - Language of Parallel Title Proper
+	** $5 - Institution to Which Field Applies
+	*/
+
+	for(int i = 0; i < subfields.size(); i++)
+	  if(subfields.at(i).m_code == 'f')
 	    {
-	      if(list[i].startsWith("100 "))
-		m_author = str;
-	      else if(!m_author.isEmpty())
-		m_author = m_author + "\n" + str;
+	      if(!m_author.isEmpty())
+		m_author = m_author + "\n" + subfields.at(i).m_data;
 	      else
-		m_author = str;
+		m_author = subfields.at(i).m_data;
 	    }
-	}
-      else if(str.startsWith("245 "))
-	{
-	  str = str.mid(4);
 
-	  /*
-	  ** $a - Title (NR)
-	  ** $b - Remainder of title (NR)
-	  ** $c - Statement of responsibility, etc. (NR)
-	  ** $f - Inclusive dates (NR)
-	  ** $g - Bulk dates (NR)
-	  ** $h - Medium (NR)
-	  ** $k - Form (R)
-	  ** $n - Number of part/section of a work (R)
-	  ** $p - Name of part/section of a work (R)
-	  ** $s - Version (NR)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
+	QString str(subfieldText(subfields, "ab"));
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+	if(str.lastIndexOf('/') > -1)
+	  str = str.mid(0, str.lastIndexOf('/')).trimmed();
 
-	  str = str.remove(" $b").trimmed();
+	m_title = str;
+	break;
+      }
+    case 205:
+      {
+	/*
+	** $a - Edition Statement
+	** $b - Issue Statement
+	** $d - Parallel Edition Statement
+	** $f - Statement of Responsibility Relating to Edition
+	** $g - Subsequent Statement of Responsibility
+	*/
+
+	QString str(subfieldText(subfields, "a"));
+
+	if(str.indexOf(" ") > -1)
+	  str = str.mid(0, str.indexOf(" ")).trimmed();
+
+	str = str.remove(".").remove("d").remove("h").remove("n").
+	  remove("r").remove("s").remove("t").trimmed();
+	m_edition = str;
+	break;
+      }
+    case 210:
+      {
+	/*
+	** $a - Place of Publication, Distribution, etc.
+	** $b - Address of Publisher, Distributor, etc.
+	** $c - Name of Publisher, Distributor, etc.
+	** $d - Date of Publication, Distribution, etc.
+	** $e - Place of Manufacture
+	** $f - Address of Manufacturer
+	** $g - Name of Manufacturer
+	** $h - Date of Manufacture
+	*/
+
+	parsePublication(subfields, 'a', 'c', 'd');
+	break;
+      }
+    case 215:
+      {
+	/*
+	** $a - Specific Material Designation and Extent of Item
+	** $c - Other Physical Details
+	** $d - Dimensions
+	** $e - Accompanying Material
+	*/
+
+	m_description = subfieldText(subfields, "acde");
+	break;
+      }
+    case 606:
+      {
+	/*
+	** $a - Entry Element
+	** $j - Form Subdivision
+	** $x - Topical Subdivision
+	** $y - Geographical Subdivision
+	** $z - Chronological Subdivision
+	** $2 - System Code
+	** $3 - Authority Record Number
+	*/
+
+	appendCategory(subfieldText(subfields, "a"));
+	break;
+      }
+    default:
+      break;
+    }
+}
 
-	  QStringList subfields;
+void biblioteq_marc::parseMagazineSRUMarc21(const int tag,
+					    QXmlStreamReader &reader)
+{
+  /*
+  ** Serials share the descriptive fields of books.
+  */
 
-	  subfields << "$c"
-		    << "$f"
-		    << "$g"
-		    << "$h"
-		    << "$k"
-		    << "$n"
-		    << "$p"
-		    << "$s"
-		    << "$6"
-		    << "$8";
+  switch(tag)
+    {
+    case 22:
+      {
+	/*
+	** $a - International Standard Serial Number (NR)
+	** $l - ISSN-L (NR)
+	** $m - Canceled ISSN-L (R)
+	** $y - Incorrect ISSN (R)
+	** $z - Canceled ISSN (R)
+	** $2 - Source (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str("");
+
+	while(reader.readNextStartElement())
+	  if(isElement(reader, "subfield"))
+	    {
+	      if(isSubfield(reader, 'a'))
+		{
+		  str.append(reader.readElementText());
+		  break;
+		}
+	    }
+	  else
+	    break;
 
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+	m_issn = str.trimmed();
+	break;
+      }
+    default:
+      parseBookSRUMarc21(tag, reader);
+      break;
+    }
+}
 
-	  if(str.lastIndexOf('/') > -1)
-	    str = str.mid(0, str.lastIndexOf('/')).trimmed();
+void biblioteq_marc::parseMagazineZ3950Marc21
+(const int tag,
+ const QString &indicators,
+ const QVector<subfield> &subfields)
+{
+  /*
+  ** Serials share the descriptive fields of books.
+  */
 
-	  m_title = str;
-	}
-      else if(str.startsWith("250 "))
-	{
-	  str = str.mid(4);
+  switch(tag)
+    {
+    case 22:
+      {
+	/*
+	** $a - International Standard Serial Number (NR)
+	** $l - ISSN-L (NR)
+	** $m - Canceled ISSN-L (R)
+	** $y - Incorrect ISSN (R)
+	** $z - Canceled ISSN (R)
+	** $2 - Source (NR)
+	** $6 - Linkage (NR)
+	** $8 - Field link and sequence number (R)
+	*/
+
+	QString str(subfieldText(subfields, "a"));
+
+	if(!str.isEmpty())
+	  m_issn = str;
+
+	break;
+      }
+    default:
+      parseBookZ3950Marc21(tag, indicators, subfields);
+      break;
+    }
+}
 
-	  /*
-	  ** $a - Edition statement (NR)
-	  ** $b - Remainder of edition statement (NR)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
+void biblioteq_marc::parseMagazineZ3950Unimarc
+(const int tag,
+ const QString &indicators,
+ const QVector<subfield> &subfields)
+{
+  switch(tag)
+    {
+    case 200:
+      {
+	/*
+	** $a - Title Proper
+	** $b - General Material Designation
+	** $c - Title Proper by Another Author
+	** $d - Parallel Title Proper
+	** $e - Other Title Information
+	** $f - First Statement of Responsibility
+	** $g - Subsequent Statement of Responsibility
+	** $h - Number of a Part
+	** $i - Name of a Part
+	** $v - Volume Designation
+	** $z - Language of Parallel Title Proper
+	** $5 - Institution to Which Field Applies
+	*/
+
+	QString str(subfieldText(subfields, "a"));
+
+	if(str.lastIndexOf('/') > -1)
+	  str = str.mid(0, str.lastIndexOf('/')).trimmed();
+
+	m_title = str;
+	break;
+      }
+    case 210:
+    case 215:
+    case 606:
+      {
+	/*
+	** Serials share the publication, description and subject
+	** fields of books.
+	*/
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+	parseBookZ3950Unimarc(tag, indicators, subfields);
+	break;
+      }
+    default:
+      break;
+    }
+}
 
-	  QStringList subfields;
+void biblioteq_marc::parseSRU(void)
+{
+  clear();
 
-	  subfields << "$b"
-		    << "$6"
-		    << "$8";
+  sruHandler handler = s_handlers[m_itemType][m_recordSyntax].m_sru;
 
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+  if(!handler)
+    return;
 
-	  if(str.indexOf(" ") > -1)
-	    str = str.mid(0, str.indexOf(" ")).trimmed();
+  QXmlStreamReader reader(m_data);
 
-	  str = str.remove("d").remove("h").remove("n").
-	    remove("r").remove("s").remove("t").trimmed();
-	  m_edition = str;
-	}
-      else if(str.startsWith("260 ") ||
-	      str.startsWith("264 "))
+  while(!reader.atEnd())
+    if(reader.readNextStartElement())
+      if(isElement(reader, "datafield"))
 	{
-	  str = str.mid(4);
-
-	  /*
-	  ** $a - Place of publication, distribution, etc. (R)
-	  ** $b - Name of publisher, distributor, etc. (R)
-	  ** $c - Date of publication, distribution, etc. (R)
-	  ** $e - Place of manufacture (R) (260)
-	  ** $f - Manufacturer (R) (260)
-	  ** $g - Date of manufacture (R) (260)
-	  ** $3 - Materials specified (NR)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
+	  int tag = fieldTag(reader.attributes().value("tag"));
 
-	  QString tmpstr = "";
-
-	  if(str.indexOf("$a") > -1)
-	    tmpstr = str.mid(str.indexOf("$a") + 2).trimmed();
-	  else
-	    tmpstr = str;
-
-	  QStringList subfields;
-
-	  if(list[i].startsWith("260 "))
-	    subfields << "$b"
-		      << "$c"
-		      << "$e"
-		      << "$f"
-		      << "$g"
-		      << "$3"
-		      << "$6"
-		      << "$8";
-	  else
-	    subfields << "$b"
-		      << "$c"
-		      << "$3"
-		      << "$6"
-		      << "$8";
-
-	  while(!subfields.isEmpty())
-	    if(tmpstr.contains(subfields.first()))
-	      tmpstr = tmpstr.mid
-		(0, tmpstr.indexOf(subfields.takeFirst())).
-		trimmed();
-	    else
-	      subfields.takeFirst();
-
-	  QStringList tmplist(tmpstr.split("$a"));
-
-	  for(int j = 0; j < tmplist.size(); j++)
-	    {
-	      tmpstr = tmplist.at(j).trimmed();
-
-	      if(tmpstr.lastIndexOf(" ") > -1)
-		tmpstr = tmpstr.mid(0, tmpstr.lastIndexOf(" ")).
-		  trimmed();
-
-	      if(tmpstr.isEmpty())
-		continue;
+	  if(tag >= 0)
+	    (this->*handler)(tag, reader);
+	}
+}
 
-	      if(!tmpstr[0].isLetterOrNumber())
-		tmpstr = tmpstr.mid(1).trimmed();
+void biblioteq_marc::parseZ3950(void)
+{
+  clear();
 
-	      if(tmpstr.isEmpty())
-		continue;
+  z3950Handler handler = s_handlers[m_itemType][m_recordSyntax].m_z3950;
 
-	      if(!tmpstr[tmpstr.length() - 1].isLetter())
-		tmpstr = tmpstr.remove(tmpstr.length() - 1, 1).
-		  trimmed();
+  if(!handler)
+    return;
 
-	      if(m_place.isEmpty())
-		m_place = tmpstr;
-	      else
-		m_place = m_place + "\n" + tmpstr;
-	    }
+  /*
+  ** The record is scanned in place. Only fields with
+  ** numeric tags are split into subfields.
+  */
 
-	  if(str.indexOf("$c") > -1 &&
-	     str.mid(str.indexOf("$c") + 2, 4).toLower().
-	     contains("c"))
-	    m_publicationDate = QDate::fromString
-	      ("01/01/" +
-	       str.mid(str.indexOf("$c") + 4, 4),
-	       "MM/dd/yyyy");
-	  else if(str.indexOf("$c") > -1)
-	    m_publicationDate = QDate::fromString
-	      ("01/01/" +
-	       str.mid(str.indexOf("$c") + 3, 4),
-	       "MM/dd/yyyy");
-
-	  if(str.contains("$b"))
-	    str = str.mid(str.indexOf("$b") + 2).trimmed();
-
-	  if(str.contains("$a"))
-	    {
-	      str = str.mid(0, str.indexOf("$a")).trimmed();
+  int start = 0;
 
-	      if(str.lastIndexOf(" ") > -1)
-		str = str.mid(0, str.lastIndexOf(" ")).trimmed();
-	    }
-	  else if(str.indexOf("$c") > -1)
-	    str = str.mid(0, str.indexOf("$c")).trimmed();
+  while(start < m_data.length())
+    {
+      int end = m_data.indexOf(QLatin1Char('\n'), start);
 
-	  if(str.contains("$b "))
-	    str.remove("$b ");
-	  else if(str.contains("$b"))
-	    str.remove("$b");
+      if(end == -1)
+	end = m_data.length();
 
-	  if(str.endsWith(","))
-	    str = str.mid(0, str.length() - 1).trimmed();
+      int tag = lineTag(m_data, start, end);
 
-	  m_publisher = str;
-	}
-      else if(str.startsWith("300 "))
+      if(tag >= 0)
 	{
-	  str = str.mid(4);
-
-	  /*
-	  ** $a - Extent (R)
-	  ** $b - Other physical details (NR)
-	  ** $c - Dimensions (R)
-	  ** $e - Accompanying material (NR)
-	  ** $f - Type of unit (R)
-	  ** $g - Size of unit (R)
-	  ** $3 - Materials specified (NR)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
+	  QString indicators("");
+	  QVector<subfield> subfields
+	    (textSubfields(m_data.mid(start, end - start), indicators));
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
-
-	  str = str.remove(" $b").trimmed();
-	  str = str.remove(" $c").trimmed();
-	  str = str.remove(" $e").trimmed();
-	  str = str.remove(" $f").trimmed();
-	  str = str.remove(" $g").trimmed();
-	  str = str.remove(" $3").trimmed();
-	  str = str.remove(" $6").trimmed();
-	  str = str.remove(" $8").trimmed();
-	  m_description = str;
+	  (this->*handler)(tag, indicators, subfields);
 	}
-      else if(str.startsWith("650 "))
-	{
-	  str = str.mid(4);
-
-	  /*
-	  ** $a - Topical term or geographic name entry
-	  **      element (NR)
-	  ** $b - Topical term following geographic name entry
-	  **      element (NR)
-	  ** $c - Location of event (NR)
-	  ** $d - Active dates (NR)
-	  ** $e - Relator term (R)
-	  ** $4 - Relator code (R)
-	  ** $v - Form subdivision (R)
-	  ** $x - General subdivision (R)
-	  ** $y - Chronological subdivision (R)
-	  ** $z - Geographic subdivision (R)
-	  ** $0 - Authority record control number (R)
-	  ** $2 - Source of heading or term (NR)
-	  ** $3 - Materials specified (NR)
-	  ** $6 - Linkage (NR)
-	  ** $8 - Field link and sequence number (R)
-	  */
-
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
-
-	  QStringList subfields;
-
-	  subfields << "$b"
-		    << "$c"
-		    << "$d"
-		    << "$e"
-		    << "$4"
-		    << "$v"
-		    << "$x"
-		    << "$y"
-		    << "$z"
-		    << "$0"
-		    << "$2"
-		    << "$3"
-		    << "$6"
-		    << "$8";
-
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
 
-	  if(!str.isEmpty())
-	    {
-	      if(!str[str.length() - 1].isPunct())
-		str += ".";
-
-	      if(!m_category.contains(str))
-		{
-		  if(!m_category.isEmpty())
-		    m_category = m_category + "\n" + str;
-		  else
-		    m_category = str;
-		}
-	    }
-	}
+      start = end + 1;
     }
 }
 
-void biblioteq_marc::parseBookZ3950Unimarc(void)
+QString biblioteq_marc::subfieldText(const QVector<subfield> &subfields,
+				     const char *codes)
 {
-  clear();
+  /*
+  ** Returns the subfields whose codes are listed, in record order and
+  ** separated by spaces.
+  */
 
-  QStringList list(m_data.split("\n"));
+  QString str("");
 
-  for(int i = 0; i < list.size(); i++)
-    {
-      QString str = list[i];
-
-      if(str.startsWith("010 "))
+  for(int i = 0; i < subfields.size(); i++)
+    for(const char *code = codes; *code; code++)
+      if(subfields.at(i).m_code == *code)
 	{
-	  str = str.mid(4);
-
-	  /*
-	  ** $a - Number (ISMN)
-	  ** $b - Qualification
-	  ** $d - Terms of Availability and/or Price
-	  ** $z - Erroneous ISMN
-	  ** $6 - Interfield Linking Data
-	  */
-
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
-
-	  if(str.toLower().contains("hardcover"))
-	    m_binding = QObject::tr("hardcover");
-	  else if(str.toLower().contains("pbk"))
-	    m_binding = QObject::tr("paperback");
-	  else
-	    m_binding = QObject::tr("UNKNOWN");
-
-	  str = str.remove("#").remove("M-").remove("-");
-
-	  if(str.indexOf("$b") > -1)
-	    str = str.mid(0, str.indexOf("$b"));
-	  else if(str.indexOf("$d") > -1)
-	    str = str.mid(0, str.indexOf("$d"));
-	  else if(str.indexOf("$z") > -1)
-	    str = str.mid(0, str.indexOf("$z"));
-
-	  str = str.trimmed();
+	  if(!str.isEmpty())
+	    str.append(" ");
 
-	  if(str.length() == 10)
-	    m_isbn10 = str;
-	  else if(str.length() == 13)
-	    m_isbn13 = str;
+	  str.append(subfields.at(i).m_data);
+	  break;
 	}
-      else if(str.startsWith("200 "))
-	{
-	  str = str.mid(4);
 
-	  /*
-	  ** $a - Title Proper
-	  ** $b - General Material Designation
-	  ** $c - Title Proper by Another Author
-	  ** $d - Parallel Title Proper
-	  ** $e - Other Title Information
-	  ** $f - First Statement of Responsibility
-	  ** $g - Subsequent Statement of Responsibility
-	  ** $h - Number of a Part
-	  ** $i - Name of a Part
-	  ** $v - Volume Designation
-	  ** $z - Language of Parallel Title Proper
-	  ** $5 - Institution to Which Field Applies
-	  */
+  return str.trimmed();
+}
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+QVector<biblioteq_marc::subfield> biblioteq_marc::iso2709Subfields
+(const iso2709Field &field,
+ const int indicators,
+ const int identifier,
+ QString &indicatorText)
+{
+  /*
+  ** Subfields are split at their delimiters on the record's bytes.
+  ** A control field is a single subfield without a code.
+  */
 
-	  str = str.remove(" $b").trimmed();
+  QVector<subfield> subfields;
+  subfield value;
 
-	  QString author(str);
+  indicatorText.clear();
 
-	  while(author.indexOf("$f") > -1)
-	    {
-	      author = author.mid(author.indexOf("$f") + 2);
+  if(field.m_tag[0] == '0' && field.m_tag[1] == '0')
+    {
+      value.m_code = 0;
+      value.m_data = QString::fromUtf8(field.m_data, field.m_length);
+      subfields.append(value);
+      return subfields;
+    }
 
-	      if(author.indexOf("$") > -1)
-		author = author.mid(0, author.indexOf("$")).trimmed();
+  int i = qBound(0, indicators, field.m_length);
 
-	      if(!m_author.isEmpty())
-		m_author = m_author + "\n" + author;
-	      else
-		m_author = author;
-	    }
+  indicatorText = QString::fromLatin1(field.m_data, i);
 
-	  QStringList subfields;
-
-	  subfields << "$c"
-		    << "$d"
-		    << "$e"
-		    << "$f"
-		    << "$g"
-		    << "$h"
-		    << "$i"
-		    << "$v"
-		    << "$z"
-		    << "$5";
-
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+  while(i < field.m_length)
+    {
+      int end = i + 1;
 
-	  if(str.lastIndexOf('/') > -1)
-	    str = str.mid(0, str.lastIndexOf('/')).trimmed();
+      while(end < field.m_length && field.m_data[end] != SUBFIELD_DELIMITER)
+	end += 1;
 
-	  m_title = str;
-	}
-      else if(str.startsWith("205 "))
+      if(field.m_data[i] == SUBFIELD_DELIMITER && end - i > 1)
 	{
-	  str = str.mid(4);
+	  int code = qBound(1, identifier - 1, end - i - 1);
 
-	  /*
-	  ** $a - Edition Statement
-	  ** $b - Issue Statement
-	  ** $d - Parallel Edition Statement
-	  ** $f - Statement of Responsibility Relating to Edition
-	  ** $g - Subsequent Statement of Responsibility
-	  */
+	  value.m_code = field.m_data[i + 1];
+	  value.m_data = QString::fromUtf8
+	    (field.m_data + i + 1 + code, end - i - 1 - code).trimmed();
+	  subfields.append(value);
+	}
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+      i = end;
+    }
 
-	  QStringList subfields;
+  return subfields;
+}
 
-	  subfields << "$b"
-		    << "$d"
-		    << "$f"
-		    << "$g";
+QVector<biblioteq_marc::subfield> biblioteq_marc::textSubfields
+(const QString &line, QString &indicators)
+{
+  /*
+  ** Rendered fields introduce each subfield with " $", the code and
+  ** a space, see iso2709Line().
+  */
 
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+  QVector<subfield> subfields;
+  subfield value;
 
-	  if(str.indexOf(" ") > -1)
-	    str = str.mid(0, str.indexOf(" ")).trimmed();
+  indicators.clear();
 
-	  str = str.remove(".").remove("d").remove("h").remove("n").
-	    remove("r").remove("s").remove("t").trimmed();
-	  m_edition = str;
-	}
-      else if(str.startsWith("210 "))
-	{
-	  str = str.mid(4);
+  if(line.length() < 4)
+    return subfields;
 
-	  /*
-	  ** $a - Place of Publication, Distribution, etc.
-	  ** $b - Address of Publisher, Distributor, etc.
-	  ** $c - Name of Publisher, Distributor, etc.
-	  ** $d - Date of Publication, Distribution, etc.
-	  ** $e - Place of Manufacture
-	  ** $f - Address of Manufacturer
-	  ** $g - Name of Manufacturer
-	  ** $h - Date of Manufacture
-	  */
+  if(line.startsWith("00"))
+    {
+      value.m_code = 0;
+      value.m_data = line.mid(4);
+      subfields.append(value);
+      return subfields;
+    }
 
-	  QString tmpstr = "";
+  int start = line.indexOf(" $", 3);
 
-	  if(str.indexOf("$a") > -1)
-	    tmpstr = str.mid(str.indexOf("$a") + 2).trimmed();
-	  else
-	    tmpstr = str;
-
-	  QStringList subfields;
-
-	  subfields << "$b"
-		    << "$c"
-		    << "$e"
-		    << "$f"
-		    << "$g"
-		    << "$h";
-
-	  while(!subfields.isEmpty())
-	    if(tmpstr.contains(subfields.first()))
-	      tmpstr = tmpstr.mid
-		(0, tmpstr.indexOf(subfields.takeFirst())).
-		trimmed();
-	    else
-	      subfields.takeFirst();
+  indicators = line.mid(4, start == -1 ? -1 : qMax(0, start - 4));
 
-	  QStringList tmplist(tmpstr.split("$a"));
+  while(start > -1)
+    {
+      int end = line.indexOf(" $", start + 2);
 
-	  for(int j = 0; j < tmplist.size(); j++)
-	    {
-	      tmpstr = tmplist.at(j).trimmed();
+      if(start + 2 < line.length())
+	{
+	  value.m_code = line.at(start + 2).toLatin1();
+	  value.m_data = line.mid
+	    (start + 3, (end == -1 ? line.length() : end) - start - 3).
+	    trimmed();
+	  subfields.append(value);
+	}
 
-	      if(tmpstr.lastIndexOf(" ") > -1)
-		tmpstr = tmpstr.mid(0, tmpstr.lastIndexOf(" ")).
-		  trimmed();
+      start = end;
+    }
 
-	      if(tmpstr.isEmpty())
-		continue;
+  return subfields;
+}
 
-	      if(!tmpstr[0].isLetterOrNumber())
-		tmpstr = tmpstr.mid(1).trimmed();
+void biblioteq_marc::appendCategory(QString str)
+{
+  if(str.isEmpty())
+    return;
 
-	      if(tmpstr.isEmpty())
-		continue;
+  if(!str[str.length() - 1].isPunct())
+    str += ".";
 
-	      if(!tmpstr[tmpstr.length() - 1].isLetter())
-		tmpstr = tmpstr.remove(tmpstr.length() - 1, 1).
-		  trimmed();
+  if(!m_category.contains(str))
+    {
+      if(!m_category.isEmpty())
+	m_category = m_category + "\n" + str;
+      else
+	m_category = str;
+    }
+}
 
-	      if(m_place.isEmpty())
-		m_place = tmpstr;
-	      else
-		m_place = m_place + "\n" + tmpstr;
-	    }
+void biblioteq_marc::parsePublication(const QVector<subfield> &subfields,
+				      const char placeCode,
+				      const char publisherCode,
+				      const char dateCode)
+{
+  /*
+  ** MARC 21 260 and 264 and UNIMARC 210 record places, publishers and
+  ** dates with different subfield codes.
+  */
 
-	  if(str.indexOf("$d") > -1 &&
-	     str.mid(str.indexOf("$d") + 2, 4).toLower().
-	     contains("c"))
-	    m_publicationDate = QDate::fromString
-	      ("01/01/" +
-	       str.mid(str.indexOf("$d") + 4, 4),
-	       "MM/dd/yyyy");
-	  else if(str.indexOf("$d") > -1)
-	    m_publicationDate = QDate::fromString
-	      ("01/01/" +
-	       str.mid(str.indexOf("$d") + 3, 4),
-	       "MM/dd/yyyy");
-
-	  if(str.contains("$c"))
-	    str = str.mid(str.indexOf("$c") + 2).trimmed();
-
-	  if(str.indexOf("$") > -1)
-	    str = str.mid(0, str.indexOf("$")).trimmed();
+  bool hasPublisher = false;
 
-	  if(str.endsWith(","))
-	    str = str.mid(0, str.length() - 1).trimmed();
+  for(int i = 0; i < subfields.size(); i++)
+    {
+      QString str(subfields.at(i).m_data);
 
-	  m_publisher = str;
-	}
-      else if(str.startsWith("215 "))
+      if(subfields.at(i).m_code == placeCode)
 	{
-	  str = str.mid(4);
-
 	  /*
-	  ** $a - Specific Material Designation and Extent of Item
-	  ** $c - Other Physical Details
-	  ** $d - Dimensions
-	  ** $e - Accompanying Material
+	  ** Remove ISBD punctuation, for example, " :" or "[".
 	  */
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
-
-	  str = str.remove(" $c").trimmed();
-	  str = str.remove(" $d").trimmed();
-	  str = str.remove(" $e").trimmed();
-	  m_description = str;
-	}
-      else if(str.startsWith("606 "))
-	{
-	  str = str.mid(4);
-
-	  /*
-	  ** $a - Entry Element
-	  ** $j - Form Subdivision
-	  ** $x - Topical Subdivision
-	  ** $y - Geographical Subdivision
-	  ** $z - Chronological Subdivision
-	  ** $2 - System Code
-	  ** $3 - Authority Record Number
-	  */
+	  while(!str.isEmpty() && !str[0].isLetterOrNumber())
+	    str = str.mid(1).trimmed();
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+	  while(!str.isEmpty() && !str[str.length() - 1].isLetter())
+	    str = str.remove(str.length() - 1, 1).trimmed();
 
-	  QStringList subfields;
+	  if(str.isEmpty())
+	    continue;
 
-	  subfields << "$j"
-		    << "$x"
-		    << "$y"
-		    << "$z"
-		    << "$2"
-		    << "$3";
+	  if(m_place.isEmpty())
+	    m_place = str;
+	  else
+	    m_place = m_place + "\n" + str;
+	}
+      else if(subfields.at(i).m_code == publisherCode && !hasPublisher)
+	{
+	  hasPublisher = true;
 
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+	  if(str.endsWith(","))
+	    str = str.mid(0, str.length() - 1).trimmed();
 
-	  if(!str.isEmpty())
-	    {
-	      if(!str[str.length() - 1].isPunct())
-		str += ".";
+	  m_publisher = str;
+	}
+      else if(subfields.at(i).m_code == dateCode &&
+	      !m_publicationDate.isValid())
+	{
+	  for(int j = str.length() - 1; j >= 0; j--)
+	    if(!str.at(j).isNumber())
+	      str.remove(j, 1);
 
-	      if(!m_category.contains(str))
-		{
-		  if(!m_category.isEmpty())
-		    m_category = m_category + "\n" + str;
-		  else
-		    m_category = str;
-		}
-	    }
+	  m_publicationDate = QDate::fromString
+	    ("01/01/" + str.mid(0, 4), "MM/dd/yyyy");
 	}
     }
 }
 
-void biblioteq_marc::parseMagazineZ3950Marc21(void)
+QString biblioteq_marc::iso2709Line(const iso2709Field &field,
+				    const int indicators,
+				    const int identifier)
 {
-}
+  /*
+  ** Fields are rendered as YAZ renders them, so that the
+  ** field handlers and the MARC tags widgets see familiar text.
+  */
 
-void biblioteq_marc::parseMagazineZ3950Unimarc(void)
-{
-  clear();
+  QByteArray line(field.m_tag, 3);
 
-  QStringList list(m_data.split("\n"));
+  line.append(' ');
 
-  for(int i = 0; i < list.size(); i++)
+  if(field.m_tag[0] == '0' && field.m_tag[1] == '0')
     {
-      QString str = list[i];
+      line.append(field.m_data, field.m_length);
+      return QString::fromUtf8(line.constData(), line.length());
+    }
 
-      if(str.startsWith("200 "))
-	{
-	  str = str.mid(4);
+  int i = qMin(indicators, field.m_length);
 
-	  /*
-	  ** $a - Title Proper
-	  ** $b - General Material Designation
-	  ** $c - Title Proper by Another Author
-	  ** $d - Parallel Title Proper
-	  ** $e - Other Title Information
-	  ** $f - First Statement of Responsibility
-	  ** $g - Subsequent Statement of Responsibility
-	  ** $h - Number of a Part
-	  ** $i - Name of a Part
-	  ** $v - Volume Designation
-	  ** $z - Language of Parallel Title Proper
-	  ** $5 - Institution to Which Field Applies
-	  */
+  line.append(field.m_data, i);
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
-
-	  QStringList subfields;
-
-	  subfields << "$c"
-		    << "$d"
-		    << "$e"
-		    << "$f"
-		    << "$g"
-		    << "$h"
-		    << "$i"
-		    << "$v"
-		    << "$z"
-		    << "$5";
-
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+  while(i < field.m_length)
+    {
+      int end = i + 1;
 
-	  if(str.lastIndexOf('/') > -1)
-	    str = str.mid(0, str.lastIndexOf('/')).trimmed();
+      while(end < field.m_length && field.m_data[end] != SUBFIELD_DELIMITER)
+	end += 1;
 
-	  m_title = str;
-	}
-      else if(str.startsWith("210 "))
+      if(field.m_data[i] == SUBFIELD_DELIMITER)
 	{
-	  str = str.mid(4);
-
-	  /*
-	  ** $a - Place of Publication, Distribution, etc.
-	  ** $b - Address of Publisher, Distributor, etc.
-	  ** $c - Name of Publisher, Distributor, etc.
-	  ** $d - Date of Publication, Distribution, etc.
-	  ** $e - Place of Manufacture
-	  ** $f - Address of Manufacturer
-	  ** $g - Name of Manufacturer
-	  ** $h - Date of Manufacture
-	  */
+	  int code = qBound(0, identifier - 1, end - i - 1);
 
-	  QString tmpstr = "";
-
-	  if(str.indexOf("$a") > -1)
-	    tmpstr = str.mid(str.indexOf("$a") + 2).trimmed();
-	  else
-	    tmpstr = str;
-
-	  QStringList subfields;
-
-	  subfields << "$b"
-		    << "$c"
-		    << "$e"
-		    << "$f"
-		    << "$g"
-		    << "$h";
-
-	  while(!subfields.isEmpty())
-	    if(tmpstr.contains(subfields.first()))
-	      tmpstr = tmpstr.mid
-		(0, tmpstr.indexOf(subfields.takeFirst())).
-		trimmed();
-	    else
-	      subfields.takeFirst();
-
-	  QStringList tmplist(tmpstr.split("$a"));
-
-	  for(int j = 0; j < tmplist.size(); j++)
-	    {
-	      tmpstr = tmplist.at(j).trimmed();
-
-	      if(tmpstr.lastIndexOf(" ") > -1)
-		tmpstr = tmpstr.mid(0, tmpstr.lastIndexOf(" ")).
-		  trimmed();
-
-	      if(tmpstr.isEmpty())
-		continue;
-
-	      if(!tmpstr[0].isLetterOrNumber())
-		tmpstr = tmpstr.mid(1).trimmed();
+	  line.append(" $");
+	  line.append(field.m_data + i + 1, code);
+	  line.append(' ');
+	  line.append(field.m_data + i + 1 + code, end - i - 1 - code);
+	}
+      else
+	line.append(field.m_data + i, end - i);
 
-	      if(tmpstr.isEmpty())
-		continue;
+      i = end;
+    }
 
-	      if(!tmpstr[tmpstr.length() - 1].isLetter())
-		tmpstr = tmpstr.remove(tmpstr.length() - 1, 1).
-		  trimmed();
+  return QString::fromUtf8(line.constData(), line.length());
+}
 
-	      if(m_place.isEmpty())
-		m_place = tmpstr;
-	      else
-		m_place = m_place + "\n" + tmpstr;
-	    }
+QString biblioteq_marc::recordText(const QByteArray &record)
+{
+  if(!isIso2709(record))
+    return QString::fromUtf8(record.constData(), record.length());
 
-	  if(str.indexOf("$d") > -1 &&
-	     str.mid(str.indexOf("$d") + 2, 4).toLower().
-	     contains("c"))
-	    m_publicationDate = QDate::fromString
-	      ("01/01/" +
-	       str.mid(str.indexOf("$d") + 4, 4),
-	       "MM/dd/yyyy");
-	  else if(str.indexOf("$d") > -1)
-	    m_publicationDate = QDate::fromString
-	      ("01/01/" +
-	       str.mid(str.indexOf("$d") + 3, 4),
-	       "MM/dd/yyyy");
-
-	  if(str.contains("$c"))
-	    str = str.mid(str.indexOf("$c") + 2).trimmed();
-
-	  if(str.indexOf("$") > -1)
-	    str = str.mid(0, str.indexOf("$")).trimmed();
+  QString text(QString::fromLatin1(record.constData(), 24));
+  QVector<iso2709Field> fields(iso2709Fields(record));
+  int identifier = numberAt(record.constData() + 11, 1);
+  int indicators = numberAt(record.constData() + 10, 1);
 
-	  if(str.endsWith(","))
-	    str = str.mid(0, str.length() - 1).trimmed();
+  for(int i = 0; i < fields.size(); i++)
+    {
+      text.append("\n");
+      text.append(iso2709Line(fields.at(i), indicators, identifier));
+    }
 
-	  m_publisher = str;
-	}
-      else if(str.startsWith("215 "))
-	{
-	  str = str.mid(4);
+  return text;
+}
 
-	  /*
-	  ** $a - Specific Material Designation and Extent of Item
-	  ** $c - Other Physical Details
-	  ** $d - Dimensions
-	  ** $e - Accompanying Material
-	  */
+QVector<biblioteq_marc::iso2709Field> biblioteq_marc::iso2709Fields
+(const QByteArray &record)
+{
+  QVector<iso2709Field> fields;
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+  if(!isIso2709(record))
+    return fields;
 
-	  str = str.remove(" $c").trimmed();
-	  str = str.remove(" $d").trimmed();
-	  str = str.remove(" $e").trimmed();
-	  m_description = str;
-	}
-      else if(str.startsWith("606 "))
-	{
-	  str = str.mid(4);
+  const char *data = record.constData();
+  int base = numberAt(data + 12, 5);
+  int length = numberAt(data, 5);
 
-	  /*
-	  ** $a - Entry Element
-	  ** $j - Form Subdivision
-	  ** $x - Topical Subdivision
-	  ** $y - Geographical Subdivision
-	  ** $z - Chronological Subdivision
-	  ** $2 - System Code
-	  ** $3 - Authority Record Number
-	  */
+  /*
+  ** Directory entries are twelve characters long: a tag, the
+  ** field's length and the field's offset from the base address.
+  */
 
-	  if(str.indexOf("$a") > -1)
-	    str = str.mid(str.indexOf("$a") + 2).trimmed();
+  for(int i = 24; i + 12 < base; i += 12)
+    {
+      int fieldLength = numberAt(data + i + 3, 4);
+      int start = numberAt(data + i + 7, 5);
 
-	  QStringList subfields;
+      if(fieldLength < 0 || start < 0 || base + start + fieldLength > length)
+	break;
 
-	  subfields << "$j"
-		    << "$x"
-		    << "$y"
-		    << "$z"
-		    << "$2"
-		    << "$3";
+      iso2709Field field;
 
-	  while(!subfields.isEmpty())
-	    if(str.contains(subfields.first()))
-	      str = str.mid
-		(0, str.indexOf(subfields.takeFirst())).trimmed();
-	    else
-	      subfields.takeFirst();
+      field.m_data = data + base + start;
+      field.m_length = fieldLength;
+      field.m_tag = data + i;
 
-	  if(!str.isEmpty())
-	    {
-	      if(!str[str.length() - 1].isPunct())
-		str += ".";
+      while(field.m_length > 0 &&
+	    (field.m_data[field.m_length - 1] == FIELD_TERMINATOR ||
+	     field.m_data[field.m_length - 1] == RECORD_TERMINATOR))
+	field.m_length -= 1;
 
-	      if(!m_category.contains(str))
-		{
-		  if(!m_category.isEmpty())
-		    m_category = m_category + "\n" + str;
-		  else
-		    m_category = str;
-		}
-	    }
-	}
+      fields.append(field);
     }
-}
 
-void biblioteq_marc::parseSRU(void)
-{
-  if(m_itemType == BOOK)
-    {
-      if(m_recordSyntax == MARC21)
-	parseBookSRUMarc21();
-      else
-	parseBookSRUUnimarc();
-    }
+  return fields;
 }
 
-void biblioteq_marc::parseZ3950(void)
+bool biblioteq_marc::isIso2709(const QByteArray &record)
 {
-  if(m_itemType == BOOK)
-    {
-      if(m_recordSyntax == MARC21)
-	parseBookZ3950Marc21();
-      else
-	parseBookZ3950Unimarc();
-    }
-  else
-    {
-      if(m_recordSyntax == MARC21)
-	parseMagazineZ3950Marc21();
-      else
-	parseMagazineZ3950Unimarc();
-    }
+  if(record.length() < 25)
+    return false;
+
+  const char *data = record.constData();
+  int base = numberAt(data + 12, 5);
+  int length = numberAt(data, 5);
+
+  return base > 24 && length >= base && length <= record.length() &&
+    data[base - 1] == FIELD_TERMINATOR &&
+    numberAt(data + 10, 2) >= 0;
 }
 
 void biblioteq_marc::setData(const QString &data)
@@ -1538,3 +1465,44 @@ void biblioteq_marc::setData(const QString &data)
   else
     parseZ3950();
 }
+
+void biblioteq_marc::setRecord(const QByteArray &record)
+{
+  if(!isIso2709(record))
+    {
+      setData(QString::fromUtf8(record.constData(), record.length()));
+      return;
+    }
+
+  clear();
+  m_data.clear();
+
+  z3950Handler handler = s_handlers[m_itemType][m_recordSyntax].m_z3950;
+
+  if(!handler)
+    return;
+
+  QVector<iso2709Field> fields(iso2709Fields(record));
+  int identifier = numberAt(record.constData() + 11, 1);
+  int indicators = numberAt(record.constData() + 10, 1);
+
+  /*
+  ** The fields are handed to the handlers as subfields. They are not
+  ** rendered as text.
+  */
+
+  for(int i = 0; i < fields.size(); i++)
+    {
+      int tag = numberAt(fields.at(i).m_tag, 3);
+
+      if(tag >= 0)
+	{
+	  QString indicatorText("");
+	  QVector<subfield> subfields
+	    (iso2709Subfields(fields.at(i), indicators, identifier,
+			      indicatorText));
+
+	  (this->*handler)(tag, indicatorText, subfields);
+	}
+    }
+}
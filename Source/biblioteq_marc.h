@@ -1,5 +1,8 @@
+#include <QByteArray>
 #include <QDate>
 #include <QString>
+#include <QVector>
+#include <QXmlStreamReader>
 
 class biblioteq_marc
 {
@@ -78,6 +81,11 @@ class biblioteq_marc
     return m_isbn13;
   }
 
+  QString issn(void) const
+  {
+    return m_issn;
+  }
+
   QString lcnum(void) const
   {
     return m_lcnum;
@@ -98,10 +106,13 @@ class biblioteq_marc
     return m_title;
   }
 
+  static QString recordText(const QByteArray &record);
+  static bool isIso2709(const QByteArray &record);
   void initialize(const ITEM_TYPE itemType,
 		  const PROTOCOL protocol,
 		  const RECORD_SYNTAX recordSyntax);
   void setData(const QString &data);
+  void setRecord(const QByteArray &record);
 
  private:
   ITEM_TYPE m_itemType;
@@ -117,18 +128,82 @@ class biblioteq_marc
   QString m_edition;
   QString m_isbn10;
   QString m_isbn13;
+  QString m_issn;
   QString m_lcnum;
   QString m_place;
   QString m_publisher;
   QString m_title;
   RECORD_SYNTAX m_recordSyntax;
+  typedef void (biblioteq_marc::*sruHandler)
+    (const int tag, QXmlStreamReader &reader);
+
+  /*
+  ** A subfield of a variable field. A control field is a single
+  ** subfield whose code is zero.
+  */
+
+  struct subfield
+  {
+    QString m_data;
+    char m_code;
+  };
+
+  typedef void (biblioteq_marc::*z3950Handler)
+    (const int tag,
+     const QString &indicators,
+     const QVector<subfield> &subfields);
+
+  struct handlers
+  {
+    sruHandler m_sru;
+    z3950Handler m_z3950;
+  };
+
+  /*
+  ** A view of an ISO 2709 field. The data belongs to the record.
+  */
+
+  struct iso2709Field
+  {
+    const char *m_data;
+    const char *m_tag;
+    int m_length;
+  };
+
+  static const handlers s_handlers[2][2];
+  static QString iso2709Line(const iso2709Field &field,
+			     const int indicators,
+			     const int identifier);
+  static QString subfieldText(const QVector<subfield> &subfields,
+			      const char *codes);
+  static QVector<iso2709Field> iso2709Fields(const QByteArray &record);
+  static QVector<subfield> iso2709Subfields(const iso2709Field &field,
+					    const int indicators,
+					    const int identifier,
+					    QString &indicatorText);
+  static QVector<subfield> textSubfields(const QString &line,
+					 QString &indicators);
+  void appendCategory(QString str);
   void clear(void);
-  void parseBookSRUMarc21(void);
-  void parseBookSRUUnimarc(void);
-  void parseBookZ3950Marc21(void);
-  void parseBookZ3950Unimarc(void);
-  void parseMagazineZ3950Marc21(void);
-  void parseMagazineZ3950Unimarc(void);
+  void parseBookSRUMarc21(const int tag, QXmlStreamReader &reader);
+  void parseBookSRUUnimarc(const int tag, QXmlStreamReader &reader);
+  void parseBookZ3950Marc21(const int tag,
+			    const QString &indicators,
+			    const QVector<subfield> &subfields);
+  void parseBookZ3950Unimarc(const int tag,
+			     const QString &indicators,
+			     const QVector<subfield> &subfields);
+  void parseMagazineSRUMarc21(const int tag, QXmlStreamReader &reader);
+  void parseMagazineZ3950Marc21(const int tag,
+				const QString &indicators,
+				const QVector<subfield> &subfields);
+  void parseMagazineZ3950Unimarc(const int tag,
+				 const QString &indicators,
+				 const QVector<subfield> &subfields);
+  void parsePublication(const QVector<subfield> &subfields,
+			const char placeCode,
+			const char publisherCode,
+			const char dateCode);
   void parseSRU(void);
   void parseZ3950(void);
 };
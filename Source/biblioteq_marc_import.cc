@@ -0,0 +1,815 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QApplication>
+#include <QEventLoop>
+#include <QFile>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QProgressDialog>
+#include <QRunnable>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include <QTime>
+#include <QTimer>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq.h"
+#include "biblioteq_marc.h"
+#include "biblioteq_marc_import.h"
+#include "biblioteq_misc_functions.h"
+
+extern biblioteq *qmain;
+
+/*
+** Parses a single batch of records on one of the pool's threads.
+*/
+
+class biblioteq_marc_import_task: public QRunnable
+{
+ public:
+  biblioteq_marc_import_task(biblioteq_marc_import *importer,
+			     const QList<QByteArray> &records,
+			     const QString &itemType,
+			     const bool xml):QRunnable()
+  {
+    m_importer = importer;
+    m_itemType = itemType;
+    m_records = records;
+    m_xml = xml;
+    setAutoDelete(true);
+  }
+
+  void run(void)
+  {
+    QList<biblioteq_marc_import::item> items
+      (biblioteq_marc_import::parse(m_records, m_itemType, m_xml));
+
+    m_records.clear();
+    m_importer->deliver(items);
+  }
+
+ private:
+  QList<QByteArray> m_records;
+  QString m_itemType;
+  biblioteq_marc_import *m_importer;
+  bool m_xml;
+};
+
+/*
+** -- biblioteq_marc_import() --
+*/
+
+biblioteq_marc_import::biblioteq_marc_import(QWidget *parent):QObject(parent)
+{
+  m_imported = 0;
+  m_parent = parent;
+  m_recordsPerSecond = 0.0;
+  m_skipped = 0;
+
+  if((m_pool = new(std::nothrow) QThreadPool(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  m_pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+/*
+** -- ~biblioteq_marc_import() --
+*/
+
+biblioteq_marc_import::~biblioteq_marc_import()
+{
+  /*
+  ** Tasks refer to this object. They must complete before
+  ** it is destroyed.
+  */
+
+  m_pool->waitForDone();
+}
+
+/*
+** -- deliver() --
+*/
+
+void biblioteq_marc_import::deliver(const QList<item> &items)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_batches.append(items);
+  locker.unlock();
+  QMetaObject::invokeMethod(this, "slotBatchParsed", Qt::QueuedConnection);
+}
+
+/*
+** -- import() --
+*/
+
+bool biblioteq_marc_import::import(const QString &fileName,
+				   const QString &itemType,
+				   QString &errorstr)
+{
+  QFile file(fileName);
+
+  errorstr = "";
+  m_imported = 0;
+  m_recordsPerSecond = 0.0;
+  m_skipped = 0;
+
+  if(!file.open(QIODevice::ReadOnly))
+    {
+      errorstr = tr("Unable to open %1.").arg(fileName);
+      return false;
+    }
+
+  /*
+  ** ISO 2709 records begin with their lengths.
+  */
+
+  QByteArray leader(file.peek(5));
+  QXmlStreamReader reader;
+  bool xml = false;
+
+  for(int i = 0; i < 5; i++)
+    if(i >= leader.length() || leader.at(i) < '0' || leader.at(i) > '9')
+      {
+	xml = true;
+	break;
+      }
+
+  if(xml)
+    reader.setDevice(&file);
+
+  QEventLoop loop;
+  QProgressDialog progress(m_parent);
+  QTime time;
+  QTimer timer;
+  bool atEnd = false;
+  int maximum = qMax(1, static_cast<int> (file.size() / 1024));
+  int pending = 0;
+
+#ifdef Q_OS_MAC
+#if QT_VERSION < 0x050000
+  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
+#endif
+#endif
+  connect(&progress, SIGNAL(canceled(void)), &loop, SLOT(quit(void)));
+  connect(&timer, SIGNAL(timeout(void)), &loop, SLOT(quit(void)));
+  connect(this, SIGNAL(batchParsed(void)), &loop, SLOT(quit(void)));
+  progress.setModal(true);
+  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
+  progress.setLabelText(tr("Importing MARC records..."));
+  progress.setMaximum(maximum);
+  progress.setMinimum(0);
+  progress.show();
+  progress.update();
+  time.start();
+  timer.start(100);
+
+  while(!progress.wasCanceled())
+    {
+      /*
+      ** Keep the pool busy while limiting the number of
+      ** batches that are held in memory.
+      */
+
+      while(!atEnd && pending < 2 * m_pool->maxThreadCount())
+	{
+	  QList<QByteArray> records(nextBatch(file, xml ? &reader : 0));
+
+	  if(records.isEmpty())
+	    {
+	      atEnd = true;
+	      break;
+	    }
+
+	  biblioteq_marc_import_task *task = 0;
+
+	  if((task = new(std::nothrow)
+	      biblioteq_marc_import_task(this, records, itemType, xml)) == 0)
+	    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+	  m_pool->start(task);
+	  pending += 1;
+	}
+
+      if(xml && reader.hasError() &&
+	 reader.error() != QXmlStreamReader::PrematureEndOfDocumentError)
+	{
+	  errorstr = reader.errorString();
+	  break;
+	}
+
+      if(pending == 0)
+	break;
+
+      QList<item> items;
+
+      {
+	QMutexLocker locker(&m_mutex);
+
+	if(m_batches.isEmpty())
+	  {
+	    locker.unlock();
+	    loop.exec();
+	    continue;
+	  }
+
+	items = m_batches.takeFirst();
+      }
+
+      pending -= 1;
+
+      if(!insert(items, itemType, errorstr))
+	break;
+
+      if(time.elapsed() > 0)
+	m_recordsPerSecond = 1000.0 * m_imported / time.elapsed();
+
+      progress.setLabelText
+	(tr("Imported %1 record(s) (%2 per second)...").
+	 arg(m_imported).
+	 arg(static_cast<int> (m_recordsPerSecond)));
+      progress.setValue
+	(qMin(maximum, static_cast<int> (file.pos() / 1024)));
+      progress.repaint();
+      QApplication::processEvents();
+    }
+
+  bool canceled = progress.wasCanceled();
+
+  progress.close();
+
+  /*
+  ** Batches which are still being parsed are discarded.
+  */
+
+  m_pool->waitForDone();
+  m_batches.clear();
+  file.close();
+
+  if(time.elapsed() > 0)
+    m_recordsPerSecond = 1000.0 * m_imported / time.elapsed();
+
+  return errorstr.isEmpty() && !canceled;
+}
+
+/*
+** -- imported() --
+*/
+
+int biblioteq_marc_import::imported(void) const
+{
+  return m_imported;
+}
+
+/*
+** -- insert() --
+*/
+
+bool biblioteq_marc_import::insert(const QList<item> &items,
+				   const QString &itemType,
+				   QString &errorstr)
+{
+  if(items.isEmpty())
+    return true;
+
+  QSet<QString> identifiers;
+  QSqlDatabase db(qmain->getDB());
+  QSqlQuery query(db);
+  QString table(itemType.toLower());
+  bool book = itemType == "Book";
+  bool sqlite = db.driverName() == "QSQLITE";
+
+  query.setForwardOnly(true);
+
+  if(book)
+    {
+      /*
+      ** ISBNs are unique. Records which are already in the catalog,
+      ** or which repeat an earlier record of the batch, are skipped.
+      */
+
+      QStringList values;
+
+      for(int i = 0; i < items.size(); i++)
+	{
+	  if(!items.at(i).m_isbn10.isEmpty())
+	    values.append(items.at(i).m_isbn10);
+
+	  if(!items.at(i).m_isbn13.isEmpty())
+	    values.append(items.at(i).m_isbn13);
+	}
+
+      /*
+      ** SQLite limits the number of parameters of a statement.
+      */
+
+      for(int i = 0; i < values.size(); i += 200)
+	{
+	  QStringList chunk(values.mid(i, 200));
+	  QString placeholders("");
+
+	  for(int j = 0; j < chunk.size(); j++)
+	    placeholders.append(j == 0 ? "?" : ", ?");
+
+	  query.prepare(QString("SELECT id, isbn13 FROM book WHERE "
+				"id IN (%1) OR isbn13 IN (%1)").
+			arg(placeholders));
+
+	  for(int j = 0; j < chunk.size(); j++)
+	    query.addBindValue(chunk.at(j));
+
+	  for(int j = 0; j < chunk.size(); j++)
+	    query.addBindValue(chunk.at(j));
+
+	  if(!query.exec())
+	    {
+	      errorstr = query.lastError().text();
+	      return false;
+	    }
+
+	  while(query.next())
+	    {
+	      if(!query.value(0).isNull())
+		identifiers.insert(query.value(0).toString());
+
+	      if(!query.value(1).isNull())
+		identifiers.insert(query.value(1).toString());
+	    }
+	}
+    }
+  else
+    {
+      /*
+      ** An issue is identified by its ISSN, volume and number.
+      ** Imported issues have neither a volume nor a number, so
+      ** issues of the same ISSN which are already in the catalog,
+      ** or which repeat an earlier record of the batch, are skipped.
+      */
+
+      QStringList values;
+
+      for(int i = 0; i < items.size(); i++)
+	if(!items.at(i).m_issn.isEmpty())
+	  values.append(items.at(i).m_issn);
+
+      for(int i = 0; i < values.size(); i += 200)
+	{
+	  QStringList chunk(values.mid(i, 200));
+	  QString placeholders("");
+
+	  for(int j = 0; j < chunk.size(); j++)
+	    placeholders.append(j == 0 ? "?" : ", ?");
+
+	  query.prepare(QString("SELECT id FROM %1 WHERE "
+				"id IN (%2) AND issuevolume = 0 AND "
+				"issueno = 0").
+			arg(table).arg(placeholders));
+
+	  for(int j = 0; j < chunk.size(); j++)
+	    query.addBindValue(chunk.at(j));
+
+	  if(!query.exec())
+	    {
+	      errorstr = query.lastError().text();
+	      return false;
+	    }
+
+	  while(query.next())
+	    identifiers.insert(query.value(0).toString());
+	}
+    }
+
+  if(!db.transaction())
+    {
+      errorstr = db.lastError().text();
+      return false;
+    }
+
+  QSqlQuery copy(db);
+
+  if(book)
+    query.prepare
+      (QString("INSERT INTO book (id, title, "
+	       "edition, author, pdate, publisher, "
+	       "category, price, description, language, "
+	       "monetary_units, quantity, "
+	       "binding_type, location, "
+	       "isbn13, lccontrolnumber, callnumber, "
+	       "deweynumber, place, marc_tags%1) "
+	       "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+	       "?, ?, ?, ?, ?, ?, ?, ?, ?, ?%2)%3").
+       arg(sqlite ? ", myoid" : "").
+       arg(sqlite ? ", ?" : "").
+       arg(sqlite ? "" : " RETURNING myoid"));
+  else
+    query.prepare
+      (QString("INSERT INTO %1 (id, title, "
+	       "pdate, publisher, "
+	       "category, price, description, language, "
+	       "monetary_units, quantity, "
+	       "location, issuevolume, issueno, "
+	       "lccontrolnumber, callnumber, deweynumber, "
+	       "place, marc_tags, type%2) "
+	       "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+	       "?, ?, ?, ?, ?, ?, ?, ?, ?%3)%4").
+       arg(table).
+       arg(sqlite ? ", myoid" : "").
+       arg(sqlite ? ", ?" : "").
+       arg(sqlite ? "" : " RETURNING myoid"));
+
+  copy.prepare(QString("INSERT INTO %1_copy_info "
+		       "(item_oid, copy_number, copyid%2) "
+		       "VALUES (?, ?, ?%3)").
+	       arg(table).
+	       arg(sqlite ? ", myoid" : "").
+	       arg(sqlite ? ", ?" : ""));
+
+  int imported = 0;
+  int skipped = 0;
+  qint64 first = -1;
+
+  if(sqlite)
+    {
+      /*
+      ** Identifiers for the batch's items and their copies are
+      ** reserved at once.
+      */
+
+      first = biblioteq_misc_functions::getSqliteUniqueIds
+	(db, 2 * items.size(), errorstr);
+
+      if(!errorstr.isEmpty())
+	{
+	  db.rollback();
+	  return false;
+	}
+    }
+
+  for(int i = 0; i < items.size(); i++)
+    {
+      const item &it = items.at(i);
+
+      if(book)
+	{
+	  if((!it.m_isbn10.isEmpty() && identifiers.contains(it.m_isbn10)) ||
+	     (!it.m_isbn13.isEmpty() && identifiers.contains(it.m_isbn13)))
+	    {
+	      skipped += 1;
+	      continue;
+	    }
+
+	  if(!it.m_isbn10.isEmpty())
+	    identifiers.insert(it.m_isbn10);
+
+	  if(!it.m_isbn13.isEmpty())
+	    identifiers.insert(it.m_isbn13);
+	}
+      else if(!it.m_issn.isEmpty())
+	{
+	  if(identifiers.contains(it.m_issn))
+	    {
+	      skipped += 1;
+	      continue;
+	    }
+
+	  identifiers.insert(it.m_issn);
+	}
+
+      QString pdate(it.m_publicationDate.isValid() ?
+		    it.m_publicationDate.toString(Qt::ISODate) :
+		    QDate::currentDate().toString(Qt::ISODate));
+      int column = 0;
+
+      if(book && !it.m_isbn10.isEmpty())
+	query.bindValue(column++, it.m_isbn10);
+      else if(!book && !it.m_issn.isEmpty())
+	query.bindValue(column++, it.m_issn);
+      else
+	query.bindValue(column++, QVariant(QVariant::String));
+
+      query.bindValue(column++, it.m_title.isEmpty() ? "N/A" : it.m_title);
+
+      if(book)
+	{
+	  query.bindValue
+	    (column++, it.m_edition.isEmpty() ? "1" : it.m_edition);
+	  query.bindValue
+	    (column++, it.m_author.isEmpty() ? "N/A" : it.m_author);
+	}
+
+      query.bindValue(column++, pdate);
+      query.bindValue
+	(column++, it.m_publisher.isEmpty() ? "N/A" : it.m_publisher);
+      query.bindValue
+	(column++, it.m_category.isEmpty() ? "N/A" : it.m_category);
+      query.bindValue(column++, 0.0);
+      query.bindValue
+	(column++, it.m_description.isEmpty() ? "N/A" : it.m_description);
+      query.bindValue(column++, tr("UNKNOWN"));
+      query.bindValue(column++, tr("UNKNOWN"));
+      query.bindValue(column++, 1);
+
+      if(book)
+	{
+	  query.bindValue
+	    (column++, it.m_binding.isEmpty() ? tr("UNKNOWN") : it.m_binding);
+	  query.bindValue(column++, tr("UNKNOWN"));
+
+	  if(!it.m_isbn13.isEmpty())
+	    query.bindValue(column++, it.m_isbn13);
+	  else
+	    query.bindValue(column++, QVariant(QVariant::String));
+	}
+      else
+	{
+	  query.bindValue(column++, tr("UNKNOWN"));
+	  query.bindValue(column++, 0);
+	  query.bindValue(column++, 0);
+	}
+
+      if(!it.m_lcnum.isEmpty())
+	query.bindValue(column++, it.m_lcnum);
+      else
+	query.bindValue(column++, QVariant(QVariant::String));
+
+      if(!it.m_callnum.isEmpty())
+	query.bindValue(column++, it.m_callnum);
+      else
+	query.bindValue(column++, QVariant(QVariant::String));
+
+      if(!it.m_deweynum.isEmpty())
+	query.bindValue(column++, it.m_deweynum);
+      else
+	query.bindValue(column++, QVariant(QVariant::String));
+
+      query.bindValue(column++, it.m_place.isEmpty() ? "N/A" : it.m_place);
+      query.bindValue(column++, it.m_marcTags);
+
+      if(!book)
+	query.bindValue(column++, itemType);
+
+      qint64 oid = -1;
+
+      if(sqlite)
+	{
+	  oid = first + 2 * i;
+	  query.bindValue(column++, oid);
+	}
+
+      if(!query.exec())
+	{
+	  errorstr = query.lastError().text();
+	  break;
+	}
+
+      if(!sqlite)
+	{
+	  if(query.next())
+	    oid = query.value(0).toLongLong();
+	  else
+	    {
+	      errorstr = query.lastError().text();
+	      break;
+	    }
+	}
+
+      copy.bindValue(0, oid);
+      copy.bindValue(1, 1);
+
+      if(book && !it.m_isbn10.isEmpty())
+	copy.bindValue(2, it.m_isbn10 + "-1");
+      else if(!book && !it.m_issn.isEmpty())
+	copy.bindValue(2, it.m_issn + "-1");
+      else
+	copy.bindValue(2, QString::number(oid) + "-1");
+
+      if(sqlite)
+	copy.bindValue(3, oid + 1);
+
+      if(!copy.exec())
+	{
+	  errorstr = copy.lastError().text();
+	  break;
+	}
+
+      imported += 1;
+    }
+
+  if(errorstr.isEmpty() && !db.commit())
+    errorstr = db.lastError().text();
+
+  if(!errorstr.isEmpty())
+    {
+      db.rollback();
+      return false;
+    }
+
+  m_imported += imported;
+  m_skipped += skipped;
+  return true;
+}
+
+/*
+** -- nextBatch() --
+*/
+
+QList<QByteArray> biblioteq_marc_import::nextBatch(QFile &file,
+						   QXmlStreamReader *reader)
+{
+  QList<QByteArray> records;
+
+  while(records.size() < BATCH_SIZE)
+    {
+      QByteArray record;
+
+      if(reader)
+	record = nextXmlRecord(*reader);
+      else
+	record = nextIso2709Record(file);
+
+      if(record.isEmpty())
+	break;
+
+      records.append(record);
+    }
+
+  return records;
+}
+
+/*
+** -- nextIso2709Record() --
+*/
+
+QByteArray biblioteq_marc_import::nextIso2709Record(QFile &file)
+{
+  const char recordTerminator = 0x1d;
+
+  while(!file.atEnd())
+    {
+      char c = 0;
+
+      /*
+      ** Line breaks are sometimes placed between records.
+      */
+
+      while(file.peek(&c, 1) == 1 && (c == '\n' || c == '\r'))
+	file.getChar(&c);
+
+      bool ok = false;
+      int length = file.peek(5).toInt(&ok);
+      qint64 position = file.pos();
+
+      if(ok && length > 24)
+	{
+	  QByteArray record(file.read(length));
+
+	  if(record.endsWith(recordTerminator) &&
+	     biblioteq_marc::isIso2709(record))
+	    return record;
+	}
+
+      /*
+      ** The record is damaged. Resume after its terminator.
+      */
+
+      file.seek(position);
+
+      while(file.getChar(&c))
+	if(c == recordTerminator)
+	  break;
+    }
+
+  return QByteArray();
+}
+
+/*
+** -- nextXmlRecord() --
+*/
+
+QByteArray biblioteq_marc_import::nextXmlRecord(QXmlStreamReader &reader)
+{
+  while(!reader.atEnd())
+    if(reader.readNext() == QXmlStreamReader::StartElement &&
+       reader.name() == QLatin1String("record"))
+      {
+	QByteArray record;
+	QXmlStreamWriter writer(&record);
+	int depth = 0;
+
+	/*
+	** The record is copied, so that it may be parsed
+	** independently of the document.
+	*/
+
+	while(!reader.hasError())
+	  {
+	    if(reader.isStartElement())
+	      depth += 1;
+	    else if(reader.isEndElement())
+	      depth -= 1;
+
+	    writer.writeCurrentToken(reader);
+
+	    if(depth == 0 || reader.atEnd())
+	      break;
+
+	    reader.readNext();
+	  }
+
+	return record;
+      }
+
+  return QByteArray();
+}
+
+/*
+** -- parse() --
+*/
+
+QList<biblioteq_marc_import::item> biblioteq_marc_import::parse
+(const QList<QByteArray> &records, const QString &itemType, const bool xml)
+{
+  /*
+  ** Journals and magazines are parsed by the magazine handlers.
+  */
+
+  QList<item> items;
+  biblioteq_marc m(itemType == "Book" ?
+		   biblioteq_marc::BOOK : biblioteq_marc::MAGAZINE,
+		   xml ? biblioteq_marc::SRU : biblioteq_marc::Z3950,
+		   biblioteq_marc::MARC21);
+
+  for(int i = 0; i < records.size(); i++)
+    {
+      item it;
+
+      if(xml)
+	{
+	  it.m_marcTags = QString::fromUtf8(records.at(i).constData(),
+					    records.at(i).length());
+	  m.setData(it.m_marcTags);
+	}
+      else
+	{
+	  it.m_marcTags = biblioteq_marc::recordText(records.at(i));
+	  m.setRecord(records.at(i));
+	}
+
+      it.m_author = m.author();
+      it.m_binding = m.binding();
+      it.m_callnum = m.callnum();
+      it.m_category = m.category();
+      it.m_description = m.description();
+      it.m_deweynum = m.deweynum();
+      it.m_edition = m.edition();
+      it.m_isbn10 = m.isbn10();
+      it.m_isbn13 = m.isbn13();
+      it.m_issn = m.issn();
+      it.m_lcnum = m.lcnum();
+      it.m_place = m.place();
+      it.m_publicationDate = m.publicationDate();
+      it.m_publisher = m.publisher();
+      it.m_title = m.title();
+      items.append(it);
+    }
+
+  return items;
+}
+
+/*
+** -- recordsPerSecond() --
+*/
+
+double biblioteq_marc_import::recordsPerSecond(void) const
+{
+  return m_recordsPerSecond;
+}
+
+/*
+** -- skipped() --
+*/
+
+int biblioteq_marc_import::skipped(void) const
+{
+  return m_skipped;
+}
+
+/*
+** -- slotBatchParsed() --
+*/
+
+void biblioteq_marc_import::slotBatchParsed(void)
+{
+  emit batchParsed();
+}
@@ -0,0 +1,92 @@
+#ifndef _BIBLIOTEQ_MARC_IMPORT_H_
+#define _BIBLIOTEQ_MARC_IMPORT_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QByteArray>
+#include <QDate>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+
+class QFile;
+class QThreadPool;
+class QWidget;
+class QXmlStreamReader;
+class biblioteq_marc_import_task;
+
+/*
+** Imports a file of MARC21 records, either ISO 2709 or MARCXML, into
+** the book, journal or magazine tables. The file is read a batch at
+** a time. Batches are parsed on a pool of threads while earlier
+** batches are inserted, each within a single transaction. Only a
+** bounded number of batches are held in memory.
+*/
+
+class biblioteq_marc_import: public QObject
+{
+  Q_OBJECT
+
+ public:
+  static const int BATCH_SIZE = 500;
+
+  struct item
+  {
+    QDate m_publicationDate;
+    QString m_author;
+    QString m_binding;
+    QString m_callnum;
+    QString m_category;
+    QString m_description;
+    QString m_deweynum;
+    QString m_edition;
+    QString m_isbn10;
+    QString m_isbn13;
+    QString m_issn;
+    QString m_lcnum;
+    QString m_marcTags;
+    QString m_place;
+    QString m_publisher;
+    QString m_title;
+  };
+
+  biblioteq_marc_import(QWidget *parent);
+  ~biblioteq_marc_import();
+  static QList<item> parse(const QList<QByteArray> &records,
+			   const QString &itemType,
+			   const bool xml);
+  bool import(const QString &fileName,
+	      const QString &itemType,
+	      QString &errorstr);
+  double recordsPerSecond(void) const;
+  int imported(void) const;
+  int skipped(void) const;
+
+ private:
+  QList<QList<item> > m_batches;
+  QMutex m_mutex;
+  QThreadPool *m_pool;
+  QWidget *m_parent;
+  double m_recordsPerSecond;
+  int m_imported;
+  int m_skipped;
+  friend class biblioteq_marc_import_task;
+  QList<QByteArray> nextBatch(QFile &file, QXmlStreamReader *reader);
+  QByteArray nextIso2709Record(QFile &file);
+  QByteArray nextXmlRecord(QXmlStreamReader &reader);
+  bool insert(const QList<item> &items,
+	      const QString &itemType,
+	      QString &errorstr);
+  void deliver(const QList<item> &items);
+
+ private slots:
+  void slotBatchParsed(void);
+
+ signals:
+  void batchParsed(void);
+};
+
+#endif
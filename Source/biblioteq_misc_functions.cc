@@ -3,6 +3,7 @@
 */
 
 #include <QDate>
+#include <QMutexLocker>
 #include <QProgressDialog>
 #include <QSqlField>
 #include <QSqlIndex>
@@ -136,11 +137,7 @@ QImage biblioteq_misc_functions::getImage(const QString &oid,
   if(query.exec())
     if(query.next())
       {
-	image.loadFromData
-	  (QByteArray::fromBase64(query.value(0).toByteArray()));
-
-	if(image.isNull())
-	  image.loadFromData(query.value(0).toByteArray());
+	image.loadFromData(imageBytes(query.value(0).toByteArray()));
       }
 
   return image;
@@ -565,8 +562,7 @@ QStringList biblioteq_misc_functions::getReservedItems(const QString &memberid,
   if(query.exec())
     while(query.next())
       {
-	date = QDate::fromString(query.value(4).toString(),
-				 "MM/dd/yyyy");
+	date = dateFromString(query.value(4).toString());
 	str = QString(QObject::tr("#")) +
 	  QString::number(list.size() + 1) + "<br>";
 	str += QObject::tr("Barcode: ") +
@@ -691,6 +687,12 @@ QString biblioteq_misc_functions::getColumnString(const QTableWidget *table,
   if(column < 0 || row < 0 || !table)
     return QString("");
 
+  const biblioteq_main_table *mainTable =
+    qobject_cast<const biblioteq_main_table *> (table);
+
+  if(mainTable)
+    return mainTable->text(row, column);
+
   QTableWidgetItem *item = 0;
 
   if((item = table->item(row, column)))
@@ -712,6 +714,8 @@ QString biblioteq_misc_functions::getColumnString(const QTableWidget *table,
 
   QString str = "";
   QTableWidgetItem *column = 0;
+  const biblioteq_main_table *mainTable =
+    qobject_cast<const biblioteq_main_table *> (table);
   int i = 0;
 
   if(row >= 0 && row < table->rowCount())
@@ -719,7 +723,21 @@ QString biblioteq_misc_functions::getColumnString(const QTableWidget *table,
       {
 	column = table->horizontalHeaderItem(i);
 
-	if(column == 0 || table->item(row, i) == 0)
+	if(column == 0)
+	  continue;
+
+	if(mainTable)
+	  {
+	    if(column->text().toLower() == columnName.toLower())
+	      {
+		str = mainTable->text(row, i);
+		break;
+	      }
+
+	    continue;
+	  }
+
+	if(table->item(row, i) == 0)
 	  continue;
 
 	if(column->text().toLower() == columnName.toLower())
@@ -771,7 +789,23 @@ void biblioteq_misc_functions::updateColumn(QTableWidget *table,
 					    const int row, int column,
 					    const QString &value)
 {
-  if(column < 0 || row < 0 || !table || !table->item(row, column))
+  if(column < 0 || row < 0 || !table)
+    return;
+
+  biblioteq_main_table *mainTable =
+    qobject_cast<biblioteq_main_table *> (table);
+
+  if(mainTable)
+    {
+      /*
+      ** The main table's rows may not have items.
+      */
+
+      mainTable->setText(row, column, value);
+      return;
+    }
+
+  if(!table->item(row, column))
     return;
 
   bool sortingEnabled = false;
@@ -1213,6 +1247,16 @@ void biblioteq_misc_functions::createInitialCopies(const QString &idArg,
 	itemoid = id;
     }
 
+  qint64 oid = -1;
+
+  if(!itemoid.isEmpty() && db.driverName() == "QSQLITE")
+    {
+      oid = getSqliteUniqueIds(db, numCopies, errorstr);
+
+      if(!errorstr.isEmpty())
+	return;
+    }
+
   if(!itemoid.isEmpty())
     for(i = 0; i < numCopies; i++)
       {
@@ -1244,14 +1288,7 @@ void biblioteq_misc_functions::createInitialCopies(const QString &idArg,
 	query.bindValue(2, id + "-" + QString::number(i + 1));
 
 	if(db.driverName() == "QSQLITE")
-	  {
-	    qint64 value = getSqliteUniqueId(db, errorstr);
-
-	    if(errorstr.isEmpty())
-	      query.bindValue(3, value);
-	    else
-	      break;
-	  }
+	  query.bindValue(3, oid + i);
 
 	if(!query.exec())
 	  {
@@ -1310,48 +1347,51 @@ void biblioteq_misc_functions::highlightWidget(QWidget *widget,
 }
 
 /*
-** -- sqliteQuerySize() --
+** Result sizes are remembered per query and database generation.
 */
 
-int biblioteq_misc_functions::sqliteQuerySize(const QString &querystr,
-					      const QSqlDatabase &db,
-					      const char *file,
-					      const int line)
-{
-  int count = 0;
+static QHash<QString, QPair<QString, int> > s_querySizes;
+static QMutex s_querySizesMutex;
 
-  if(db.driverName() != "QSQLITE")
-    return count; // SQLite only.
-  else if(querystr.trimmed().isEmpty())
-    return count;
+/*
+** -- sqliteGeneration() --
+*/
+
+static QString sqliteGeneration(const QSqlDatabase &db)
+{
+  /*
+  ** data_version changes whenever another connection commits and
+  ** total_changes() counts the rows written through this connection.
+  ** Together they identify the state of the database.
+  */
 
   QSqlQuery query(db);
+  QString generation("");
 
   query.setForwardOnly(true);
 
-  if(query.exec(querystr))
-    while(query.next())
-      count += 1;
+  if(query.exec("PRAGMA data_version") && query.next())
+    generation = query.value(0).toString();
+  else
+    return QString("");
 
-  if(query.lastError().isValid())
-    if(qmain)
-      qmain->addError
-	(QString(QObject::tr("Database Error")),
-	 QString(QObject::tr("Unable to determine the query size.")),
-	 query.lastError().text(), file, line);
+  if(query.exec("SELECT total_changes()") && query.next())
+    generation.append(":").append(query.value(0).toString());
+  else
+    return QString("");
 
-  return count;
+  return generation;
 }
 
 /*
-** -- sqliteQuerySize() --
+** -- sqliteCountRows() --
 */
 
-int biblioteq_misc_functions::sqliteQuerySize
-(const QString &querystr,
- const QMap<QString, QVariant> &boundValues,
- const QSqlDatabase &db,
- const char *file, const int line)
+static int sqliteCountRows(const QString &querystr,
+			   const QList<QVariant> &values,
+			   const QSqlDatabase &db,
+			   const char *file,
+			   const int line)
 {
   int count = 0;
 
@@ -1360,29 +1400,98 @@ int biblioteq_misc_functions::sqliteQuerySize
   else if(querystr.trimmed().isEmpty())
     return count;
 
-  QList<QVariant> list = boundValues.values();
+  QString generation(sqliteGeneration(db));
+  QString key(db.connectionName());
+
+  key.append("\n").append(db.databaseName());
+  key.append("\n").append(querystr);
+
+  for(int i = 0; i < values.size(); i++)
+    key.append("\n").append(values.at(i).toString());
+
+  if(!generation.isEmpty())
+    {
+      QMutexLocker locker(&s_querySizesMutex);
+
+      if(s_querySizes.contains(key) &&
+	 s_querySizes.value(key).first == generation)
+	return s_querySizes.value(key).second;
+    }
+
+  /*
+  ** Let SQLite count the rows rather than stepping through them.
+  */
+
   QSqlQuery query(db);
+  QString str(querystr.trimmed());
+
+  while(str.endsWith(";"))
+    str = str.mid(0, str.length() - 1).trimmed();
 
+  str = QString("SELECT COUNT(*) FROM (%1) AS biblioteq_count").arg(str);
   query.setForwardOnly(true);
-  query.prepare(querystr);
 
-  for(int i = 0; i < list.size(); i++)
-    query.bindValue(i, list.at(i));
+  bool ok = false;
 
-  if(query.exec())
-    while(query.next())
-      count += 1;
+  if(values.isEmpty())
+    ok = query.exec(str);
+  else if((ok = query.prepare(str)))
+    {
+      for(int i = 0; i < values.size(); i++)
+	query.bindValue(i, values.at(i));
+
+      ok = query.exec();
+    }
+
+  if(ok && query.next())
+    count = query.value(0).toInt();
 
   if(query.lastError().isValid())
-    if(qmain)
-      qmain->addError
-	(QString(QObject::tr("Database Error")),
-	 QString(QObject::tr("Unable to determine the query size.")),
-	 query.lastError().text(), file, line);
+    {
+      if(qmain)
+	qmain->addError
+	  (QString(QObject::tr("Database Error")),
+	   QString(QObject::tr("Unable to determine the query size.")),
+	   query.lastError().text(), file, line);
+    }
+  else if(!generation.isEmpty())
+    {
+      QMutexLocker locker(&s_querySizesMutex);
+
+      if(s_querySizes.size() >= 128)
+	s_querySizes.clear();
+
+      s_querySizes[key] = QPair<QString, int> (generation, count);
+    }
 
   return count;
 }
 
+/*
+** -- sqliteQuerySize() --
+*/
+
+int biblioteq_misc_functions::sqliteQuerySize(const QString &querystr,
+					      const QSqlDatabase &db,
+					      const char *file,
+					      const int line)
+{
+  return sqliteCountRows(querystr, QList<QVariant> (), db, file, line);
+}
+
+/*
+** -- sqliteQuerySize() --
+*/
+
+int biblioteq_misc_functions::sqliteQuerySize
+(const QString &querystr,
+ const QMap<QString, QVariant> &boundValues,
+ const QSqlDatabase &db,
+ const char *file, const int line)
+{
+  return sqliteCountRows(querystr, boundValues.values(), db, file, line);
+}
+
 /*
 ** -- center() --
 */
@@ -1873,31 +1982,67 @@ QStringList biblioteq_misc_functions::getVideoGamePlatforms
 qint64 biblioteq_misc_functions::getSqliteUniqueId(const QSqlDatabase &db,
 						   QString &errorstr)
 {
-  qint64 value = -1;
+  return getSqliteUniqueIds(db, 1, errorstr);
+}
 
-  if(db.driverName() != "QSQLITE")
-    return value;
+static const int SQLITE_SEQUENCE_PRUNE_INTERVAL = 64;
 
-  QSqlQuery query(db);
-  QString querystr("");
+/*
+** -- getSqliteUniqueIds() --
+*/
+
+qint64 biblioteq_misc_functions::getSqliteUniqueIds(const QSqlDatabase &db,
+						    const int count,
+						    QString &errorstr)
+{
+  /*
+  ** Returns the first of count consecutive identifiers with a single
+  ** statement. The identifiers are recorded by a row of the sequence
+  ** table, the last identifier. Identifiers are not held in memory,
+  ** so that a rolled-back reservation cannot be handed out twice.
+  ** Earlier rows are removed whenever a multiple of
+  ** SQLITE_SEQUENCE_PRUNE_INTERVAL is passed.
+  */
 
   errorstr = "";
-  querystr = "INSERT INTO sequence VALUES (NULL)";
-  query.setForwardOnly(true);
 
-  if(query.exec(querystr))
+  if(count <= 0 || db.driverName() != "QSQLITE")
+    return -1;
+
+  QSqlQuery query(db);
+  qint64 value = -1;
+
+  query.prepare("INSERT INTO sequence (value) "
+		"SELECT COALESCE(MAX(value), 0) + ? FROM sequence");
+  query.bindValue(0, count);
+
+  if(query.exec())
+    value = query.lastInsertId().toLongLong();
+
+  if(value < count)
     {
-      querystr = "SELECT MAX(value) FROM sequence";
+      if(query.lastError().isValid())
+	errorstr = query.lastError().text();
+      else
+	errorstr = QObject::tr("Unable to reserve identifiers.");
 
-      if(query.exec(querystr))
-	if(query.next())
-	  value = query.value(0).toLongLong();
+      return -1;
     }
 
-  if(query.lastError().isValid())
-    errorstr = query.lastError().text();
+  if(value / SQLITE_SEQUENCE_PRUNE_INTERVAL !=
+     (value - count) / SQLITE_SEQUENCE_PRUNE_INTERVAL)
+    {
+      query.prepare("DELETE FROM sequence WHERE value < ?");
+      query.bindValue(0, value);
 
-  return value;
+      if(!query.exec())
+	{
+	  errorstr = query.lastError().text();
+	  return -1;
+	}
+    }
+
+  return value - count + 1;
 }
 
 /*
@@ -1918,7 +2063,7 @@ bool biblioteq_misc_functions::hasMemberExpired(const QSqlDatabase &db,
     query.prepare("SELECT expiration_date "
 		  "FROM member WHERE memberid = ?");
   else
-    query.prepare("SELECT TO_DATE(expiration_date, 'mm/dd/yyyy') - "
+    query.prepare("SELECT TO_DATE(expiration_date, 'yyyy-mm-dd') - "
 		  "current_date FROM member WHERE memberid = ?");
 
   query.bindValue(0, memberid);
@@ -1928,8 +2073,7 @@ bool biblioteq_misc_functions::hasMemberExpired(const QSqlDatabase &db,
       {
 	if(db.driverName() == "QSQLITE")
 	  {
-	    QDate date(QDate::fromString(query.value(0).toString(),
-					 "MM/dd/yyyy"));
+	    QDate date(dateFromString(query.value(0).toString()));
 
 	    if(date.daysTo(QDate::currentDate()) > 0)
 	      expired = true;
@@ -2112,8 +2256,7 @@ void biblioteq_misc_functions::exportPhotographs
 	  if(progress.wasCanceled())
 	    break;
 
-	  QByteArray bytes
-	    (QByteArray::fromBase64(query.value(0).toByteArray()));
+	  QByteArray bytes(imageBytes(query.value(0).toByteArray()));
 	  QImage image;
 	  QString format(imageFormatGuess(bytes));
 
@@ -2158,6 +2301,24 @@ QStringList biblioteq_misc_functions::getBookBindingTypes
   return types;
 }
 
+/*
+** -- dateFromString() --
+*/
+
+QDate biblioteq_misc_functions::dateFromString(const QString &str)
+{
+  /*
+  ** Dates are stored as yyyy-MM-dd so that they may be compared and
+  ** indexed. Databases which have not been upgraded may still contain
+  ** MM/dd/yyyy dates.
+  */
+
+  if(str.length() == 10 && str.at(4) == '-')
+    return QDate::fromString(str, Qt::ISODate);
+  else
+    return QDate::fromString(str, "MM/dd/yyyy");
+}
+
 /*
 ** -- dnt() --
 */
@@ -2216,3 +2377,276 @@ QString biblioteq_misc_functions::imageFormatGuess(const QByteArray &bytes)
 
   return format;
 }
+
+/*
+** -- hasFullTextSearch() --
+*/
+
+bool biblioteq_misc_functions::hasFullTextSearch(const QSqlDatabase &db)
+{
+  QSqlQuery query(db);
+
+  query.setForwardOnly(true);
+
+  if(db.driverName() == "QSQLITE")
+    query.exec("SELECT COUNT(*) FROM sqlite_master "
+	       "WHERE name = 'item_search'");
+  else
+    query.exec("SELECT COUNT(*) FROM information_schema.tables "
+	       "WHERE table_name = 'item_search'");
+
+  if(query.next())
+    return query.value(0).toLongLong() > 0;
+  else
+    return false;
+}
+
+/*
+** -- getFullTextSearchCondition() --
+*/
+
+QString biblioteq_misc_functions::getFullTextSearchCondition
+(const QSqlDatabase &db, const QString &itemType, const QString &column,
+ const QString &text)
+{
+  /*
+  ** Produce a condition that restricts itemType's rows to those whose
+  ** column (title, keyword, or every indexed column if column is empty)
+  ** contains words beginning with the words of text. Only letters and
+  ** digits are retained, so the words do not require escaping.
+  ** An empty string is returned if text does not contain any words.
+  */
+
+  QString word("");
+  QStringList words;
+
+  for(int i = 0; i <= text.length(); i++)
+    if(i < text.length() && text.at(i).isLetterOrNumber())
+      word.append(text.at(i).toLower());
+    else if(!word.isEmpty())
+      {
+	words.append(word);
+	word.clear();
+      }
+
+  if(words.isEmpty())
+    return "";
+
+  QString table(itemType.toLower().remove(" "));
+  int code = 0;
+
+  if(itemType == "Book")
+    code = 1;
+  else if(itemType == "CD")
+    code = 2;
+  else if(itemType == "DVD")
+    code = 3;
+  else if(itemType == "Journal")
+    code = 4;
+  else if(itemType == "Magazine")
+    code = 5;
+  else if(itemType == "Photograph Collection")
+    {
+      code = 6;
+      table = "photograph_collection";
+    }
+  else if(itemType == "Video Game")
+    code = 7;
+  else
+    return "";
+
+  if(db.driverName() == "QSQLITE")
+    {
+      /*
+      ** The rowid of an item_search row is myoid * 16 + code.
+      */
+
+      QString match("");
+
+      for(int i = 0; i < words.size(); i++)
+	{
+	  if(!column.isEmpty())
+	    match.append(column + ":");
+
+	  match.append(words.at(i) + "* ");
+	}
+
+      return QString("%1.myoid IN (SELECT rowid / 16 FROM item_search "
+		     "WHERE item_search MATCH '%2' AND "
+		     "rowid - (rowid / 16) * 16 = %3)").
+	arg(table).arg(match.trimmed()).arg(code);
+    }
+  else
+    return QString("%1.myoid IN (SELECT item_oid FROM item_search "
+		   "WHERE type = '%2' AND %3 @@ "
+		   "to_tsquery('simple', '%4'))").
+      arg(table).arg(itemType).
+      arg(column.isEmpty() ? "document" : column).
+      arg(words.join(":* & ") + ":*");
+}
+
+/*
+** -- isBase64() --
+*/
+
+bool biblioteq_misc_functions::isBase64(const QByteArray &bytes)
+{
+  /*
+  ** Binary images begin with signatures that are not part of
+  ** the base64 alphabet.
+  */
+
+  if(bytes.isEmpty())
+    return false;
+
+  for(int i = 0; i < bytes.length(); i++)
+    {
+      char c = bytes.at(i);
+
+      if(!((c >= 'A' && c <= 'Z') ||
+	   (c >= 'a' && c <= 'z') ||
+	   (c >= '0' && c <= '9') ||
+	   c == '+' || c == '/' || c == '=' ||
+	   c == '\n' || c == '\r'))
+	return false;
+    }
+
+  return true;
+}
+
+/*
+** -- imageBytes() --
+*/
+
+QByteArray biblioteq_misc_functions::imageBytes(const QByteArray &bytes)
+{
+  /*
+  ** Earlier versions stored images as base64 text.
+  */
+
+  if(isBase64(bytes))
+    return QByteArray::fromBase64(bytes);
+  else
+    return bytes;
+}
+
+/*
+** -- convertImagesToBinary() --
+*/
+
+bool biblioteq_misc_functions::convertImagesToBinary(const QSqlDatabase &db,
+						     QString &errorstr)
+{
+  /*
+  ** Replace base64-encoded images with their binary forms. Rows are
+  ** visited in batches, in order of myoid, and each batch is
+  ** committed separately.
+  */
+
+  const char *columns[][2] =
+    {
+      {"book", "back_cover"},
+      {"book", "front_cover"},
+      {"cd", "back_cover"},
+      {"cd", "front_cover"},
+      {"dvd", "back_cover"},
+      {"dvd", "front_cover"},
+      {"journal", "back_cover"},
+      {"journal", "front_cover"},
+      {"magazine", "back_cover"},
+      {"magazine", "front_cover"},
+      {"photograph", "image"},
+      {"photograph", "image_scaled"},
+      {"photograph_collection", "image"},
+      {"photograph_collection", "image_scaled"},
+      {"videogame", "back_cover"},
+      {"videogame", "front_cover"},
+      {0, 0}
+    };
+  QSqlDatabase database(db);
+  const int batchSize = 50;
+
+  errorstr = "";
+
+  for(int i = 0; columns[i][0] != 0; i++)
+    {
+      QString column(columns[i][1]);
+      QString table(columns[i][0]);
+      bool first = true;
+      qint64 myoid = 0;
+
+      while(true)
+	{
+	  QList<QPair<qint64, QByteArray> > images;
+	  QSqlQuery query(database);
+	  int count = 0;
+
+	  query.setForwardOnly(true);
+
+	  if(first)
+	    query.prepare(QString("SELECT myoid, %1 FROM %2 "
+				  "WHERE %1 IS NOT NULL "
+				  "ORDER BY myoid LIMIT %3").
+			  arg(column).arg(table).arg(batchSize));
+	  else
+	    {
+	      query.prepare(QString("SELECT myoid, %1 FROM %2 "
+				    "WHERE %1 IS NOT NULL AND myoid > ? "
+				    "ORDER BY myoid LIMIT %3").
+			    arg(column).arg(table).arg(batchSize));
+	      query.bindValue(0, myoid);
+	    }
+
+	  if(!query.exec())
+	    {
+	      errorstr = query.lastError().text();
+	      return false;
+	    }
+
+	  while(query.next())
+	    {
+	      QByteArray bytes(query.value(1).toByteArray());
+
+	      count += 1;
+	      myoid = query.value(0).toLongLong();
+
+	      if(isBase64(bytes))
+		images.append(qMakePair(myoid, QByteArray::fromBase64(bytes)));
+	    }
+
+	  first = false;
+
+	  if(!images.isEmpty())
+	    {
+	      database.transaction();
+	      query.prepare(QString("UPDATE %1 SET %2 = ? WHERE myoid = ?").
+			    arg(table).arg(column));
+
+	      for(int j = 0; j < images.size(); j++)
+		{
+		  query.bindValue(0, images.at(j).second);
+		  query.bindValue(1, images.at(j).first);
+
+		  if(!query.exec())
+		    {
+		      errorstr = query.lastError().text();
+		      database.rollback();
+		      return false;
+		    }
+		}
+
+	      if(!database.commit())
+		{
+		  errorstr = database.lastError().text();
+		  database.rollback();
+		  return false;
+		}
+	    }
+
+	  if(count < batchSize)
+	    break;
+	}
+    }
+
+  return true;
+}
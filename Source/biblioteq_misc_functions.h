@@ -11,6 +11,7 @@
 ** -- Qt Includes --
 */
 
+#include <QDate>
 #include <QPair>
 #include <QSqlDatabase>
 #include <QSqlError>
@@ -28,6 +29,8 @@ class biblioteq_misc_functions
   static const int CREATE_USER = 100;
   static const int DELETE_USER = 200;
   static const int UPDATE_USER = 300;
+  static QByteArray imageBytes(const QByteArray &bytes);
+  static QDate dateFromString(const QString &str);
   static QImage getImage(const QString &, const QString &,
 			 const QString &, const QSqlDatabase &);
   static QList<QPair<QString, QString> > getLocations
@@ -41,6 +44,10 @@ class biblioteq_misc_functions
   static QString getColumnString(const QTableWidget *, const int,
 				 const QString &);
   static QString getColumnString(const QTableWidget *, const int, const int);
+  static QString getFullTextSearchCondition(const QSqlDatabase &,
+					    const QString &,
+					    const QString &,
+					    const QString &);
   static QString getMemberName(const QSqlDatabase &,
 			       const QString &, QString &);
   static QString getOID(const QString &, const QString &,
@@ -61,9 +68,13 @@ class biblioteq_misc_functions
 				      QString &);
   static QStringList getVideoGamePlatforms(const QSqlDatabase &, QString &);
   static QStringList getVideoGameRatings(const QSqlDatabase &, QString &);
+  static bool convertImagesToBinary(const QSqlDatabase &db,
+				    QString &errorstr);
   static bool dnt(const QSqlDatabase &, const QString &, QString &);
+  static bool hasFullTextSearch(const QSqlDatabase &);
   static bool hasMemberExpired(const QSqlDatabase &db,
 			       const QString &memberid, QString &errorstr);
+  static bool isBase64(const QByteArray &bytes);
   static bool isCheckedOut(const QSqlDatabase &,
 			   const QString &, const QString &, QString &);
   static bool isCopyAvailable(const QSqlDatabase &, const QString &,
@@ -84,6 +95,9 @@ class biblioteq_misc_functions
   static qint64 getMemberMatchCount(const QString &, const QString &,
 				    const QSqlDatabase &, QString &);
   static qint64 getSqliteUniqueId(const QSqlDatabase &, QString &);
+  static qint64 getSqliteUniqueIds(const QSqlDatabase &db,
+				   const int count,
+				   QString &errorstr);
   static qint64 userCount(const QString &, const QSqlDatabase &, QString &);
   static void DBAccount(const QString &, const QSqlDatabase &,
 			const int, QString &, const QString & = "");
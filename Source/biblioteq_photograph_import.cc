@@ -0,0 +1,531 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QApplication>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QEventLoop>
+#include <QFile>
+#include <QImage>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QProgressDialog>
+#include <QRunnable>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QThreadPool>
+#include <QTime>
+#include <QTimer>
+#include <QVariant>
+#include <QtAlgorithms>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq.h"
+#include "biblioteq_misc_functions.h"
+#include "biblioteq_photograph_import.h"
+#include "biblioteq_thumbnail_loader.h"
+
+extern biblioteq *qmain;
+
+/*
+** Prepares a single image on one of the pool's threads.
+*/
+
+class biblioteq_photograph_import_task: public QRunnable
+{
+ public:
+  biblioteq_photograph_import_task(biblioteq_photograph_import *importer,
+				   const QString &fileName,
+				   const int index):QRunnable()
+  {
+    m_fileName = fileName;
+    m_importer = importer;
+    m_index = index;
+    setAutoDelete(true);
+  }
+
+  void run(void)
+  {
+    biblioteq_photograph_import::image i;
+    bool valid = false;
+
+    i.m_index = m_index;
+    valid = biblioteq_photograph_import::prepare(m_fileName, i);
+    m_importer->deliver(i, valid);
+  }
+
+ private:
+  QString m_fileName;
+  biblioteq_photograph_import *m_importer;
+  int m_index;
+};
+
+/*
+** -- lessThan() --
+*/
+
+static bool lessThan(const biblioteq_photograph_import::image &i1,
+		     const biblioteq_photograph_import::image &i2)
+{
+  return i1.m_index < i2.m_index;
+}
+
+/*
+** -- biblioteq_photograph_import() --
+*/
+
+biblioteq_photograph_import::biblioteq_photograph_import(QWidget *parent):
+  QObject(parent)
+{
+  m_duplicates = 0;
+  m_imagesPerSecond = 0.0;
+  m_imported = 0;
+  m_parent = parent;
+  m_prepared = 0;
+
+  if((m_pool = new(std::nothrow) QThreadPool(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  m_pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+}
+
+/*
+** -- ~biblioteq_photograph_import() --
+*/
+
+biblioteq_photograph_import::~biblioteq_photograph_import()
+{
+  /*
+  ** Tasks refer to this object. They must complete before
+  ** it is destroyed.
+  */
+
+  m_pool->waitForDone();
+}
+
+/*
+** -- deliver() --
+*/
+
+void biblioteq_photograph_import::deliver(const image &i, const bool valid)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_prepared += 1;
+
+  if(valid)
+    m_images.append(i);
+
+  locker.unlock();
+  QMetaObject::invokeMethod(this, "slotImagePrepared", Qt::QueuedConnection);
+}
+
+/*
+** -- duplicates() --
+*/
+
+int biblioteq_photograph_import::duplicates(void) const
+{
+  return m_duplicates;
+}
+
+/*
+** -- imagesPerSecond() --
+*/
+
+double biblioteq_photograph_import::imagesPerSecond(void) const
+{
+  return m_imagesPerSecond;
+}
+
+/*
+** -- import() --
+*/
+
+bool biblioteq_photograph_import::import(const QFileInfoList &files,
+					 const QString &collectionOid,
+					 QString &errorstr)
+{
+  errorstr = "";
+  m_collectionOid = collectionOid;
+  m_digests.clear();
+  m_duplicates = 0;
+  m_images.clear();
+  m_imagesPerSecond = 0.0;
+  m_imported = 0;
+  m_prepared = 0;
+  m_unhashed.clear();
+
+  if(files.isEmpty())
+    return true;
+
+  /*
+  ** Only the collection's images whose lengths match an imported
+  ** image's length are retrieved and digested.
+  */
+
+  QSqlQuery query(qmain->getDB());
+
+  query.setForwardOnly(true);
+  query.prepare("SELECT myoid, LENGTH(image) FROM photograph "
+		"WHERE collection_oid = ? AND image IS NOT NULL");
+  query.bindValue(0, m_collectionOid);
+
+  if(!query.exec())
+    {
+      errorstr = query.lastError().text();
+      return false;
+    }
+
+  while(query.next())
+    m_unhashed[query.value(1).toInt()].append(query.value(0).toLongLong());
+
+  QEventLoop loop;
+  QList<image> batch;
+  QProgressDialog progress(m_parent);
+  QTime time;
+  QTimer timer;
+  int next = 0;
+  int prepared = 0;
+  qint64 batchBytes = 0;
+
+#ifdef Q_OS_MAC
+#if QT_VERSION < 0x050000
+  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
+#endif
+#endif
+  connect(&progress, SIGNAL(canceled(void)), &loop, SLOT(quit(void)));
+  connect(&timer, SIGNAL(timeout(void)), &loop, SLOT(quit(void)));
+  connect(this, SIGNAL(imagePrepared(void)), &loop, SLOT(quit(void)));
+  progress.setModal(true);
+  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
+  progress.setLabelText(tr("Importing image(s)..."));
+  progress.setMaximum(files.size());
+  progress.setMinimum(0);
+  progress.show();
+  progress.update();
+  time.start();
+  timer.start(100);
+
+  while(!progress.wasCanceled())
+    {
+      /*
+      ** Keep the pool busy while limiting the number of
+      ** images that are held in memory.
+      */
+
+      while(next < files.size() &&
+	    next - prepared < 4 * m_pool->maxThreadCount())
+	{
+	  biblioteq_photograph_import_task *task = 0;
+
+	  if((task = new(std::nothrow)
+	      biblioteq_photograph_import_task
+	      (this, files.at(next).absoluteFilePath(), next)) == 0)
+	    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+	  m_pool->start(task);
+	  next += 1;
+	}
+
+      {
+	QMutexLocker locker(&m_mutex);
+
+	prepared = m_prepared;
+
+	while(!m_images.isEmpty())
+	  {
+	    image i(m_images.takeFirst());
+
+	    batchBytes += i.m_image.size() + i.m_imageScaled.size();
+	    batch.append(i);
+	  }
+      }
+
+      bool done = prepared >= files.size();
+
+      if(batch.size() >= BATCH_SIZE || batchBytes >= BATCH_BYTES ||
+	 (done && !batch.isEmpty()))
+	{
+	  if(!insert(batch, errorstr))
+	    break;
+
+	  batch.clear();
+	  batchBytes = 0;
+	}
+
+      if(time.elapsed() > 0)
+	m_imagesPerSecond = 1000.0 * m_imported / time.elapsed();
+
+      progress.setLabelText
+	(tr("Imported %1 image(s) (%2 per second). "
+	    "Skipped %3 duplicate(s)...").
+	 arg(m_imported).
+	 arg(static_cast<int> (m_imagesPerSecond)).
+	 arg(m_duplicates));
+      progress.setValue(prepared);
+      progress.repaint();
+
+      if(done)
+	break;
+
+      loop.exec();
+    }
+
+  bool canceled = progress.wasCanceled();
+
+  progress.close();
+
+  m_pool->waitForDone();
+
+  if(canceled && errorstr.isEmpty())
+    {
+      /*
+      ** Images which have been prepared are kept.
+      */
+
+      batch.append(m_images);
+      insert(batch, errorstr);
+    }
+
+  m_images.clear();
+
+  if(time.elapsed() > 0)
+    m_imagesPerSecond = 1000.0 * m_imported / time.elapsed();
+
+  return errorstr.isEmpty() && !canceled;
+}
+
+/*
+** -- imported() --
+*/
+
+int biblioteq_photograph_import::imported(void) const
+{
+  return m_imported;
+}
+
+/*
+** -- insert() --
+*/
+
+bool biblioteq_photograph_import::insert(QList<image> &images,
+					 QString &errorstr)
+{
+  if(images.isEmpty())
+    return true;
+
+  qSort(images.begin(), images.end(), lessThan);
+
+  if(!loadDigests(images, errorstr))
+    return false;
+
+  QList<int> accepted;
+
+  for(int i = 0; i < images.size(); i++)
+    if(m_digests.contains(images.at(i).m_digest))
+      m_duplicates += 1;
+    else
+      {
+	accepted.append(i);
+	m_digests.insert(images.at(i).m_digest);
+      }
+
+  if(accepted.isEmpty())
+    return true;
+
+  QSqlDatabase db(qmain->getDB());
+  bool sqlite = db.driverName() == "QSQLITE";
+  qint64 first = -1;
+
+  if(sqlite)
+    {
+      first = biblioteq_misc_functions::getSqliteUniqueIds
+	(db, accepted.size(), errorstr);
+
+      if(!errorstr.isEmpty())
+	return false;
+    }
+
+  qint64 id = 0;
+
+#if QT_VERSION >= 0x040700
+  id = QDateTime::currentMSecsSinceEpoch();
+#else
+  QDateTime dateTime(QDateTime::currentDateTime());
+
+  id = static_cast<qint64> (dateTime.toTime_t());
+#endif
+
+  QVariantList collectionOids;
+  QVariantList ids;
+  QVariantList images1;
+  QVariantList images2;
+  QVariantList myoids;
+  QVariantList notApplicable;
+  QVariantList pdates;
+  QVariantList quantities;
+
+  for(int i = 0; i < accepted.size(); i++)
+    {
+      const image &it = images.at(accepted.at(i));
+
+      collectionOids << m_collectionOid;
+      ids << QString::number(id + m_imported + i);
+      images1 << it.m_image;
+      images2 << it.m_imageScaled;
+      myoids << first + i;
+      notApplicable << "N/A";
+      pdates << "2001-01-01";
+      quantities << 1;
+    }
+
+  QSqlQuery query(db);
+
+  if(!sqlite)
+    query.prepare("INSERT INTO photograph "
+		  "(id, collection_oid, title, creators, pdate, "
+		  "quantity, medium, reproduction_number, "
+		  "copyright, callnumber, other_number, notes, subjects, "
+		  "format, image, image_scaled) "
+		  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, "
+		  "?, ?, ?, ?, ?, ?, ?, ?)");
+  else
+    query.prepare("INSERT INTO photograph "
+		  "(id, collection_oid, title, creators, pdate, "
+		  "quantity, medium, reproduction_number, "
+		  "copyright, callnumber, other_number, notes, subjects, "
+		  "format, image, image_scaled, myoid) "
+		  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, "
+		  "?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+  query.addBindValue(ids);
+  query.addBindValue(collectionOids);
+  query.addBindValue(notApplicable);
+  query.addBindValue(notApplicable);
+  query.addBindValue(pdates);
+  query.addBindValue(quantities);
+
+  for(int i = 0; i < 8; i++)
+    query.addBindValue(notApplicable);
+
+  query.addBindValue(images1);
+  query.addBindValue(images2);
+
+  if(sqlite)
+    query.addBindValue(myoids);
+
+  if(!db.transaction())
+    {
+      errorstr = db.lastError().text();
+      return false;
+    }
+
+  if(!query.execBatch())
+    errorstr = query.lastError().text();
+  else if(!db.commit())
+    errorstr = db.lastError().text();
+
+  if(!errorstr.isEmpty())
+    {
+      db.rollback();
+      return false;
+    }
+
+  m_imported += accepted.size();
+  return true;
+}
+
+/*
+** -- loadDigests() --
+*/
+
+bool biblioteq_photograph_import::loadDigests(const QList<image> &images,
+					      QString &errorstr)
+{
+  QSqlQuery query(qmain->getDB());
+
+  query.setForwardOnly(true);
+  query.prepare("SELECT image FROM photograph WHERE myoid = ?");
+
+  for(int i = 0; i < images.size(); i++)
+    {
+      int length = images.at(i).m_image.size();
+
+      if(!m_unhashed.contains(length))
+	continue;
+
+      QList<qint64> oids(m_unhashed.take(length));
+
+      for(int j = 0; j < oids.size(); j++)
+	{
+	  query.bindValue(0, oids.at(j));
+
+	  if(!query.exec())
+	    {
+	      errorstr = query.lastError().text();
+	      return false;
+	    }
+
+	  if(query.next())
+	    m_digests.insert
+	      (QCryptographicHash::hash(query.value(0).toByteArray(),
+					QCryptographicHash::Sha1));
+	}
+    }
+
+  return true;
+}
+
+/*
+** -- prepare() --
+*/
+
+bool biblioteq_photograph_import::prepare(const QString &fileName, image &i)
+{
+  QFile file(fileName);
+
+  if(!file.open(QIODevice::ReadOnly))
+    return false;
+
+  i.m_image = file.readAll();
+
+  if(static_cast<qint64> (i.m_image.length()) != file.size())
+    return false;
+
+  QImage img;
+
+  if(!img.loadFromData(i.m_image))
+    return false;
+
+  QBuffer buffer;
+  QString format(biblioteq_misc_functions::imageFormatGuess(i.m_image));
+
+  buffer.setBuffer(&i.m_imageScaled);
+  buffer.open(QIODevice::WriteOnly);
+  img = img.scaled
+    (biblioteq_thumbnail_loader::THUMBNAIL_WIDTH,
+     biblioteq_thumbnail_loader::THUMBNAIL_HEIGHT,
+     Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+  if(img.isNull() || !img.save(&buffer, format.toLatin1().constData(), 100))
+    i.m_imageScaled = i.m_image;
+
+  i.m_digest = QCryptographicHash::hash(i.m_image, QCryptographicHash::Sha1);
+  return true;
+}
+
+/*
+** -- slotImagePrepared() --
+*/
+
+void biblioteq_photograph_import::slotImagePrepared(void)
+{
+  emit imagePrepared();
+}
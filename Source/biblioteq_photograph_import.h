@@ -0,0 +1,78 @@
+#ifndef _BIBLIOTEQ_PHOTOGRAPH_IMPORT_H_
+#define _BIBLIOTEQ_PHOTOGRAPH_IMPORT_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QByteArray>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class QThreadPool;
+class QWidget;
+class biblioteq_photograph_import_task;
+
+/*
+** Imports a directory's images into a photograph collection. Images
+** are read, decoded and scaled on a pool of threads. An image whose
+** content is already in the collection is skipped. Images are
+** inserted in batches, each within a single transaction.
+*/
+
+class biblioteq_photograph_import: public QObject
+{
+  Q_OBJECT
+
+ public:
+  static const int BATCH_BYTES = 64 * 1024 * 1024;
+  static const int BATCH_SIZE = 250;
+
+  struct image
+  {
+    QByteArray m_digest;
+    QByteArray m_image;
+    QByteArray m_imageScaled;
+    int m_index;
+  };
+
+  biblioteq_photograph_import(QWidget *parent);
+  ~biblioteq_photograph_import();
+  static bool prepare(const QString &fileName, image &i);
+  bool import(const QFileInfoList &files,
+	      const QString &collectionOid,
+	      QString &errorstr);
+  double imagesPerSecond(void) const;
+  int duplicates(void) const;
+  int imported(void) const;
+
+ private:
+  QHash<int, QList<qint64> > m_unhashed;
+  QList<image> m_images;
+  QMutex m_mutex;
+  QSet<QByteArray> m_digests;
+  QString m_collectionOid;
+  QThreadPool *m_pool;
+  QWidget *m_parent;
+  double m_imagesPerSecond;
+  int m_duplicates;
+  int m_imported;
+  int m_prepared;
+  friend class biblioteq_photograph_import_task;
+  bool insert(QList<image> &images, QString &errorstr);
+  bool loadDigests(const QList<image> &images, QString &errorstr);
+  void deliver(const image &i, const bool valid);
+
+ private slots:
+  void slotImagePrepared(void);
+
+ signals:
+  void imagePrepared(void);
+};
+
+#endif
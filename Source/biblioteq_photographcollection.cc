@@ -17,6 +17,7 @@
 #include "biblioteq.h"
 #include "biblioteq_bgraphicsscene.h"
 #include "biblioteq_graphicsitempixmap.h"
+#include "biblioteq_photograph_import.h"
 #include "biblioteq_photographcollection.h"
 #include "ui_biblioteq_photographview.h"
 
@@ -55,6 +56,10 @@ biblioteq_photographcollection::biblioteq_photographcollection
   if((m_photo_diag = new(std::nothrow) QDialog(this)) == 0)
     biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
 
+  if((m_thumbnailLoader = new(std::nothrow)
+      biblioteq_thumbnail_loader(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
   pc.setupUi(this);
   pc.thumbnail_item->enableDoubleClickResize(false);
 
@@ -292,7 +297,7 @@ void biblioteq_photographcollection::slotGo(void)
 	      pc.thumbnail_collection->m_image.save
 		(&buffer, pc.thumbnail_collection->m_imageFormat.toLatin1(),
 		 100);
-	      query.bindValue(5, bytes.toBase64());
+	      query.bindValue(5, bytes);
 	    }
 	  else
 	    query.bindValue(5, QVariant(QVariant::ByteArray));
@@ -310,7 +315,7 @@ void biblioteq_photographcollection::slotGo(void)
 	      image.save
 		(&buffer, pc.thumbnail_collection->m_imageFormat.toLatin1(),
 		 100);
-	      query.bindValue(6, bytes.toBase64());
+	      query.bindValue(6, bytes);
 	    }
 	  else
 	    query.bindValue(6, QVariant(QVariant::ByteArray));
@@ -386,29 +391,26 @@ void biblioteq_photographcollection::slotGo(void)
 		  m_row, qmain->getUI().table->columnNumber("Type")) ==
 		 "Photograph Collection")
 		{
-		  qmain->getUI().table->setSortingEnabled(false);
-
 		  QStringList names(qmain->getUI().table->columnNames());
 
 		  for(int i = 0; i < names.size(); i++)
 		    {
 		      if(names.at(i) == "ID" ||
 			 names.at(i) == "ID Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (pc.id_collection->text());
+			qmain->getUI().table->setText
+			  (m_row, i, pc.id_collection->text());
 		      else if(names.at(i) == "Title")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (pc.title_collection->text());
+			qmain->getUI().table->setText
+			  (m_row, i, pc.title_collection->text());
 		      else if(names.at(i) == "Location")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (pc.location->currentText());
+			qmain->getUI().table->setText
+			  (m_row, i, pc.location->currentText());
 		      else if(names.at(i) == "About")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (pc.about_collection->toPlainText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i,
+			   pc.about_collection->toPlainText().trimmed());
 		    }
 
-		  qmain->getUI().table->setSortingEnabled(true);
-
 		  foreach(QLineEdit *textfield, findChildren<QLineEdit *>())
 		    textfield->setCursorPosition(0);
 
@@ -479,14 +481,13 @@ void biblioteq_photographcollection::slotGo(void)
       searchstr = "SELECT DISTINCT photograph_collection.title, "
 	"photograph_collection.id, "
 	"photograph_collection.location, "
-	"COUNT(photograph.myoid) AS photograph_count, "
+	"(SELECT COUNT(*) FROM photograph "
+	"WHERE photograph.collection_oid = "
+	"photograph_collection.myoid) AS photograph_count, "
 	"photograph_collection.about, "
 	"photograph_collection.type, "
-	"photograph_collection.myoid, "
-	"photograph_collection.image_scaled "
-	"FROM photograph_collection LEFT JOIN "
-	"photograph "
-	"ON photograph_collection.myoid = photograph.collection_oid "
+	"photograph_collection.myoid "
+	"FROM photograph_collection "
 	"WHERE ";
       searchstr.append("photograph_collection.id LIKE '%" +
 		       pc.id_collection->text().trimmed() +
@@ -497,21 +498,47 @@ void biblioteq_photographcollection::slotGo(void)
       if(qmain->getDB().driverName() != "QSQLITE")
 	E = "E";
 
-      searchstr.append("photograph_collection.title LIKE " + E + "'%" +
-		       biblioteq_myqstring::escape(pc.title_collection->
-						   text().trimmed()) +
-		       "%' AND ");
+      /*
+      ** The about text is indexed as the keyword column.
+      */
+
+      bool fullText = biblioteq_misc_functions::hasFullTextSearch
+	(qmain->getDB());
+      QString condition("");
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "Photograph Collection", "title",
+	   pc.title_collection->text());
+
+      if(!condition.isEmpty())
+	searchstr.append(condition + " AND ");
+      else
+	searchstr.append("photograph_collection.title LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape(pc.title_collection->
+						     text().trimmed()) +
+			 "%' AND ");
 
       if(pc.location->currentIndex() != 0)
 	searchstr.append("photograph_collection.location = " + E + "'" +
 			 biblioteq_myqstring::escape
 			 (pc.location->currentText().trimmed()) + "' AND ");
 
-      searchstr.append("COALESCE(photograph_collection.about, '') LIKE " +
-		       E + "'%" +
-		       biblioteq_myqstring::escape
-		       (pc.about_collection->toPlainText().trimmed()) +
-		       "%' AND ");
+      condition.clear();
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "Photograph Collection", "keyword",
+	   pc.about_collection->toPlainText());
+
+      if(!condition.isEmpty())
+	searchstr.append(condition + " AND ");
+      else
+	searchstr.append("COALESCE(photograph_collection.about, '') "
+			 "LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape
+			 (pc.about_collection->toPlainText().trimmed()) +
+			 "%' AND ");
       searchstr.append("COALESCE(photograph_collection.notes, '') LIKE " +
 		       E + "'%" +
 		       biblioteq_myqstring::escape
@@ -749,10 +776,7 @@ void biblioteq_photographcollection::modify(const int state,
 	      if(!query.record().field(i).isNull())
 		{
 		  pc.thumbnail_collection->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(pc.thumbnail_collection->m_image.isNull())
-		    pc.thumbnail_collection->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	}
@@ -1177,11 +1201,14 @@ void biblioteq_photographcollection::showPhotographs(const int page)
       if(qmain->getDB().driverName() == "QPSQL")
 	progress.setMaximum(query.size());
 
+      m_thumbnailLoader->clear();
       pc.graphicsView->scene()->clear();
       pc.graphicsView->resetTransform();
       pc.graphicsView->verticalScrollBar()->setValue(0);
       pc.graphicsView->horizontalScrollBar()->setValue(0);
 
+      QPixmap placeholder
+	(QPixmap::fromImage(biblioteq_thumbnail_loader::placeholder()));
       int columnIdx = 0;
       int i = -1;
       int rowIdx = 0;
@@ -1201,29 +1228,14 @@ void biblioteq_photographcollection::showPhotographs(const int page)
 	  if(progress.wasCanceled())
 	    break;
 
-	  QImage image;
 	  biblioteq_graphicsitempixmap *pixmapItem = 0;
 
-	  image.loadFromData
-	    (QByteArray::fromBase64(query.value(0).
-				    toByteArray()));
-
-	  if(image.isNull())
-	    image.loadFromData(query.value(0).toByteArray());
-
-	  if(image.isNull())
-	    image = QImage(":/no_image.png");
-
 	  /*
-	  ** The size of no_image.png is 126x187.
+	  ** The image is decoded and scaled by the thumbnail loader.
 	  */
 
-	  if(!image.isNull())
-	    image = image.scaled
-	      (126, 187, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-
 	  pixmapItem = new(std::nothrow) biblioteq_graphicsitempixmap
-	    (QPixmap::fromImage(image), 0);
+	    (placeholder, 0);
 
 	  if(pixmapItem)
 	    {
@@ -1236,6 +1248,7 @@ void biblioteq_photographcollection::showPhotographs(const int page)
 	      pixmapItem->setData(2, i); // Next / previous navigation.
 	      pixmapItem->setFlag(QGraphicsItem::ItemIsSelectable, true);
 	      pc.graphicsView->scene()->addItem(pixmapItem);
+	      m_thumbnailLoader->load(pixmapItem, query.value(0).toByteArray());
 	    }
 
 	  columnIdx += 1;
@@ -1433,7 +1446,7 @@ void biblioteq_photographcollection::slotInsertItem(void)
   query.bindValue(1, m_oid);
   query.bindValue(2, photo.title_item->text());
   query.bindValue(3, photo.creators_item->toPlainText());
-  query.bindValue(4, photo.publication_date->date().toString("MM/dd/yyyy"));
+  query.bindValue(4, photo.publication_date->date().toString(Qt::ISODate));
   query.bindValue(5, photo.quantity->value());
   query.bindValue(6, photo.medium_item->text());
   query.bindValue(7, photo.reproduction_number_item->toPlainText());
@@ -1456,7 +1469,7 @@ void biblioteq_photographcollection::slotInsertItem(void)
 	{
 	  photo.thumbnail_item->m_image.save
 	    (&buffer, photo.thumbnail_item->m_imageFormat.toLatin1(), 100);
-	  query.bindValue(14, bytes.toBase64());
+	  query.bindValue(14, bytes);
 	}
       else
 	query.bindValue(14, QVariant(QVariant::ByteArray));
@@ -1473,7 +1486,7 @@ void biblioteq_photographcollection::slotInsertItem(void)
 	{
 	  image.save
 	    (&buffer, photo.thumbnail_item->m_imageFormat.toLatin1(), 100);
-	  query.bindValue(15, bytes.toBase64());
+	  query.bindValue(15, bytes);
 	}
       else
 	query.bindValue(15, QVariant(QVariant::ByteArray));
@@ -1662,9 +1675,9 @@ void biblioteq_photographcollection::slotSceneSelectionChanged(void)
 	      else if(fieldname == "pdate")
 		{
 		  pc.publication_date->setDate
-		    (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+		    (biblioteq_misc_functions::dateFromString(var.toString()));
 		  photo.publication_date->setDate
-		    (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+		    (biblioteq_misc_functions::dateFromString(var.toString()));
 		}
 	      else if(fieldname == "quantity")
 		{
@@ -1716,18 +1729,12 @@ void biblioteq_photographcollection::slotSceneSelectionChanged(void)
 		  if(!query.record().field(i).isNull())
 		    {
 		      pc.thumbnail_item->loadFromData
-			(QByteArray::fromBase64(var.toByteArray()));
-
-		      if(pc.thumbnail_item->m_image.isNull())
-			pc.thumbnail_item->loadFromData
-			  (var.toByteArray());
+			(biblioteq_misc_functions::
+			 imageBytes(var.toByteArray()));
 
 		      photo.thumbnail_item->loadFromData
-			(QByteArray::fromBase64(var.toByteArray()));
-
-		      if(photo.thumbnail_item->m_image.isNull())
-			photo.thumbnail_item->loadFromData
-			  (var.toByteArray());
+			(biblioteq_misc_functions::
+			 imageBytes(var.toByteArray()));
 		    }
 		  else
 		    {
@@ -1834,7 +1841,7 @@ void biblioteq_photographcollection::slotUpdateItem(void)
   query.bindValue(0, photo.id_item->text());
   query.bindValue(1, photo.title_item->text());
   query.bindValue(2, photo.creators_item->toPlainText());
-  query.bindValue(3, photo.publication_date->date().toString("MM/dd/yyyy"));
+  query.bindValue(3, photo.publication_date->date().toString(Qt::ISODate));
   query.bindValue(4, photo.quantity->value());
   query.bindValue(5, photo.medium_item->text());
   query.bindValue(6, photo.reproduction_number_item->toPlainText());
@@ -1857,7 +1864,7 @@ void biblioteq_photographcollection::slotUpdateItem(void)
 	{
 	  photo.thumbnail_item->m_image.save
 	    (&buffer, photo.thumbnail_item->m_imageFormat.toLatin1(), 100);
-	  query.bindValue(13, bytes.toBase64());
+	  query.bindValue(13, bytes);
 	}
       else
 	query.bindValue(13, QVariant(QVariant::ByteArray));
@@ -1874,7 +1881,7 @@ void biblioteq_photographcollection::slotUpdateItem(void)
 	{
 	  image.save
 	    (&buffer, photo.thumbnail_item->m_imageFormat.toLatin1(), 100);
-	  query.bindValue(14, bytes.toBase64());
+	  query.bindValue(14, bytes);
 	}
       else
 	query.bindValue(14, QVariant(QVariant::ByteArray));
@@ -2187,17 +2194,12 @@ void biblioteq_photographcollection::loadPhotographFromItem
   if(query.exec())
     if(query.next())
       {
-	QByteArray bytes(QByteArray::fromBase64(query.value(0).toByteArray()));
+	QByteArray bytes
+	  (biblioteq_misc_functions::imageBytes(query.value(0).toByteArray()));
 	QImage image;
 
 	image.loadFromData(bytes);
 
-	if(image.isNull())
-	  {
-	    bytes = query.value(0).toByteArray();
-	    image.loadFromData(bytes);
-	  }
-
 	if(image.isNull())
 	  image = QImage(":/no_image.png");
 
@@ -2458,145 +2460,18 @@ void biblioteq_photographcollection::slotImportItems(void)
   if(files.isEmpty())
     return;
 
-  QProgressDialog progress(this);
-
-#ifdef Q_OS_MAC
-#if QT_VERSION < 0x050000
-  progress.setAttribute(Qt::WA_MacMetalStyle, BIBLIOTEQ_WA_MACMETALSTYLE);
-#endif
-#endif
-  progress.setLabelText(tr("Importing image(s)..."));
-  progress.setMaximum(files.size());
-  progress.setMinimum(0);
-  progress.setModal(true);
-  progress.setWindowTitle(tr("BiblioteQ: Progress Dialog"));
-  progress.show();
-#ifndef Q_OS_MAC
-  progress.repaint();
-  QApplication::processEvents();
-#endif
-
-  int imported = 0;
+  QString errorstr("");
+  biblioteq_photograph_import importer(this);
   int pages = 0;
 
-  for(int i = 0; i < files.size(); i++)
+  if(!importer.import(files, m_oid, errorstr))
     {
-      if(i + 1 <= progress.maximum())
-	progress.setValue(i + 1);
-
-#ifndef Q_OS_MAC
-      progress.repaint();
-      QApplication::processEvents();
-#endif
-
-      if(progress.wasCanceled())
-	break;
-
-      QByteArray bytes1;
-      QFile file(files.at(i).absoluteFilePath());
-
-      if(!file.open(QIODevice::ReadOnly))
-	continue;
-      else
-	bytes1 = file.readAll();
-
-      if(static_cast<qint64> (bytes1.length()) != file.size())
-	continue;
-
-      QImage image;
-
-      if(!image.loadFromData(bytes1))
-	continue;
-
-      QSqlQuery query(qmain->getDB());
-
-      if(qmain->getDB().driverName() != "QSQLITE")
-	query.prepare("INSERT INTO photograph "
-		      "(id, collection_oid, title, creators, pdate, "
-		      "quantity, medium, reproduction_number, "
-		      "copyright, callnumber, other_number, notes, subjects, "
-		      "format, image, image_scaled) "
-		      "VALUES (?, ?, ?, ?, ?, ?, ?, ?, "
-		      "?, ?, ?, ?, ?, ?, ?, ?)");
-      else
-	query.prepare("INSERT INTO photograph "
-		      "(id, collection_oid, title, creators, pdate, "
-		      "quantity, medium, reproduction_number, "
-		      "copyright, callnumber, other_number, notes, subjects, "
-		      "format, image, image_scaled, myoid) "
-		      "VALUES (?, ?, ?, ?, ?, ?, ?, ?, "
-		      "?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
-      QString id("");
-
-#if QT_VERSION >= 0x040700
-      id = QString::number(QDateTime::currentMSecsSinceEpoch() +
-			   static_cast<qint64> (imported));
-#else
-      QDateTime dateTime(QDateTime::currentDateTime());
-
-      id = QString::number(static_cast<qint64> (dateTime.toTime_t()) +
-			   static_cast<qint64> (imported));
-#endif
-
-      query.bindValue(0, id);
-      query.bindValue(1, m_oid);
-      query.bindValue(2, "N/A");
-      query.bindValue(3, "N/A");
-      query.bindValue(4, "01/01/2001");
-      query.bindValue(5, 1);
-      query.bindValue(6, "N/A");
-      query.bindValue(7, "N/A");
-      query.bindValue(8, "N/A");
-      query.bindValue(9, "N/A");
-      query.bindValue(10, "N/A");
-      query.bindValue(11, "N/A");
-      query.bindValue(12, "N/A");
-      query.bindValue(13, "N/A");
-      query.bindValue(14, bytes1.toBase64());
-
-      QBuffer buffer;
-      QByteArray bytes2;
-      QString format(biblioteq_misc_functions::imageFormatGuess(bytes1));
-
-      buffer.setBuffer(&bytes2);
-      buffer.open(QIODevice::WriteOnly);
-
-      if(!image.isNull())
-	image = image.scaled
-	  (126, 187, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-
-      if(image.isNull() || !image.save(&buffer, format.toLatin1().constData(),
-				       100))
-	bytes2 = bytes1;
-
-      query.bindValue(15, bytes2.toBase64());
-
-      if(qmain->getDB().driverName() == "QSQLITE")
-	{
-	  QString errorstr("");
-	  qint64 value = biblioteq_misc_functions::getSqliteUniqueId
-	    (qmain->getDB(),
-	     errorstr);
-
-	  if(errorstr.isEmpty())
-	    query.bindValue(16, value);
-	  else
-	    qmain->addError(QString(tr("Database Error")),
-			    QString(tr("Unable to generate a unique "
-				       "integer.")),
-			    errorstr);
-	}
-
-      if(!query.exec())
+      if(!errorstr.isEmpty())
 	qmain->addError(QString(tr("Database Error")),
 			QString(tr("Unable to import photograph.")),
-			query.lastError().text(), __FILE__, __LINE__);
-      else
-	imported += 1;
+			errorstr, __FILE__, __LINE__);
     }
 
-  progress.close();
 #ifndef Q_OS_MAC
   repaint();
   QApplication::processEvents();
@@ -2636,9 +2511,13 @@ void biblioteq_photographcollection::slotImportItems(void)
   showPhotographs(1);
   QMessageBox::information(this,
 			   tr("BiblioteQ: Information"),
-			   tr("A total of %1 image(s) were imported. "
-			      "The directory %2 contains %3 image(s).").
-			   arg(imported).
+			   tr("A total of %1 image(s) were imported "
+			      "at %2 image(s) per second. "
+			      "%3 duplicate image(s) were skipped. "
+			      "The directory %4 contains %5 image(s).").
+			   arg(importer.imported()).
+			   arg(static_cast<int> (importer.imagesPerSecond())).
+			   arg(importer.duplicates()).
 			   arg(dialog.directory().absolutePath()).
 			   arg(files.size()));
 }
@@ -2723,15 +2602,13 @@ void biblioteq_photographcollection::updateTablePhotographCount
       m_row, qmain->getUI().table->columnNumber("Type")) ==
      "Photograph Collection")
     {
-      qmain->getUI().table->setSortingEnabled(false);
-
       QStringList names(qmain->getUI().table->columnNames());
 
       for(int i = 0; i < names.size(); i++)
 	if(names.at(i) == "Photograph Count")
 	  {
-	    qmain->getUI().table->item(m_row, i)->
-	      setText(QString::number(count));
+	    qmain->getUI().table->setText
+	      (m_row, i, QString::number(count));
 	    qmain->slotDisplaySummary();
 	    break;
 	  }
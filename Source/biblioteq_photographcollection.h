@@ -23,6 +23,7 @@ class biblioteq_bgraphicsscene;
 class biblioteq_borrowers_editor;
 class biblioteq_copy_editor;
 class biblioteq_graphicsitempixmap;
+class biblioteq_thumbnail_loader;
 
 class biblioteq_photographcollection: public QMainWindow, public biblioteq_item
 {
@@ -47,6 +48,7 @@ class biblioteq_photographcollection: public QMainWindow, public biblioteq_item
   Ui_pcDialog pc;
   Ui_photographDialog photo;
   biblioteq_bgraphicsscene *m_scene;
+  biblioteq_thumbnail_loader *m_thumbnailLoader;
   bool verifyItemFields(void);
   void changeEvent(QEvent *event);
   void closeEvent(QCloseEvent *event);
@@ -0,0 +1,306 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QDate>
+#include <QMutexLocker>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq_misc_functions.h"
+#include "biblioteq_query_thread.h"
+
+/*
+** -- biblioteq_query_thread() --
+*/
+
+biblioteq_query_thread::biblioteq_query_thread(QObject *parent):
+  QThread(parent)
+{
+  m_canceled = false;
+  m_connection.m_port = -1;
+}
+
+/*
+** -- ~biblioteq_query_thread() --
+*/
+
+biblioteq_query_thread::~biblioteq_query_thread()
+{
+  cancel();
+  wait();
+}
+
+/*
+** -- cancel() --
+*/
+
+void biblioteq_query_thread::cancel(void)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_canceled = true;
+}
+
+/*
+** -- wasCanceled() --
+*/
+
+bool biblioteq_query_thread::wasCanceled(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_canceled;
+}
+
+/*
+** -- setDatabase() --
+*/
+
+void biblioteq_query_thread::setDatabase(const connection &parameters,
+					 const QString &roles)
+{
+  /*
+  ** A QSqlDatabase may only be used by the thread that created it.
+  ** run() opens a private connection with the session's parameters.
+  */
+
+  m_connection = parameters;
+  m_roles = roles;
+}
+
+/*
+** -- setErrorStr() --
+*/
+
+void biblioteq_query_thread::setErrorStr(const QString &errorstr)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_errorStr = errorstr;
+}
+
+/*
+** -- setQuery() --
+*/
+
+void biblioteq_query_thread::setQuery(const QString &querystr,
+				      const QVariantList &values)
+{
+  m_querystr = querystr;
+  m_values = values;
+}
+
+/*
+** -- getErrorStr() --
+*/
+
+QString biblioteq_query_thread::getErrorStr(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_errorStr;
+}
+
+/*
+** -- getFieldNames() --
+*/
+
+QStringList biblioteq_query_thread::getFieldNames(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_fieldNames;
+}
+
+/*
+** -- hasRows() --
+*/
+
+bool biblioteq_query_thread::hasRows(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return !m_rows.isEmpty();
+}
+
+/*
+** -- takeRows() --
+*/
+
+QList<QVariantList> biblioteq_query_thread::takeRows(void)
+{
+  QMutexLocker locker(&m_mutex);
+  QList<QVariantList> rows(m_rows);
+
+  m_rows.clear();
+  return rows;
+}
+
+/*
+** -- appendRows() --
+*/
+
+void biblioteq_query_thread::appendRows(QList<QVariantList> &rows)
+{
+  if(rows.isEmpty())
+    return;
+
+  {
+    QMutexLocker locker(&m_mutex);
+
+    m_rows.append(rows);
+  }
+
+  rows.clear();
+  emit rowsReady();
+}
+
+/*
+** -- decode() --
+*/
+
+QVariant biblioteq_query_thread::decode(const QString &fieldName,
+					const QVariant &value)
+{
+  if(fieldName.endsWith("front_cover") ||
+     fieldName.endsWith("image_scaled"))
+    {
+      /*
+      ** Images are decoded and scaled by the thumbnail loader.
+      */
+
+      return value.toByteArray();
+    }
+  else if(fieldName.contains("date") || fieldName.contains("membersince"))
+    {
+      QString str(value.toString());
+
+      /*
+      ** Dates are stored as yyyy-MM-dd. Databases which have not been
+      ** upgraded may still contain MM/dd/yyyy dates.
+      */
+
+      if(str.length() == 10 && str.at(4) == '-')
+	return str;
+
+      QDate date(QDate::fromString(str, "MM/dd/yyyy"));
+
+      return date.toString(Qt::ISODate);
+    }
+  else
+    return value;
+}
+
+/*
+** -- processQuery() --
+*/
+
+void biblioteq_query_thread::processQuery(QSqlQuery &query)
+{
+  QList<QVariantList> rows;
+  QSqlRecord record(query.record());
+  QStringList fieldNames;
+  int batchSize = FIRST_BATCH_SIZE;
+
+  for(int i = 0; i < record.count(); i++)
+    fieldNames.append(record.fieldName(i));
+
+  {
+    QMutexLocker locker(&m_mutex);
+
+    m_fieldNames = fieldNames;
+  }
+
+  while(!wasCanceled() && query.next())
+    {
+      QVariantList row;
+
+      for(int i = 0; i < fieldNames.size(); i++)
+	row.append(decode(fieldNames.at(i), query.value(i)));
+
+      rows.append(row);
+
+      if(rows.size() >= batchSize)
+	{
+	  /*
+	  ** Deliver the first screenful as early as possible
+	  ** and then increase the batch size so that the
+	  ** main thread is not flooded with signals.
+	  */
+
+	  appendRows(rows);
+	  batchSize *= 2;
+
+	  if(batchSize > MAXIMUM_BATCH_SIZE)
+	    batchSize = MAXIMUM_BATCH_SIZE;
+	}
+    }
+
+  appendRows(rows);
+}
+
+/*
+** -- run() --
+*/
+
+void biblioteq_query_thread::run(void)
+{
+  QString connectionName
+    (QString("biblioteq_query_thread_%1").
+     arg(reinterpret_cast<quintptr> (this)));
+
+  {
+    QSqlDatabase db(QSqlDatabase::addDatabase(m_connection.m_driverName,
+					      connectionName));
+
+    db.setConnectOptions(m_connection.m_connectOptions);
+    db.setDatabaseName(m_connection.m_databaseName);
+    db.setHostName(m_connection.m_hostName);
+    db.setPort(m_connection.m_port);
+
+    if(db.open(m_connection.m_userName, m_connection.m_password))
+      {
+	QString errorstr("");
+
+	biblioteq_misc_functions::setRole(db, errorstr, m_roles);
+
+	if(errorstr.isEmpty())
+	  {
+	    QSqlQuery query(db);
+	    bool ok = false;
+
+	    query.setForwardOnly(true);
+
+	    if(m_values.isEmpty())
+	      ok = query.exec(m_querystr);
+	    else if((ok = query.prepare(m_querystr)))
+	      {
+		for(int i = 0; i < m_values.size(); i++)
+		  query.addBindValue(m_values.at(i));
+
+		ok = query.exec();
+	      }
+
+	    if(ok)
+	      processQuery(query);
+
+	    if(query.lastError().isValid())
+	      setErrorStr(query.lastError().text());
+	  }
+	else
+	  setErrorStr(errorstr);
+
+	db.close();
+      }
+    else
+      setErrorStr(db.lastError().text());
+  }
+
+  QSqlDatabase::removeDatabase(connectionName);
+}
@@ -0,0 +1,73 @@
+#ifndef _BIBLIOTEQ_QUERY_THREAD_H_
+#define _BIBLIOTEQ_QUERY_THREAD_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QList>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QThread>
+#include <QVariant>
+
+class biblioteq_query_thread: public QThread
+{
+  Q_OBJECT
+
+ public:
+  /*
+  ** The parameters of a session's connection. Each thread opens
+  ** a private connection with them.
+  */
+
+  struct connection
+  {
+    QString m_connectOptions;
+    QString m_databaseName;
+    QString m_driverName;
+    QString m_hostName;
+    QString m_password;
+    QString m_userName;
+    int m_port;
+  };
+
+  static const int FIRST_BATCH_SIZE = 50;
+  static const int MAXIMUM_BATCH_SIZE = 500;
+  biblioteq_query_thread(QObject *parent);
+  ~biblioteq_query_thread();
+  static QVariant decode(const QString &fieldName, const QVariant &value);
+  QList<QVariantList> takeRows(void);
+  QString getErrorStr(void) const;
+  QStringList getFieldNames(void) const;
+  bool hasRows(void) const;
+  bool wasCanceled(void) const;
+  void cancel(void);
+  void run(void);
+  void setDatabase(const connection &parameters, const QString &roles);
+  void setQuery(const QString &querystr,
+		const QVariantList &values = QVariantList());
+
+ protected:
+  mutable QMutex m_mutex;
+  virtual void processQuery(QSqlQuery &query);
+  void setErrorStr(const QString &errorstr);
+
+ private:
+  QList<QVariantList> m_rows;
+  QString m_errorStr;
+  QString m_querystr;
+  QString m_roles;
+  QStringList m_fieldNames;
+  QVariantList m_values;
+  bool m_canceled;
+  connection m_connection;
+  void appendRows(QList<QVariantList> &rows);
+
+ signals:
+  void rowsReady(void);
+};
+
+#endif
@@ -0,0 +1,319 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QFontMetrics>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QPrinter>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq_report_thread.h"
+
+/*
+** -- biblioteq_report_thread() --
+*/
+
+biblioteq_report_thread::biblioteq_report_thread(QObject *parent):
+  QThread(parent)
+{
+  m_canceled = false;
+  m_padding = 1;
+  m_pagesPrinted = 0;
+  m_printer = 0;
+  m_rowsPrinted = 0;
+}
+
+/*
+** -- ~biblioteq_report_thread() --
+*/
+
+biblioteq_report_thread::~biblioteq_report_thread()
+{
+  cancel();
+  wait();
+}
+
+/*
+** -- cancel() --
+*/
+
+void biblioteq_report_thread::cancel(void)
+{
+  QMutexLocker locker(&m_mutex);
+
+  m_canceled = true;
+}
+
+/*
+** -- columnWidths() --
+*/
+
+QVector<int> biblioteq_report_thread::columnWidths
+(const QFontMetrics &fontMetrics,
+ const QFontMetrics &boldMetrics,
+ const int width) const
+{
+  /*
+  ** The natural widths are estimated from the headers and from the
+  ** first rows. If the columns do not fit, they are narrowed in
+  ** proportion and their contents are wrapped.
+  */
+
+  QVector<int> widths(m_headers.size(), 0);
+  qint64 total = 0;
+
+  for(int i = 0; i < m_headers.size(); i++)
+    widths[i] = boldMetrics.width(m_headers.at(i)) + 2 * m_padding;
+
+  for(int i = 0; i < qMin(m_rows.size(), SAMPLE_SIZE); i++)
+    for(int j = 0; j < qMin(m_rows.at(i).size(), widths.size()); j++)
+      {
+	QStringList lines(m_rows.at(i).at(j).split('\n'));
+
+	for(int k = 0; k < lines.size(); k++)
+	  widths[j] = qMax
+	    (widths.at(j),
+	     fontMetrics.width(lines.at(k)) + 2 * m_padding);
+      }
+
+  for(int i = 0; i < widths.size(); i++)
+    total += widths.at(i);
+
+  if(total > width)
+    for(int i = 0; i < widths.size(); i++)
+      widths[i] = qMax
+	(static_cast<int> (widths.at(i) * width / total),
+	 2 * m_padding + 1);
+
+  return widths;
+}
+
+/*
+** -- drawRow() --
+*/
+
+void biblioteq_report_thread::drawRow(QPainter &painter,
+				      const QStringList &row,
+				      const QVector<int> &widths,
+				      const int y,
+				      const int height) const
+{
+  int x = 0;
+
+  for(int i = 0; i < widths.size(); i++)
+    {
+      QRect cell(x, y, widths.at(i), height);
+
+      painter.drawRect(cell);
+      painter.drawText
+	(cell.adjusted(m_padding, m_padding, -m_padding, -m_padding),
+	 Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap,
+	 row.value(i));
+      x += widths.at(i);
+    }
+}
+
+/*
+** -- getErrorStr() --
+*/
+
+QString biblioteq_report_thread::getErrorStr(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_errorStr;
+}
+
+/*
+** -- pagesPrinted() --
+*/
+
+int biblioteq_report_thread::pagesPrinted(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_pagesPrinted;
+}
+
+/*
+** -- rowHeight() --
+*/
+
+int biblioteq_report_thread::rowHeight(const QFontMetrics &fontMetrics,
+				       const QStringList &row,
+				       const QVector<int> &widths) const
+{
+  int height = fontMetrics.height();
+
+  for(int i = 0; i < widths.size(); i++)
+    {
+      QRect rect
+	(fontMetrics.boundingRect
+	 (QRect(0, 0, widths.at(i) - 2 * m_padding, 1000000),
+	  Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap,
+	  row.value(i)));
+
+      height = qMax(height, rect.height());
+    }
+
+  return height + 2 * m_padding;
+}
+
+/*
+** -- rowsPrinted() --
+*/
+
+int biblioteq_report_thread::rowsPrinted(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_rowsPrinted;
+}
+
+/*
+** -- run() --
+*/
+
+void biblioteq_report_thread::run(void)
+{
+  if(!m_printer)
+    return;
+
+  QPainter painter;
+
+  if(!painter.begin(m_printer))
+    {
+      QMutexLocker locker(&m_mutex);
+
+      m_errorStr = tr("Unable to begin printing.");
+      return;
+    }
+
+  QFont font(painter.font());
+
+  font.setPointSize(POINT_SIZE);
+
+  QFont bold(font);
+
+  bold.setBold(true);
+
+  QFontMetrics boldMetrics(bold, m_printer);
+  QFontMetrics fontMetrics(font, m_printer);
+  QRect page(0, 0, m_printer->pageRect().width(),
+	     m_printer->pageRect().height());
+
+  m_padding = qMax(1, fontMetrics.height() / 4);
+
+  QVector<int> widths(columnWidths(fontMetrics, boldMetrics, page.width()));
+  int headerHeight = rowHeight(boldMetrics, m_headers, widths);
+  int pageNumber = 0;
+  int row = 0;
+  int titleHeight = boldMetrics.height() + 2 * m_padding;
+
+  while(!wasCanceled())
+    {
+      if(pageNumber > 0 && !m_printer->newPage())
+	{
+	  QMutexLocker locker(&m_mutex);
+
+	  m_errorStr = tr("Unable to begin a new page.");
+	  break;
+	}
+
+      pageNumber += 1;
+
+      int y = 0;
+
+      painter.setFont(bold);
+      painter.drawText(QRect(0, 0, page.width(), titleHeight),
+		       Qt::AlignLeft | Qt::AlignTop, m_title);
+      painter.drawText(QRect(0, 0, page.width(), titleHeight),
+		       Qt::AlignRight | Qt::AlignTop,
+		       QString(tr("Page %1")).arg(pageNumber));
+      y += titleHeight;
+
+      if(!m_headers.isEmpty())
+	{
+	  drawRow(painter, m_headers, widths, y, headerHeight);
+	  y += headerHeight;
+	}
+
+      painter.setFont(font);
+
+      int printed = 0;
+
+      while(row < m_rows.size())
+	{
+	  int height = rowHeight(fontMetrics, m_rows.at(row), widths);
+
+	  /*
+	  ** A row that is taller than a page is clipped.
+	  */
+
+	  if(y + height > page.height())
+	    {
+	      if(printed > 0)
+		break;
+
+	      height = page.height() - y;
+	    }
+
+	  drawRow(painter, m_rows.at(row), widths, y, height);
+	  printed += 1;
+	  row += 1;
+	  y += height;
+	}
+
+      {
+	QMutexLocker locker(&m_mutex);
+
+	m_pagesPrinted = pageNumber;
+	m_rowsPrinted = row;
+      }
+
+      if(row >= m_rows.size())
+	break;
+    }
+
+  if(wasCanceled())
+    m_printer->abort();
+
+  painter.end();
+}
+
+/*
+** -- setPrinter() --
+*/
+
+void biblioteq_report_thread::setPrinter(QPrinter *printer)
+{
+  m_printer = printer;
+}
+
+/*
+** -- setReport() --
+*/
+
+void biblioteq_report_thread::setReport(const QString &title,
+					const QStringList &headers,
+					const QList<QStringList> &rows)
+{
+  m_headers = headers;
+  m_rows = rows;
+  m_title = title;
+}
+
+/*
+** -- wasCanceled() --
+*/
+
+bool biblioteq_report_thread::wasCanceled(void) const
+{
+  QMutexLocker locker(&m_mutex);
+
+  return m_canceled;
+}
@@ -0,0 +1,71 @@
+#ifndef _BIBLIOTEQ_REPORT_THREAD_H_
+#define _BIBLIOTEQ_REPORT_THREAD_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QList>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+class QFontMetrics;
+class QPainter;
+class QPrinter;
+
+/*
+** Prints a table directly onto a printer, one page at a time. The
+** title and the column headers are repeated on every page. Only the
+** layout of the current row is computed, so the memory that is
+** required does not depend on the number of pages.
+*/
+
+class biblioteq_report_thread: public QThread
+{
+  Q_OBJECT
+
+ public:
+  static const int POINT_SIZE = 8;
+  static const int SAMPLE_SIZE = 250;
+  biblioteq_report_thread(QObject *parent);
+  ~biblioteq_report_thread();
+  QString getErrorStr(void) const;
+  bool wasCanceled(void) const;
+  int pagesPrinted(void) const;
+  int rowsPrinted(void) const;
+  void cancel(void);
+  void setPrinter(QPrinter *printer);
+  void setReport(const QString &title,
+		 const QStringList &headers,
+		 const QList<QStringList> &rows);
+
+ protected:
+  void run(void);
+
+ private:
+  QList<QStringList> m_rows;
+  QPrinter *m_printer;
+  QString m_errorStr;
+  QString m_title;
+  QStringList m_headers;
+  bool m_canceled;
+  int m_padding;
+  int m_pagesPrinted;
+  int m_rowsPrinted;
+  mutable QMutex m_mutex;
+  QVector<int> columnWidths(const QFontMetrics &fontMetrics,
+			    const QFontMetrics &boldMetrics,
+			    const int width) const;
+  int rowHeight(const QFontMetrics &fontMetrics,
+		const QStringList &row,
+		const QVector<int> &widths) const;
+  void drawRow(QPainter &painter,
+	       const QStringList &row,
+	       const QVector<int> &widths,
+	       const int y,
+	       const int height) const;
+};
+
+#endif
@@ -166,6 +166,14 @@ BEGIN									\
 	        type = old.type;					\
 END;									\
 									\
+CREATE TABLE file_chunks						\
+(									\
+    chunk		BYTEA NOT NULL,					\
+    chunk_number	INTEGER NOT NULL,				\
+    file_digest		TEXT NOT NULL,					\
+    PRIMARY KEY(file_digest, chunk_number)				\
+);									\
+									\
 CREATE TABLE grey_literature						\
 (									\
     author		TEXT NOT NULL,					\
@@ -396,6 +404,30 @@ CREATE TABLE item_borrower						\
     FOREIGN KEY(memberid) REFERENCES member ON DELETE RESTRICT		\
 );									\
 									\
+CREATE TABLE item_reservation_counts					\
+(									\
+    item_oid	   BIGINT NOT NULL,					\
+    total_reserved INTEGER NOT NULL DEFAULT 0,				\
+    type	   VARCHAR(16) NOT NULL,				\
+    PRIMARY KEY(item_oid, type)					\
+);									\
+									\
+CREATE TRIGGER item_borrower_insert_trigger AFTER INSERT ON item_borrower \
+FOR EACH row								\
+BEGIN									\
+    INSERT OR IGNORE INTO item_reservation_counts (item_oid, type)	\
+    VALUES (new.item_oid, new.type);					\
+    UPDATE item_reservation_counts SET total_reserved = total_reserved + 1 \
+    WHERE item_oid = new.item_oid AND type = new.type;			\
+END;									\
+									\
+CREATE TRIGGER item_borrower_delete_trigger AFTER DELETE ON item_borrower \
+FOR EACH row								\
+BEGIN									\
+    UPDATE item_reservation_counts SET total_reserved = total_reserved - 1 \
+    WHERE item_oid = old.item_oid AND type = old.type;			\
+END;									\
+									\
 CREATE TABLE member							\
 (									\
     city	     VARCHAR(256) NOT NULL,				\
@@ -512,3 +544,492 @@ CREATE TABLE sequence							\
     value            INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT		\
 );									\
 ";
+
+/*
+** Secondary indexes. The statements may be executed repeatedly.
+** Increase BIBLIOTEQ_SQLITE_INDEXES_VERSION whenever the set changes so
+** that existing databases are brought up to date when they are opened.
+** Version 3 also converts base64-encoded images to binary. Version 4
+** adds the file_chunks table. Version 5 adds the member indexes.
+** Version 6 converts circulation dates to yyyy-MM-dd. Version 7 adds
+** the item_reservation_counts table and its triggers. Version 8 adds
+** the photograph indexes. Version 9 converts the member and
+** publication dates to yyyy-MM-dd.
+*/
+
+#define BIBLIOTEQ_SQLITE_INDEXES_VERSION 9
+
+const char *sqlite_create_indexes_text = "\
+CREATE INDEX IF NOT EXISTS book_myoid_idx ON book(myoid);		\
+CREATE INDEX IF NOT EXISTS cd_myoid_idx ON cd(myoid);			\
+CREATE INDEX IF NOT EXISTS dvd_myoid_idx ON dvd(myoid);			\
+CREATE INDEX IF NOT EXISTS item_borrower_duedate_idx			\
+ON item_borrower(duedate);						\
+CREATE INDEX IF NOT EXISTS item_borrower_item_oid_type_idx		\
+ON item_borrower(item_oid, type);					\
+CREATE INDEX IF NOT EXISTS item_borrower_memberid_idx			\
+ON item_borrower(memberid);						\
+CREATE INDEX IF NOT EXISTS journal_myoid_idx ON journal(myoid);		\
+CREATE INDEX IF NOT EXISTS magazine_myoid_idx ON magazine(myoid);	\
+CREATE INDEX IF NOT EXISTS member_last_name_nocase_idx			\
+ON member(last_name COLLATE NOCASE);					\
+CREATE INDEX IF NOT EXISTS member_memberid_nocase_idx			\
+ON member(memberid COLLATE NOCASE);					\
+CREATE INDEX IF NOT EXISTS member_history_item_oid_type_idx		\
+ON member_history(item_oid, type);					\
+CREATE INDEX IF NOT EXISTS member_history_memberid_idx			\
+ON member_history(memberid);						\
+CREATE INDEX IF NOT EXISTS photograph_collection_myoid_idx		\
+ON photograph_collection(myoid);					\
+CREATE INDEX IF NOT EXISTS photograph_collection_oid_id_idx		\
+ON photograph(collection_oid, id);					\
+CREATE INDEX IF NOT EXISTS photograph_myoid_idx ON photograph(myoid);	\
+CREATE INDEX IF NOT EXISTS videogame_myoid_idx ON videogame(myoid);	\
+UPDATE item_borrower SET duedate =					\
+SUBSTR(duedate, 7, 4) || '-' ||						\
+SUBSTR(duedate, 1, 2) || '-' ||						\
+SUBSTR(duedate, 4, 2)							\
+WHERE duedate LIKE '__/__/____';					\
+UPDATE item_borrower SET reserved_date =				\
+SUBSTR(reserved_date, 7, 4) || '-' ||					\
+SUBSTR(reserved_date, 1, 2) || '-' ||					\
+SUBSTR(reserved_date, 4, 2)						\
+WHERE reserved_date LIKE '__/__/____';					\
+UPDATE member_history SET duedate =					\
+SUBSTR(duedate, 7, 4) || '-' ||						\
+SUBSTR(duedate, 1, 2) || '-' ||						\
+SUBSTR(duedate, 4, 2)							\
+WHERE duedate LIKE '__/__/____';					\
+UPDATE member_history SET reserved_date =				\
+SUBSTR(reserved_date, 7, 4) || '-' ||					\
+SUBSTR(reserved_date, 1, 2) || '-' ||					\
+SUBSTR(reserved_date, 4, 2)						\
+WHERE reserved_date LIKE '__/__/____';					\
+UPDATE member_history SET returned_date =				\
+SUBSTR(returned_date, 7, 4) || '-' ||					\
+SUBSTR(returned_date, 1, 2) || '-' ||					\
+SUBSTR(returned_date, 4, 2)						\
+WHERE returned_date LIKE '__/__/____';					\
+UPDATE book SET pdate =							\
+SUBSTR(pdate, 7, 4) || '-' ||						\
+SUBSTR(pdate, 1, 2) || '-' ||						\
+SUBSTR(pdate, 4, 2)							\
+WHERE pdate LIKE '__/__/____';						\
+UPDATE cd SET rdate =							\
+SUBSTR(rdate, 7, 4) || '-' ||						\
+SUBSTR(rdate, 1, 2) || '-' ||						\
+SUBSTR(rdate, 4, 2)							\
+WHERE rdate LIKE '__/__/____';						\
+UPDATE dvd SET rdate =							\
+SUBSTR(rdate, 7, 4) || '-' ||						\
+SUBSTR(rdate, 1, 2) || '-' ||						\
+SUBSTR(rdate, 4, 2)							\
+WHERE rdate LIKE '__/__/____';						\
+UPDATE journal SET pdate =						\
+SUBSTR(pdate, 7, 4) || '-' ||						\
+SUBSTR(pdate, 1, 2) || '-' ||						\
+SUBSTR(pdate, 4, 2)							\
+WHERE pdate LIKE '__/__/____';						\
+UPDATE magazine SET pdate =						\
+SUBSTR(pdate, 7, 4) || '-' ||						\
+SUBSTR(pdate, 1, 2) || '-' ||						\
+SUBSTR(pdate, 4, 2)							\
+WHERE pdate LIKE '__/__/____';						\
+UPDATE photograph SET pdate =						\
+SUBSTR(pdate, 7, 4) || '-' ||						\
+SUBSTR(pdate, 1, 2) || '-' ||						\
+SUBSTR(pdate, 4, 2)							\
+WHERE pdate LIKE '__/__/____';						\
+UPDATE videogame SET rdate =						\
+SUBSTR(rdate, 7, 4) || '-' ||						\
+SUBSTR(rdate, 1, 2) || '-' ||						\
+SUBSTR(rdate, 4, 2)							\
+WHERE rdate LIKE '__/__/____';						\
+UPDATE member SET dob =							\
+SUBSTR(dob, 7, 4) || '-' ||						\
+SUBSTR(dob, 1, 2) || '-' ||						\
+SUBSTR(dob, 4, 2)							\
+WHERE dob LIKE '__/__/____';						\
+UPDATE member SET expiration_date =					\
+SUBSTR(expiration_date, 7, 4) || '-' ||					\
+SUBSTR(expiration_date, 1, 2) || '-' ||					\
+SUBSTR(expiration_date, 4, 2)						\
+WHERE expiration_date LIKE '__/__/____';				\
+UPDATE member SET membersince =						\
+SUBSTR(membersince, 7, 4) || '-' ||					\
+SUBSTR(membersince, 1, 2) || '-' ||					\
+SUBSTR(membersince, 4, 2)						\
+WHERE membersince LIKE '__/__/____';					\
+CREATE TABLE IF NOT EXISTS file_chunks					\
+(									\
+    chunk		BYTEA NOT NULL,					\
+    chunk_number	INTEGER NOT NULL,				\
+    file_digest		TEXT NOT NULL,					\
+    PRIMARY KEY(file_digest, chunk_number)				\
+);									\
+CREATE TABLE IF NOT EXISTS item_reservation_counts			\
+(									\
+    item_oid		BIGINT NOT NULL,				\
+    total_reserved	INTEGER NOT NULL DEFAULT 0,			\
+    type		VARCHAR(16) NOT NULL,				\
+    PRIMARY KEY(item_oid, type)					\
+);									\
+";
+
+/*
+** Trigger bodies contain semicolons, so the reservation counts'
+** triggers cannot be part of sqlite_create_indexes_text. The counts are
+** recomputed from item_borrower whenever the statements are executed.
+*/
+
+const char *sqlite_create_reservation_counts_statements[] =
+  {
+    "CREATE TRIGGER IF NOT EXISTS item_borrower_insert_trigger "
+    "AFTER INSERT ON item_borrower "
+    "FOR EACH row "
+    "BEGIN "
+    "INSERT OR IGNORE INTO item_reservation_counts (item_oid, type) "
+    "VALUES (new.item_oid, new.type); "
+    "UPDATE item_reservation_counts "
+    "SET total_reserved = total_reserved + 1 "
+    "WHERE item_oid = new.item_oid AND type = new.type; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS item_borrower_delete_trigger "
+    "AFTER DELETE ON item_borrower "
+    "FOR EACH row "
+    "BEGIN "
+    "UPDATE item_reservation_counts "
+    "SET total_reserved = total_reserved - 1 "
+    "WHERE item_oid = old.item_oid AND type = old.type; "
+    "END;",
+    "DELETE FROM item_reservation_counts",
+    "INSERT INTO item_reservation_counts "
+    "(item_oid, total_reserved, type) "
+    "SELECT item_oid, COUNT(*), type FROM item_borrower "
+    "GROUP BY item_oid, type",
+    0
+  };
+
+/*
+** Full-text search. The item_search table is created with FTS5 if
+** available and with FTS4 otherwise. Its rowid is myoid * 16 plus a code
+** that identifies the item's table. See
+** biblioteq_misc_functions::getFullTextSearchCondition().
+*/
+
+const char *sqlite_create_search_fts4_text =
+  "CREATE VIRTUAL TABLE item_search USING fts4"
+  "(title, author, keyword, description, publisher, songs, prefix=\"2,3\")";
+const char *sqlite_create_search_fts5_text =
+  "CREATE VIRTUAL TABLE item_search USING fts5"
+  "(title, author, keyword, description, publisher, songs, prefix='2 3')";
+const char *sqlite_create_search_statements[] =
+  {
+    "CREATE TRIGGER IF NOT EXISTS book_search_insert_trigger "
+    "AFTER INSERT ON book "
+    "FOR EACH row "
+    "BEGIN "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 1, "
+    "new.title, new.author, new.keyword, new.description, "
+    "new.publisher, ''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS book_search_update_trigger "
+    "AFTER UPDATE OF title, author, keyword, description, "
+    "publisher "
+    "ON book "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 1; "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 1, "
+    "new.title, new.author, new.keyword, new.description, "
+    "new.publisher, ''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS book_search_delete_trigger "
+    "AFTER DELETE ON book "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 1; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS cd_search_insert_trigger "
+    "AFTER INSERT ON cd "
+    "FOR EACH row "
+    "BEGIN "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 2, "
+    "new.title, new.artist, new.keyword, new.description, "
+    "new.recording_label, (SELECT "
+    "COALESCE(group_concat(songtitle, ' '), '') FROM cd_songs "
+    "WHERE item_oid = new.myoid)); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS cd_search_update_trigger "
+    "AFTER UPDATE OF title, keyword, description, artist, "
+    "recording_label "
+    "ON cd "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 2; "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 2, "
+    "new.title, new.artist, new.keyword, new.description, "
+    "new.recording_label, (SELECT "
+    "COALESCE(group_concat(songtitle, ' '), '') FROM cd_songs "
+    "WHERE item_oid = new.myoid)); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS cd_search_delete_trigger "
+    "AFTER DELETE ON cd "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 2; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS dvd_search_insert_trigger "
+    "AFTER INSERT ON dvd "
+    "FOR EACH row "
+    "BEGIN "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 3, "
+    "new.title, COALESCE(new.dvdactor, '') || ' ' || "
+    "COALESCE(new.dvddirector, ''), new.keyword, new.description, "
+    "new.studio, ''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS dvd_search_update_trigger "
+    "AFTER UPDATE OF title, keyword, description, dvdactor, "
+    "dvddirector, studio "
+    "ON dvd "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 3; "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 3, "
+    "new.title, COALESCE(new.dvdactor, '') || ' ' || "
+    "COALESCE(new.dvddirector, ''), new.keyword, new.description, "
+    "new.studio, ''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS dvd_search_delete_trigger "
+    "AFTER DELETE ON dvd "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 3; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS journal_search_insert_trigger "
+    "AFTER INSERT ON journal "
+    "FOR EACH row "
+    "BEGIN "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 4, "
+    "new.title, '', new.keyword, new.description, new.publisher, "
+    "''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS journal_search_update_trigger "
+    "AFTER UPDATE OF title, keyword, description, publisher "
+    "ON journal "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 4; "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 4, "
+    "new.title, '', new.keyword, new.description, new.publisher, "
+    "''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS journal_search_delete_trigger "
+    "AFTER DELETE ON journal "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 4; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS magazine_search_insert_trigger "
+    "AFTER INSERT ON magazine "
+    "FOR EACH row "
+    "BEGIN "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 5, "
+    "new.title, '', new.keyword, new.description, new.publisher, "
+    "''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS magazine_search_update_trigger "
+    "AFTER UPDATE OF title, keyword, description, publisher "
+    "ON magazine "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 5; "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 5, "
+    "new.title, '', new.keyword, new.description, new.publisher, "
+    "''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS magazine_search_delete_trigger "
+    "AFTER DELETE ON magazine "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 5; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS "
+    "photograph_collection_search_insert_trigger "
+    "AFTER INSERT ON photograph_collection "
+    "FOR EACH row "
+    "BEGIN "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 6, "
+    "new.title, '', new.about, '', '', ''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS "
+    "photograph_collection_search_update_trigger "
+    "AFTER UPDATE OF title, about "
+    "ON photograph_collection "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 6; "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 6, "
+    "new.title, '', new.about, '', '', ''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS "
+    "photograph_collection_search_delete_trigger "
+    "AFTER DELETE ON photograph_collection "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 6; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS videogame_search_insert_trigger "
+    "AFTER INSERT ON videogame "
+    "FOR EACH row "
+    "BEGIN "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 7, "
+    "new.title, new.developer, new.keyword, new.description, "
+    "new.publisher, ''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS videogame_search_update_trigger "
+    "AFTER UPDATE OF title, keyword, description, publisher, "
+    "developer "
+    "ON videogame "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 7; "
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "VALUES (new.myoid * 16 + 7, "
+    "new.title, new.developer, new.keyword, new.description, "
+    "new.publisher, ''); "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS videogame_search_delete_trigger "
+    "AFTER DELETE ON videogame "
+    "FOR EACH row "
+    "BEGIN "
+    "DELETE FROM item_search WHERE rowid = old.myoid * 16 + 7; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS cd_songs_search_insert_trigger "
+    "AFTER INSERT ON cd_songs "
+    "FOR EACH row "
+    "BEGIN "
+    "UPDATE item_search SET songs = "
+    "(SELECT COALESCE(group_concat(songtitle, ' '), '') FROM "
+    "cd_songs "
+    "WHERE item_oid = new.item_oid) "
+    "WHERE rowid = new.item_oid * 16 + 2; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS cd_songs_search_update_trigger "
+    "AFTER UPDATE ON cd_songs "
+    "FOR EACH row "
+    "BEGIN "
+    "UPDATE item_search SET songs = "
+    "(SELECT COALESCE(group_concat(songtitle, ' '), '') FROM "
+    "cd_songs "
+    "WHERE item_oid = new.item_oid) "
+    "WHERE rowid = new.item_oid * 16 + 2; "
+    "END;",
+    "CREATE TRIGGER IF NOT EXISTS cd_songs_search_delete_trigger "
+    "AFTER DELETE ON cd_songs "
+    "FOR EACH row "
+    "BEGIN "
+    "UPDATE item_search SET songs = "
+    "(SELECT COALESCE(group_concat(songtitle, ' '), '') FROM "
+    "cd_songs "
+    "WHERE item_oid = old.item_oid) "
+    "WHERE rowid = old.item_oid * 16 + 2; "
+    "END;",
+    0
+  };
+const char *sqlite_populate_search_statements[] =
+  {
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "SELECT book.myoid * 16 + 1, "
+    "book.title, book.author, book.keyword, book.description, "
+    "book.publisher, '' "
+    "FROM book",
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "SELECT cd.myoid * 16 + 2, "
+    "cd.title, cd.artist, cd.keyword, cd.description, "
+    "cd.recording_label, (SELECT COALESCE(group_concat(songtitle, "
+    "' '), '') FROM cd_songs WHERE item_oid = cd.myoid) "
+    "FROM cd",
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "SELECT dvd.myoid * 16 + 3, "
+    "dvd.title, COALESCE(dvd.dvdactor, '') || ' ' || "
+    "COALESCE(dvd.dvddirector, ''), dvd.keyword, dvd.description, "
+    "dvd.studio, '' "
+    "FROM dvd",
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "SELECT journal.myoid * 16 + 4, "
+    "journal.title, '', journal.keyword, journal.description, "
+    "journal.publisher, '' "
+    "FROM journal",
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "SELECT magazine.myoid * 16 + 5, "
+    "magazine.title, '', magazine.keyword, magazine.description, "
+    "magazine.publisher, '' "
+    "FROM magazine",
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "SELECT photograph_collection.myoid * 16 + 6, "
+    "photograph_collection.title, '', "
+    "photograph_collection.about, '', '', '' "
+    "FROM photograph_collection",
+    "INSERT INTO item_search "
+    "(rowid, title, author, keyword, description, publisher, "
+    "songs) "
+    "SELECT videogame.myoid * 16 + 7, "
+    "videogame.title, videogame.developer, videogame.keyword, "
+    "videogame.description, videogame.publisher, '' "
+    "FROM videogame",
+    0
+  };
@@ -0,0 +1,533 @@
+/*
+** -- C++ Includes --
+*/
+
+#include <algorithm>
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QNetworkDiskCache>
+#include <QNetworkProxyFactory>
+#include <QNetworkProxyQuery>
+#include <QNetworkRequest>
+#include <QTimer>
+#if QT_VERSION >= 0x050000
+#include <QUrlQuery>
+#endif
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq.h"
+#include "biblioteq_sru_client.h"
+
+extern biblioteq *qmain;
+
+/*
+** -- biblioteq_sru_search() --
+*/
+
+biblioteq_sru_search::biblioteq_sru_search(biblioteq_sru_client *client):
+  QObject(client)
+{
+  m_aborted = false;
+  m_resultCount = 0;
+}
+
+/*
+** -- ~biblioteq_sru_search() --
+*/
+
+biblioteq_sru_search::~biblioteq_sru_search()
+{
+  QHashIterator<QNetworkReply *, response *> it(m_responses);
+
+  while(it.hasNext())
+    {
+      it.next();
+      it.key()->disconnect(this);
+      it.key()->abort();
+      it.key()->deleteLater();
+      delete it.value()->m_reader;
+      delete it.value();
+    }
+
+  m_responses.clear();
+}
+
+/*
+** -- abort() --
+*/
+
+void biblioteq_sru_search::abort(void)
+{
+  /*
+  ** Outstanding replies are discarded. The finished() signal
+  ** is not emitted.
+  */
+
+  if(m_aborted)
+    return;
+
+  m_aborted = true;
+  disconnect(this, SIGNAL(finished(void)), 0, 0);
+  disconnect(this, SIGNAL(resultReady(const QString &, const QByteArray &)),
+	     0, 0);
+  deleteLater();
+}
+
+/*
+** -- addReply() --
+*/
+
+void biblioteq_sru_search::addReply(const QString &site,
+				    QNetworkReply *reply)
+{
+  if(!reply)
+    return;
+
+  response *r = 0;
+
+  if((r = new(std::nothrow) response) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  if((r->m_reader = new(std::nothrow) QXmlStreamReader()) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  r->m_inNumberOfRecords = false;
+  r->m_records = -1;
+  r->m_site = site;
+  m_responses[reply] = r;
+  connect(reply, SIGNAL(error(QNetworkReply::NetworkError)),
+	  this, SLOT(slotError(QNetworkReply::NetworkError)));
+  connect(reply, SIGNAL(finished(void)),
+	  this, SLOT(slotFinished(void)));
+  connect(reply, SIGNAL(readyRead(void)),
+	  this, SLOT(slotReadyRead(void)));
+  connect(reply, SIGNAL(sslErrors(const QList<QSslError> &)),
+	  this, SLOT(slotSslErrors(const QList<QSslError> &)));
+}
+
+/*
+** -- errorString() --
+*/
+
+QString biblioteq_sru_search::errorString(void) const
+{
+  return m_errorString;
+}
+
+/*
+** -- finish() --
+*/
+
+void biblioteq_sru_search::finish(QNetworkReply *reply)
+{
+  response *r = m_responses.take(reply);
+
+  if(!r)
+    return;
+
+  reply->disconnect(this);
+  reply->deleteLater();
+
+  if(r->m_records > 0)
+    {
+      m_resultCount += 1;
+      emit resultReady(r->m_site, r->m_data);
+    }
+
+  delete r->m_reader;
+  delete r;
+
+  if(m_responses.isEmpty() && !m_aborted)
+    {
+      emit finished();
+      deleteLater();
+    }
+}
+
+/*
+** -- parse() --
+*/
+
+void biblioteq_sru_search::parse(response *r)
+{
+  if(!r)
+    return;
+
+  while(!r->m_reader->atEnd())
+    {
+      QXmlStreamReader::TokenType token = r->m_reader->readNext();
+
+      if(token == QXmlStreamReader::Invalid)
+	break;
+      else if(token == QXmlStreamReader::StartElement)
+	{
+	  if(r->m_reader->name().toString().toLower() == "numberofrecords")
+	    {
+	      r->m_inNumberOfRecords = true;
+	      r->m_text.clear();
+	    }
+	}
+      else if(token == QXmlStreamReader::Characters)
+	{
+	  if(r->m_inNumberOfRecords)
+	    r->m_text.append(r->m_reader->text().toString());
+	}
+      else if(token == QXmlStreamReader::EndElement)
+	{
+	  if(r->m_inNumberOfRecords)
+	    {
+	      r->m_inNumberOfRecords = false;
+	      r->m_records = r->m_text.trimmed().toInt();
+	    }
+	}
+    }
+}
+
+/*
+** -- resultCount() --
+*/
+
+int biblioteq_sru_search::resultCount(void) const
+{
+  return m_resultCount;
+}
+
+/*
+** -- slotError() --
+*/
+
+void biblioteq_sru_search::slotError(QNetworkReply::NetworkError error)
+{
+  QNetworkReply *reply = qobject_cast<QNetworkReply *> (sender());
+
+  if(m_errorString.isEmpty())
+    {
+      if(reply)
+	m_errorString = reply->errorString();
+      else
+	m_errorString = QString::number(error);
+    }
+}
+
+/*
+** -- slotFinished() --
+*/
+
+void biblioteq_sru_search::slotFinished(void)
+{
+  QNetworkReply *reply = qobject_cast<QNetworkReply *> (sender());
+
+  if(!reply)
+    return;
+
+  response *r = m_responses.value(reply, 0);
+
+  if(r)
+    {
+      QByteArray data(reply->readAll());
+
+      r->m_data.append(data);
+      r->m_reader->addData(data);
+      parse(r);
+    }
+
+  finish(reply);
+}
+
+/*
+** -- slotNoReplies() --
+*/
+
+void biblioteq_sru_search::slotNoReplies(void)
+{
+  if(m_aborted)
+    return;
+
+  emit finished();
+  deleteLater();
+}
+
+/*
+** -- slotReadyRead() --
+*/
+
+void biblioteq_sru_search::slotReadyRead(void)
+{
+  QNetworkReply *reply = qobject_cast<QNetworkReply *> (sender());
+
+  if(!reply)
+    return;
+
+  response *r = m_responses.value(reply, 0);
+
+  if(!r)
+    return;
+
+  QByteArray data(reply->readAll());
+
+  r->m_data.append(data);
+  r->m_reader->addData(data);
+  parse(r);
+
+  if(r->m_records == 0)
+    {
+      /*
+      ** The site does not have the item. The remainder of
+      ** the response is not required. Aborting a reply reports
+      ** OperationCanceledError, which is not a failure of the search.
+      */
+
+      reply->disconnect(this);
+      reply->abort();
+      finish(reply);
+    }
+}
+
+/*
+** -- slotSslErrors() --
+*/
+
+void biblioteq_sru_search::slotSslErrors(const QList<QSslError> &list)
+{
+  Q_UNUSED(list);
+
+  if(m_errorString.isEmpty())
+    m_errorString = tr("One or more SSL errors occurred. "
+		       "Please verify your settings.");
+}
+
+/*
+** -- start() --
+*/
+
+void biblioteq_sru_search::start(void)
+{
+  if(m_responses.isEmpty())
+    QTimer::singleShot(0, this, SLOT(slotNoReplies(void)));
+}
+
+/*
+** -- biblioteq_sru_client() --
+*/
+
+biblioteq_sru_client::biblioteq_sru_client(QObject *parent):QObject(parent)
+{
+}
+
+/*
+** -- ~biblioteq_sru_client() --
+*/
+
+biblioteq_sru_client::~biblioteq_sru_client()
+{
+  m_managers.clear();
+}
+
+/*
+** -- cachePath() --
+*/
+
+QString biblioteq_sru_client::cachePath(void) const
+{
+  return biblioteq::homePath() + QDir::separator() + "sru";
+}
+
+/*
+** -- manager() --
+*/
+
+QNetworkAccessManager *biblioteq_sru_client::manager
+(const QHash<QString, QString> &hash, const QUrl &url)
+{
+  QNetworkProxy proxy;
+  QString key("");
+  QString type(hash.value("proxy_type").toLower().trimmed());
+
+  if(type == "none")
+    {
+      key = "none";
+      proxy.setType(QNetworkProxy::NoProxy);
+    }
+  else if(type == "http" || type == "socks5")
+    {
+      if(type == "http")
+	proxy.setType(QNetworkProxy::HttpProxy);
+      else
+	proxy.setType(QNetworkProxy::Socks5Proxy);
+
+      proxy.setHostName(hash.value("proxy_host"));
+      proxy.setPort(hash.value("proxy_port").toUShort());
+
+      if(!hash.value("proxy_username").isEmpty())
+	proxy.setUser(hash.value("proxy_username"));
+
+      if(!hash.value("proxy_password").isEmpty())
+	proxy.setPassword(hash.value("proxy_password"));
+    }
+  else if(type == "system")
+    {
+      QList<QNetworkProxy> list;
+      QNetworkProxyQuery query(url);
+
+      list = QNetworkProxyFactory::systemProxyForQuery(query);
+
+      if(!list.isEmpty())
+	proxy = list.at(0);
+    }
+
+  if(key.isEmpty() && !type.isEmpty())
+    key = QString("%1:%2:%3:%4:%5").
+      arg(proxy.type()).
+      arg(proxy.hostName()).
+      arg(proxy.port()).
+      arg(proxy.user()).
+      arg(proxy.password());
+
+  if(m_managers.contains(key))
+    return m_managers.value(key);
+
+  QNetworkAccessManager *manager = 0;
+  QNetworkDiskCache *cache = 0;
+
+  if((manager = new(std::nothrow) QNetworkAccessManager(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  if((cache = new(std::nothrow) QNetworkDiskCache(manager)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  /*
+  ** Each manager requires its own cache directory.
+  */
+
+  QCryptographicHash digest(QCryptographicHash::Sha1);
+
+  digest.addData(key.toUtf8());
+  cache->setCacheDirectory(cachePath() + QDir::separator() +
+			   digest.result().toHex().left(16));
+  cache->setMaximumCacheSize(16 * 1024 * 1024);
+  manager->setCache(cache);
+
+  if(!type.isEmpty())
+    manager->setProxy(proxy);
+
+  if(type == "http" || type == "socks5" || type == "system")
+    {
+      /*
+      ** This is required to resolve an odd error.
+      */
+
+      QNetworkReply *reply = manager->get
+	(QNetworkRequest(QUrl::fromUserInput("http://0.0.0.0")));
+
+      if(reply)
+	reply->deleteLater();
+    }
+
+  m_managers[key] = manager;
+  return manager;
+}
+
+/*
+** -- normalizedUrl() --
+*/
+
+QUrl biblioteq_sru_client::normalizedUrl(const QUrl &url)
+{
+  /*
+  ** Equivalent queries should share cache entries. The scheme and
+  ** host are case-insensitive and the order of the query's
+  ** parameters is not significant.
+  */
+
+  QUrl normalized(url);
+
+  normalized.setFragment(QString());
+  normalized.setHost(url.host().toLower());
+  normalized.setScheme(url.scheme().toLower());
+
+#if QT_VERSION >= 0x050000
+  QList<QPair<QString, QString> > items
+    (QUrlQuery(url).queryItems(QUrl::FullyDecoded));
+  QUrlQuery query;
+
+  std::sort(items.begin(), items.end());
+  query.setQueryItems(items);
+  normalized.setQuery(query);
+#else
+  QList<QPair<QString, QString> > items(url.queryItems());
+
+  std::sort(items.begin(), items.end());
+  normalized.setQueryItems(items);
+#endif
+
+  if(normalized.port() == 80 && normalized.scheme() == "http")
+    normalized.setPort(-1);
+  else if(normalized.port() == 443 && normalized.scheme() == "https")
+    normalized.setPort(-1);
+
+  return normalized;
+}
+
+/*
+** -- search() --
+*/
+
+biblioteq_sru_search *biblioteq_sru_client::search
+(const QMap<QString, QUrl> &urls, QObject *authenticationReceiver)
+{
+  biblioteq_sru_search *search = 0;
+
+  if((search = new(std::nothrow) biblioteq_sru_search(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  QMapIterator<QString, QUrl> it(urls);
+
+  while(it.hasNext())
+    {
+      it.next();
+
+      QNetworkAccessManager *manager = this->manager
+	(qmain->getSRUMaps().value(it.key()), it.value());
+
+      if(authenticationReceiver)
+	{
+	  /*
+	  ** Credentials are requested from the window which
+	  ** issued the most recent query.
+	  */
+
+	  disconnect
+	    (manager,
+	     SIGNAL(proxyAuthenticationRequired(const QNetworkProxy &,
+						QAuthenticator *)),
+	     0, 0);
+	  connect
+	    (manager,
+	     SIGNAL(proxyAuthenticationRequired(const QNetworkProxy &,
+						QAuthenticator *)),
+	     authenticationReceiver,
+	     SLOT(slotProxyAuthenticationRequired(const QNetworkProxy &,
+						  QAuthenticator *)));
+	}
+
+      QNetworkRequest request(normalizedUrl(it.value()));
+
+      request.setAttribute(QNetworkRequest::CacheLoadControlAttribute,
+			   QNetworkRequest::PreferCache);
+      request.setAttribute(QNetworkRequest::CacheSaveControlAttribute,
+			   true);
+      request.setRawHeader("Connection", "keep-alive");
+      search->addReply(it.key(), manager->get(request));
+    }
+
+  search->start();
+  return search;
+}
@@ -0,0 +1,98 @@
+#ifndef _BIBLIOTEQ_SRU_CLIENT_H_
+#define _BIBLIOTEQ_SRU_CLIENT_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QAuthenticator>
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+#include <QNetworkReply>
+#include <QObject>
+#include <QPointer>
+#include <QSslError>
+#include <QStringList>
+#include <QUrl>
+#include <QXmlStreamReader>
+
+class biblioteq_sru_client;
+
+/*
+** A single query which is sent to several SRU sites at once. Each
+** response is parsed as it arrives. A site which reports that it has
+** no records is abandoned as soon as it says so.
+*/
+
+class biblioteq_sru_search: public QObject
+{
+  Q_OBJECT
+
+ public:
+  biblioteq_sru_search(biblioteq_sru_client *client);
+  ~biblioteq_sru_search();
+  QString errorString(void) const;
+  int resultCount(void) const;
+  void abort(void);
+  void addReply(const QString &site, QNetworkReply *reply);
+  void start(void);
+
+ private:
+  struct response
+  {
+    QByteArray m_data;
+    QString m_site;
+    QString m_text;
+    QXmlStreamReader *m_reader;
+    bool m_inNumberOfRecords;
+    int m_records;
+  };
+
+  QHash<QNetworkReply *, response *> m_responses;
+  QString m_errorString;
+  bool m_aborted;
+  int m_resultCount;
+  void finish(QNetworkReply *reply);
+  void parse(response *r);
+
+ private slots:
+  void slotError(QNetworkReply::NetworkError error);
+  void slotFinished(void);
+  void slotNoReplies(void);
+  void slotReadyRead(void);
+  void slotSslErrors(const QList<QSslError> &list);
+
+ signals:
+  void finished(void);
+  void resultReady(const QString &site, const QByteArray &data);
+};
+
+/*
+** The application's SRU client. Network access managers, and thus
+** their persistent connections, are shared by all windows. One
+** manager exists per distinct proxy configuration. Responses are
+** kept in a disk cache and are keyed by their normalized URLs.
+*/
+
+class biblioteq_sru_client: public QObject
+{
+  Q_OBJECT
+
+ public:
+  biblioteq_sru_client(QObject *parent);
+  ~biblioteq_sru_client();
+  static QUrl normalizedUrl(const QUrl &url);
+  biblioteq_sru_search *search(const QMap<QString, QUrl> &urls,
+			       QObject *authenticationReceiver);
+
+ private:
+  QHash<QString, QNetworkAccessManager *> m_managers;
+  QString cachePath(void) const;
+  QNetworkAccessManager *manager(const QHash<QString, QString> &hash,
+				 const QUrl &url);
+};
+
+#endif
@@ -0,0 +1,297 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QPointer>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq.h"
+#include "biblioteq_graphicsitempixmap.h"
+#include "biblioteq_thumbnail_loader.h"
+
+/*
+** Produces a single thumbnail on one of the pool's threads.
+*/
+
+class biblioteq_thumbnail_task: public QRunnable
+{
+ public:
+  biblioteq_thumbnail_task(biblioteq_thumbnail_loader *loader,
+			   const QByteArray &data,
+			   const int id):QRunnable()
+  {
+    m_data = data;
+    m_id = id;
+    m_loader = loader;
+    setAutoDelete(true);
+  }
+
+  void run(void)
+  {
+    QImage image(biblioteq_thumbnail_loader::thumbnail(m_data));
+
+    m_data.clear();
+    QMetaObject::invokeMethod(m_loader,
+			      "slotThumbnailReady",
+			      Qt::QueuedConnection,
+			      Q_ARG(int, m_id),
+			      Q_ARG(QImage, image));
+  }
+
+ private:
+  QByteArray m_data;
+  biblioteq_thumbnail_loader *m_loader;
+  int m_id;
+};
+
+/*
+** Removes expired thumbnails on one of the pool's threads.
+*/
+
+class biblioteq_thumbnail_prune_task: public QRunnable
+{
+ public:
+  biblioteq_thumbnail_prune_task(void):QRunnable()
+  {
+    setAutoDelete(true);
+  }
+
+  void run(void)
+  {
+    biblioteq_thumbnail_loader::prune();
+  }
+};
+
+/*
+** -- biblioteq_thumbnail_loader() --
+*/
+
+biblioteq_thumbnail_loader::biblioteq_thumbnail_loader(QObject *parent):
+  QObject(parent)
+{
+  m_id = 0;
+
+  if((m_pool = new(std::nothrow) QThreadPool(this)) == 0)
+    biblioteq::quit("Memory allocation failure", __FILE__, __LINE__);
+
+  m_pool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+  QDir().mkpath(cachePath());
+
+  biblioteq_thumbnail_prune_task *task = 0;
+
+  if((task = new(std::nothrow) biblioteq_thumbnail_prune_task()) != 0)
+    m_pool->start(task);
+}
+
+/*
+** -- ~biblioteq_thumbnail_loader() --
+*/
+
+biblioteq_thumbnail_loader::~biblioteq_thumbnail_loader()
+{
+  /*
+  ** Tasks refer to this object. They must complete before
+  ** it is destroyed.
+  */
+
+  clear();
+  m_pool->waitForDone();
+}
+
+/*
+** -- cachePath() --
+*/
+
+QString biblioteq_thumbnail_loader::cachePath(void)
+{
+  return biblioteq::homePath() + QDir::separator() + "thumbnails";
+}
+
+/*
+** -- clear() --
+*/
+
+void biblioteq_thumbnail_loader::clear(void)
+{
+  /*
+  ** Tasks that are already running will deliver results for
+  ** unknown identifiers. Such results are discarded.
+  */
+
+#if QT_VERSION >= 0x050200
+  m_pool->clear();
+#endif
+
+  QHashIterator<biblioteq_graphicsitempixmap *, int> it(m_ids);
+
+  while(it.hasNext())
+    {
+      it.next();
+      it.key()->setThumbnailLoader(0);
+    }
+
+  m_ids.clear();
+  m_items.clear();
+}
+
+/*
+** -- forget() --
+*/
+
+void biblioteq_thumbnail_loader::forget(biblioteq_graphicsitempixmap *item)
+{
+  if(m_ids.contains(item))
+    m_items.remove(m_ids.take(item));
+}
+
+/*
+** -- load() --
+*/
+
+void biblioteq_thumbnail_loader::load(biblioteq_graphicsitempixmap *item,
+				      const QByteArray &data)
+{
+  if(!item)
+    return;
+
+  forget(item);
+
+  if(data.isEmpty())
+    {
+      item->setPixmap(QPixmap::fromImage(placeholder()));
+      return;
+    }
+
+  biblioteq_thumbnail_task *task = 0;
+
+  m_id += 1;
+
+  if(m_id <= 0)
+    m_id = 1;
+
+  if((task = new(std::nothrow) biblioteq_thumbnail_task(this, data,
+							m_id)) == 0)
+    {
+      item->setPixmap(QPixmap::fromImage(placeholder()));
+      return;
+    }
+
+  item->setThumbnailLoader(this);
+  m_ids[item] = m_id;
+  m_items[m_id] = item;
+  m_pool->start(task);
+}
+
+/*
+** -- placeholder() --
+*/
+
+QImage biblioteq_thumbnail_loader::placeholder(void)
+{
+  /*
+  ** The size of no_image.png is 126x187.
+  */
+
+  return QImage(":/no_image.png");
+}
+
+/*
+** -- prune() --
+*/
+
+void biblioteq_thumbnail_loader::prune(void)
+{
+  /*
+  ** Temporary files which were left behind are also removed.
+  */
+
+  QDateTime now(QDateTime::currentDateTime());
+  QFileInfoList list
+    (QDir(cachePath()).entryInfoList(QDir::Files | QDir::NoDotAndDotDot));
+
+  for(int i = 0; i < list.size(); i++)
+    if(list.at(i).lastModified().secsTo(now) > CACHE_LIFETIME)
+      QFile::remove(list.at(i).absoluteFilePath());
+}
+
+/*
+** -- slotThumbnailReady() --
+*/
+
+void biblioteq_thumbnail_loader::slotThumbnailReady(const int id,
+						    const QImage &image)
+{
+  biblioteq_graphicsitempixmap *item = m_items.take(id);
+
+  if(!item)
+    return;
+
+  m_ids.remove(item);
+  item->setThumbnailLoader(0);
+  item->setPixmap(QPixmap::fromImage(image));
+}
+
+/*
+** -- thumbnail() --
+*/
+
+QImage biblioteq_thumbnail_loader::thumbnail(const QByteArray &data)
+{
+  if(data.isEmpty())
+    return placeholder();
+
+  QCryptographicHash digest(QCryptographicHash::Sha1);
+  QImage image;
+
+  digest.addData(data);
+
+  QString fileName(cachePath() + QDir::separator() +
+		   digest.result().toHex() + ".png");
+
+  QFileInfo fileInfo(fileName);
+
+  if(fileInfo.exists())
+    {
+      if(fileInfo.lastModified().
+	 secsTo(QDateTime::currentDateTime()) > CACHE_LIFETIME)
+	QFile::remove(fileName);
+      else if(image.load(fileName, "PNG"))
+	return image;
+    }
+
+  image.loadFromData(biblioteq_misc_functions::imageBytes(data));
+
+  if(image.isNull())
+    return placeholder();
+
+  image = image.scaled
+    (THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT,
+     Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+  /*
+  ** Several threads may produce the same thumbnail. Each writes
+  ** to a private file which is then renamed.
+  */
+
+  QString temporary
+    (fileName + "." +
+     QString::number(reinterpret_cast<quintptr> (QThread::currentThread())));
+
+  if(image.save(temporary, "PNG"))
+    if(!QFile::rename(temporary, fileName))
+      QFile::remove(temporary);
+
+  return image;
+}
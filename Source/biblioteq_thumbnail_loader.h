@@ -0,0 +1,52 @@
+#ifndef _BIBLIOTEQ_THUMBNAIL_LOADER_H_
+#define _BIBLIOTEQ_THUMBNAIL_LOADER_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+
+class QThreadPool;
+class biblioteq_graphicsitempixmap;
+
+/*
+** Decodes and scales cover images on a pool of threads. Items are
+** displayed with a placeholder pixmap until their thumbnails are
+** available. Thumbnails are cached on disk, keyed by a digest of the
+** stored image, so that a cover is only decoded once. Cached
+** thumbnails expire after CACHE_LIFETIME seconds.
+*/
+
+class biblioteq_thumbnail_loader: public QObject
+{
+  Q_OBJECT
+
+ public:
+  static const int CACHE_LIFETIME = 7 * 24 * 60 * 60; // Seconds.
+  static const int THUMBNAIL_HEIGHT = 187;
+  static const int THUMBNAIL_WIDTH = 126;
+  biblioteq_thumbnail_loader(QObject *parent);
+  ~biblioteq_thumbnail_loader();
+  static QImage placeholder(void);
+  static QImage thumbnail(const QByteArray &data);
+  static QString cachePath(void);
+  static void prune(void);
+  void clear(void);
+  void forget(biblioteq_graphicsitempixmap *item);
+  void load(biblioteq_graphicsitempixmap *item, const QByteArray &data);
+
+ private:
+  QHash<biblioteq_graphicsitempixmap *, int> m_ids;
+  QHash<int, biblioteq_graphicsitempixmap *> m_items;
+  QThreadPool *m_pool;
+  int m_id;
+
+ private slots:
+  void slotThumbnailReady(const int id, const QImage &image);
+};
+
+#endif
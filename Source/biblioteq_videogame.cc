@@ -429,7 +429,7 @@ void biblioteq_videogame::slotGo(void)
       query.bindValue(1, vg.title->text());
       query.bindValue(2, vg.rating->currentText().trimmed());
       query.bindValue(3, vg.developer->toPlainText().trimmed());
-      query.bindValue(4, vg.release_date->date().toString("MM/dd/yyyy"));
+      query.bindValue(4, vg.release_date->date().toString(Qt::ISODate));
       query.bindValue(5, vg.publisher->toPlainText().trimmed());
       query.bindValue(6, vg.genre->toPlainText().trimmed());
       query.bindValue(7, vg.price->value());
@@ -450,7 +450,7 @@ void biblioteq_videogame::slotGo(void)
 	    {
 	      vg.front_image->m_image.save
 		(&buffer, vg.front_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(15, bytes.toBase64());
+	      query.bindValue(15, bytes);
 	    }
 	  else
 	    query.bindValue(15, QVariant(QVariant::ByteArray));
@@ -470,7 +470,7 @@ void biblioteq_videogame::slotGo(void)
 	    {
 	      vg.back_image->m_image.save
 		(&buffer, vg.back_image->m_imageFormat.toLatin1(), 100);
-	      query.bindValue(16, bytes.toBase64());
+	      query.bindValue(16, bytes);
 	    }
 	  else
 	    query.bindValue(16, QVariant(QVariant::ByteArray));
@@ -628,62 +628,62 @@ void biblioteq_videogame::slotGo(void)
 		  m_row, qmain->getUI().table->columnNumber("Type")) ==
 		 "Video Game")
 		{
-		  qmain->getUI().table->setSortingEnabled(false);
-
 		  QStringList names(qmain->getUI().table->columnNames());
 
 		  for(i = 0; i < names.size(); i++)
 		    {
 		      if(names.at(i) == "UPC" ||
 			 names.at(i) == "ID Number")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.id->text());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.id->text());
 		      else if(names.at(i) == "Title")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.title->text());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.title->text());
 		      else if(names.at(i) == "Game Rating")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.rating->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.rating->currentText().trimmed());
 		      else if(names.at(i) == "Release Date" ||
 			      names.at(i) == "Publication Date")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.release_date->date().toString
+			qmain->getUI().table->setText
+			  (m_row, i, vg.release_date->date().toString
 			   (Qt::ISODate));
 		      else if(names.at(i) == "Publisher")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.publisher->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.publisher->toPlainText());
 		      else if(names.at(i) == "Place of Publication")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.place->toPlainText());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.place->toPlainText());
 		      else if(names.at(i) == "Genres" ||
 			      names.at(i) == "Categories")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.genre->toPlainText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.genre->toPlainText().trimmed());
 		      else if(names.at(i) == "Price")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.price->cleanText());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.price->cleanText());
 		      else if(names.at(i) == "Language")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.language->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.language->currentText().trimmed());
 		      else if(names.at(i) == "Monetary Units")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.monetary_units->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i,
+			   vg.monetary_units->currentText().trimmed());
 		      else if(names.at(i) == "Quantity")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.quantity->text());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.quantity->text());
 		      else if(names.at(i) == "Platform")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.platform->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.platform->currentText().trimmed());
 		      else if(names.at(i) == "Location")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.location->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.location->currentText().trimmed());
 		      else if(names.at(i) == "Mode")
-			qmain->getUI().table->item(m_row, i)->setText
-			  (vg.mode->currentText().trimmed());
+			qmain->getUI().table->setText
+			  (m_row, i, vg.mode->currentText().trimmed());
 		      else if(names.at(i) == "Availability")
 			{
-			  qmain->getUI().table->item(m_row, i)->setText
-			    (biblioteq_misc_functions::getAvailability
+			  qmain->getUI().table->setText
+			    (m_row, i,
+			     biblioteq_misc_functions::getAvailability
 			     (m_oid, qmain->getDB(), "Video Game",
 			      errorstr));
 
@@ -695,8 +695,6 @@ void biblioteq_videogame::slotGo(void)
 			}
 		    }
 
-		  qmain->getUI().table->setSortingEnabled(true);
-
 		  foreach(QLineEdit *textfield, findChildren<QLineEdit *>())
 		    textfield->setCursorPosition(0);
 
@@ -760,7 +758,7 @@ void biblioteq_videogame::slotGo(void)
     }
   else
     {
-      searchstr = "SELECT DISTINCT videogame.title, "
+      searchstr = "SELECT videogame.title, "
 	"videogame.vgrating, "
 	"videogame.vgplatform, "
 	"videogame.vgmode, "
@@ -769,16 +767,15 @@ void biblioteq_videogame::slotGo(void)
 	"videogame.price, videogame.monetary_units, "
 	"videogame.quantity, "
 	"videogame.location, "
-	"videogame.quantity - COUNT(item_borrower_vw.item_oid) "
+	"videogame.quantity - COALESCE(irc.total_reserved, 0) "
 	"AS availability, "
-	"COUNT(item_borrower_vw.item_oid) AS total_reserved, "
+	"COALESCE(irc.total_reserved, 0) AS total_reserved, "
 	"videogame.type, "
-	"videogame.myoid, "
-	"videogame.front_cover "
+	"videogame.myoid "
 	"FROM "
-	"videogame LEFT JOIN item_borrower_vw ON "
-	"videogame.myoid = item_borrower_vw.item_oid "
-	"AND item_borrower_vw.type = 'Video Game' "
+	"videogame LEFT JOIN item_reservation_counts irc ON "
+	"videogame.myoid = irc.item_oid "
+	"AND irc.type = 'Video Game' "
 	"WHERE ";
       searchstr.append("id LIKE '%" + vg.id->text().trimmed() +
 		       "%' AND ");
@@ -788,10 +785,21 @@ void biblioteq_videogame::slotGo(void)
       if(qmain->getDB().driverName() != "QSQLITE")
 	E = "E";
 
-      searchstr.append("title LIKE " + E + "'%" +
-		       biblioteq_myqstring::escape
-		       (vg.title->text().trimmed()) +
-		       "%' AND ");
+      bool fullText = biblioteq_misc_functions::hasFullTextSearch
+	(qmain->getDB());
+      QString condition("");
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "Video Game", "title", vg.title->text());
+
+      if(!condition.isEmpty())
+	searchstr.append(condition + " AND ");
+      else
+	searchstr.append("title LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape
+			 (vg.title->text().trimmed()) +
+			 "%' AND ");
 
       if(vg.rating->currentIndex() != 0)
 	searchstr.append("vgrating = " + E + "'" +
@@ -805,9 +813,9 @@ void biblioteq_videogame::slotGo(void)
 		       "AND ");
 
       if(vg.release_date->date().toString("MM/yyyy") != "01/7999")
-	searchstr.append("SUBSTR(rdate, 1, 3) || SUBSTR(rdate, 7) = '" +
+	searchstr.append("SUBSTR(rdate, 1, 7) = '" +
 			 vg.release_date->date().toString
-			 ("MM/yyyy") +
+			 ("yyyy-MM") +
 			 "' AND ");
 
       searchstr.append("publisher LIKE " + E + "'%" +
@@ -866,9 +874,18 @@ void biblioteq_videogame::slotGo(void)
 			 biblioteq_myqstring::escape
 			 (vg.mode->currentText().trimmed()) + "' ");
 
-      searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
-		       biblioteq_myqstring::escape
-		       (vg.keyword->toPlainText().trimmed()) + "%' ");
+      condition.clear();
+
+      if(fullText)
+	condition = biblioteq_misc_functions::getFullTextSearchCondition
+	  (qmain->getDB(), "Video Game", "keyword", vg.keyword->toPlainText());
+
+      if(!condition.isEmpty())
+	searchstr.append("AND " + condition + " ");
+      else
+	searchstr.append("AND COALESCE(keyword, '') LIKE " + E + "'%" +
+			 biblioteq_myqstring::escape
+			 (vg.keyword->toPlainText().trimmed()) + "%' ");
 
       /*
       ** Search the database.
@@ -1118,7 +1135,7 @@ void biblioteq_videogame::modify(const int state)
 	       var.toString());
 	  else if(fieldname == "rdate")
 	    vg.release_date->setDate
-	      (QDate::fromString(var.toString(), "MM/dd/yyyy"));
+	      (biblioteq_misc_functions::dateFromString(var.toString()));
 	  else if(fieldname == "vgrating")
 	    {
 	      if(vg.rating->findText(var.toString()) > -1)
@@ -1211,10 +1228,7 @@ void biblioteq_videogame::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  vg.front_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(vg.front_image->m_image.isNull())
-		    vg.front_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	  else if(fieldname == "back_cover")
@@ -1222,10 +1236,7 @@ void biblioteq_videogame::modify(const int state)
 	      if(!query.record().field(i).isNull())
 		{
 		  vg.back_image->loadFromData
-		    (QByteArray::fromBase64(var.toByteArray()));
-
-		  if(vg.back_image->m_image.isNull())
-		    vg.back_image->loadFromData(var.toByteArray());
+		    (biblioteq_misc_functions::imageBytes(var.toByteArray()));
 		}
 	    }
 	}
@@ -0,0 +1,393 @@
+/*
+** -- Qt Includes --
+*/
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+
+/*
+** -- Local Includes --
+*/
+
+#include "biblioteq.h"
+#include "biblioteq_z3950_pool.h"
+
+QHash<QString, QList<QByteArray> > biblioteq_z3950_pool::s_records;
+QList<biblioteq_z3950_pool::entry> biblioteq_z3950_pool::s_busy;
+QList<biblioteq_z3950_pool::entry> biblioteq_z3950_pool::s_idle;
+QMutex biblioteq_z3950_pool::s_mutex;
+
+/*
+** -- biblioteq_z3950_pool() --
+*/
+
+biblioteq_z3950_pool::biblioteq_z3950_pool(void)
+{
+}
+
+/*
+** -- acquire() --
+*/
+
+ZOOM_connection biblioteq_z3950_pool::acquire
+(const QString &site,
+ const QHash<QString, QString> &hash,
+ const int count,
+ bool *reused)
+{
+  QMutexLocker locker(&s_mutex);
+  QString fp(fingerprint(hash, count));
+
+  if(reused)
+    *reused = false;
+
+  prune();
+
+  for(int i = 0; i < s_idle.size(); i++)
+    if(s_idle.at(i).m_fingerprint == fp && s_idle.at(i).m_site == site)
+      {
+	entry e(s_idle.takeAt(i));
+
+	e.m_lastUsed = QDateTime::currentDateTime();
+	s_busy.append(e);
+
+	if(reused)
+	  *reused = true;
+
+	return e.m_connection;
+      }
+
+  locker.unlock();
+
+  QString recordSyntax(hash.value("RecordSyntax").trimmed());
+  entry e;
+
+  e.m_fingerprint = fp;
+  e.m_lastUsed = QDateTime::currentDateTime();
+  e.m_options = ZOOM_options_create();
+  e.m_site = site;
+  ZOOM_options_set(e.m_options, "async", "1");
+  ZOOM_options_set
+    (e.m_options, "count", QString::number(count).toLatin1().constData());
+  ZOOM_options_set
+    (e.m_options,
+     "databaseName",
+     hash.value("Database").toLatin1().constData());
+
+  if(recordSyntax.isEmpty())
+    ZOOM_options_set(e.m_options, "preferredRecordSyntax", "MARC21");
+  else
+    ZOOM_options_set(e.m_options, "preferredRecordSyntax",
+		     recordSyntax.toLatin1().constData());
+
+  if(!hash.value("proxy_host").isEmpty() &&
+     !hash.value("proxy_port").isEmpty())
+    {
+      QString value(QString("%1:%2").
+		    arg(hash.value("proxy_host")).
+		    arg(hash.value("proxy_port")));
+
+      ZOOM_options_set(e.m_options, "proxy", value.toLatin1().constData());
+    }
+
+  if(!hash.value("Userid").isEmpty())
+    ZOOM_options_set
+      (e.m_options,
+       "user",
+       hash.value("Userid").toLatin1().constData());
+
+  if(!hash.value("Password").isEmpty())
+    ZOOM_options_set
+      (e.m_options,
+       "password",
+       hash.value("Password").toLatin1().constData());
+
+  e.m_connection = ZOOM_connection_create(e.m_options);
+  ZOOM_connection_connect
+    (e.m_connection, (hash.value("Address") + ":" +
+		      hash.value("Port")).toLatin1().constData(), 0);
+  locker.relock();
+  s_busy.append(e);
+  return e.m_connection;
+}
+
+/*
+** -- cacheKey() --
+*/
+
+QString biblioteq_z3950_pool::cacheKey(const QString &site,
+				       const QHash<QString, QString> &hash,
+				       const QString &identifier)
+{
+  if(identifier.isEmpty())
+    return "";
+
+  QString recordSyntax(hash.value("RecordSyntax").trimmed());
+
+  if(recordSyntax.isEmpty())
+    recordSyntax = "MARC21";
+
+  /*
+  ** Records are cached in their ISO 2709 form.
+  */
+
+  return "iso2709\n" +
+    site + "\n" +
+    recordSyntax + "\n" +
+    hash.value("Format").trimmed().toLower() + "\n" +
+    identifier;
+}
+
+/*
+** -- cachePath() --
+*/
+
+QString biblioteq_z3950_pool::cachePath(void)
+{
+  return biblioteq::homePath() + QDir::separator() + "z3950";
+}
+
+/*
+** -- cacheRecords() --
+*/
+
+void biblioteq_z3950_pool::cacheRecords(const QString &key,
+					const QList<QByteArray> &records)
+{
+  if(key.isEmpty() || records.isEmpty())
+    return;
+
+  QMutexLocker locker(&s_mutex);
+
+  /*
+  ** Identifiers are entered by hand. The memory cache only needs
+  ** to cover a session's worth of lookups.
+  */
+
+  if(s_records.size() >= 1000)
+    s_records.clear();
+
+  s_records[key] = records;
+  locker.unlock();
+
+  QCryptographicHash digest(QCryptographicHash::Sha1);
+
+  digest.addData(key.toUtf8());
+  QDir().mkpath(cachePath());
+
+  QString fileName(cachePath() + QDir::separator() +
+		   digest.result().toHex());
+  QString temporary
+    (fileName + "." +
+     QString::number(reinterpret_cast<quintptr> (QThread::currentThread())));
+  QFile file(temporary);
+
+  if(file.open(QIODevice::Truncate | QIODevice::WriteOnly))
+    {
+      QDataStream out(&file);
+
+      out << key << records;
+      file.close();
+
+      if(out.status() != QDataStream::Ok)
+	QFile::remove(temporary);
+      else
+	{
+	  QFile::remove(fileName);
+
+	  if(!QFile::rename(temporary, fileName))
+	    QFile::remove(temporary);
+	}
+    }
+}
+
+/*
+** -- cachedRecords() --
+*/
+
+QList<QByteArray> biblioteq_z3950_pool::cachedRecords(const QString &key)
+{
+  if(key.isEmpty())
+    return QList<QByteArray> ();
+
+  QMutexLocker locker(&s_mutex);
+
+  if(s_records.contains(key))
+    return s_records.value(key);
+
+  locker.unlock();
+
+  QCryptographicHash digest(QCryptographicHash::Sha1);
+
+  digest.addData(key.toUtf8());
+
+  QFileInfo fileInfo(cachePath() + QDir::separator() +
+		     digest.result().toHex());
+
+  if(!fileInfo.exists())
+    return QList<QByteArray> ();
+  else if(fileInfo.lastModified().
+	  secsTo(QDateTime::currentDateTime()) > CACHE_LIFETIME)
+    {
+      QFile::remove(fileInfo.absoluteFilePath());
+      return QList<QByteArray> ();
+    }
+
+  QFile file(fileInfo.absoluteFilePath());
+
+  if(!file.open(QIODevice::ReadOnly))
+    return QList<QByteArray> ();
+
+  QDataStream in(&file);
+  QString storedKey("");
+  QList<QByteArray> records;
+
+  in >> storedKey >> records;
+
+  if(in.status() != QDataStream::Ok || storedKey != key)
+    return QList<QByteArray> ();
+
+  locker.relock();
+  s_records[key] = records;
+  return records;
+}
+
+/*
+** -- clear() --
+*/
+
+void biblioteq_z3950_pool::clear(void)
+{
+  QMutexLocker locker(&s_mutex);
+
+  while(!s_idle.isEmpty())
+    destroy(s_idle.takeFirst());
+
+  s_records.clear();
+}
+
+/*
+** -- destroy() --
+*/
+
+void biblioteq_z3950_pool::destroy(const entry &e)
+{
+  ZOOM_connection_destroy(e.m_connection);
+  ZOOM_options_destroy(e.m_options);
+}
+
+/*
+** -- fingerprint() --
+*/
+
+QString biblioteq_z3950_pool::fingerprint(const QHash<QString, QString> &hash,
+					  const int count)
+{
+  /*
+  ** A connection may only be reused if the site's settings
+  ** have not changed.
+  */
+
+  QStringList list;
+
+  list << hash.value("Address")
+       << hash.value("Database")
+       << hash.value("Password")
+       << hash.value("Port")
+       << hash.value("RecordSyntax").trimmed()
+       << hash.value("Userid")
+       << hash.value("proxy_host")
+       << hash.value("proxy_port")
+       << QString::number(count);
+  return list.join("\n");
+}
+
+/*
+** -- normalizedIdentifier() --
+*/
+
+QString biblioteq_z3950_pool::normalizedIdentifier
+(const QStringList &identifiers)
+{
+  QStringList list;
+
+  for(int i = 0; i < identifiers.size(); i++)
+    {
+      QString identifier("");
+      QString str(identifiers.at(i).toUpper());
+
+      for(int j = 0; j < str.length(); j++)
+	if(str.at(j).isDigit() || str.at(j) == 'X')
+	  identifier.append(str.at(j));
+
+      if(!identifier.isEmpty() && !list.contains(identifier))
+	list.append(identifier);
+    }
+
+  list.sort();
+  return list.join(",");
+}
+
+/*
+** -- prune() --
+*/
+
+void biblioteq_z3950_pool::prune(void)
+{
+  /*
+  ** The mutex must be locked.
+  */
+
+  QDateTime now(QDateTime::currentDateTime());
+
+  for(int i = s_idle.size() - 1; i >= 0; i--)
+    if(s_idle.at(i).m_lastUsed.secsTo(now) > IDLE_TIMEOUT)
+      destroy(s_idle.takeAt(i));
+}
+
+/*
+** -- pruneIdle() --
+*/
+
+void biblioteq_z3950_pool::pruneIdle(void)
+{
+  QMutexLocker locker(&s_mutex);
+
+  prune();
+}
+
+/*
+** -- release() --
+*/
+
+void biblioteq_z3950_pool::release(ZOOM_connection connection,
+				   const bool healthy)
+{
+  if(!connection)
+    return;
+
+  QMutexLocker locker(&s_mutex);
+
+  for(int i = 0; i < s_busy.size(); i++)
+    if(s_busy.at(i).m_connection == connection)
+      {
+	entry e(s_busy.takeAt(i));
+
+	if(healthy)
+	  {
+	    e.m_lastUsed = QDateTime::currentDateTime();
+	    s_idle.append(e);
+	  }
+	else
+	  destroy(e);
+
+	break;
+      }
+
+  prune();
+}
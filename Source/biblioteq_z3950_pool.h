@@ -0,0 +1,71 @@
+#ifndef _BIBLIOTEQ_Z3950_POOL_H_
+#define _BIBLIOTEQ_Z3950_POOL_H_
+
+/*
+** -- Qt Includes --
+*/
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+/*
+** -- YAZ Includes --
+*/
+
+#include <yaz/zoom.h>
+
+/*
+** Z39.50 sessions are expensive to establish. Connections are
+** therefore kept open, per site, between queries and are discarded
+** after a period of inactivity. Records are also cached, in memory
+** and on disk, by site, record syntax and normalized identifier.
+*/
+
+class biblioteq_z3950_pool
+{
+ public:
+  static const int CACHE_LIFETIME = 7 * 24 * 60 * 60; // Seconds.
+  static const int IDLE_TIMEOUT = 180; // Seconds.
+  static QString cacheKey(const QString &site,
+			  const QHash<QString, QString> &hash,
+			  const QString &identifier);
+  static QString normalizedIdentifier(const QStringList &identifiers);
+  static QList<QByteArray> cachedRecords(const QString &key);
+  static ZOOM_connection acquire(const QString &site,
+				 const QHash<QString, QString> &hash,
+				 const int count,
+				 bool *reused);
+  static void cacheRecords(const QString &key,
+			   const QList<QByteArray> &records);
+  static void clear(void);
+  static void pruneIdle(void);
+  static void release(ZOOM_connection connection, const bool healthy);
+
+ private:
+  struct entry
+  {
+    QDateTime m_lastUsed;
+    QString m_fingerprint;
+    QString m_site;
+    ZOOM_connection m_connection;
+    ZOOM_options m_options;
+  };
+
+  static QHash<QString, QList<QByteArray> > s_records;
+  static QList<entry> s_busy;
+  static QList<entry> s_idle;
+  static QMutex s_mutex;
+  biblioteq_z3950_pool(void);
+  static QString cachePath(void);
+  static QString fingerprint(const QHash<QString, QString> &hash,
+			     const int count);
+  static void destroy(const entry &e);
+  static void prune(void);
+};
+
+#endif
@@ -14,13 +14,13 @@ biblioteq_z3950results::biblioteq_z3950results
  QStringList &list,
  biblioteq_magazine *magazine_arg,
  const QFont &font,
- const QString &recordSyntax):QDialog(parent)
+ const QStringList &recordSyntaxes):QDialog(parent)
 {
   int i = 0;
   int row = -1;
 
   m_magazine = magazine_arg;
-  m_recordSyntax = recordSyntax;
+  m_recordSyntaxes = recordSyntaxes;
   setWindowModality(Qt::WindowModal);
   m_ui.setupUi(this);
 #ifdef Q_OS_MAC
@@ -111,7 +111,8 @@ void biblioteq_z3950results::slotSelectRecord(void)
   list = m_ui.textarea->toPlainText().split("\n");
 
   if(m_magazine)
-    m_magazine->populateDisplayAfterZ3950(list, m_recordSyntax);
+    m_magazine->populateDisplayAfterZ3950
+      (list, m_recordSyntaxes.value(m_ui.list->currentRow(), "MARC21"));
 
   list.clear();
   close();
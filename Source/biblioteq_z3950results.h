@@ -26,11 +26,11 @@ class biblioteq_z3950results: public QDialog
 			 QStringList &list,
 			 biblioteq_magazine *magazine_arg,
 			 const QFont &font,
-			 const QString &recordSyntax);
+			 const QStringList &recordSyntaxes);
   ~biblioteq_z3950results();
 
  private:
-  QString m_recordSyntax;
+  QStringList m_recordSyntaxes;
   QStringList m_records;
   Ui_z3950ResultsDialog m_ui;
   biblioteq_magazine *m_magazine;
@@ -54,12 +54,14 @@ FORMS           = UI\\biblioteq_adminsetup.ui \
 UI_HEADERS_DIR  = Include
 
 HEADERS		= Source\\biblioteq.h \
+                  Source\\biblioteq_attachments.h \
                   Source\\biblioteq_bgraphicsscene.h \
 		  Source\\biblioteq_book.h \
 		  Source\\biblioteq_borrowers_editor.h \
 		  Source\\biblioteq_cd.h \
 		  Source\\biblioteq_copy_editor.h \
 		  Source\\biblioteq_copy_editor_book.h \
+                  Source\\biblioteq_csv_export_thread.h \
                   Source\\biblioteq_dbenumerations.h \
 		  Source\\biblioteq_dvd.h \
                   Source\\biblioteq_generic_thread.h \
@@ -68,21 +70,31 @@ HEADERS		= Source\\biblioteq.h \
 		  Source\\biblioteq_item.h \
 		  Source\\biblioteq_magazine.h \
 		  Source\\biblioteq_main_table.h \
+                  Source\\biblioteq_marc_import.h \
                   Source\\biblioteq_myqstring.h \
+                  Source\\biblioteq_photograph_import.h \
 		  Source\\biblioteq_photographcollection.h \
+                  Source\\biblioteq_query_thread.h \
+                  Source\\biblioteq_report_thread.h \
+                  Source\\biblioteq_sru_client.h \
 		  Source\\biblioteq_sruResults.h \
+                  Source\\biblioteq_thumbnail_loader.h \
 		  Source\\biblioteq_videogame.h \
+                  Source\\biblioteq_z3950_pool.h \
 		  Source\\biblioteq_z3950results.h
 
 SOURCES		= Source\\biblioteq_a.cc \
+                  Source\\biblioteq_attachments.cc \
                   Source\\biblioteq_b.cc \
                   Source\\biblioteq_bgraphicsscene.cc \
                   Source\\biblioteq_book.cc \
                   Source\\biblioteq_borrowers_editor.cc \
                   Source\\biblioteq_callnum_table_item.cc \
                   Source\\biblioteq_cd.cc \
+                  Source\\biblioteq_columnar_store.cc \
                   Source\\biblioteq_copy_editor.cc \
                   Source\\biblioteq_copy_editor_book.cc \
+                  Source\\biblioteq_csv_export_thread.cc \
                   Source\\biblioteq_dbenumerations.cc \
                   Source\\biblioteq_dvd.cc \
                   Source\\biblioteq_generic_thread.cc \
@@ -93,12 +105,19 @@ SOURCES		= Source\\biblioteq_a.cc \
                   Source\\biblioteq_magazine.cc \
                   Source\\biblioteq_main_table.cc \
                   Source\\biblioteq_marc.cc \
+                  Source\\biblioteq_marc_import.cc \
                   Source\\biblioteq_misc_functions.cc \
                   Source\\biblioteq_myqstring.cc \
                   Source\\biblioteq_numeric_table_item.cc \
+                  Source\\biblioteq_photograph_import.cc \
                   Source\\biblioteq_photographcollection.cc \
+                  Source\\biblioteq_query_thread.cc \
+                  Source\\biblioteq_report_thread.cc \
+                  Source\\biblioteq_sru_client.cc \
                   Source\\biblioteq_sruResults.cc \
+                  Source\\biblioteq_thumbnail_loader.cc \
                   Source\\biblioteq_videogame.cc \
+                  Source\\biblioteq_z3950_pool.cc \
                   Source\\biblioteq_z3950results.cc
 
 TRANSLATIONS    = Translations\\biblioteq_cs_CZ.ts \